@@ -0,0 +1,435 @@
+#ifndef __RAPIDJSON_UTIL_BENCH_CORPUS_H__
+#define __RAPIDJSON_UTIL_BENCH_CORPUS_H__
+
+#include "rapid_util/rapid_util.h"
+#include <array>
+#include <chrono>
+#include <random>
+
+// Described structs modelled on the documents of the usual JSON benchmarks, twitter.json (string
+// heavy), canada.json (number heavy) and citm_catalog.json (deep nesting, many keys), plus batches
+// of log events, filled by seeded generators to any size
+
+// twitter.json
+
+struct FeedUser {
+    uint64_t id;
+    std::string screenName;
+    std::string name;
+    std::string description;
+    std::string location;
+    std::optional<std::string> url;
+    int32_t followersCount;
+    int32_t friendsCount;
+    bool verified;
+};
+
+struct FeedHashtag {
+    std::string text;
+    std::array<int32_t, 2> indices;
+};
+
+struct FeedEntities {
+    std::vector<FeedHashtag> hashtags;
+    std::vector<std::string> urls;
+    std::vector<uint64_t> userMentions;
+};
+
+struct FeedStatus {
+    uint64_t id;
+    std::string createdAt;
+    std::string text;
+    std::string source;
+    FeedUser user;
+    FeedEntities entities;
+    std::optional<uint64_t> inReplyToStatusId;
+    int32_t retweetCount;
+    int32_t favoriteCount;
+    std::string lang;
+};
+
+struct FeedCorpus {
+    std::vector<FeedStatus> statuses;
+};
+
+// canada.json
+
+struct GeoProperties {
+    std::string name;
+};
+
+struct GeoGeometry {
+    std::string type;
+    std::vector<std::vector<std::array<double, 2>>> coordinates;
+};
+
+struct GeoFeature {
+    std::string type;
+    GeoProperties properties;
+    GeoGeometry geometry;
+};
+
+struct GeoCorpus {
+    std::string type;
+    std::vector<GeoFeature> features;
+};
+
+// citm_catalog.json
+
+struct CitmPrice {
+    int64_t amount;
+    int64_t audienceSubCategoryId;
+    int64_t seatCategoryId;
+};
+
+struct CitmArea {
+    int64_t areaId;
+    std::vector<int64_t> blockIds;
+};
+
+struct CitmSeatCategory {
+    std::vector<CitmArea> areas;
+    int64_t seatCategoryId;
+};
+
+struct CitmPerformance {
+    int64_t id;
+    int64_t eventId;
+    std::optional<std::string> logo;
+    std::optional<std::string> name;
+    std::vector<CitmPrice> prices;
+    std::vector<CitmSeatCategory> seatCategories;
+    std::optional<std::string> seatMapImage;
+    int64_t start;
+    std::string venueCode;
+};
+
+struct CitmEvent {
+    int64_t id;
+    std::string name;
+    std::optional<std::string> description;
+    std::optional<std::string> logo;
+    std::vector<int64_t> subTopicIds;
+    std::optional<std::string> subjectCode;
+    std::optional<std::string> subtitle;
+    std::vector<int64_t> topicIds;
+};
+
+struct CitmCorpus {
+    std::vector<CitmEvent> events;
+    std::vector<CitmPerformance> performances;
+};
+
+// Log events, as shipped by a service to a collector
+
+struct LogEvent {
+    std::chrono::system_clock::time_point timestamp;
+    std::string level;
+    std::string service;
+    std::string host;
+    std::string message;
+    std::optional<std::string> traceId;
+    int32_t status;
+    double latencyMs;
+    std::vector<std::string> tags;
+};
+
+struct LogCorpus {
+    std::vector<LogEvent> events;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(FeedUser, (id, screenName, name, description, location, url, followersCount, friendsCount, verified))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(FeedHashtag, (text, indices))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(FeedEntities, (hashtags, urls, userMentions))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(FeedStatus, (id, createdAt, text, source, user, entities, inReplyToStatusId, retweetCount, favoriteCount, lang))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(FeedCorpus, (statuses))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(GeoProperties, (name))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(GeoGeometry, (type, coordinates))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(GeoFeature, (type, properties, geometry))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(GeoCorpus, (type, features))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CitmPrice, (amount, audienceSubCategoryId, seatCategoryId))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CitmArea, (areaId, blockIds))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CitmSeatCategory, (areas, seatCategoryId))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CitmPerformance, (id, eventId, logo, name, prices, seatCategories, seatMapImage, start, venueCode))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CitmEvent, (id, name, description, logo, subTopicIds, subjectCode, subtitle, topicIds))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CitmCorpus, (events, performances))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(LogEvent, (timestamp, level, service, host, message, traceId, status, latencyMs, tags))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(LogCorpus, (events))
+
+
+/**
+ * Random values that are the same on every platform for a given seed. std::mt19937_64 is fully
+ * specified by the standard, unlike the std:: distributions, so values are derived from its raw
+ * output rather than through them. Expressions that draw several values are braced initializers,
+ * whose elements are evaluated in order, unlike the operands of + or the arguments of a call.
+ */
+class CorpusRandom {
+public:
+    explicit CorpusRandom(uint64_t seed) : engine(seed) {}
+
+    // In [low, high]
+    int64_t between(int64_t low, int64_t high) {
+        return low + static_cast<int64_t>(engine() % static_cast<uint64_t>(high - low + 1));
+    }
+
+    // In [low, high)
+    double real(double low, double high) {
+        return low + (high - low) * static_cast<double>(engine() >> 11) * 0x1.0p-53;
+    }
+
+    bool chance(int percent) {
+        return between(0, 99) < percent;
+    }
+
+    template<std::size_t N>
+    const char* pick(const char* const (&choices)[N]) {
+        return choices[between(0, N - 1)];
+    }
+
+    std::string word() {
+        // Mostly ASCII, with the accented, CJK and emoji words and the quotes and line breaks that
+        // user text brings
+        static constexpr const char* words[] = {
+            "the", "of", "and", "release", "build", "json", "parser", "fast", "today", "new", "update",
+            "service", "latency", "request", "user", "stream", "market", "price", "order", "city",
+            "caf\xC3\xA9", "na\xC3\xAFve", "\xE6\x9D\xB1\xE4\xBA\xAC", "\xF0\x9F\x9A\x80", "\"quoted\"", "line\nbreak"
+        };
+
+        return pick(words);
+    }
+
+    std::string sentence(int minWords, int maxWords) {
+        std::string text = word();
+
+        for (int64_t i = between(minWords, maxWords) - 1; i > 0; --i)
+            text.append(" ").append(word());
+
+        return text;
+    }
+
+    std::string identifier(std::size_t length) {
+        static constexpr char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+
+        std::string text(length, ' ');
+        for (auto&& c : text)
+            c = alphabet[between(0, sizeof(alphabet) - 2)];
+
+        return text;
+    }
+
+private:
+    std::mt19937_64 engine;
+};
+
+inline constexpr uint64_t corpusSeed = 0x5eed2024;
+
+
+inline FeedStatus makeFeedStatus(CorpusRandom& random, uint64_t index) {
+    static constexpr const char* sources[] = { "web", "iphone", "android", "api" };
+    static constexpr const char* languages[] = { "en", "ja", "fr", "es", "und" };
+
+    FeedStatus status;
+    status.id = 505874924095815700 + index;
+    status.createdAt = "Sun Aug 31 00:" + std::to_string(10 + index % 50) + ":25 +0000 2014";
+    status.text = random.sentence(4, 24);
+    const std::string source = random.pick(sources);
+    status.source = "<a href=\"https://example.com/" + source + "\" rel=\"nofollow\">" + source + "</a>";
+    status.user = FeedUser{ static_cast<uint64_t>(random.between(1, 3000000000)), random.identifier(10), random.sentence(1, 3),
+                            random.sentence(0, 20), random.sentence(1, 2),
+                            random.chance(30) ? std::optional<std::string>("https://example.com/" + random.identifier(8)) : std::nullopt,
+                            static_cast<int32_t>(random.between(0, 500000)), static_cast<int32_t>(random.between(0, 5000)), random.chance(5) };
+
+    for (int64_t i = random.between(0, 3); i > 0; --i) {
+        int32_t start = static_cast<int32_t>(random.between(0, 100));
+        status.entities.hashtags.push_back(FeedHashtag{ random.word(), { start, start + 8 } });
+    }
+    for (int64_t i = random.between(0, 2); i > 0; --i)
+        status.entities.urls.push_back("https://t.co/" + random.identifier(10));
+    for (int64_t i = random.between(0, 2); i > 0; --i)
+        status.entities.userMentions.push_back(static_cast<uint64_t>(random.between(1, 3000000000)));
+
+    if (random.chance(20))
+        status.inReplyToStatusId = status.id - static_cast<uint64_t>(random.between(1, 1000));
+    status.retweetCount = static_cast<int32_t>(random.between(0, 10000));
+    status.favoriteCount = static_cast<int32_t>(random.between(0, 10000));
+    status.lang = random.pick(languages);
+
+    return status;
+}
+
+// A polygon ring traced around a random centre, the closing point repeating the first
+inline GeoFeature makeGeoFeature(CorpusRandom& random, uint64_t index) {
+    GeoFeature feature{ "Feature", { "Region " + std::to_string(index) }, { "Polygon", {} } };
+
+    for (int64_t ring = random.between(1, 3); ring > 0; --ring) {
+        double longitude = random.real(-141.0, -52.6);
+        double latitude = random.real(41.7, 83.1);
+
+        std::vector<std::array<double, 2>> points(static_cast<std::size_t>(random.between(8, 128)));
+        for (auto&& point : points) {
+            longitude += random.real(-0.01, 0.01);
+            latitude += random.real(-0.01, 0.01);
+            point = { longitude, latitude };
+        }
+        points.push_back(points.front());
+
+        feature.geometry.coordinates.push_back(std::move(points));
+    }
+
+    return feature;
+}
+
+inline CitmEvent makeCitmEvent(CorpusRandom& random, uint64_t index) {
+    CitmEvent event;
+    event.id = 138586341 + static_cast<int64_t>(index);
+    event.name = random.sentence(2, 6);
+    if (random.chance(10))
+        event.description = random.sentence(10, 40);
+    if (random.chance(50))
+        event.logo = "/images/UE0AAAAACEKo6QAAAAZDSVRN";
+    for (int64_t i = random.between(1, 4); i > 0; --i)
+        event.subTopicIds.push_back(337184262 + random.between(0, 100));
+    if (random.chance(5))
+        event.subjectCode = random.identifier(4);
+    if (random.chance(5))
+        event.subtitle = random.sentence(2, 5);
+    for (int64_t i = random.between(1, 3); i > 0; --i)
+        event.topicIds.push_back(107888604 + random.between(0, 100));
+
+    return event;
+}
+
+inline CitmPerformance makeCitmPerformance(CorpusRandom& random, uint64_t index, int64_t eventId) {
+    CitmPerformance performance;
+    performance.id = 339887544 + static_cast<int64_t>(index);
+    performance.eventId = eventId;
+    if (random.chance(50))
+        performance.logo = "/images/UE0AAAAACEKo6QAAAAZDSVRN";
+
+    for (int64_t i = random.between(1, 6); i > 0; --i) {
+        int64_t seatCategoryId = 338937295 + random.between(0, 20);
+        performance.prices.push_back(CitmPrice{ random.between(9, 400) * 50, 337100890, seatCategoryId });
+
+        CitmSeatCategory category{ {}, seatCategoryId };
+        for (int64_t j = random.between(1, 12); j > 0; --j) {
+            CitmArea area{ 205705993 + random.between(0, 200), {} };
+            for (int64_t k = random.between(0, 3); k > 0; --k)
+                area.blockIds.push_back(random.between(1, 1000));
+
+            category.areas.push_back(std::move(area));
+        }
+        performance.seatCategories.push_back(std::move(category));
+    }
+
+    performance.seatMapImage = std::nullopt;
+    performance.start = 1372616400000 + random.between(0, 400) * 86400000;
+    performance.venueCode = "PLEYEL_PLEYEL";
+
+    return performance;
+}
+
+inline LogEvent makeLogEvent(CorpusRandom& random, uint64_t index) {
+    static constexpr const char* levels[] = { "DEBUG", "INFO", "INFO", "INFO", "WARN", "ERROR" };
+    static constexpr const char* services[] = { "checkout", "payments", "inventory", "search", "auth" };
+    static constexpr const char* tags[] = { "canary", "eu-west-1", "k8s", "retry", "cache-miss", "slow" };
+
+    LogEvent event;
+    event.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(1705314600000 + static_cast<int64_t>(index) * 7));
+    event.level = random.pick(levels);
+    event.service = random.pick(services);
+    const int64_t subnet = random.between(0, 255);
+    event.host = "ip-10-" + std::to_string(subnet) + "-" + std::to_string(random.between(0, 255));
+    event.message = random.sentence(3, 30);
+    if (random.chance(70))
+        event.traceId = random.identifier(32);
+    event.status = static_cast<int32_t>(random.chance(95) ? 200 : random.between(400, 504));
+    event.latencyMs = random.real(0.05, 2500.0);
+    for (int64_t i = random.between(0, 3); i > 0; --i)
+        event.tags.push_back(random.pick(tags));
+
+    return event;
+}
+
+
+/**
+ * The corpora of each shape: generate fills one with records until its JSON reaches the given
+ * size, the same records for the same size on every run, and records counts them
+ */
+template<typename Corpus>
+struct CorpusOf;
+
+// Appends records made by make until their JSON, one comma each, reaches bytes
+template<typename Record, typename Make>
+void appendRecords(std::vector<Record>& records, std::size_t& size, std::size_t bytes, CorpusRandom& random, Make make) {
+    while (size < bytes) {
+        records.push_back(make(random, static_cast<uint64_t>(records.size())));
+        size += rapidjson_util::marshal(records.back()).size() + 1;
+    }
+}
+
+template<>
+struct CorpusOf<FeedCorpus> {
+    static FeedCorpus generate(std::size_t bytes) {
+        CorpusRandom random(corpusSeed);
+        FeedCorpus corpus;
+        std::size_t size = 0;
+
+        appendRecords(corpus.statuses, size, bytes, random, makeFeedStatus);
+        return corpus;
+    }
+
+    static std::size_t records(const FeedCorpus& corpus) { return corpus.statuses.size(); }
+};
+
+template<>
+struct CorpusOf<GeoCorpus> {
+    static GeoCorpus generate(std::size_t bytes) {
+        CorpusRandom random(corpusSeed);
+        GeoCorpus corpus{ "FeatureCollection", {} };
+        std::size_t size = 0;
+
+        appendRecords(corpus.features, size, bytes, random, makeGeoFeature);
+        return corpus;
+    }
+
+    static std::size_t records(const GeoCorpus& corpus) { return corpus.features.size(); }
+};
+
+// Every event is followed by the performances of it, a quarter of the bytes going to events
+template<>
+struct CorpusOf<CitmCorpus> {
+    static CitmCorpus generate(std::size_t bytes) {
+        CorpusRandom random(corpusSeed);
+        CitmCorpus corpus;
+        std::size_t eventSize = 0;
+        std::size_t performanceSize = 0;
+
+        while (eventSize + performanceSize < bytes) {
+            appendRecords(corpus.events, eventSize, eventSize + 1, random, makeCitmEvent);
+
+            int64_t eventId = corpus.events.back().id;
+            appendRecords(corpus.performances, performanceSize, 3 * eventSize, random,
+                          [eventId](CorpusRandom& random, uint64_t index) { return makeCitmPerformance(random, index, eventId); });
+        }
+
+        return corpus;
+    }
+
+    static std::size_t records(const CitmCorpus& corpus) { return corpus.events.size() + corpus.performances.size(); }
+};
+
+template<>
+struct CorpusOf<LogCorpus> {
+    static LogCorpus generate(std::size_t bytes) {
+        CorpusRandom random(corpusSeed);
+        LogCorpus corpus;
+        std::size_t size = 0;
+
+        appendRecords(corpus.events, size, bytes, random, makeLogEvent);
+        return corpus;
+    }
+
+    static std::size_t records(const LogCorpus& corpus) { return corpus.events.size(); }
+};
+
+#endif
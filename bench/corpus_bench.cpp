@@ -0,0 +1,54 @@
+#include "benchmark/benchmark.h"
+#include "corpus.h"
+
+// The argument is the size of the JSON of the corpus, from 1 KiB to 100 MiB. The corpus is
+// generated before timing starts, so the larger ones take a while to set up
+
+template<typename Corpus>
+void MarshalCorpus(benchmark::State& state) {
+    const Corpus corpus = CorpusOf<Corpus>::generate(static_cast<std::size_t>(state.range(0)));
+    std::size_t size = 0;
+
+    for (auto _ : state) {
+        std::string json = rapidjson_util::marshal(corpus);
+        size = json.size();
+        benchmark::DoNotOptimize(json.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * CorpusOf<Corpus>::records(corpus)));
+    state.counters["encoded_bytes"] = static_cast<double>(size);
+}
+
+template<typename Corpus>
+void UnmarshalCorpus(benchmark::State& state) {
+    std::string json;
+    std::size_t records = 0;
+    {
+        const Corpus corpus = CorpusOf<Corpus>::generate(static_cast<std::size_t>(state.range(0)));
+        json = rapidjson_util::marshal(corpus);
+        records = CorpusOf<Corpus>::records(corpus);
+    }
+
+    for (auto _ : state) {
+        Corpus decoded;
+        rapidjson_util::unmarshal(json, decoded);
+        benchmark::DoNotOptimize(&decoded);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * records));
+    state.counters["encoded_bytes"] = static_cast<double>(json.size());
+}
+
+#define RAPIDUTIL_BENCHMARK_CORPUS_SIZES(registration)                             \
+    registration->ArgName("bytes")->Arg(1 << 10)->Arg(100 << 10)->Arg(10 << 20)->Arg(100 << 20)->Unit(benchmark::kMillisecond)
+
+#define RAPIDUTIL_BENCHMARK_CORPUS(Corpus)                                        \
+    RAPIDUTIL_BENCHMARK_CORPUS_SIZES(BENCHMARK_TEMPLATE(MarshalCorpus, Corpus));   \
+    RAPIDUTIL_BENCHMARK_CORPUS_SIZES(BENCHMARK_TEMPLATE(UnmarshalCorpus, Corpus))
+
+RAPIDUTIL_BENCHMARK_CORPUS(FeedCorpus);
+RAPIDUTIL_BENCHMARK_CORPUS(GeoCorpus);
+RAPIDUTIL_BENCHMARK_CORPUS(CitmCorpus);
+RAPIDUTIL_BENCHMARK_CORPUS(LogCorpus);
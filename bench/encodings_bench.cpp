@@ -0,0 +1,486 @@
+#include "benchmark/benchmark.h"
+#include "rapid_util/rapid_util_binary_view.h"
+#include "rapid_util/rapid_util_cbor.h"
+#include "rapid_util/rapid_util_columns.h"
+#include "rapid_util/rapid_util_msgpack.h"
+#include "rapid_util/rapid_util_protobuf.h"
+#include <chrono>
+
+// The types of marshal_example.cpp and unmarshal_example.cpp, plus a number-heavy one
+
+struct Person {
+    std::string name;
+    int age;
+    bool isStudent;
+    std::optional<std::string> email;
+};
+
+struct Address {
+    std::string street;
+    std::string city;
+    int zipCode;
+};
+
+struct Employee {
+    std::string name;
+    Address address;
+    double salary;
+};
+
+struct Product {
+    std::string productId;
+    std::string name;
+    double price;
+    int quantity;
+};
+
+struct Inventory {
+    std::string warehouse;
+    std::vector<std::optional<Product>> products;
+};
+
+struct SensorReading {
+    std::string sensorType;
+    double value;
+};
+
+struct SystemStatus {
+    std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds> timestamp;
+    std::tuple<bool, int, SensorReading, std::string> statusData;
+    std::optional<std::tuple<double, std::string, int>> diagnostics;
+};
+
+struct SensorTrace {
+    std::string sensorId;
+    std::vector<double> samples;
+};
+
+// The same table of products, an object per product in Catalog and an array per member in
+// ColumnarCatalog
+
+struct CatalogItem {
+    std::string productId;
+    std::string name;
+    double price;
+    int quantity;
+};
+
+using CatalogColumns = rapidjson_util::columnar<std::vector<CatalogItem>>;
+
+struct Catalog {
+    std::string warehouse;
+    std::vector<Product> products;
+};
+
+struct ColumnarCatalog {
+    std::string warehouse;
+    CatalogColumns products;
+};
+
+struct MarketTick {
+    std::string symbol;
+    double bid;
+    double ask;
+    std::optional<double> last;
+    std::optional<int64_t> volume;
+    std::optional<std::string> condition;
+    int flags;
+};
+
+// The same tick without its null and zero members, under one-letter names
+struct CompactMarketTick : MarketTick {
+};
+
+// The members of Employee listed in a directory, copied into a struct of their own
+struct EmployeeDirectoryEntry {
+    std::string name;
+    Address address;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Person, (name, age, isStudent, email))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Address, (street, city, zipCode))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Employee, (name, address, salary))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Product, (productId, name, price, quantity))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Inventory, (warehouse, products))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SensorReading, (sensorType, value))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SystemStatus, (timestamp, statusData, diagnostics))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SensorTrace, (sensorId, samples))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CatalogItem, (productId, name, price, quantity))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Catalog, (warehouse, products))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(ColumnarCatalog, (warehouse, products))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MarketTick, (symbol, bid, ask, last, volume, condition, flags))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CompactMarketTick, (symbol, bid, ask, last, volume, condition, flags))
+RAPIDJSON_UTIL_DESCRIBE_OMISSION(CompactMarketTick, Defaults)
+RAPIDJSON_UTIL_DESCRIBE_WIRE_NAMES(CompactMarketTick, (symbol, "s"), (bid, "b"), (ask, "a"), (last, "l"), (volume, "v"),
+                                   (condition, "c"), (flags, "f"))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(EmployeeDirectoryEntry, (name, address))
+RAPIDJSON_UTIL_DESCRIBE_VIEW(Employee, EmployeeDirectoryView, (name, address))
+
+
+template<typename T>
+T makeSample();
+
+template<>
+Person makeSample<Person>() {
+    return Person{ "Alice", 25, true, "alice@example.com" };
+}
+
+template<>
+Employee makeSample<Employee>() {
+    return Employee{ "John Doe", { "123 Main St", "Beijing", 10001 }, 75000.0 };
+}
+
+template<>
+Inventory makeSample<Inventory>() {
+    Inventory inventory{ "Main Storage", {} };
+
+    for (int i = 0; i < 100; ++i) {
+        if (i % 10 == 0)
+            inventory.products.push_back(std::nullopt);
+        else
+            inventory.products.push_back(Product{ "P" + std::to_string(1000 + i), "Product " + std::to_string(i),
+                                                  9.99 + i, i * 3 });
+    }
+
+    return inventory;
+}
+
+template<>
+SystemStatus makeSample<SystemStatus>() {
+    SystemStatus status;
+    status.timestamp = decltype(status.timestamp)(std::chrono::seconds(1705314600));
+    status.statusData = std::make_tuple(true, 85, SensorReading{ "Temperature", 23.5 }, "Operational");
+    status.diagnostics = std::make_tuple(0.75, "Nominal", 3);
+
+    return status;
+}
+
+template<>
+SensorTrace makeSample<SensorTrace>() {
+    SensorTrace trace{ "accelerometer-x", std::vector<double>(4096) };
+
+    for (std::size_t i = 0; i < trace.samples.size(); ++i)
+        trace.samples[i] = 9.81 + 0.001 * static_cast<double>(i % 97) - 0.0375 * static_cast<double>(i % 13);
+
+    return trace;
+}
+
+template<>
+Catalog makeSample<Catalog>() {
+    Catalog catalog{ "Main Storage", {} };
+
+    for (int i = 0; i < 1000; ++i)
+        catalog.products.push_back(Product{ "P" + std::to_string(1000 + i), "Product " + std::to_string(i), 9.99 + i, i * 3 });
+
+    return catalog;
+}
+
+template<>
+ColumnarCatalog makeSample<ColumnarCatalog>() {
+    ColumnarCatalog catalog{ "Main Storage", {} };
+
+    for (auto&& product : makeSample<Catalog>().products)
+        catalog.products.push_back(CatalogItem{ product.productId, product.name, product.price, product.quantity });
+
+    return catalog;
+}
+
+template<>
+MarketTick makeSample<MarketTick>() {
+    return MarketTick{ "AAPL", 189.5, 189.52, std::nullopt, std::nullopt, std::nullopt, 0 };
+}
+
+template<>
+CompactMarketTick makeSample<CompactMarketTick>() {
+    return CompactMarketTick{ makeSample<MarketTick>() };
+}
+
+
+// Bytes processed are the bytes of the encoded form, so every format reports its own throughput
+
+template<typename T>
+void MarshalJson(benchmark::State& state) {
+    const T sample = makeSample<T>();
+    std::size_t size = 0;
+
+    for (auto _ : state) {
+        std::string json = rapidjson_util::marshal(sample);
+        size = json.size();
+        benchmark::DoNotOptimize(json.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    state.counters["encoded_bytes"] = static_cast<double>(size);
+}
+
+template<typename T>
+void MarshalMsgpack(benchmark::State& state) {
+    const T sample = makeSample<T>();
+    std::vector<uint8_t> buffer;
+
+    for (auto _ : state) {
+        rapidjson_util::marshal_msgpack(sample, buffer);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+    state.counters["encoded_bytes"] = static_cast<double>(buffer.size());
+}
+
+template<typename T>
+void MarshalCbor(benchmark::State& state) {
+    const T sample = makeSample<T>();
+    std::vector<uint8_t> buffer;
+
+    for (auto _ : state) {
+        rapidjson_util::marshal_cbor(sample, buffer);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+    state.counters["encoded_bytes"] = static_cast<double>(buffer.size());
+}
+
+template<typename T>
+void MarshalBinary(benchmark::State& state) {
+    const T sample = makeSample<T>();
+    std::vector<uint8_t> buffer;
+
+    for (auto _ : state) {
+        rapidjson_util::marshal_binary(sample, buffer);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+    state.counters["encoded_bytes"] = static_cast<double>(buffer.size());
+}
+
+template<typename T>
+void MarshalProtobuf(benchmark::State& state) {
+    const T sample = makeSample<T>();
+    std::vector<uint8_t> buffer;
+
+    for (auto _ : state) {
+        rapidjson_util::marshal_protobuf(sample, buffer);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+    state.counters["encoded_bytes"] = static_cast<double>(buffer.size());
+}
+
+template<typename T>
+void UnmarshalJson(benchmark::State& state) {
+    const std::string json = rapidjson_util::marshal(makeSample<T>());
+
+    for (auto _ : state) {
+        T decoded;
+        rapidjson_util::unmarshal(json, decoded);
+        benchmark::DoNotOptimize(&decoded);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+}
+
+template<typename T>
+void UnmarshalMsgpack(benchmark::State& state) {
+    const std::vector<uint8_t> buffer = rapidjson_util::marshal_msgpack(makeSample<T>());
+
+    for (auto _ : state) {
+        T decoded;
+        rapidjson_util::unmarshal_msgpack(buffer, decoded);
+        benchmark::DoNotOptimize(&decoded);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+}
+
+template<typename T>
+void UnmarshalCbor(benchmark::State& state) {
+    const std::vector<uint8_t> buffer = rapidjson_util::marshal_cbor(makeSample<T>());
+
+    for (auto _ : state) {
+        T decoded;
+        rapidjson_util::unmarshal_cbor(buffer, decoded);
+        benchmark::DoNotOptimize(&decoded);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+}
+
+template<typename T>
+void UnmarshalBinary(benchmark::State& state) {
+    const std::vector<uint8_t> buffer = rapidjson_util::marshal_binary(makeSample<T>());
+
+    for (auto _ : state) {
+        T decoded;
+        rapidjson_util::unmarshal_binary(buffer, decoded);
+        benchmark::DoNotOptimize(&decoded);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+}
+
+template<typename T>
+void UnmarshalProtobuf(benchmark::State& state) {
+    const std::vector<uint8_t> buffer = rapidjson_util::marshal_protobuf(makeSample<T>());
+
+    for (auto _ : state) {
+        T decoded;
+        rapidjson_util::unmarshal_protobuf(buffer, decoded);
+        benchmark::DoNotOptimize(&decoded);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+}
+
+// Reads the samples in place, where UnmarshalBinary<SensorTrace> copies them first
+void SumBinaryViewSamples(benchmark::State& state) {
+    const std::vector<uint8_t> buffer = rapidjson_util::marshal_binary(makeSample<SensorTrace>());
+
+    for (auto _ : state) {
+        rapidjson_util::binary_view<SensorTrace> view(buffer.data(), buffer.size());
+        auto samples = view.get<&SensorTrace::samples>();
+
+        double sum = 0;
+        for (std::size_t i = 0; i < samples.size(); ++i)
+            sum += samples.data()[i];
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+}
+
+// The products of Catalog as NDJSON, one object per line
+std::vector<std::string> makeProductLines() {
+    std::vector<std::string> lines;
+
+    for (auto&& product : makeSample<Catalog>().products)
+        lines.push_back(rapidjson_util::marshal(product));
+
+    return lines;
+}
+
+// Sums the prices of the products after decoding them into structs, one line at a time
+void SumPricesOfUnmarshalledLines(benchmark::State& state) {
+    const std::vector<std::string> lines = makeProductLines();
+    std::size_t size = 0;
+    for (auto&& line : lines)
+        size += line.size() + 1;
+
+    for (auto _ : state) {
+        std::vector<Product> products(lines.size());
+        for (std::size_t i = 0; i < lines.size(); ++i)
+            rapidjson_util::unmarshal(lines[i], products[i]);
+
+        double sum = 0;
+        for (auto&& product : products)
+            sum += product.price;
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+
+// Sums the same prices decoded straight into columns
+void SumPricesOfColumnarLines(benchmark::State& state) {
+    std::string ndjson;
+    for (auto&& line : makeProductLines())
+        ndjson.append(line).append("\n");
+
+    for (auto _ : state) {
+        auto table = rapidjson_util::unmarshal_lines_columnar<Product>(ndjson);
+        auto& prices = table.get<&Product::price>();
+
+        double sum = 0;
+        for (std::size_t i = 0; i < prices.size(); ++i)
+            sum += prices.data()[i];
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * ndjson.size()));
+}
+
+void ExportCatalogToColumns(benchmark::State& state) {
+    const Catalog catalog = makeSample<Catalog>();
+
+    for (auto _ : state) {
+        auto table = rapidjson_util::to_columns(catalog.products);
+        benchmark::DoNotOptimize(table.get<&Product::price>().data());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * catalog.products.size()));
+}
+
+// Writes the directory members of Employee the way endpoints without views do, through a copy
+void MarshalDirectoryEntryCopy(benchmark::State& state) {
+    const Employee employee = makeSample<Employee>();
+
+    for (auto _ : state) {
+        EmployeeDirectoryEntry entry{ employee.name, employee.address };
+        benchmark::DoNotOptimize(rapidjson_util::marshal(entry));
+    }
+}
+
+// Writes the same members through a view of Employee
+void MarshalDirectoryView(benchmark::State& state) {
+    const Employee employee = makeSample<Employee>();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(rapidjson_util::marshal<EmployeeDirectoryView>(employee));
+}
+
+// Writes only the prices of Inventory, which MarshalJson<Inventory> writes whole
+void MarshalInventoryPricesMasked(benchmark::State& state) {
+    const Inventory inventory = makeSample<Inventory>();
+    const rapidjson_util::FieldMask<Inventory> mask{ "products.price" };
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(rapidjson_util::marshal(inventory, mask));
+}
+
+#define RAPIDUTIL_BENCHMARK_ENCODINGS(T)          \
+    BENCHMARK_TEMPLATE(MarshalJson, T);           \
+    BENCHMARK_TEMPLATE(MarshalMsgpack, T);        \
+    BENCHMARK_TEMPLATE(MarshalCbor, T);           \
+    BENCHMARK_TEMPLATE(UnmarshalJson, T);         \
+    BENCHMARK_TEMPLATE(UnmarshalMsgpack, T);      \
+    BENCHMARK_TEMPLATE(UnmarshalCbor, T)
+
+RAPIDUTIL_BENCHMARK_ENCODINGS(Person);
+RAPIDUTIL_BENCHMARK_ENCODINGS(Employee);
+RAPIDUTIL_BENCHMARK_ENCODINGS(Inventory);
+RAPIDUTIL_BENCHMARK_ENCODINGS(SystemStatus);
+RAPIDUTIL_BENCHMARK_ENCODINGS(SensorTrace);
+RAPIDUTIL_BENCHMARK_ENCODINGS(Catalog);
+RAPIDUTIL_BENCHMARK_ENCODINGS(ColumnarCatalog);
+RAPIDUTIL_BENCHMARK_ENCODINGS(MarketTick);
+RAPIDUTIL_BENCHMARK_ENCODINGS(CompactMarketTick);
+
+// The compact binary format has no tuples, which SystemStatus holds
+#define RAPIDUTIL_BENCHMARK_BINARY(T)             \
+    BENCHMARK_TEMPLATE(MarshalBinary, T);         \
+    BENCHMARK_TEMPLATE(UnmarshalBinary, T)
+
+RAPIDUTIL_BENCHMARK_BINARY(Person);
+RAPIDUTIL_BENCHMARK_BINARY(Employee);
+RAPIDUTIL_BENCHMARK_BINARY(Inventory);
+RAPIDUTIL_BENCHMARK_BINARY(SensorTrace);
+BENCHMARK(SumBinaryViewSamples);
+
+// Protobuf has no tuples, and no null elements in repeated fields, which Inventory holds
+#define RAPIDUTIL_BENCHMARK_PROTOBUF(T)           \
+    BENCHMARK_TEMPLATE(MarshalProtobuf, T);       \
+    BENCHMARK_TEMPLATE(UnmarshalProtobuf, T)
+
+RAPIDUTIL_BENCHMARK_PROTOBUF(Person);
+RAPIDUTIL_BENCHMARK_PROTOBUF(Employee);
+RAPIDUTIL_BENCHMARK_PROTOBUF(SensorTrace);
+
+BENCHMARK(SumPricesOfUnmarshalledLines);
+BENCHMARK(SumPricesOfColumnarLines);
+BENCHMARK(ExportCatalogToColumns);
+
+BENCHMARK(MarshalDirectoryEntryCopy);
+BENCHMARK(MarshalDirectoryView);
+BENCHMARK(MarshalInventoryPricesMasked);
@@ -0,0 +1,214 @@
+#include "latency_histogram.h"
+#include "workloads.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+// Per-call latency of marshal and unmarshal under sustained load, for the tail percentiles that
+// mean throughput hides:
+//
+//   rapidutil_latency [--rate=<calls/s>] [--duration=<s>] [--warmup=<s>] [--bytes=<n>]
+//                     [--filter=<substring>] [--output=<file.json>]
+//
+// Without a rate the loop is closed, each call starting as soon as the one before returns, and a
+// call's latency is its own duration. With a rate the loop is open, calls are due at fixed
+// intervals whether or not the ones before have returned, and a call's latency runs from the
+// time it was due, so a stall counts against every call queued behind it, as it would against
+// requests arriving at a server.
+
+using Clock = std::chrono::steady_clock;
+
+struct LatencyOptions {
+    double rate = 0.0;
+    double duration = 5.0;
+    double warmup = 1.0;
+    std::size_t bytes = 16 << 10;
+    std::string filter;
+    std::string output;
+};
+
+struct LatencyBucket {
+    uint64_t upperNs;
+    uint64_t count;
+};
+
+struct LatencyResult {
+    std::string workload;
+    std::string mode;
+    double targetRate;
+    double achievedRate;
+    uint64_t calls;
+    double meanNs;
+    uint64_t p50Ns;
+    uint64_t p90Ns;
+    uint64_t p99Ns;
+    uint64_t p999Ns;
+    uint64_t maxNs;
+    std::vector<LatencyBucket> buckets;
+};
+
+struct LatencyReport {
+    uint64_t bytes;
+    double durationSeconds;
+    std::vector<LatencyResult> results;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(LatencyBucket, (upperNs, count))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(LatencyResult, (workload, mode, targetRate, achievedRate, calls, meanNs, p50Ns, p90Ns, p99Ns, p999Ns, maxNs, buckets))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(LatencyReport, (bytes, durationSeconds, results))
+
+
+uint64_t nanosecondsBetween(Clock::time_point from, Clock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+// Sleeps until shortly before due, then yields, since sleeps overshoot by more than a call takes
+void waitUntil(Clock::time_point due) {
+    constexpr auto spin = std::chrono::microseconds(200);
+
+    for (Clock::time_point now = Clock::now(); now < due; now = Clock::now()) {
+        if (due - now > spin)
+            std::this_thread::sleep_for(due - now - spin);
+        else
+            std::this_thread::yield();
+    }
+}
+
+void runClosedLoop(const Workload& workload, Clock::duration duration, LatencyHistogram& histogram) {
+    const Clock::time_point end = Clock::now() + duration;
+
+    for (Clock::time_point start = Clock::now(); start < end; ) {
+        workload.call();
+        Clock::time_point finish = Clock::now();
+        histogram.record(nanosecondsBetween(start, finish));
+        start = finish;
+    }
+}
+
+void runOpenLoop(const Workload& workload, Clock::duration duration, double rate, LatencyHistogram& histogram) {
+    const auto interval = std::chrono::duration<double>(1.0 / rate);
+    const Clock::time_point begin = Clock::now();
+    const Clock::time_point end = begin + duration;
+
+    for (uint64_t i = 0; ; ++i) {
+        Clock::time_point due = begin + std::chrono::duration_cast<Clock::duration>(interval * static_cast<double>(i));
+        if (due >= end)
+            break;
+
+        waitUntil(due);
+        workload.call();
+        histogram.record(nanosecondsBetween(due, Clock::now()));
+    }
+}
+
+LatencyResult measure(const Workload& workload, const LatencyOptions& options) {
+    const auto seconds = [](double value) { return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(value)); };
+
+    LatencyHistogram warmup;
+    runClosedLoop(workload, seconds(options.warmup), warmup);
+
+    LatencyHistogram histogram;
+    Clock::time_point start = Clock::now();
+
+    if (options.rate > 0.0)
+        runOpenLoop(workload, seconds(options.duration), options.rate, histogram);
+    else
+        runClosedLoop(workload, seconds(options.duration), histogram);
+
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    LatencyResult result;
+    result.workload = workload.name;
+    result.mode = options.rate > 0.0 ? "open" : "closed";
+    result.targetRate = options.rate;
+    result.achievedRate = static_cast<double>(histogram.count()) / elapsed;
+    result.calls = histogram.count();
+    result.meanNs = histogram.mean();
+    result.p50Ns = histogram.percentile(50.0);
+    result.p90Ns = histogram.percentile(90.0);
+    result.p99Ns = histogram.percentile(99.0);
+    result.p999Ns = histogram.percentile(99.9);
+    result.maxNs = histogram.max();
+
+    for (const auto& [upper, count] : histogram.nonEmptyBuckets())
+        result.buckets.push_back({ upper, count });
+
+    return result;
+}
+
+
+bool parseOptions(int argc, char** argv, LatencyOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        std::string value;
+        bool valid = true;
+
+        // std::stod and std::stoull throw on values that aren't numbers
+        try {
+            if (parseOption(argument, "rate", value))
+                options.rate = std::stod(value);
+            else if (parseOption(argument, "duration", value))
+                options.duration = std::stod(value);
+            else if (parseOption(argument, "warmup", value))
+                options.warmup = std::stod(value);
+            else if (parseOption(argument, "bytes", value))
+                options.bytes = static_cast<std::size_t>(std::stoull(value));
+            else if (parseOption(argument, "filter", value))
+                options.filter = value;
+            else if (parseOption(argument, "output", value))
+                options.output = value;
+            else
+                valid = false;
+        }
+        catch (const std::logic_error&) {
+            valid = false;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid argument " << argument << "\n"
+                      << "Usage: " << argv[0] << " [--rate=<calls/s>] [--duration=<s>] [--warmup=<s>] [--bytes=<n>]"
+                      << " [--filter=<substring>] [--output=<file.json>]\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    LatencyOptions options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    LatencyReport report{ options.bytes, options.duration, {} };
+
+    std::printf("%-24s %-6s %12s %10s %10s %10s %10s %10s %12s\n",
+                "workload", "mode", "calls/s", "p50 us", "p90 us", "p99 us", "p999 us", "max us", "calls");
+
+    for (const Workload& workload : makeWorkloads(options.bytes)) {
+        if (workload.name.find(options.filter) == std::string::npos)
+            continue;
+
+        const LatencyResult& result = report.results.emplace_back(measure(workload, options));
+
+        std::printf("%-24s %-6s %12.0f %10.1f %10.1f %10.1f %10.1f %10.1f %12llu\n",
+                    result.workload.c_str(), result.mode.c_str(), result.achievedRate,
+                    result.p50Ns / 1e3, result.p90Ns / 1e3, result.p99Ns / 1e3, result.p999Ns / 1e3, result.maxNs / 1e3,
+                    static_cast<unsigned long long>(result.calls));
+        std::fflush(stdout);
+    }
+
+    if (!options.output.empty()) {
+        std::ofstream file(options.output, std::ios::binary);
+        file << rapidjson_util::marshal(report);
+
+        if (!file) {
+            std::cerr << "Could not write " << options.output << "\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
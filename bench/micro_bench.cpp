@@ -0,0 +1,260 @@
+#include "benchmark/benchmark.h"
+#include "allocation_counter.h"
+#include "rapid_util/rapid_util.h"
+#include <array>
+#include <list>
+
+// One struct per category of member types, marshalled and unmarshalled on its own so that the
+// cost of each category shows apart from the others
+
+struct PrimitiveFields {
+    bool active;
+    int32_t count;
+    int64_t id;
+    uint32_t flags;
+    double ratio;
+    float scale;
+};
+
+struct NestedLeaf {
+    int32_t value;
+    std::string tag;
+};
+
+struct NestedBranch {
+    NestedLeaf leaf;
+    int32_t depth;
+};
+
+struct NestedTrunk {
+    NestedBranch branch;
+    double weight;
+};
+
+struct NestedRoot {
+    std::string id;
+    NestedTrunk trunk;
+};
+
+struct OptionalFields {
+    std::optional<int32_t> count;
+    std::optional<double> ratio;
+    std::optional<std::string> label;
+    std::unique_ptr<int64_t> id;
+    std::shared_ptr<std::string> note;
+};
+
+// Numbers in std::vector and std::array are written and read as one block, those in std::list
+// one element at a time
+struct VectorField {
+    std::vector<int64_t> values;
+};
+
+struct ListField {
+    std::list<int64_t> values;
+};
+
+struct ArrayField {
+    std::array<int64_t, 256> values;
+};
+
+struct StringVectorField {
+    std::vector<std::string> values;
+};
+
+struct TupleField {
+    std::tuple<int64_t, double, std::string, bool> record;
+};
+
+struct StringField {
+    std::string text;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(PrimitiveFields, (active, count, id, flags, ratio, scale))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(NestedLeaf, (value, tag))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(NestedBranch, (leaf, depth))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(NestedTrunk, (branch, weight))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(NestedRoot, (id, trunk))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(OptionalFields, (count, ratio, label, id, note))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(VectorField, (values))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(ListField, (values))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(ArrayField, (values))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(StringVectorField, (values))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(TupleField, (record))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(StringField, (text))
+
+
+template<typename Sequence>
+void fillNumbers(Sequence& sequence) {
+    int64_t i = 0;
+
+    for (auto&& value : sequence)
+        value = (i++ * 7919) % 100003 - 50000;
+}
+
+std::string makeText(std::size_t length) {
+    std::string text(length, ' ');
+
+    for (std::size_t i = 0; i < length; ++i)
+        text[i] = static_cast<char>('a' + i % 26);
+
+    return text;
+}
+
+
+// make builds the sample for the argument of a run, and items counts the values it holds, that
+// is the members, elements or strings written and read per iteration
+
+template<typename T>
+struct MicroCase;
+
+template<>
+struct MicroCase<PrimitiveFields> {
+    static PrimitiveFields make(const benchmark::State&) { return PrimitiveFields{ true, 4096, 1705314600123, 0x5a5a, 0.8125, 1.5f }; }
+    static int64_t items(const benchmark::State&) { return 6; }
+};
+
+template<>
+struct MicroCase<NestedRoot> {
+    static NestedRoot make(const benchmark::State&) { return NestedRoot{ "root", { { { 42, "leaf" }, 3 }, 0.25 } }; }
+    static int64_t items(const benchmark::State&) { return 6; }
+};
+
+// Every member holds a value when the argument is 1, and is null when it is 0
+template<>
+struct MicroCase<OptionalFields> {
+    static OptionalFields make(const benchmark::State& state) {
+        OptionalFields fields;
+
+        if (state.range(0) != 0) {
+            fields.count = 4096;
+            fields.ratio = 0.8125;
+            fields.label = "optional";
+            fields.id = std::make_unique<int64_t>(1705314600123);
+            fields.note = std::make_shared<std::string>("shared");
+        }
+
+        return fields;
+    }
+
+    static int64_t items(const benchmark::State&) { return 5; }
+};
+
+template<>
+struct MicroCase<VectorField> {
+    static VectorField make(const benchmark::State& state) {
+        VectorField field{ std::vector<int64_t>(static_cast<std::size_t>(state.range(0))) };
+        fillNumbers(field.values);
+        return field;
+    }
+
+    static int64_t items(const benchmark::State& state) { return state.range(0); }
+};
+
+template<>
+struct MicroCase<ListField> {
+    static ListField make(const benchmark::State& state) {
+        ListField field{ std::list<int64_t>(static_cast<std::size_t>(state.range(0))) };
+        fillNumbers(field.values);
+        return field;
+    }
+
+    static int64_t items(const benchmark::State& state) { return state.range(0); }
+};
+
+template<>
+struct MicroCase<ArrayField> {
+    static ArrayField make(const benchmark::State&) {
+        ArrayField field;
+        fillNumbers(field.values);
+        return field;
+    }
+
+    static int64_t items(const benchmark::State&) { return 256; }
+};
+
+// The argument is the number of strings, each 16 characters long
+template<>
+struct MicroCase<StringVectorField> {
+    static StringVectorField make(const benchmark::State& state) {
+        return StringVectorField{ std::vector<std::string>(static_cast<std::size_t>(state.range(0)), makeText(16)) };
+    }
+
+    static int64_t items(const benchmark::State& state) { return state.range(0); }
+};
+
+template<>
+struct MicroCase<TupleField> {
+    static TupleField make(const benchmark::State&) { return TupleField{ std::make_tuple(1705314600123, 0.8125, "tuple", true) }; }
+    static int64_t items(const benchmark::State&) { return 4; }
+};
+
+// The argument is the length of the string
+template<>
+struct MicroCase<StringField> {
+    static StringField make(const benchmark::State& state) { return StringField{ makeText(static_cast<std::size_t>(state.range(0))) }; }
+    static int64_t items(const benchmark::State&) { return 1; }
+};
+
+
+// Bytes processed are the bytes of the JSON, and items processed the values in it. Allocations
+// are those one more call makes, outside of the timed loop
+
+template<typename T>
+void MarshalCase(benchmark::State& state) {
+    const T sample = MicroCase<T>::make(state);
+    std::size_t size = 0;
+
+    for (auto _ : state) {
+        std::string json = rapidjson_util::marshal(sample);
+        size = json.size();
+        benchmark::DoNotOptimize(json.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * MicroCase<T>::items(state));
+    state.counters["allocations"] = static_cast<double>(rapidutil_test::countAllocations([&sample] {
+        benchmark::DoNotOptimize(rapidjson_util::marshal(sample).data());
+    }).allocations);
+}
+
+template<typename T>
+void UnmarshalCase(benchmark::State& state) {
+    const std::string json = rapidjson_util::marshal(MicroCase<T>::make(state));
+
+    for (auto _ : state) {
+        T decoded;
+        rapidjson_util::unmarshal(json, decoded);
+        benchmark::DoNotOptimize(&decoded);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * MicroCase<T>::items(state));
+    state.counters["allocations"] = static_cast<double>(rapidutil_test::countAllocations([&json] {
+        T decoded;
+        rapidjson_util::unmarshal(json, decoded);
+        benchmark::DoNotOptimize(&decoded);
+    }).allocations);
+}
+
+#define RAPIDUTIL_BENCHMARK_CASE(T)            \
+    BENCHMARK_TEMPLATE(MarshalCase, T);        \
+    BENCHMARK_TEMPLATE(UnmarshalCase, T)
+
+// Runs T for argument values from first to last, growing by multiplier
+#define RAPIDUTIL_BENCHMARK_SIZED_CASE(T, name, multiplier, first, last)                              \
+    BENCHMARK_TEMPLATE(MarshalCase, T)->ArgName(name)->RangeMultiplier(multiplier)->Range(first, last);  \
+    BENCHMARK_TEMPLATE(UnmarshalCase, T)->ArgName(name)->RangeMultiplier(multiplier)->Range(first, last)
+
+RAPIDUTIL_BENCHMARK_CASE(PrimitiveFields);
+RAPIDUTIL_BENCHMARK_CASE(NestedRoot);
+RAPIDUTIL_BENCHMARK_CASE(TupleField);
+RAPIDUTIL_BENCHMARK_CASE(ArrayField);
+
+BENCHMARK_TEMPLATE(MarshalCase, OptionalFields)->ArgName("present")->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(UnmarshalCase, OptionalFields)->ArgName("present")->Arg(0)->Arg(1);
+
+RAPIDUTIL_BENCHMARK_SIZED_CASE(VectorField, "elements", 16, 16, 4096);
+RAPIDUTIL_BENCHMARK_SIZED_CASE(ListField, "elements", 16, 16, 4096);
+RAPIDUTIL_BENCHMARK_SIZED_CASE(StringVectorField, "elements", 16, 16, 4096);
+RAPIDUTIL_BENCHMARK_SIZED_CASE(StringField, "length", 8, 8, 32768);
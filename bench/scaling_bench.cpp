@@ -0,0 +1,300 @@
+#include "workloads.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+// Throughput of marshal and unmarshal on 1 to N threads, each running its own stream of calls on
+// inputs they share read-only, so that anything but linear scaling is contention in the library,
+// the allocator or the hardware:
+//
+//   rapidutil_scaling [--threads=<n,n,...>] [--duration=<s>] [--warmup=<s>] [--bytes=<n>] [--pin]
+//                     [--filter=<substring>] [--output=<file.json>]
+//
+// The thread counts default to the powers of two up to the hardware threads, and the hardware
+// threads themselves. Efficiency is the throughput per thread against that of the fewest threads,
+// 100% when adding threads costs the others nothing. --pin pins the i-th thread to the i-th CPU
+// the process may run on, to keep the scheduler from moving threads between runs.
+
+using Clock = std::chrono::steady_clock;
+
+struct ScalingOptions {
+    std::vector<unsigned> threads;
+    double duration = 3.0;
+    double warmup = 0.5;
+    std::size_t bytes = 16 << 10;
+    bool pin = false;
+    std::string filter;
+    std::string output;
+};
+
+struct ScalingResult {
+    std::string workload;
+    uint32_t threads;
+    double callsPerSecond;
+    double bytesPerSecond;
+    double callsPerSecondPerThread;
+    double slowestThreadCallsPerSecond;
+    double fastestThreadCallsPerSecond;
+    double efficiency;
+};
+
+struct ScalingReport {
+    uint64_t bytes;
+    double durationSeconds;
+    bool pinned;
+    std::vector<ScalingResult> results;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(ScalingResult, (workload, threads, callsPerSecond, bytesPerSecond, callsPerSecondPerThread,
+                                                slowestThreadCallsPerSecond, fastestThreadCallsPerSecond, efficiency))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(ScalingReport, (bytes, durationSeconds, pinned, results))
+
+
+// The CPUs the process may run on, in the order threads are pinned to them
+std::vector<unsigned> allowedCpus() {
+    std::vector<unsigned> cpus;
+
+#if defined(__linux__)
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set))
+                cpus.push_back(cpu);
+        }
+    }
+#else
+    for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu)
+        cpus.push_back(cpu);
+#endif
+
+    return cpus;
+}
+
+bool pinToCpu(std::thread& thread, unsigned cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    return cpu < 64 && SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << cpu) != 0;
+#else
+    (void)thread;
+    (void)cpu;
+    return false;
+#endif
+}
+
+std::vector<unsigned> defaultThreadCounts() {
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+
+    for (unsigned count = 1; count < hardware; count *= 2)
+        counts.push_back(count);
+
+    counts.push_back(hardware);
+    return counts;
+}
+
+
+// Each thread writes its own cache line, so that counting doesn't add contention of its own
+struct alignas(64) StreamCount {
+    uint64_t calls = 0;
+    double seconds = 0.0;
+};
+
+// Runs workload on threads threads at once, each calling it until the same deadline, and returns
+// the calls per second of every thread
+std::vector<double> runStreams(const Workload& workload, unsigned threads, const ScalingOptions& options, const std::vector<unsigned>& cpus) {
+    const auto seconds = [](double value) { return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(value)); };
+
+    std::vector<StreamCount> counts(threads);
+    std::atomic<unsigned> ready{ 0 };
+    std::atomic<bool> go{ false };
+    Clock::time_point measureFrom;
+    Clock::time_point measureUntil;
+
+    std::vector<std::thread> streams;
+    for (unsigned i = 0; i < threads; ++i) {
+        streams.emplace_back([&, i] {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+
+            while (Clock::now() < measureFrom)
+                workload.call();
+
+            Clock::time_point start = Clock::now();
+            Clock::time_point now = start;
+            uint64_t calls = 0;
+
+            for (; now < measureUntil; now = Clock::now()) {
+                workload.call();
+                ++calls;
+            }
+
+            counts[i].calls = calls;
+            counts[i].seconds = std::chrono::duration<double>(now - start).count();
+        });
+
+        if (options.pin && !pinToCpu(streams.back(), cpus[i % cpus.size()]))
+            std::cerr << "Could not pin thread " << i << " to CPU " << cpus[i % cpus.size()] << "\n";
+    }
+
+    while (ready.load() != threads)
+        std::this_thread::yield();
+
+    measureFrom = Clock::now() + seconds(options.warmup);
+    measureUntil = measureFrom + seconds(options.duration);
+    go.store(true, std::memory_order_release);
+
+    for (std::thread& stream : streams)
+        stream.join();
+
+    std::vector<double> rates;
+    for (const StreamCount& count : counts)
+        rates.push_back(static_cast<double>(count.calls) / count.seconds);
+
+    return rates;
+}
+
+
+bool parseThreadCounts(const std::string& value, std::vector<unsigned>& counts) {
+    std::istringstream list(value);
+    std::string item;
+
+    while (std::getline(list, item, ',')) {
+        if (item.empty() || !std::isdigit(static_cast<unsigned char>(item[0])))
+            return false;
+
+        std::size_t end = 0;
+        unsigned long count = std::stoul(item, &end);
+        if (end != item.size() || count == 0 || count > std::numeric_limits<unsigned>::max())
+            return false;
+
+        counts.push_back(static_cast<unsigned>(count));
+    }
+
+    return !counts.empty();
+}
+
+bool parseOptions(int argc, char** argv, ScalingOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        std::string value;
+        bool valid = true;
+
+        // std::stoul and friends throw std::invalid_argument or std::out_of_range on values that
+        // aren't numbers, which are reported like unknown arguments
+        try {
+            if (argument == "--pin")
+                options.pin = true;
+            else if (parseOption(argument, "threads", value))
+                valid = parseThreadCounts(value, options.threads);
+            else if (parseOption(argument, "duration", value))
+                options.duration = std::stod(value);
+            else if (parseOption(argument, "warmup", value))
+                options.warmup = std::stod(value);
+            else if (parseOption(argument, "bytes", value))
+                options.bytes = static_cast<std::size_t>(std::stoull(value));
+            else if (parseOption(argument, "filter", value))
+                options.filter = value;
+            else if (parseOption(argument, "output", value))
+                options.output = value;
+            else
+                valid = false;
+        }
+        catch (const std::logic_error&) {
+            valid = false;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid argument " << argument << "\n"
+                      << "Usage: " << argv[0] << " [--threads=<n,n,...>] [--duration=<s>] [--warmup=<s>] [--bytes=<n>] [--pin]"
+                      << " [--filter=<substring>] [--output=<file.json>]\n";
+            return false;
+        }
+    }
+
+    if (options.threads.empty())
+        options.threads = defaultThreadCounts();
+
+    std::sort(options.threads.begin(), options.threads.end());
+    options.threads.erase(std::unique(options.threads.begin(), options.threads.end()), options.threads.end());
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    ScalingOptions options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    const std::vector<unsigned> cpus = allowedCpus();
+    ScalingReport report{ options.bytes, options.duration, options.pin, {} };
+
+    std::printf("%-24s %8s %14s %12s %16s %16s %11s\n",
+                "workload", "threads", "calls/s", "MB/s", "calls/s/thread", "slowest-fastest", "efficiency");
+
+    for (const Workload& workload : makeWorkloads(options.bytes)) {
+        if (workload.name.find(options.filter) == std::string::npos)
+            continue;
+
+        double baselinePerThread = 0.0;
+
+        for (unsigned threads : options.threads) {
+            std::vector<double> rates = runStreams(workload, threads, options, cpus);
+
+            ScalingResult result;
+            result.workload = workload.name;
+            result.threads = threads;
+            result.callsPerSecond = 0.0;
+            for (double rate : rates)
+                result.callsPerSecond += rate;
+
+            result.bytesPerSecond = result.callsPerSecond * static_cast<double>(workload.bytes);
+            result.callsPerSecondPerThread = result.callsPerSecond / threads;
+            result.slowestThreadCallsPerSecond = *std::min_element(rates.begin(), rates.end());
+            result.fastestThreadCallsPerSecond = *std::max_element(rates.begin(), rates.end());
+
+            if (baselinePerThread == 0.0)
+                baselinePerThread = result.callsPerSecondPerThread;
+            result.efficiency = result.callsPerSecondPerThread / baselinePerThread;
+
+            std::printf("%-24s %8u %14.0f %12.1f %16.0f %8.0f-%-7.0f %10.1f%%\n",
+                        result.workload.c_str(), threads, result.callsPerSecond, result.bytesPerSecond / 1e6,
+                        result.callsPerSecondPerThread, result.slowestThreadCallsPerSecond, result.fastestThreadCallsPerSecond,
+                        result.efficiency * 100.0);
+            std::fflush(stdout);
+
+            report.results.push_back(std::move(result));
+        }
+    }
+
+    if (!options.output.empty()) {
+        std::ofstream file(options.output, std::ios::binary);
+        file << rapidjson_util::marshal(report);
+
+        if (!file) {
+            std::cerr << "Could not write " << options.output << "\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#ifndef __RAPIDJSON_UTIL_BENCH_WORKLOADS_H__
+#define __RAPIDJSON_UTIL_BENCH_WORKLOADS_H__
+
+#include "corpus.h"
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// The calls rapidutil_latency and rapidutil_scaling run, and the parsing of their options
+
+// bytes is the size of the JSON each call writes or reads
+struct Workload {
+    std::string name;
+    std::size_t bytes;
+    std::function<void()> call;
+};
+
+template<typename Corpus>
+void addCorpusWorkloads(std::vector<Workload>& workloads, const std::string& name, std::size_t bytes) {
+    auto corpus = std::make_shared<const Corpus>(CorpusOf<Corpus>::generate(bytes));
+    auto json = std::make_shared<const std::string>(rapidjson_util::marshal(*corpus));
+
+    workloads.push_back({ "Marshal/" + name, json->size(), [corpus] {
+        std::string encoded = rapidjson_util::marshal(*corpus);
+        if (encoded.empty())
+            std::abort();
+    } });
+
+    workloads.push_back({ "Unmarshal/" + name, json->size(), [json] {
+        Corpus decoded;
+        rapidjson_util::unmarshal(*json, decoded);
+    } });
+}
+
+// The log corpus with a string as the status of its last event, which JsonReader only reaches
+// after reading everything before it, so that every call ends on the exception path
+inline void addMismatchWorkload(std::vector<Workload>& workloads, std::size_t bytes) {
+    std::string json = rapidjson_util::marshal(CorpusOf<LogCorpus>::generate(bytes));
+    const std::string key = "\"status\":";
+    std::size_t value = json.rfind(key) + key.size();
+    std::size_t end = json.find_first_of(",}", value);
+    json.replace(value, end - value, "\"500\"");
+
+    std::size_t size = json.size();
+    auto mismatched = std::make_shared<const std::string>(std::move(json));
+
+    workloads.push_back({ "UnmarshalMismatch/Log", size, [mismatched] {
+        LogCorpus decoded;
+        try {
+            rapidjson_util::unmarshal(*mismatched, decoded);
+        } catch (const rapidjson_util::MemberSerializationFailure&) {
+            return;
+        }
+        std::abort();
+    } });
+}
+
+inline std::vector<Workload> makeWorkloads(std::size_t bytes) {
+    std::vector<Workload> workloads;
+
+    addCorpusWorkloads<FeedCorpus>(workloads, "Feed", bytes);
+    addCorpusWorkloads<GeoCorpus>(workloads, "Geo", bytes);
+    addCorpusWorkloads<CitmCorpus>(workloads, "Citm", bytes);
+    addCorpusWorkloads<LogCorpus>(workloads, "Log", bytes);
+    addMismatchWorkload(workloads, bytes);
+
+    return workloads;
+}
+
+
+// Takes value from argument when it is --name=value
+inline bool parseOption(const std::string& argument, const char* name, std::string& value) {
+    std::string prefix = std::string("--") + name + "=";
+    if (argument.compare(0, prefix.size(), prefix) != 0)
+        return false;
+
+    value = argument.substr(prefix.size());
+    return true;
+}
+
+#endif
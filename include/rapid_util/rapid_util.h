@@ -12,9 +12,12 @@
 #ifndef __SIMPLE_RAPID_JSON_UTIL_H__
 #define __SIMPLE_RAPID_JSON_UTIL_H__
 
+#include <cstring>
 #include <type_traits>
 #include "rapid_util_preprocessor.h"
 #include "rapid_util_parser.h"
+#include "rapid_util_chrono.h"
+#include "rapid_util_binary.h"
 
 
 namespace rapidjson_util {
@@ -39,10 +42,164 @@ namespace rapidjson_util {
  * @endcode
  */
 template<typename Struct> 
-std::string marshal(const Struct& s) noexcept {
+std::string marshal(const Struct& s) {
     return detail::marshalImpl(s);
 }
 
+namespace detail {
+
+template<typename Struct>
+std::string marshalImpl(const Struct& s, Omission omission);
+
+}  // namespace detail
+
+/**
+ * @brief Serialize a C++ struct to JSON string, leaving members out to shrink it
+ *
+ * @param s The struct instance to serialize
+ * @param omission Members left out of the structs that have no RAPIDJSON_UTIL_DESCRIBE_OMISSION
+ *                 style of their own. unmarshal reads them back when given the same omission
+ * @return JSON string representation of the struct
+ *
+ * @code
+ * struct Person {
+ *     std::string name;
+ *     int age;
+ *     std::optional<std::string> email;
+ * };
+ *
+ * Person p{"John", 0, std::nullopt};
+ * std::string json = marshal(p, Omission::Nulls);     // {"name":"John","age":0}
+ * std::string json = marshal(p, Omission::Defaults);  // {"name":"John"}
+ * @endcode
+ */
+template<typename Struct>
+std::string marshal(const Struct& s, Omission omission) {
+    return detail::marshalImpl(s, omission);
+}
+
+namespace detail {
+
+template<typename View>
+std::string marshalViewImpl(const typename marshal_view<View>::struct_type& s);
+
+}  // namespace detail
+
+/**
+ * @brief Serialize the members of a C++ struct listed by a view to JSON string
+ *
+ * @tparam View A view declared by the RAPIDJSON_UTIL_DESCRIBE_VIEW macro
+ * @param s The struct instance to serialize, of the type the view was declared for
+ * @return JSON string representation of the members of the view, in the order they are listed
+ *
+ * The members are selected at compile time, the others are neither copied nor visited.
+ *
+ * @code
+ * RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Person, (name, age, email))
+ * RAPIDJSON_UTIL_DESCRIBE_VIEW(Person, PublicPerson, (name, age))
+ *
+ * Person p{"John", 30, "john@example.com"};
+ * std::string json = marshal<PublicPerson>(p);  // {"name":"John","age":30}
+ * @endcode
+ */
+template<typename View>
+std::string marshal(const typename marshal_view<View>::struct_type& s) {
+    return detail::marshalViewImpl<View>(s);
+}
+
+namespace detail {
+
+// A FieldMask compiled for one described struct: a bit per member in the order of its descriptors,
+// set for the members written, and the mask of the nested struct of a member that is selected in
+// part. Members selected without a nested mask are written whole
+struct FieldMaskNode {
+    std::vector<uint64_t> selectedMembers;
+    std::vector<std::unique_ptr<FieldMaskNode>> nestedMasks;
+
+    explicit FieldMaskNode(std::size_t memberCount) :
+        selectedMembers((memberCount + 63) / 64), nestedMasks(memberCount) {
+    }
+
+    bool isSelected(std::size_t member) const {
+        return (selectedMembers[member / 64] >> (member % 64)) & 1;
+    }
+
+    void select(std::size_t member, std::unique_ptr<FieldMaskNode> nestedMask) {
+        selectedMembers[member / 64] |= uint64_t(1) << (member % 64);
+        nestedMasks[member] = std::move(nestedMask);
+    }
+};
+
+template<typename Struct>
+void selectFieldPath(FieldMaskNode& mask, std::string_view path, std::string_view fullPath);
+
+template<typename Struct>
+std::string marshalMaskedImpl(const Struct& s, const FieldMaskNode& mask);
+
+}  // namespace detail
+
+/**
+ * @brief Members of a described struct written by marshal(s, mask), selected at run time by
+ *        paths of member names such as "address.city"
+ *
+ * The paths are resolved once, when the mask is constructed, into a bit per member of each
+ * struct they go through, so a mask is meant to be built once per selection and reused. A path
+ * ending at a member selects it whole, and wins over the paths into it. A path through a member
+ * holding a described struct, directly, through std::optional or a smart pointer, or as the
+ * elements of a container, selects the members of that struct it goes on to name. Members are
+ * named as they are written, i.e. by their wire names.
+ *
+ * @throws InvalidFieldPathException if a path doesn't name a member, or goes through a member
+ *         that holds no described struct
+ */
+template<typename Struct>
+class FieldMask {
+    static_assert(detail::is_describable_struct_v<Struct>, "Use the RAPIDJSON_UTIL_DESCRIBE_MEMBERS macro to declare serializable struct members");
+
+public:
+    FieldMask(std::initializer_list<std::string_view> paths) :
+        root(detail::describedMemberCount(detail::Descriptor<Struct>::member_descriptors)) {
+        for (std::string_view path : paths)
+            detail::selectFieldPath<Struct>(root, path, path);
+    }
+
+    /**
+     * @param paths Container of the paths, such as std::vector<std::string> parsed from a request
+     */
+    template<typename Paths,
+             typename = std::enable_if_t<std::is_convertible_v<decltype(*std::begin(std::declval<const Paths&>())), std::string_view>>>
+    explicit FieldMask(const Paths& paths) :
+        root(detail::describedMemberCount(detail::Descriptor<Struct>::member_descriptors)) {
+        for (auto&& path : paths)
+            detail::selectFieldPath<Struct>(root, path, path);
+    }
+
+private:
+    template<typename S>
+    friend std::string marshal(const S& s, const FieldMask<S>& mask);
+
+    detail::FieldMaskNode root;
+};
+
+/**
+ * @brief Serialize the members of a C++ struct selected by a field mask to JSON string
+ *
+ * @param s The struct instance to serialize
+ * @param mask The members to write, see FieldMask
+ * @return JSON string representation of the selected members, in the order they are described
+ *
+ * The members left out are skipped by testing a bit, without visiting their values.
+ *
+ * @code
+ * FieldMask<Employee> mask{ "name", "address.city" };
+ * std::string json = marshal(employee, mask);  // {"name":"John","address":{"city":"Beijing"}}
+ * @endcode
+ */
+template<typename Struct>
+std::string marshal(const Struct& s, const FieldMask<Struct>& mask) {
+    return detail::marshalMaskedImpl(s, mask.root);
+}
+
 /**
  * @brief Deserialize a JSON string to populate a C++ struct
  *
@@ -69,10 +226,127 @@ void unmarshal(std::string_view json, Struct& s) {
 
 namespace detail {
 
+template<typename Struct>
+void unmarshalImpl(std::string_view json, Struct& s, std::pmr::memory_resource* resource);
+
+}  // namespace detail
+
+/**
+ * @brief Deserialize a JSON string to populate a C++ struct, allocating std::pmr members from
+ *        the given memory resource
+ *
+ * Every std::pmr::string and std::pmr container that is written or resized while deserializing
+ * is re-seated on resource first, so their memory, including that of nested pmr elements they
+ * construct, comes from resource. Members of other types allocate as usual, as does the parser.
+ *
+ * @param json JSON string to parse and deserialize
+ * @param s The struct instance to populate with deserialized data
+ * @param resource The memory resource, e.g. a per-request std::pmr::monotonic_buffer_resource
+ *
+ * @code
+ * struct Request {
+ *     std::pmr::string user;
+ *     std::pmr::vector<std::pmr::string> tags;
+ * };
+ * RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Request, (user, tags))
+ *
+ * std::pmr::monotonic_buffer_resource arena;
+ * Request r;
+ * unmarshal(R"({"user":"Alice","tags":["a","b"]})", r, &arena);
+ * // r.user.get_allocator().resource() == &arena
+ * @endcode
+ */
+template<typename Struct>
+void unmarshal(std::string_view json, Struct& s, std::pmr::memory_resource* resource) {
+    return detail::unmarshalImpl(json, s, resource);
+}
+
+namespace detail {
+
+template<typename Struct>
+void unmarshalImpl(std::string_view json, Struct& s, std::pmr::memory_resource* resource, Omission omission);
+
+}  // namespace detail
+
+/**
+ * @brief Deserialize a JSON string written by marshal with the same omission
+ *
+ * Members missing from the JSON that the omission leaves out are restored, to null under
+ * Omission::Nulls and to the member of a value-initialized struct under Omission::Defaults.
+ * Other missing members still throw MemberNotFoundException.
+ *
+ * @param json JSON string to parse and deserialize
+ * @param s The struct instance to populate with deserialized data
+ * @param omission Members that may be missing from the structs that have no
+ *                 RAPIDJSON_UTIL_DESCRIBE_OMISSION style of their own
+ */
+template<typename Struct>
+void unmarshal(std::string_view json, Struct& s, Omission omission) {
+    return detail::unmarshalImpl(json, s, nullptr, omission);
+}
+
+namespace detail {
+
 
 template<typename T>
 std::shared_ptr<JsonValue> convertToJsonValueFrom(T& memberRef);
 
+template<typename Struct>
+std::vector<JsonAttribute> buildJsonTreeFrom(Struct& s);
+
+template<auto Member, typename... NameDescriptors>
+constexpr const char* wireNameIn(TypeList<NameDescriptors...>, const char* memberName) {
+    constexpr const char* wireNames[] = { NameDescriptors::name()..., nullptr };
+    constexpr std::size_t index = describedMemberIndex<Member>(TypeList<NameDescriptors...>{});
+
+    return wireNames[index] != nullptr ? wireNames[index] : memberName;
+}
+
+// The name a member of Struct is written with, set by RAPIDJSON_UTIL_DESCRIBE_WIRE_NAMES
+template<typename Struct, typename Desc>
+constexpr const char* wireNameOf(Desc descriptor) {
+    if constexpr (wire_names<Struct>::is_described)
+        return wireNameIn<Desc::pointer()>(wire_names<Struct>::name_descriptors, descriptor.name());
+    else
+        return descriptor.name();
+}
+
+constexpr bool isSameWireName(const char* lhs, const char* rhs) {
+    while (*lhs != '\0' && *lhs == *rhs) {
+        ++lhs;
+        ++rhs;
+    }
+
+    return *lhs == *rhs;
+}
+
+template<typename Struct, typename... MemberDescriptors, typename... NameDescriptors>
+constexpr bool areValidWireNames(TypeList<MemberDescriptors...> members, TypeList<NameDescriptors...>) {
+    constexpr bool areMembersDescribed = (... && (describedMemberIndex<NameDescriptors::pointer()>(members) < sizeof...(MemberDescriptors)));
+    constexpr const char* names[] = { wireNameOf<Struct>(MemberDescriptors{})..., "" };
+
+    for (std::size_t i = 0; i < sizeof...(MemberDescriptors); ++i) {
+        if (*names[i] == '\0')
+            return false;
+
+        for (std::size_t j = 0; j < i; ++j)
+            if (isSameWireName(names[i], names[j]))
+                return false;
+    }
+
+    return areMembersDescribed;
+}
+
+template<typename Struct>
+constexpr bool areValidWireNames() {
+    return areValidWireNames<Struct>(Descriptor<Struct>::member_descriptors, wire_names<Struct>::name_descriptors);
+}
+
+template<typename Struct, typename Desc>
+std::string getMemberName(Desc descriptor) {
+    return std::string(wireNameOf<std::remove_const_t<Struct>>(descriptor));
+}
+
 template<typename Sequence>
 std::vector<std::shared_ptr<JsonValue>> convertSequenceToJsonArrayElements(Sequence& sequence) {
     static_assert(is_json_serializable_sequential_container_v<Sequence>);
@@ -100,18 +374,63 @@ std::vector <std::shared_ptr<JsonValue>> convertTupleToJsonArrayElements(Tuple&
 
 enum WrapperType {
     None,
-    StdOptional
+    Nullable    // std::optional, std::unique_ptr or std::shared_ptr
 };
 
 enum JsonSourceType {
     Struct,      // C++ struct/class
     Primitive,   // Basic C++ types
     Sequential,  // Containers (vector, list, array)
-    Tuple        // std::tuple
+    NumberArray, // Contiguous containers of numbers, possibly nested
+    InlineString, // Strings with fixed inline capacity (char[N], std::array<char, N>, fixed_string<N>)
+    Custom,      // Types encoded by a codec (std::chrono time points and durations, binary data)
+    Tuple,       // std::tuple
+    Variant,     // std::variant
+    View,        // std::string_view, std::span<const T>, std::reference_wrapper<const T>
+    Columnar     // Containers of described structs wrapped in columnar, laid out as an array per member
 };
 
+template<typename Wrapper>
+bool hasReferencedValue(const Wrapper& wrapper) {
+    static_assert(is_nullable_wrapper_v<Wrapper>);
+
+    return static_cast<bool>(wrapper);
+}
+
+/**
+ * Puts a default constructed value into a nullable wrapper. The smart pointers only 
+ * allocate here, that is once a non-null JSON value has to be stored in them.
+ */
+template<typename Wrapper>
+auto& emplaceReferencedValue(Wrapper& wrapper) {
+    static_assert(is_nullable_wrapper_v<Wrapper>);
+
+    using BaseType = remove_nullable_wrapper_t<Wrapper>;
+
+    if constexpr (is_std_unique_ptr_v<Wrapper>)
+        wrapper = std::make_unique<BaseType>();
+    else if constexpr (is_std_shared_ptr_v<Wrapper>)
+        wrapper = std::make_shared<BaseType>();
+    else
+        wrapper = BaseType{};
+
+    return *wrapper;
+}
+
+/**
+ * Resizes a container on behalf of the reader. A std::pmr container is first re-seated on the
+ * reader's memory resource, so that it and the elements it constructs allocate from there.
+ */
+template<typename Sequence>
+void resizeSequence(Sequence& sequence, std::size_t newSize, std::pmr::memory_resource* resource) {
+    if constexpr (uses_polymorphic_allocator_v<Sequence>)
+        rebindMemoryResource(sequence, resource);
+
+    sequence.resize(newSize);
+}
+
 template<typename T>
-constexpr WrapperType wrapper_type_trait_v = is_std_optional_v<T> ? WrapperType::StdOptional : WrapperType::None;
+constexpr WrapperType wrapper_type_trait_v = is_nullable_wrapper_v<T> ? WrapperType::Nullable : WrapperType::None;
 
 template<size_t JsonSourceType, size_t WrapperType, bool isConstQualified>
 struct JsonValueCreator;
@@ -127,23 +446,157 @@ struct JsonValueCreator<JsonSourceType::Primitive, WrapperType, isConstQualified
 };
 
 
+template<bool isConstQualified>
+struct JsonValueCreator<JsonSourceType::InlineString, WrapperType::None, isConstQualified> {
+    template<typename T>
+    static std::shared_ptr<JsonInlineString> create(T& value) {
+        static_assert(!is_nullable_wrapper_v<T>);
+
+        return std::make_shared<JsonInlineString>(&value);
+    }
+};
+
+template<>
+struct JsonValueCreator<JsonSourceType::InlineString, WrapperType::Nullable, true> {
+    template<typename T>
+    static std::shared_ptr<JsonNullableInlineString> create(T& value) {
+        static_assert(is_nullable_wrapper_v<T> && std::is_const_v<T>);
+
+        using BaseType = const remove_nullable_wrapper_t<T>;
+
+        return std::make_shared<JsonNullableInlineString>(hasReferencedValue(value) ? &*value : static_cast<BaseType*>(nullptr));
+    }
+};
+
+template<>
+struct JsonValueCreator<JsonSourceType::InlineString, WrapperType::Nullable, false> {
+    template<typename T>
+    static std::shared_ptr<JsonNullableInlineString> create(T& value) {
+        static_assert(is_nullable_wrapper_v<T> && !std::is_const_v<T>);
+
+        using BaseType = remove_nullable_wrapper_t<T>;
+
+        auto jsonString = std::make_shared<JsonNullableInlineString>(hasReferencedValue(value) ? &*value :
+                                                                                                  static_cast<BaseType*>(nullptr));
+
+        auto referencedValueResetter = [&value]() { value.reset(); };
+        auto referencedValueReinitializer = [&value]() -> void* { return &emplaceReferencedValue(value); };
+
+        jsonString->setReferencedValueHandlers(referencedValueReinitializer, referencedValueResetter);
+
+        return jsonString;
+    }
+};
+
+
+/**
+ * Adapts a json_codec specialization to the encode and decode functions of JsonCustomValue.
+ * The JSON writer and reader pass the value of the member itself, MessagePack and CBOR a
+ * temporary one they convert from and to their own encoding.
+ */
+template<typename T>
+struct user_codec {
+    static void encode(const void* value, rapidjson::Value& jsonOutput, rapidjson::Document::AllocatorType& allocator) {
+        JsonValueWriter writer(jsonOutput, allocator);
+        json_codec<T>::write(writer, *static_cast<const T*>(value));
+    }
+
+    static void decode(void* value, const rapidjson::Value& jsonInput) {
+        JsonValueReader reader(jsonInput);
+        json_codec<T>::read(reader, *static_cast<T*>(value));
+    }
+
+    static constexpr JsonCustomValue::NativeAccess native() {
+        return {};
+    }
+};
+
+template<typename T, typename = void>
+struct codec_of;
+
+template<typename T>
+struct codec_of<T, std::enable_if_t<has_json_codec_v<T>>> {
+    using type = user_codec<T>;
+};
+
+template<typename T>
+struct codec_of<T, std::enable_if_t<!has_json_codec_v<T> && is_json_chrono_v<T>>> {
+    using type = chrono_codec<T>;
+};
+
+template<typename T>
+struct codec_of<T, std::enable_if_t<!has_json_codec_v<T> && is_json_binary_v<T>>> {
+    using type = binary_codec<T>;
+};
+
+template<typename T>
+using codec_of_t = typename codec_of<remove_nullable_wrapper_t<T>>::type;
+
+template<bool isConstQualified>
+struct JsonValueCreator<JsonSourceType::Custom, WrapperType::None, isConstQualified> {
+    template<typename T>
+    static std::shared_ptr<JsonCustomValue> create(T& value) {
+        static_assert(!is_nullable_wrapper_v<T>);
+
+        return std::make_shared<JsonCustomValue>(&value, &codec_of_t<T>::encode, &codec_of_t<T>::decode,
+                                                 codec_of_t<T>::native());
+    }
+};
+
+template<>
+struct JsonValueCreator<JsonSourceType::Custom, WrapperType::Nullable, true> {
+    template<typename T>
+    static std::shared_ptr<JsonNullableCustomValue> create(T& value) {
+        static_assert(is_nullable_wrapper_v<T> && std::is_const_v<T>);
+
+        using BaseType = const remove_nullable_wrapper_t<T>;
+
+        return std::make_shared<JsonNullableCustomValue>(hasReferencedValue(value) ? &*value : static_cast<BaseType*>(nullptr),
+                                                         &codec_of_t<T>::encode, &codec_of_t<T>::decode,
+                                                         codec_of_t<T>::native());
+    }
+};
+
+template<>
+struct JsonValueCreator<JsonSourceType::Custom, WrapperType::Nullable, false> {
+    template<typename T>
+    static std::shared_ptr<JsonNullableCustomValue> create(T& value) {
+        static_assert(is_nullable_wrapper_v<T> && !std::is_const_v<T>);
+
+        using BaseType = remove_nullable_wrapper_t<T>;
+
+        auto jsonValue = std::make_shared<JsonNullableCustomValue>(hasReferencedValue(value) ? &*value :
+                                                                                                static_cast<BaseType*>(nullptr),
+                                                                   &codec_of_t<T>::encode, &codec_of_t<T>::decode,
+                                                                   codec_of_t<T>::native());
+
+        auto referencedValueResetter = [&value]() { value.reset(); };
+        auto referencedValueReinitializer = [&value]() -> void* { return &emplaceReferencedValue(value); };
+
+        jsonValue->setReferencedValueHandlers(referencedValueReinitializer, referencedValueResetter);
+
+        return jsonValue;
+    }
+};
+
+
 template<bool isConstQualified>
 struct JsonValueCreator<JsonSourceType::Struct, WrapperType::None, isConstQualified> {
     template<typename T>
     static std::shared_ptr<JsonObject> create(T& value) {
-        static_assert(!is_std_optional_v<T>);
+        static_assert(!is_nullable_wrapper_v<T>);
 
         return std::make_shared<JsonObject>(buildJsonTreeFrom(value));
     }
 };
 
 template<>
-struct JsonValueCreator<JsonSourceType::Struct, WrapperType::StdOptional, true> {
+struct JsonValueCreator<JsonSourceType::Struct, WrapperType::Nullable, true> {
     template<typename T>
     static std::shared_ptr<JsonNullableObject> create(T& value) {
-        static_assert(is_std_optional_v<T> && std::is_const_v<T>);
+        static_assert(is_nullable_wrapper_v<T> && std::is_const_v<T>);
 
-        if (value.has_value())
+        if (hasReferencedValue(value))
             return std::make_shared<JsonNullableObject>(buildJsonTreeFrom(std::as_const(*value)));
         else
             return std::make_shared<JsonNullableObject>();
@@ -151,21 +604,20 @@ struct JsonValueCreator<JsonSourceType::Struct, WrapperType::StdOptional, true>
 };
 
 template<>
-struct JsonValueCreator<JsonSourceType::Struct, WrapperType::StdOptional, false> {
+struct JsonValueCreator<JsonSourceType::Struct, WrapperType::Nullable, false> {
     template<typename T>
     static std::shared_ptr<JsonNullableObject> create(T& value) {
-        static_assert(is_std_optional_v<T> && !std::is_const_v<T>);
+        static_assert(is_nullable_wrapper_v<T> && !std::is_const_v<T>);
 
-        auto object = (value.has_value()) ? std::make_shared<JsonNullableObject>(buildJsonTreeFrom(*value)) :
+        auto object = (hasReferencedValue(value)) ? std::make_shared<JsonNullableObject>(buildJsonTreeFrom(*value)) :
                                             std::make_shared<JsonNullableObject>();
                                            
         auto referencedValueResetter = [&value]() { value.reset(); };
         auto referencedValueReinitializer = [&value]() {
-                                                    using BaseType = remove_std_optional_t<T>;
-                                                    value = BaseType{};
+                                                    emplaceReferencedValue(value);
                                                 
                                                     auto object = JsonValueCreator<JsonSourceType::Struct, 
-                                                                                   WrapperType::StdOptional, 
+                                                                                   WrapperType::Nullable, 
                                                                                    false>::create(value);
                                                     return object->getMembers();
                                                 };
@@ -181,30 +633,30 @@ template<bool isConstQualified>
 struct JsonValueCreator<JsonSourceType::Sequential, WrapperType::None, isConstQualified> {
     template<typename T>
     static std::shared_ptr<JsonArray> create(T& sequence) {
-        static_assert(!is_std_optional_v<T>);
+        static_assert(!is_nullable_wrapper_v<T>);
 
         auto elements = convertSequenceToJsonArrayElements(sequence);
         auto jsonArray = std::make_shared<JsonArray>(elements, has_std_optional_elements<T>::value);
 
         if constexpr(!isConstQualified && is_json_serializable_dynamic_array_v<T>)
-            jsonArray->setArrayResizer([sequencePtr = &sequence](std::size_t newSize) {
-                                                                 sequencePtr->resize(newSize);
+            jsonArray->setArrayResizer([sequencePtr = &sequence](std::size_t newSize, std::pmr::memory_resource* resource) {
+                                                                 resizeSequence(*sequencePtr, newSize, resource);
                                                                  return  convertSequenceToJsonArrayElements(*sequencePtr);
-                                                             });
-            
+                                                             }, sequence.max_size());
+
         return jsonArray;
     }
 };
 
 template<>
-struct JsonValueCreator<JsonSourceType::Sequential, WrapperType::StdOptional, true> {
+struct JsonValueCreator<JsonSourceType::Sequential, WrapperType::Nullable, true> {
     template<typename T>
     static std::shared_ptr<JsonNullableArray> create(T& sequence) {
-        static_assert(is_std_optional_v<T> && std::is_const_v<T>);
+        static_assert(is_nullable_wrapper_v<T> && std::is_const_v<T>);
 
         bool hasOptionalElems = has_std_optional_elements<T>::value;
 
-        if (!sequence.has_value()) 
+        if (!hasReferencedValue(sequence)) 
             return std::make_shared<JsonNullableArray>(hasOptionalElems);
         else {
             auto elements = convertSequenceToJsonArrayElements(std::as_const(*sequence));
@@ -214,32 +666,37 @@ struct JsonValueCreator<JsonSourceType::Sequential, WrapperType::StdOptional, tr
 };
 
 template<>
-struct JsonValueCreator<JsonSourceType::Sequential, WrapperType::StdOptional, false> {
+struct JsonValueCreator<JsonSourceType::Sequential, WrapperType::Nullable, false> {
     template<typename T>
     static std::shared_ptr<JsonNullableArray> create(T& sequence) {
-        static_assert(is_std_optional_v<T> &&  !std::is_const_v<T>);
+        static_assert(is_nullable_wrapper_v<T> &&  !std::is_const_v<T>);
 
         bool hasOptionalElems = has_std_optional_elements<T>::value;
-        auto jsonArray = (sequence.has_value()) ?
+        auto jsonArray = (hasReferencedValue(sequence)) ?
                             std::make_shared<JsonNullableArray>(convertSequenceToJsonArrayElements(*sequence), hasOptionalElems) :
                             std::make_shared<JsonNullableArray>(hasOptionalElems);
                                 
         auto optValueReinitializer = [&sequence]() {
-                                            using BaseType = remove_std_optional_t<T>;
-                                            sequence = BaseType{};
+                                            emplaceReferencedValue(sequence);
                                         
-                                            return std::vector<std::shared_ptr<JsonValue>>{};
+                                            return convertSequenceToJsonArrayElements(*sequence);
                                         };
-        auto resizer = [&sequence, optValueReinitializer](std::size_t newSize) {
-                                            if (!sequence.has_value())
-                                                optValueReinitializer();
-        
-                                            sequence->resize(newSize);
-                                            return  convertSequenceToJsonArrayElements(*sequence); 
-                                         };
         auto optValueResetter = [&sequence]() { sequence.reset(); };
+
+        if constexpr (is_json_serializable_dynamic_array_v<T>) {
+            using Sequence = remove_nullable_wrapper_t<T>;
+
+            auto resizer = [&sequence, optValueReinitializer](std::size_t newSize, std::pmr::memory_resource* resource) {
+                                                if (!hasReferencedValue(sequence))
+                                                    optValueReinitializer();
         
-        jsonArray->setArrayResizer(resizer);
+                                                resizeSequence(*sequence, newSize, resource);
+                                                return  convertSequenceToJsonArrayElements(*sequence); 
+                                             };
+
+            jsonArray->setArrayResizer(resizer, hasReferencedValue(sequence) ? sequence->max_size() : Sequence{}.max_size());
+        }
+
         jsonArray->setReferencedValueHandlers(optValueReinitializer, optValueResetter);
         
         return jsonArray;
@@ -247,11 +704,43 @@ struct JsonValueCreator<JsonSourceType::Sequential, WrapperType::StdOptional, fa
 };
 
 
+template<bool isConstQualified>
+struct JsonValueCreator<JsonSourceType::NumberArray, WrapperType::None, isConstQualified> {
+    template<typename T>
+    static std::shared_ptr<JsonNumberArray> create(T& sequence) {
+        using Traits = contiguous_number_array_traits<std::remove_const_t<T>>;
+        using Number = std::conditional_t<isConstQualified, const typename Traits::number_type, typename Traits::number_type>;
+
+        std::vector<std::size_t> extents(Traits::extents.begin(), Traits::extents.end());
+        extents.front() = sequence.size();
+
+        auto jsonArray = std::make_shared<JsonNumberArray>(numbersOf<Number>(sequence), extents);
+
+        if constexpr (!isConstQualified && Traits::is_resizable)
+            jsonArray->setArrayResizer([sequencePtr = &sequence](std::size_t newSize,
+                                                                 std::pmr::memory_resource* resource) -> void* {
+                                                                 resizeSequence(*sequencePtr, newSize, resource);
+                                                                 return numbersOf<Number>(*sequencePtr);
+                                                             }, sequence.max_size());
+
+        return jsonArray;
+    }
+
+private:
+    // Nested std::arrays are unpadded (checked by contiguous_number_array_traits), so the
+    // numbers of all rows form a single run starting at the first element.
+    template<typename Number, typename T>
+    static Number* numbersOf(T& sequence) {
+        return reinterpret_cast<Number*>(sequence.data());
+    }
+};
+
+
 template<bool isConstQualified>
 struct JsonValueCreator<JsonSourceType::Tuple, WrapperType::None, isConstQualified> {
     template<typename T>
     static std::shared_ptr<JsonArray> create(T& tuple) {
-        static_assert(!is_std_optional_v<T>);
+        static_assert(!is_nullable_wrapper_v<T>);
 
         auto elements = convertTupleToJsonArrayElements(tuple);
 
@@ -260,12 +749,12 @@ struct JsonValueCreator<JsonSourceType::Tuple, WrapperType::None, isConstQualifi
 };
 
 template<>
-struct JsonValueCreator<JsonSourceType::Tuple, WrapperType::StdOptional, true> {
+struct JsonValueCreator<JsonSourceType::Tuple, WrapperType::Nullable, true> {
     template<typename T>
     static std::shared_ptr<JsonNullableArray> create(T& tuple) {
-        static_assert(is_std_optional_v<T> && std::is_const_v<T>);
+        static_assert(is_nullable_wrapper_v<T> && std::is_const_v<T>);
 
-        if (!tuple.has_value())
+        if (!hasReferencedValue(tuple))
             return std::make_shared<JsonNullableArray>();
 
         auto elements = convertTupleToJsonArrayElements(std::as_const(*tuple));
@@ -275,18 +764,17 @@ struct JsonValueCreator<JsonSourceType::Tuple, WrapperType::StdOptional, true> {
 };
 
 template<>
-struct JsonValueCreator<JsonSourceType::Tuple, WrapperType::StdOptional, false> {
+struct JsonValueCreator<JsonSourceType::Tuple, WrapperType::Nullable, false> {
     template<typename T>
     static std::shared_ptr<JsonNullableArray> create(T& tuple) {
-        static_assert(is_std_optional_v<T> && !std::is_const_v<T>);
+        static_assert(is_nullable_wrapper_v<T> && !std::is_const_v<T>);
 
-        auto jsonArray = (tuple.has_value()) ?
+        auto jsonArray = (hasReferencedValue(tuple)) ?
                             std::make_shared<JsonNullableArray>(convertTupleToJsonArrayElements(*tuple)) :
                             std::make_shared<JsonNullableArray>();
                                               
         auto referencedValueReinitializer = [&tuple]() {
-                                                    using BaseType = remove_std_optional_t<T>;
-                                                    tuple = BaseType{};
+                                                    emplaceReferencedValue(tuple);
                                                 
                                                     return convertTupleToJsonArrayElements(*tuple);
                                                 };
@@ -299,26 +787,339 @@ struct JsonValueCreator<JsonSourceType::Tuple, WrapperType::StdOptional, false>
 };
 
 
-template<typename T>
-std::shared_ptr<JsonValue> createJsonPrimitiveValueFrom(T& value) {
-    static_assert(is_json_serializable_primitive_type_v<std::remove_const_t<T>>);
+template<typename Variant>
+struct VariantAlternativeTags;
 
-    return JsonValueCreator<JsonSourceType::Primitive, wrapper_type_trait_v<T>, std::is_const_v<T>>::create(value);
-}
+template<typename Variant, const char* Discriminator>
+struct VariantAlternativeTags<internally_tagged<Variant, Discriminator>> : VariantAlternativeTags<Variant> {};
 
-template<typename T>
-std::shared_ptr<JsonValue> createJsonObjectFrom(T& value) {
-    static_assert(is_describable_struct_v<std::remove_const_t<T>>);
+template<typename... Alternatives>
+struct VariantAlternativeTags<std::variant<Alternatives...>> {
+    static constexpr std::array<std::string_view, sizeof...(Alternatives)> names{ 
+                                   std::string_view(Descriptor<Alternatives>::name())... };
 
-    return JsonValueCreator<JsonSourceType::Struct, wrapper_type_trait_v<T>, std::is_const_v<T>>::create(value);
-}
+    static constexpr bool hasUniqueNames() {
+        for (std::size_t i = 0; i < names.size(); ++i)
+            for (std::size_t j = i + 1; j < names.size(); ++j)
+                if (names[i] == names[j])
+                    return false;
 
-template<typename T>
-std::shared_ptr<JsonValue> createJsonArrayFromSeq(T& sequence) {
-    static_assert(is_json_serializable_sequential_container_v<std::remove_const_t<T>>);
+        return true;
+    }
 
-    return JsonValueCreator<JsonSourceType::Sequential, wrapper_type_trait_v<T>, std::is_const_v<T>>::create(sequence);
-}
+    static_assert(hasUniqueNames(), "Alternatives of a std::variant member must be distinct described structs");
+};
+
+template<typename Struct, typename... MemberDescriptors>
+constexpr bool hasMemberWireName(std::string_view name, TypeList<MemberDescriptors...>) {
+    return (false || ... || (name == wireNameOf<Struct>(MemberDescriptors{})));
+}
+
+template<typename... Alternatives>
+constexpr bool isMemberOfAlternative(std::string_view name, const std::variant<Alternatives...>*) {
+    return (... || hasMemberWireName<Alternatives>(name, Descriptor<Alternatives>::member_descriptors));
+}
+
+/**
+ * The tagging of Variant, whose discriminator may not be a member of an alternative, as it is
+ * written into the same object. Checked where the variant is serialized, so that wire names
+ * described after the variant are taken into account.
+ */
+template<typename Variant>
+struct CheckedVariantTagging : variant_tagging_of<Variant> {
+    static_assert(variant_tagging_of<Variant>::style != VariantTagging::Internal ||
+                  !isMemberOfAlternative(variant_tagging_of<Variant>::discriminator, static_cast<const Variant*>(nullptr)),
+                  "The discriminator of a std::variant member must differ from the members of its alternatives");
+};
+
+template<typename Variant>
+void checkHasAlternative(const Variant& variant) {
+    if (variant.valueless_by_exception())
+        throw UnserializableValueException("Expected a std::variant holding an alternative, got one valueless by exception");
+}
+
+template<typename Variant>
+std::shared_ptr<JsonObject> convertVariantAlternativeToJsonObject(Variant& variant) {
+    return std::visit([](auto& alternative) { return std::make_shared<JsonObject>(buildJsonTreeFrom(alternative)); }, variant);
+}
+
+/**
+ * Emplaces the alternative whose described name equals the tag. The comparisons are
+ * unrolled at compile time over the alternatives' indices, so no alternative is
+ * speculatively parsed.
+ */
+template<typename Variant, std::size_t... Indices>
+std::shared_ptr<JsonObject> emplaceVariantAlternative(Variant& variant, std::string_view tag, std::index_sequence<Indices...>) {
+    using Tags = VariantAlternativeTags<Variant>;
+
+    std::shared_ptr<JsonObject> alternative;
+    (void)(... || (tag == Tags::names[Indices] && 
+                   (alternative = std::make_shared<JsonObject>(buildJsonTreeFrom(variant.template emplace<Indices>())), true)));
+
+    return alternative;
+}
+
+template<typename Variant>
+std::shared_ptr<JsonObject> emplaceVariantAlternative(Variant& variant, std::string_view tag) {
+    return emplaceVariantAlternative(variant, tag, std::make_index_sequence<std::variant_size_v<Variant>>{});
+}
+
+template<bool isConstQualified>
+struct JsonValueCreator<JsonSourceType::Variant, WrapperType::None, isConstQualified> {
+    template<typename T>
+    static std::shared_ptr<JsonVariant> create(T& variant) {
+        static_assert(!is_nullable_wrapper_v<T>);
+
+        using VariantType = std::remove_const_t<T>;
+        using Tagging = CheckedVariantTagging<VariantType>;
+
+        auto jsonVariant = std::make_shared<JsonVariant>(Tagging::style, Tagging::discriminator);
+
+        if constexpr (isConstQualified) {
+            checkHasAlternative(variant);
+            jsonVariant->setAlternative(VariantAlternativeTags<VariantType>::names[variant.index()],
+                                        convertVariantAlternativeToJsonObject(variant));
+        }
+        else 
+            jsonVariant->setAlternativeSelector([&variant](std::string_view tag) {
+                                                    return emplaceVariantAlternative(variant, tag); 
+                                                });
+
+        return jsonVariant;
+    }
+};
+
+template<>
+struct JsonValueCreator<JsonSourceType::Variant, WrapperType::Nullable, true> {
+    template<typename T>
+    static std::shared_ptr<JsonNullableVariant> create(T& variant) {
+        static_assert(is_nullable_wrapper_v<T> && std::is_const_v<T>);
+
+        using VariantType = remove_nullable_wrapper_t<T>;
+        using Tagging = CheckedVariantTagging<VariantType>;
+
+        auto jsonVariant = std::make_shared<JsonNullableVariant>(Tagging::style, Tagging::discriminator, !hasReferencedValue(variant));
+
+        if (hasReferencedValue(variant)) {
+            checkHasAlternative(*variant);
+            jsonVariant->setAlternative(VariantAlternativeTags<VariantType>::names[variant->index()],
+                                        convertVariantAlternativeToJsonObject(std::as_const(*variant)));
+        }
+
+        return jsonVariant;
+    }
+};
+
+template<>
+struct JsonValueCreator<JsonSourceType::Variant, WrapperType::Nullable, false> {
+    template<typename T>
+    static std::shared_ptr<JsonNullableVariant> create(T& variant) {
+        static_assert(is_nullable_wrapper_v<T> && !std::is_const_v<T>);
+
+        using VariantType = remove_nullable_wrapper_t<T>;
+        using Tagging = CheckedVariantTagging<VariantType>;
+
+        auto jsonVariant = std::make_shared<JsonNullableVariant>(Tagging::style, Tagging::discriminator, !hasReferencedValue(variant));
+
+        auto alternativeSelector = [&variant](std::string_view tag) {
+                                            if (!hasReferencedValue(variant))
+                                                emplaceReferencedValue(variant);
+
+                                            return emplaceVariantAlternative(*variant, tag);
+                                        };
+        auto referencedValueResetter = [&variant]() { variant.reset(); };
+
+        jsonVariant->setAlternativeSelector(alternativeSelector);
+        jsonVariant->setReferencedValueResetter(referencedValueResetter);
+
+        return jsonVariant;
+    }
+};
+
+
+/**
+ * Views are only read from, the nodes refer directly to the memory they view.
+ */
+template<>
+struct JsonValueCreator<JsonSourceType::View, WrapperType::None, true> {
+    template<typename T>
+    static std::shared_ptr<JsonValue> create(T& view) {
+        using ViewType = std::remove_const_t<T>;
+
+        if constexpr (std::is_same_v<ViewType, std::string_view>)
+            return std::make_shared<JsonPrimitiveValue>(&view);
+        else if constexpr (is_std_reference_wrapper_v<ViewType>)
+            return convertToJsonValueFrom(view.get());
+        else
+            return createFromSpan(view);
+    }
+
+private:
+    template<typename Span>
+    static std::shared_ptr<JsonValue> createFromSpan(const Span& span) {
+        using Element = std::remove_cv_t<typename Span::element_type>;
+        using RowTraits = contiguous_number_array_traits<std::array<Element, 1>>;
+
+        if constexpr (RowTraits::value) {
+            using Number = const typename RowTraits::number_type;
+
+            std::vector<std::size_t> extents(RowTraits::extents.begin(), RowTraits::extents.end());
+            extents.front() = span.size();
+
+            return std::make_shared<JsonNumberArray>(reinterpret_cast<Number*>(span.data()), extents);
+        }
+        else {
+            std::vector<std::shared_ptr<JsonValue>> elements;
+
+            for (auto&& item : span)
+                elements.push_back(convertToJsonValueFrom(item));
+
+            return std::make_shared<JsonArray>(elements, is_nullable_wrapper_v<Element>);
+        }
+    }
+};
+
+template<>
+struct JsonValueCreator<JsonSourceType::View, WrapperType::None, false> {
+    template<typename T>
+    static std::shared_ptr<JsonValue> create(T&) {
+        static_assert(std::is_const_v<T>, "std::string_view, std::span and std::reference_wrapper members "
+                                          "are marshal-only, unmarshal needs members that own their values");
+        return nullptr;
+    }
+};
+
+
+/**
+ * Builds a column per member of the described element type, each of which takes its values
+ * from the elements of the container when it is visited.
+ */
+template<typename Sequence>
+std::vector<JsonAttribute> convertSequenceToJsonColumns(Sequence& sequence) {
+    static_assert(is_json_columnar_array_v<Sequence>);
+
+    using Element = typename std::remove_const_t<Sequence>::value_type;
+
+    static_assert(is_json_serializable_sequential_container_v<std::remove_const_t<Sequence>> &&
+                  is_describable_struct_v<Element> && !is_nullable_wrapper_v<Element>,
+                  "Only containers of described structs can be laid out as columns");
+
+    std::vector<JsonAttribute> columns;
+    auto length = std::make_shared<std::optional<std::size_t>>();
+
+    for_each(Descriptor<Element>::member_descriptors, [&sequence, &columns, &length](auto desc) {
+        using Member = member_type_t<decltype(desc.pointer())>;
+
+        auto builder = [&sequence, desc]() {
+                           std::vector<std::shared_ptr<JsonValue>> elements;
+                           elements.reserve(sequence.size());
+
+                           for (auto&& item : sequence)
+                               elements.push_back(convertToJsonValueFrom(item.*(desc.pointer())));
+
+                           return elements;
+                       };
+
+        auto column = std::make_shared<JsonColumn>(builder, is_nullable_wrapper_v<Member>, length);
+
+        if constexpr (!std::is_const_v<Sequence> && is_json_serializable_dynamic_array_v<Sequence>)
+            column->setSequenceResizer([&sequence](std::size_t newSize, std::pmr::memory_resource* resource) {
+                                           resizeSequence(sequence, newSize, resource);
+                                       }, sequence.max_size());
+
+        columns.push_back(JsonAttribute{ getMemberName<Element>(desc), column });
+    });
+
+    return columns;
+}
+
+template<bool isConstQualified>
+struct JsonValueCreator<JsonSourceType::Columnar, WrapperType::None, isConstQualified> {
+    template<typename T>
+    static std::shared_ptr<JsonObject> create(T& sequence) {
+        static_assert(!is_nullable_wrapper_v<T>);
+
+        return std::make_shared<JsonObject>(convertSequenceToJsonColumns(sequence));
+    }
+};
+
+template<>
+struct JsonValueCreator<JsonSourceType::Columnar, WrapperType::Nullable, true> {
+    template<typename T>
+    static std::shared_ptr<JsonNullableObject> create(T& sequence) {
+        static_assert(is_nullable_wrapper_v<T> && std::is_const_v<T>);
+
+        if (hasReferencedValue(sequence))
+            return std::make_shared<JsonNullableObject>(convertSequenceToJsonColumns(std::as_const(*sequence)));
+        else
+            return std::make_shared<JsonNullableObject>();
+    }
+};
+
+template<>
+struct JsonValueCreator<JsonSourceType::Columnar, WrapperType::Nullable, false> {
+    template<typename T>
+    static std::shared_ptr<JsonNullableObject> create(T& sequence) {
+        static_assert(is_nullable_wrapper_v<T> && !std::is_const_v<T>);
+
+        auto object = (hasReferencedValue(sequence)) ? std::make_shared<JsonNullableObject>(convertSequenceToJsonColumns(*sequence)) :
+                                                       std::make_shared<JsonNullableObject>();
+
+        auto referencedValueResetter = [&sequence]() { sequence.reset(); };
+        auto referencedValueReinitializer = [&sequence]() {
+                                                    emplaceReferencedValue(sequence);
+
+                                                    return convertSequenceToJsonColumns(*sequence);
+                                                };
+
+        object->setReferencedValueHandlers(referencedValueReinitializer, referencedValueResetter);
+
+        return object;
+    }
+};
+
+
+template<typename T>
+std::shared_ptr<JsonValue> createJsonPrimitiveValueFrom(T& value) {
+    static_assert(is_json_serializable_primitive_type_v<std::remove_const_t<T>>);
+
+    return JsonValueCreator<JsonSourceType::Primitive, wrapper_type_trait_v<T>, std::is_const_v<T>>::create(value);
+}
+
+template<typename T>
+std::shared_ptr<JsonValue> createJsonInlineStringFrom(T& value) {
+    static_assert(is_json_inline_string_v<std::remove_const_t<T>>);
+
+    return JsonValueCreator<JsonSourceType::InlineString, wrapper_type_trait_v<T>, std::is_const_v<T>>::create(value);
+}
+
+template<typename T>
+std::shared_ptr<JsonValue> createJsonCustomValueFrom(T& value) {
+    static_assert(is_json_codec_value_v<std::remove_const_t<T>>);
+
+    return JsonValueCreator<JsonSourceType::Custom, wrapper_type_trait_v<T>, std::is_const_v<T>>::create(value);
+}
+
+template<typename T>
+std::shared_ptr<JsonValue> createJsonObjectFrom(T& value) {
+    static_assert(is_describable_struct_v<std::remove_const_t<T>>);
+
+    return JsonValueCreator<JsonSourceType::Struct, wrapper_type_trait_v<T>, std::is_const_v<T>>::create(value);
+}
+
+template<typename T>
+std::shared_ptr<JsonValue> createJsonArrayFromSeq(T& sequence) {
+    static_assert(is_json_serializable_sequential_container_v<std::remove_const_t<T>>);
+
+    return JsonValueCreator<JsonSourceType::Sequential, wrapper_type_trait_v<T>, std::is_const_v<T>>::create(sequence);
+}
+
+template<typename T>
+std::shared_ptr<JsonValue> createJsonNumberArrayFrom(T& sequence) {
+    static_assert(is_contiguous_number_array_v<T>);
+
+    return JsonValueCreator<JsonSourceType::NumberArray, WrapperType::None, std::is_const_v<T>>::create(sequence);
+}
 
 template<typename T>
 std::shared_ptr<JsonValue> createJsonArrayFromTup(T& tuple) {
@@ -327,20 +1128,64 @@ std::shared_ptr<JsonValue> createJsonArrayFromTup(T& tuple) {
     return JsonValueCreator<JsonSourceType::Tuple, wrapper_type_trait_v<T>, std::is_const_v<T>>::create(tuple);
 }
 
+template<typename T>
+std::shared_ptr<JsonValue> createJsonVariantFrom(T& variant) {
+    static_assert(is_json_serializable_variant_v<std::remove_const_t<T>>);
+
+    return JsonValueCreator<JsonSourceType::Variant, wrapper_type_trait_v<T>, std::is_const_v<T>>::create(variant);
+}
+
+
+template<typename T>
+std::shared_ptr<JsonValue> createJsonColumnsFrom(T& sequence) {
+    static_assert(is_json_columnar_array_v<T>);
+
+    return JsonValueCreator<JsonSourceType::Columnar, wrapper_type_trait_v<T>, std::is_const_v<T>>::create(sequence);
+}
+
+
+template<typename T>
+std::shared_ptr<JsonValue> createJsonValueFromView(T& view) {
+    static_assert(is_json_view_v<T>);
+
+    return JsonValueCreator<JsonSourceType::View, WrapperType::None, std::is_const_v<T>>::create(view);
+}
+
 
 template<typename T>
 std::shared_ptr<JsonValue> convertToJsonValueFrom(T& memberRef) {
     using ValueType = std::remove_const_t<T>;
 
-    if constexpr (is_json_serializable_primitive_type_v<ValueType>)
+    if constexpr (has_json_codec_v<ValueType>)
+        return createJsonCustomValueFrom(memberRef);
+
+    else if constexpr (is_json_serializable_primitive_type_v<ValueType>)
         return createJsonPrimitiveValueFrom(memberRef);
 
+    else if constexpr (is_json_inline_string_v<ValueType>)
+        return createJsonInlineStringFrom(memberRef);
+
+    else if constexpr (is_json_chrono_v<ValueType> || is_json_binary_v<ValueType>)
+        return createJsonCustomValueFrom(memberRef);
+
+    else if constexpr (is_json_view_v<ValueType>)
+        return createJsonValueFromView(memberRef);
+
     else if constexpr (is_describable_struct_v<ValueType>)
         return createJsonObjectFrom(memberRef);
 
     else if constexpr (is_json_serializable_tuple_v<ValueType>)
         return createJsonArrayFromTup(memberRef);
 
+    else if constexpr (is_json_serializable_variant_v<ValueType>)
+        return createJsonVariantFrom(memberRef);
+
+    else if constexpr (is_json_columnar_array_v<ValueType>)
+        return createJsonColumnsFrom(memberRef);
+
+    else if constexpr (is_contiguous_number_array_v<ValueType>)
+        return createJsonNumberArrayFrom(memberRef);
+
     else if constexpr (is_json_serializable_sequential_container_v<ValueType>)
         return createJsonArrayFromSeq(memberRef);
 
@@ -349,9 +1194,153 @@ std::shared_ptr<JsonValue> convertToJsonValueFrom(T& memberRef) {
 }
 
 
-template<typename Desc>
-std::string getMemberName(Desc descriptor) {
-    return std::string(descriptor.name());
+template<typename T, typename = void>
+struct is_equality_comparable : std::false_type {};
+
+template<typename T>
+struct is_equality_comparable<T, std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>> : std::true_type {};
+
+// How Omission::Defaults tells a member that equals the member of a value-initialized struct,
+// and restores it. Nested structs, fixed arrays, tuples and variants are always written.
+enum class DefaultOmission {
+    Never,
+    Null,           // Both are null
+    Equal,          // Both compare equal
+    InlineString,   // Both hold the same characters
+    Empty           // Both are empty containers
+};
+
+template<typename T>
+constexpr DefaultOmission defaultOmissionOf() {
+    if constexpr (std::is_const_v<T>)
+        return DefaultOmission::Never;
+    else if constexpr (is_nullable_wrapper_v<T>)
+        return DefaultOmission::Null;
+    else if constexpr (has_json_codec_v<T>)
+        return is_equality_comparable<T>::value && std::is_copy_assignable_v<T> ? DefaultOmission::Equal : DefaultOmission::Never;
+    else if constexpr (is_json_inline_string_v<T>)
+        return DefaultOmission::InlineString;
+    else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T> || is_json_chrono_v<T> ||
+                       std::is_same_v<T, std::string> || std::is_same_v<T, std::pmr::string>)
+        return DefaultOmission::Equal;
+    else if constexpr (is_resizable_sequence_container<T>::value)
+        return DefaultOmission::Empty;
+    else
+        return DefaultOmission::Never;
+}
+
+// Floating-point numbers and ticks compare their bits, so that -0.0 isn't taken for the 0.0 it
+// equals and read back as such
+template<typename T>
+bool isSameValue(const T& value, const T& other) {
+    if constexpr (std::is_floating_point_v<T>)
+        return std::memcmp(&value, &other, sizeof(T)) == 0;
+    else if constexpr (is_json_chrono_v<T> && !has_json_codec_v<T>) {
+        if constexpr (is_chrono_time_point_v<T>)
+            return isSameValue(value.time_since_epoch().count(), other.time_since_epoch().count());
+        else
+            return isSameValue(value.count(), other.count());
+    }
+    else
+        return value == other;
+}
+
+template<typename Struct>
+const Struct& valueInitialized() {
+    static const Struct value{};
+    return value;
+}
+
+template<typename Member>
+bool isDefaultMember(const Member& member, const Member& defaultMember) {
+    constexpr DefaultOmission omission = defaultOmissionOf<Member>();
+
+    if constexpr (omission == DefaultOmission::Null)
+        return !member && !defaultMember;
+    else if constexpr (omission == DefaultOmission::Equal)
+        return isSameValue(member, defaultMember);
+    else if constexpr (omission == DefaultOmission::InlineString)
+        return inline_string_traits<Member>::view(&member) == inline_string_traits<Member>::view(&defaultMember);
+    else if constexpr (omission == DefaultOmission::Empty)
+        return member.size() == 0 && defaultMember.size() == 0;
+    else
+        return false;
+}
+
+template<typename Member>
+bool restoreDefaultMember(Member& member, const Member& defaultMember) {
+    constexpr DefaultOmission omission = defaultOmissionOf<Member>();
+
+    if constexpr (omission == DefaultOmission::Null) {
+        if (defaultMember)
+            return false;
+
+        member.reset();
+        return true;
+    }
+    else if constexpr (omission == DefaultOmission::Equal) {
+        member = defaultMember;
+        return true;
+    }
+    else if constexpr (omission == DefaultOmission::InlineString) {
+        inline_string_traits<Member>::assign(&member, inline_string_traits<Member>::view(&defaultMember));
+        return true;
+    }
+    else if constexpr (omission == DefaultOmission::Empty) {
+        if (defaultMember.size() != 0)
+            return false;
+
+        member.resize(0);
+        return true;
+    }
+    else
+        return false;
+}
+
+// Tells whether a member of a struct being written is left out, or restores a member missing from
+// a struct being read, see JsonMemberOmitter
+template<typename Struct, typename Desc>
+bool omitDescribedMember(const void* object, Omission omission) {
+    using Value = std::remove_const_t<Struct>;
+    using Member = member_type_t<decltype(Desc::pointer())>;
+
+    if constexpr (std::is_const_v<Struct>) {
+        const Member& member = static_cast<const Value*>(object)->*Desc::pointer();
+
+        if (omission == Omission::Nulls) {
+            if constexpr (is_nullable_wrapper_v<Member>)
+                return !member;
+            else
+                return false;
+        }
+
+        if constexpr (std::is_default_constructible_v<Value>)
+            return isDefaultMember(member, valueInitialized<Value>().*Desc::pointer());
+        else
+            return false;
+    }
+    else {
+        Member& member = const_cast<Value*>(static_cast<const Value*>(object))->*Desc::pointer();
+
+        if (omission == Omission::Nulls) {
+            if constexpr (is_nullable_wrapper_v<Member> && !std::is_const_v<Member>) {
+                member.reset();
+                return true;
+            }
+            else
+                return false;
+        }
+
+        if constexpr (std::is_default_constructible_v<Value>)
+            return restoreDefaultMember(member, valueInitialized<Value>().*Desc::pointer());
+        else
+            return false;
+    }
+}
+
+template<typename Struct, typename Desc>
+JsonMemberOmitter makeMemberOmitter(Struct& s, Desc) {
+    return JsonMemberOmitter{ member_omission<std::remove_const_t<Struct>>::style, &s, &omitDescribedMember<Struct, Desc> };
 }
 
 template<typename Struct, typename Desc>
@@ -360,40 +1349,210 @@ auto& getMemberValueRef(Struct& s, Desc descriptor) {
 }
 
 
-template<typename Struct>
-std::vector<JsonAttribute> buildJsonTreeFrom(Struct& s) {
-    static_assert(is_describable_struct_v<std::remove_const_t<Struct>>, "Use the RAPIDJSON_UTIL_DESCRIBE_MEMBERS macro to declare serializable struct members");
-
+template<typename Struct, typename Descriptors>
+std::vector<JsonAttribute> buildJsonTreeFrom(Struct& s, Descriptors descriptors) {
     std::vector<JsonAttribute> members;
 
-    auto descriptors = Descriptor<std::remove_const_t<Struct>>::member_descriptors;
     for_each(descriptors, [&s, &members](auto desc) {
-                              std::string name = getMemberName(desc);
+                              std::string name = getMemberName<Struct>(desc);
                               auto& valueRef = getMemberValueRef(s, desc);
                               
-                              members.push_back(JsonAttribute{ name, convertToJsonValueFrom(valueRef) });
+                              members.push_back(JsonAttribute{ name, convertToJsonValueFrom(valueRef), makeMemberOmitter(s, desc) });
                           });
 
     return members;
 }
 
+template<typename Struct>
+std::vector<JsonAttribute> buildJsonTreeFrom(Struct& s) {
+    static_assert(is_describable_struct_v<std::remove_const_t<Struct>>, "Use the RAPIDJSON_UTIL_DESCRIBE_MEMBERS macro to declare serializable struct members");
+
+    return buildJsonTreeFrom(s, Descriptor<std::remove_const_t<Struct>>::member_descriptors);
+}
+
+
+// The described struct whose members a FieldMask selects through a member of type Member
+template<typename Member, typename = void>
+struct masked_struct {
+    static constexpr bool is_maskable = false;
+};
+
+template<typename Member>
+struct masked_struct<Member, std::enable_if_t<is_describable_struct_v<Member> && !has_json_codec_v<remove_nullable_wrapper_t<Member>>>> {
+    static constexpr bool is_maskable = true;
+    using type = std::remove_const_t<remove_nullable_wrapper_t<Member>>;
+};
+
+template<typename Member>
+struct masked_struct<Member, std::enable_if_t<is_json_serializable_sequential_container_v<Member> && !is_nullable_wrapper_v<Member> &&
+                                              !is_json_columnar_array_v<Member> && !has_json_codec_v<Member>>> :
+    masked_struct<std::remove_reference_t<decltype(*std::begin(std::declval<Member&>()))>> {
+};
+
+template<typename Struct, typename Desc>
+void selectNestedFieldPath(FieldMaskNode& mask, std::size_t member, Desc descriptor, std::string_view path, std::string_view fullPath) {
+    using Member = member_type_t<decltype(Desc::pointer())>;
+
+    if constexpr (masked_struct<Member>::is_maskable) {
+        using Nested = typename masked_struct<Member>::type;
+
+        std::unique_ptr<FieldMaskNode>& nestedMask = mask.nestedMasks[member];
+        bool isSelectedWhole = mask.isSelected(member) && !nestedMask;
+
+        auto nested = nestedMask ? std::move(nestedMask) :
+                                   std::make_unique<FieldMaskNode>(describedMemberCount(Descriptor<Nested>::member_descriptors));
+        selectFieldPath<Nested>(*nested, path, fullPath);
+
+        mask.select(member, isSelectedWhole ? nullptr : std::move(nested));
+    }
+    else
+        throw InvalidFieldPathException(std::string("Expected a member holding described structs in field path \"").append(fullPath)
+                                        .append("\", got ").append(wireNameOf<Struct>(descriptor)));
+}
 
+// Selects the member of Struct named by path up to the first '.', and the members of its nested
+// struct named by the rest
 template<typename Struct>
-std::string marshalImpl(const Struct& s) {
+void selectFieldPath(FieldMaskNode& mask, std::string_view path, std::string_view fullPath) {
+    std::size_t separator = path.find('.');
+    std::string_view name = path.substr(0, separator);
+
+    bool isFound = false;
+    std::size_t member = 0;
+
+    for_each(Descriptor<Struct>::member_descriptors, [&](auto desc) {
+                                                         if (!isFound && name == wireNameOf<Struct>(desc)) {
+                                                             isFound = true;
+
+                                                             if (separator == std::string_view::npos)
+                                                                 mask.select(member, nullptr);
+                                                             else
+                                                                 selectNestedFieldPath<Struct>(mask, member, desc, path.substr(separator + 1), fullPath);
+                                                         }
+
+                                                         ++member;
+                                                     });
+
+    ThrowUnless(isFound, InvalidFieldPathException(std::string("Expected a member of ").append(Descriptor<Struct>::name())
+                                                   .append(" in field path \"").append(fullPath)
+                                                   .append("\", got \"").append(name).append("\"")));
+}
+
+template<typename T>
+std::shared_ptr<JsonValue> convertMaskedToJsonValueFrom(const T& value, const FieldMaskNode& mask);
+
+template<typename Struct>
+std::vector<JsonAttribute> buildMaskedJsonTreeFrom(const Struct& s, const FieldMaskNode& mask) {
+    std::vector<JsonAttribute> members;
+    std::size_t member = 0;
+
+    for_each(Descriptor<Struct>::member_descriptors, [&](auto desc) {
+                                                         if (mask.isSelected(member)) {
+                                                             auto& valueRef = getMemberValueRef(s, desc);
+                                                             const FieldMaskNode* nestedMask = mask.nestedMasks[member].get();
+                                                             std::shared_ptr<JsonValue> value;
+
+                                                             if constexpr (masked_struct<std::remove_const_t<std::remove_reference_t<decltype(valueRef)>>>::is_maskable)
+                                                                 value = nestedMask ? convertMaskedToJsonValueFrom(valueRef, *nestedMask) : convertToJsonValueFrom(valueRef);
+                                                             else
+                                                                 value = convertToJsonValueFrom(valueRef);
+
+                                                             members.push_back(JsonAttribute{ getMemberName<Struct>(desc), value, makeMemberOmitter(s, desc) });
+                                                         }
+
+                                                         ++member;
+                                                     });
+
+    return members;
+}
+
+template<typename T>
+std::shared_ptr<JsonValue> convertMaskedToJsonValueFrom(const T& value, const FieldMaskNode& mask) {
+    if constexpr (is_json_serializable_sequential_container_v<T>) {
+        std::vector<std::shared_ptr<JsonValue>> elements;
+
+        for (auto&& element : value)
+            elements.push_back(convertMaskedToJsonValueFrom(element, mask));
+
+        return std::make_shared<JsonArray>(elements, has_std_optional_elements<T>::value);
+    }
+    else if constexpr (is_nullable_wrapper_v<T>) {
+        if (hasReferencedValue(value))
+            return std::make_shared<JsonNullableObject>(buildMaskedJsonTreeFrom(*value, mask));
+        else
+            return std::make_shared<JsonNullableObject>();
+    }
+    else
+        return std::make_shared<JsonObject>(buildMaskedJsonTreeFrom(value, mask));
+}
+
+// The members of a view must be described members of its struct, each listed once
+template<typename... ViewDescriptors, typename... MemberDescriptors>
+constexpr bool areValidViewMembers(TypeList<ViewDescriptors...> view, TypeList<MemberDescriptors...> members) {
+    constexpr bool areMembersDescribed = (... && (describedMemberIndex<ViewDescriptors::pointer()>(members) < sizeof...(MemberDescriptors)));
+    constexpr std::size_t indices[] = { describedMemberIndex<ViewDescriptors::pointer()>(view)..., 0 };
+
+    for (std::size_t i = 0; i < sizeof...(ViewDescriptors); ++i)
+        if (indices[i] != i)
+            return false;
+
+    return areMembersDescribed;
+}
+
+template<typename View>
+constexpr bool areValidViewMembers() {
+    using Struct = typename marshal_view<View>::struct_type;
+    return areValidViewMembers(marshal_view<View>::member_descriptors, Descriptor<Struct>::member_descriptors);
+}
+
+
+template<typename Struct>
+std::string marshalImpl(const Struct& s, Omission omission) {
     JsonObject root(buildJsonTreeFrom(s));
 
+    JsonWriter writer(omission);
+    return writer.witeToJson(&root);
+}
+
+template<typename Struct>
+std::string marshalImpl(const Struct& s) {
+    return marshalImpl(s, Omission::None);
+}
+
+template<typename Struct>
+std::string marshalMaskedImpl(const Struct& s, const FieldMaskNode& mask) {
+    JsonObject root(buildMaskedJsonTreeFrom(s, mask));
+
+    JsonWriter writer;
+    return writer.witeToJson(&root);
+}
+
+template<typename View>
+std::string marshalViewImpl(const typename marshal_view<View>::struct_type& s) {
+    JsonObject root(buildJsonTreeFrom(s, marshal_view<View>::member_descriptors));
+
     JsonWriter writer;
     return writer.witeToJson(&root);
 }
 
 template<typename Struct>
-void unmarshalImpl(std::string_view json, Struct& s)  {
-    JsonReader reader(json);
+void unmarshalImpl(std::string_view json, Struct& s, std::pmr::memory_resource* resource, Omission omission)  {
+    JsonReader reader(json, resource, omission);
 
     JsonObject root(buildJsonTreeFrom(s));
     reader.readFromJson(&root);
 }
 
+template<typename Struct>
+void unmarshalImpl(std::string_view json, Struct& s, std::pmr::memory_resource* resource)  {
+    unmarshalImpl(json, s, resource, Omission::None);
+}
+
+template<typename Struct>
+void unmarshalImpl(std::string_view json, Struct& s)  {
+    unmarshalImpl(json, s, nullptr);
+}
+
 
 #define RAPIDJSON_UTIL_CHECK_MEMBERS_ARE_SERIALIZABLE(C, members) \
         RAPIDJSON_UTIL_STRIP_COMMAS(RAPIDJSON_UTIL_FOR_EACH(RAPIDJSON_UTIL_ASSERT_IS_SERIALIZABLE, C, RAPIDJSON_UTIL_UNPACK members))
@@ -404,6 +1563,7 @@ void unmarshalImpl(std::string_view json, Struct& s)  {
 
 #define RAPIDJSON_UTIL_DESCRIBE_MEMBERS_IMP(C, members)  template<> struct rapidjson_util::detail::Descriptor<C> {     \
      	static constexpr bool is_describable = true;                                                                   \
+        static constexpr auto name() noexcept { return RAPIDJSON_UTIL_STRINGIFY(C); }                                  \
         static constexpr auto member_descriptors = make_typelist(                                                      \
                        RAPIDJSON_UTIL_FOR_EACH(RAPIDJSON_UTIL_MEMBER_META, C, RAPIDJSON_UTIL_UNPACK members));         \
         };
@@ -418,10 +1578,74 @@ void unmarshalImpl(std::string_view json, Struct& s)  {
 }  // namespace detail
 }  // namespace rapidjson_util 
 
+// Members are checked after C is described, so that recursive structs can refer to
+// themselves through std::unique_ptr, std::shared_ptr or containers
 #define RAPIDJSON_UTIL_DESCRIBE_MEMBERS(C, members)                        \
         static_assert(std::is_class_v<C>);                                 \
-        RAPIDJSON_UTIL_CHECK_MEMBERS_ARE_SERIALIZABLE(C, members)          \
-        RAPIDJSON_UTIL_DESCRIBE_MEMBERS_IMP(C, members)
-        
-        
-#endif
\ No newline at end of file
+        RAPIDJSON_UTIL_DESCRIBE_MEMBERS_IMP(C, members)                    \
+        RAPIDJSON_UTIL_CHECK_MEMBERS_ARE_SERIALIZABLE(C, members)
+
+
+/**
+ * Leaves members of the described struct C out as omission, one of the Omission values, e.g.
+ * RAPIDJSON_UTIL_DESCRIBE_OMISSION(Quote, Defaults). It applies to every encoding that writes
+ * member names, and the readers of each restore the members that are missing.
+ */
+#define RAPIDJSON_UTIL_DESCRIBE_OMISSION(C, omission)                                                    \
+        static_assert(rapidjson_util::detail::is_describable_struct_v<C>,                                \
+                      "Only structs described by RAPIDJSON_UTIL_DESCRIBE_MEMBERS have an omission");     \
+        template<> struct rapidjson_util::member_omission<C> {                                           \
+            static constexpr Omission style = Omission::omission;                                        \
+        };
+
+
+/**
+ * Names members of the described struct C on the wire, listed as (member, "name"), e.g.
+ *
+ * RAPIDJSON_UTIL_DESCRIBE_WIRE_NAMES(Quote, (symbol, "s"), (price, "p"), (quantity, "q"))
+ *
+ * Members left out keep their own names. The names apply to every encoding that writes member
+ * names, and must be unique within C.
+ */
+#define RAPIDJSON_UTIL_DESCRIBE_WIRE_NAMES(C, ...)                                                       \
+        template<> struct rapidjson_util::wire_names<C> {                                                \
+            static constexpr bool is_described = true;                                                   \
+            static constexpr auto name_descriptors = rapidjson_util::detail::make_typelist(              \
+                       RAPIDJSON_UTIL_FOR_EACH_TUPLE(RAPIDJSON_UTIL_WIRE_NAME_META, C, __VA_ARGS__));   \
+        };                                                                                               \
+        static_assert(rapidjson_util::detail::areValidWireNames<C>(),                                    \
+                      "Wire names must name described members and be unique and not empty");
+
+
+/**
+ * Declares the view View over the described struct C, which lists the members written by
+ * marshal<View>, e.g. RAPIDJSON_UTIL_DESCRIBE_VIEW(Person, PublicPerson, (name, age)). View is
+ * declared as an incomplete struct in the enclosing namespace and only serves as a tag.
+ */
+#define RAPIDJSON_UTIL_DESCRIBE_VIEW(C, View, members)                                                   \
+        static_assert(rapidjson_util::detail::is_describable_struct_v<C>,                                \
+                      "Only structs described by RAPIDJSON_UTIL_DESCRIBE_MEMBERS have views");         \
+        struct View;                                                                                     \
+        template<> struct rapidjson_util::marshal_view<View> {                                           \
+            static constexpr bool is_described = true;                                                   \
+            using struct_type = C;                                                                       \
+            static constexpr auto member_descriptors = rapidjson_util::detail::make_typelist(            \
+                       RAPIDJSON_UTIL_FOR_EACH(RAPIDJSON_UTIL_MEMBER_META, C, RAPIDJSON_UTIL_UNPACK members)); \
+        };                                                                                               \
+        static_assert(rapidjson_util::detail::areValidViewMembers<View>(),                               \
+                      "View members must be described members of the struct, each listed once");
+
+
+#define RAPIDJSON_UTIL_WIRE_NAME_META(C, wireName) \
+        RAPIDJSON_UTIL_WIRE_NAME_APPLY(RAPIDJSON_UTIL_WIRE_NAME_META_I, (C, RAPIDJSON_UTIL_UNPACK wireName))
+
+#define RAPIDJSON_UTIL_WIRE_NAME_APPLY(macro, arguments) macro arguments
+
+#define RAPIDJSON_UTIL_WIRE_NAME_META_I(C, member, wireName)                                       \
+	[]{ struct rapidjsonUtilWireName {                                                             \
+             static constexpr auto pointer() noexcept { return &C::member; }                       \
+             static constexpr auto name() noexcept { return wireName; }                            \
+    }; return rapidjsonUtilWireName{}; }  ()
+
+
+#endif
@@ -0,0 +1,491 @@
+// Copyright (C) 2025 Liu Wu. All rights reserved.
+//
+// Licensed under the zlib License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/Zlib
+//
+// This software is provided as-is, without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+
+
+#ifndef __RAPIDJSON_UTIL_BINARY_H__
+#define __RAPIDJSON_UTIL_BINARY_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include "rapid_util_parser.h"
+
+// The SSSE3 kernels are built on x86 wherever the compiler can target SSSE3 for single
+// functions, and taken if the CPU supports it. Define RAPIDJSON_UTIL_BINARY_SSSE3 as 0 to
+// leave them out.
+#if !defined(RAPIDJSON_UTIL_BINARY_SSSE3)
+#if defined(__SSSE3__) || ((defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))) || \
+    (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#define RAPIDJSON_UTIL_BINARY_SSSE3 1
+#else
+#define RAPIDJSON_UTIL_BINARY_SSSE3 0
+#endif
+#endif
+
+#if RAPIDJSON_UTIL_BINARY_SSSE3
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <tmmintrin.h>
+#endif
+
+#if defined(__SSSE3__) || defined(_MSC_VER)
+#define RAPIDJSON_UTIL_BINARY_SSSE3_TARGET
+#else
+#define RAPIDJSON_UTIL_BINARY_SSSE3_TARGET __attribute__((target("ssse3")))
+#endif
+#endif
+
+namespace rapidjson_util {
+namespace detail {
+
+// Encoders and decoders of the BinaryEncoding values. The SSSE3 kernels process 12 bytes or
+// 16 base64 characters, and 16 bytes or 32 hex digits, per step; the scalar loops handle the
+// remainder, and everything on CPUs without SSSE3.
+
+constexpr char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr char hexDigits[] = "0123456789abcdef";
+
+// Maps every character to its 6-bit (base64) or 4-bit (hex) value, or to 0xff if it is invalid
+struct BinaryDecodingTable {
+    uint8_t base64[256];
+    uint8_t hex[256];
+
+    constexpr BinaryDecodingTable() : base64(), hex() {
+        for (int c = 0; c < 256; ++c) {
+            base64[c] = 0xff;
+            hex[c] = 0xff;
+        }
+
+        for (int i = 0; i < 64; ++i)
+            base64[static_cast<unsigned char>(base64Alphabet[i])] = static_cast<uint8_t>(i);
+
+        for (int i = 0; i < 10; ++i)
+            hex['0' + i] = static_cast<uint8_t>(i);
+
+        for (int i = 0; i < 6; ++i) {
+            hex['a' + i] = static_cast<uint8_t>(10 + i);
+            hex['A' + i] = static_cast<uint8_t>(10 + i);
+        }
+    }
+};
+
+constexpr BinaryDecodingTable binaryDecodingTable{};
+
+
+#if RAPIDJSON_UTIL_BINARY_SSSE3
+/**
+ * @return Whether the CPU supports SSSE3, known at compile time if it is enabled
+ */
+inline bool hasSsse3() noexcept {
+#if defined(__SSSE3__)
+    return true;
+#elif defined(_MSC_VER)
+    static const bool isSupported = [] {
+        int registers[4];
+        __cpuid(registers, 1);
+        return (registers[2] & (1 << 9)) != 0;
+    }();
+    return isSupported;
+#else
+    static const bool isSupported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("ssse3") != 0;
+    }();
+    return isSupported;
+#endif
+}
+
+/**
+ * Encodes data 12 bytes at a time, until fewer than 16 are left.
+ *
+ * @return Number of bytes encoded, out holds base64EncodedLength of them
+ */
+RAPIDJSON_UTIL_BINARY_SSSE3_TARGET
+inline std::size_t encodeBase64Ssse3(const uint8_t* data, std::size_t size, char* out) noexcept {
+    std::size_t i = 0;
+
+    // Each step loads 16 bytes and encodes the first 12 of them
+    for (; i + 16 <= size; i += 12, out += 16) {
+        __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+        // Spread every 3 bytes over 4 lanes of 6 bits, each in its own byte
+        input = _mm_shuffle_epi8(input, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        const __m128i shiftedRight = _mm_mulhi_epu16(_mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00)),
+                                                     _mm_set1_epi32(0x04000040));
+        const __m128i shiftedLeft = _mm_mullo_epi16(_mm_and_si128(input, _mm_set1_epi32(0x003f03f0)),
+                                                    _mm_set1_epi32(0x01000010));
+        const __m128i indices = _mm_or_si128(shiftedRight, shiftedLeft);
+
+        // Offset of the alphabet range of every index: 0..25 -> 'A', 26..51 -> 'a' - 26,
+        // 52..61 -> '0' - 52, 62 -> '+' - 62 and 63 -> '/' - 63
+        __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+
+        const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                              '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices));
+    }
+
+    return i;
+}
+
+/**
+ * Decodes base64 16 characters at a time, until fewer than 24 are left or a step holds an
+ * invalid character, which the scalar loop then locates.
+ *
+ * @return Number of characters decoded, out holds 3 bytes for every 4 of them
+ */
+RAPIDJSON_UTIL_BINARY_SSSE3_TARGET
+inline std::size_t decodeBase64Ssse3(const unsigned char* in, std::size_t length, uint8_t* out) noexcept {
+    std::size_t i = 0;
+
+    // Each step stores 16 bytes of which 12 are decoded, so it stops 8 characters early. That
+    // keeps the stores inside out and the padding of the last quantum out of the vector path.
+    for (; i + 24 <= length; i += 16, out += 12) {
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i higherNibbles = _mm_and_si128(_mm_srli_epi32(input, 4), _mm_set1_epi8(0x0f));
+        const __m128i lowerNibbles = _mm_and_si128(input, _mm_set1_epi8(0x0f));
+
+        // A character is valid if the bit of its higher nibble is set in the mask of its lower nibble
+        const __m128i validHigherNibbles = _mm_setr_epi8(
+            char(0xa8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8),
+            char(0xf8), char(0xf8), char(0xf0), char(0x54), char(0x50), char(0x50), char(0x50), char(0x54));
+        const __m128i higherNibbleBits = _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, char(0x80),
+                                                       0, 0, 0, 0, 0, 0, 0, 0);
+
+        const __m128i matches = _mm_and_si128(_mm_shuffle_epi8(validHigherNibbles, lowerNibbles),
+                                              _mm_shuffle_epi8(higherNibbleBits, higherNibbles));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(matches, _mm_setzero_si128())) != 0)
+            break;
+
+        // Map the characters to their 6-bit values by the offset of their range, '/' shares its
+        // higher nibble with '+' and is fixed up separately
+        const __m128i rangeOffsets = _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m128i isSlash = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+        const __m128i offsets = _mm_or_si128(_mm_andnot_si128(isSlash, _mm_shuffle_epi8(rangeOffsets, higherNibbles)),
+                                             _mm_and_si128(isSlash, _mm_set1_epi8(16)));
+        const __m128i values = _mm_add_epi8(input, offsets);
+
+        // Join 4 values of 6 bits into 3 bytes per 32-bit lane, then pack the lanes together
+        const __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        const __m128i triples = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        const __m128i packed = _mm_shuffle_epi8(triples, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+    }
+
+    return i;
+}
+
+/**
+ * Encodes data 16 bytes at a time, until fewer than 16 are left.
+ *
+ * @return Number of bytes encoded, out holds 2 digits for every one of them
+ */
+RAPIDJSON_UTIL_BINARY_SSSE3_TARGET
+inline std::size_t encodeHexSsse3(const uint8_t* data, std::size_t size, char* out) noexcept {
+    const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hexDigits));
+    std::size_t i = 0;
+
+    for (; i + 16 <= size; i += 16, out += 32) {
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i higher = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(input, 4), _mm_set1_epi8(0x0f)));
+        const __m128i lower = _mm_shuffle_epi8(digits, _mm_and_si128(input, _mm_set1_epi8(0x0f)));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(higher, lower));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(higher, lower));
+    }
+
+    return i;
+}
+
+// Maps 16 hex digits of either case to their 4-bit values, and sets validMask to the mask of
+// the characters that are digits
+RAPIDJSON_UTIL_BINARY_SSSE3_TARGET
+inline __m128i hexValuesSsse3(__m128i input, int& validMask) noexcept {
+    // Characters from 0x80 up are negative, so they fall outside both ranges
+    const __m128i isDecimal = _mm_and_si128(_mm_cmpgt_epi8(input, _mm_set1_epi8('0' - 1)),
+                                            _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), input));
+    const __m128i lowercase = _mm_or_si128(input, _mm_set1_epi8(0x20));
+    const __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(lowercase, _mm_set1_epi8('a' - 1)),
+                                           _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), lowercase));
+
+    validMask = _mm_movemask_epi8(_mm_or_si128(isDecimal, isLetter));
+
+    return _mm_or_si128(_mm_and_si128(isDecimal, _mm_sub_epi8(input, _mm_set1_epi8('0'))),
+                        _mm_andnot_si128(isDecimal, _mm_sub_epi8(lowercase, _mm_set1_epi8('a' - 10))));
+}
+
+/**
+ * Decodes hex 32 digits at a time, until fewer than 32 are left or a step holds an invalid
+ * digit, which the scalar loop then locates.
+ *
+ * @return Number of digits decoded, out holds a byte for every 2 of them
+ */
+RAPIDJSON_UTIL_BINARY_SSSE3_TARGET
+inline std::size_t decodeHexSsse3(const unsigned char* in, std::size_t length, uint8_t* out) noexcept {
+    std::size_t i = 0;
+
+    for (; i + 32 <= length; i += 32, out += 16) {
+        int firstValid, secondValid;
+        const __m128i first = hexValuesSsse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), firstValid);
+        const __m128i second = hexValuesSsse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 16)), secondValid);
+
+        if ((firstValid & secondValid) != 0xffff)
+            break;
+
+        // Join every pair of values into a byte, the higher nibble first
+        const __m128i weights = _mm_set1_epi16(0x0110);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                         _mm_packus_epi16(_mm_maddubs_epi16(first, weights), _mm_maddubs_epi16(second, weights)));
+    }
+
+    return i;
+}
+#endif
+
+
+constexpr std::size_t base64EncodedLength(std::size_t size) noexcept {
+    return (size + 2) / 3 * 4;
+}
+
+/**
+ * @brief Writes the base64 encoding of size bytes at data to out, which must hold
+ *        base64EncodedLength(size) characters
+ */
+inline void encodeBase64(const uint8_t* data, std::size_t size, char* out) noexcept {
+    std::size_t i = 0;
+
+#if RAPIDJSON_UTIL_BINARY_SSSE3
+    if (hasSsse3()) {
+        i = encodeBase64Ssse3(data, size, out);
+        out += base64EncodedLength(i);
+    }
+#endif
+
+    for (; i + 3 <= size; i += 3, out += 4) {
+        const uint32_t triple = uint32_t(data[i]) << 16 | uint32_t(data[i + 1]) << 8 | data[i + 2];
+
+        out[0] = base64Alphabet[triple >> 18];
+        out[1] = base64Alphabet[triple >> 12 & 0x3f];
+        out[2] = base64Alphabet[triple >> 6 & 0x3f];
+        out[3] = base64Alphabet[triple & 0x3f];
+    }
+
+    if (i < size) {
+        const uint32_t triple = uint32_t(data[i]) << 16 | (i + 1 < size ? uint32_t(data[i + 1]) << 8 : 0);
+
+        out[0] = base64Alphabet[triple >> 18];
+        out[1] = base64Alphabet[triple >> 12 & 0x3f];
+        out[2] = i + 1 < size ? base64Alphabet[triple >> 6 & 0x3f] : '=';
+        out[3] = '=';
+    }
+}
+
+/**
+ * @return Number of bytes text decodes to, or SIZE_MAX if its length is not a multiple of 4
+ */
+inline std::size_t base64DecodedLength(std::string_view text) noexcept {
+    if (text.size() % 4 != 0)
+        return SIZE_MAX;
+
+    std::size_t padding = 0;
+    if (!text.empty())
+        padding = (text.back() == '=') + (text.size() > 1 && text[text.size() - 2] == '=');
+
+    return text.size() / 4 * 3 - padding;
+}
+
+/**
+ * @brief Decodes the padded base64 text into out, which must hold base64DecodedLength(text) bytes
+ *
+ * @return Offset of the first invalid character, or SIZE_MAX if text is valid
+ */
+inline std::size_t decodeBase64(std::string_view text, uint8_t* out) noexcept {
+    const auto* in = reinterpret_cast<const unsigned char*>(text.data());
+    const std::size_t length = text.size();
+    std::size_t i = 0;
+
+#if RAPIDJSON_UTIL_BINARY_SSSE3
+    if (hasSsse3()) {
+        i = decodeBase64Ssse3(in, length, out);
+        out += i / 4 * 3;
+    }
+#endif
+
+    const auto& table = binaryDecodingTable.base64;
+
+    for (; i < length; i += 4) {
+        const bool isLast = i + 4 == length;
+        const bool hasPadding2 = isLast && in[i + 3] == '=';
+        const bool hasPadding1 = hasPadding2 && in[i + 2] == '=';
+
+        const uint8_t a = table[in[i]], b = table[in[i + 1]];
+        const uint8_t c = hasPadding1 ? 0 : table[in[i + 2]];
+        const uint8_t d = hasPadding2 ? 0 : table[in[i + 3]];
+
+        if ((a | b | c | d) == 0xff) {
+            for (std::size_t j = i; ; ++j)
+                if (table[in[j]] == 0xff)
+                    return j;
+        }
+
+        const uint32_t triple = uint32_t(a) << 18 | uint32_t(b) << 12 | uint32_t(c) << 6 | d;
+
+        *out++ = static_cast<uint8_t>(triple >> 16);
+        if (!hasPadding1)
+            *out++ = static_cast<uint8_t>(triple >> 8);
+        if (!hasPadding2)
+            *out++ = static_cast<uint8_t>(triple);
+    }
+
+    return SIZE_MAX;
+}
+
+
+/**
+ * @brief Writes the lowercase hex encoding of size bytes at data to out, which must hold
+ *        2 * size characters
+ */
+inline void encodeHex(const uint8_t* data, std::size_t size, char* out) noexcept {
+    std::size_t i = 0;
+
+#if RAPIDJSON_UTIL_BINARY_SSSE3
+    if (hasSsse3()) {
+        i = encodeHexSsse3(data, size, out);
+        out += 2 * i;
+    }
+#endif
+
+    for (; i < size; ++i, out += 2) {
+        out[0] = hexDigits[data[i] >> 4];
+        out[1] = hexDigits[data[i] & 0x0f];
+    }
+}
+
+/**
+ * @brief Decodes the hex text, whose length must be even, into out, which must hold
+ *        text.size() / 2 bytes
+ *
+ * @return Offset of the first invalid character, or SIZE_MAX if text is valid
+ */
+inline std::size_t decodeHex(std::string_view text, uint8_t* out) noexcept {
+    const auto* in = reinterpret_cast<const unsigned char*>(text.data());
+    const auto& table = binaryDecodingTable.hex;
+    std::size_t i = 0;
+
+#if RAPIDJSON_UTIL_BINARY_SSSE3
+    if (hasSsse3()) {
+        i = decodeHexSsse3(in, text.size(), out);
+        out += i / 2;
+    }
+#endif
+
+    for (; i < text.size(); i += 2) {
+        const uint8_t higher = table[in[i]], lower = table[in[i + 1]];
+
+        if ((higher | lower) == 0xff)
+            return table[in[i]] == 0xff ? i : i + 1;
+
+        *out++ = static_cast<uint8_t>(higher << 4 | lower);
+    }
+
+    return SIZE_MAX;
+}
+
+
+/**
+ * @brief Encodes and decodes a byte buffer as a JSON string in its BinaryEncoding
+ *
+ * Encoding writes straight into a string allocated by the document, decoding writes straight
+ * into the buffer, after sizing it once.
+ */
+template<typename Bytes>
+struct binary_codec {
+    static constexpr BinaryEncoding encoding = binary_traits<Bytes>::encoding;
+    static constexpr const char* name = encoding == BinaryEncoding::Base64 ? "base64" : "hex";
+
+    static void encode(const void* value, rapidjson::Value& jsonOutput, rapidjson::Document::AllocatorType& allocator) {
+        const Bytes& bytes = *static_cast<const Bytes*>(value);
+        const auto* data = reinterpret_cast<const uint8_t*>(bytes.data());
+
+        const std::size_t length = encoding == BinaryEncoding::Base64 ? base64EncodedLength(bytes.size()) : 2 * bytes.size();
+        char* text = static_cast<char*>(allocator.Malloc(length + 1));
+
+        if constexpr (encoding == BinaryEncoding::Base64)
+            encodeBase64(data, bytes.size(), text);
+        else
+            encodeHex(data, bytes.size(), text);
+
+        text[length] = '\0';
+        jsonOutput.SetString(text, static_cast<rapidjson::SizeType>(length));
+    }
+
+    static void decode(void* value, const rapidjson::Value& jsonInput) {
+        RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsString);
+
+        std::string_view text(jsonInput.GetString(), jsonInput.GetStringLength());
+
+        const std::size_t length = encoding == BinaryEncoding::Base64 ? base64DecodedLength(text) :
+                                                                        (text.size() % 2 == 0 ? text.size() / 2 : SIZE_MAX);
+        if (length == SIZE_MAX)
+            throw TypeMismatchException(std::string("Expected ") + name + " string, got " + std::to_string(text.size()) +
+                                        " characters");
+
+        // Invalid text leaves the target as it was: bytes it holds are only replaced once the
+        // text decoded, and an empty target is emptied again
+        Bytes& target = *static_cast<Bytes*>(value);
+        Bytes scratch;
+        Bytes& bytes = target.empty() ? target : scratch;
+
+        bytes.resize(length);
+        auto* out = reinterpret_cast<uint8_t*>(bytes.data());
+
+        // The message names the invalid character, so it can only be built once there is one
+        std::size_t invalidOffset = encoding == BinaryEncoding::Base64 ? decodeBase64(text, out) : decodeHex(text, out);
+        if (invalidOffset != SIZE_MAX) {
+            bytes.clear();
+            throw TypeMismatchException(std::string("Expected ") + name + " string, got '" + text[invalidOffset] +
+                                        "' at offset " + std::to_string(invalidOffset));
+        }
+
+        if (&bytes == &scratch)
+            target.swap(scratch);
+    }
+
+    // MessagePack and CBOR write the bytes as their native byte strings instead
+    static std::pair<const uint8_t*, std::size_t> bytes(const void* value) {
+        const Bytes& bytes = *static_cast<const Bytes*>(value);
+
+        return { reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size() };
+    }
+
+    static void assignBytes(void* value, const uint8_t* data, std::size_t size) {
+        Bytes& bytes = *static_cast<Bytes*>(value);
+
+        bytes.resize(size);
+        if (size != 0)
+            std::memcpy(bytes.data(), data, size);
+    }
+
+    static constexpr JsonCustomValue::NativeAccess native() {
+        return { &bytes, &assignBytes };
+    }
+};
+
+}  // namespace detail
+}  // namespace rapidjson_util
+
+#endif
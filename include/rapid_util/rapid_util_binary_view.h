@@ -0,0 +1,1078 @@
+// Copyright (C) 2025 Liu Wu. All rights reserved.
+//
+// Licensed under the zlib License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/Zlib
+//
+// This software is provided as-is, without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+
+
+#ifndef __RAPIDJSON_UTIL_BINARY_VIEW_H__
+#define __RAPIDJSON_UTIL_BINARY_VIEW_H__
+
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include "rapid_util.h"
+#include "rapid_util_typed_array.h"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace rapidjson_util {
+
+class InvalidBinaryException : public std::logic_error {
+public:
+    InvalidBinaryException(std::string_view what);
+};
+
+
+/**
+ * @brief Serialize a C++ struct to the compact binary format
+ *
+ * The format is laid out from the members described by RAPIDJSON_UTIL_DESCRIBE_MEMBERS, so that
+ * binary_view can read it in place:
+ *   - a 24-byte header: the magic "RJUB", a 16-bit version, 16 reserved bits, the 64-bit
+ *     binary_fingerprint of Struct and the 64-bit size of the data
+ *   - the record of Struct, followed by the variable-size data the record refers to
+ *
+ * A record holds the members in declaration order, each at a fixed offset aligned to its size.
+ * Numbers, bools and std::chrono values are stored in place, as are nested structs and
+ * std::array. Strings, resizable containers and nullable members hold a reference instead, a
+ * 64-bit offset from the start of the data and a 64-bit count of characters or elements, which
+ * follow each other at that offset; a null member has a count of 0. All numbers are little-endian.
+ *
+ * Variants, tuples, views and members encoded by a json_codec aren't supported.
+ *
+ * @param s The struct instance to serialize
+ * @param buffer Receives the encoded bytes, its previous content is discarded but its capacity
+ *               is reused
+ */
+template<typename Struct>
+void marshal_binary(const Struct& s, std::vector<uint8_t>& buffer);
+
+/**
+ * @brief Serialize a C++ struct to the compact binary format
+ *
+ * @return The encoded bytes
+ */
+template<typename Struct>
+std::vector<uint8_t> marshal_binary(const Struct& s);
+
+/**
+ * @brief Deserialize data in the compact binary format to populate a C++ struct
+ *
+ * Use binary_view instead to read members in place, without decoding the whole struct.
+ *
+ * @param data The binary data, aligned to 8 bytes
+ * @param size Number of bytes in data
+ * @param s The struct instance to populate
+ * @throws InvalidBinaryException if data wasn't written for the members of Struct, or is
+ *         truncated or malformed
+ */
+template<typename Struct>
+void unmarshal_binary(const uint8_t* data, std::size_t size, Struct& s);
+
+template<typename Struct>
+void unmarshal_binary(const std::vector<uint8_t>& data, Struct& s);
+
+/**
+ * @brief The schema fingerprint written to the header of the binary data of Struct
+ *
+ * It hashes the names, types and order of the members of Struct and of everything it contains,
+ * so data written for any other layout is rejected rather than misread.
+ */
+template<typename Struct>
+uint64_t binary_fingerprint();
+
+
+template<typename Struct>
+class binary_record;
+
+template<typename Element>
+class binary_array;
+
+
+namespace detail {
+
+enum class BinaryKind {
+    Scalar,
+    Chrono,
+    String,
+    Record,
+    FixedArray,
+    Sequence,
+    Nullable,
+    Unsupported
+};
+
+template<typename T>
+constexpr BinaryKind binaryKindOf() {
+    using Type = std::remove_const_t<T>;
+
+    if constexpr (has_json_codec_v<Type>)
+        return BinaryKind::Unsupported;
+    else if constexpr (is_nullable_wrapper_v<Type>)
+        return BinaryKind::Nullable;
+    else if constexpr ((std::is_arithmetic_v<Type> && is_json_primitive_core_type_v<Type>) || std::is_same_v<Type, std::byte>)
+        return BinaryKind::Scalar;
+    else if constexpr (is_json_chrono_v<Type>)
+        return BinaryKind::Chrono;
+    else if constexpr (std::is_same_v<Type, std::string> || std::is_same_v<Type, std::pmr::string> ||
+                       is_json_inline_string_v<Type>)
+        return BinaryKind::String;
+    else if constexpr (is_describable_struct_v<Type>)
+        return BinaryKind::Record;
+    else if constexpr (is_std_array_v<Type>)
+        return BinaryKind::FixedArray;
+    else if constexpr (is_resizable_sequence_container<Type>::value)
+        return BinaryKind::Sequence;
+    else
+        return BinaryKind::Unsupported;
+}
+
+// Elements stored exactly as in memory on little-endian hosts, so that arrays of them are copied at once
+template<typename T>
+constexpr bool is_binary_plain_v = is_json_number_v<T> || std::is_same_v<T, std::byte>;
+
+// The number type std::chrono values are stored as, the ticks of their own duration
+template<typename Chrono>
+using binary_chrono_rep_t = std::conditional_t<std::is_integral_v<typename chrono_duration_of<Chrono>::type::rep>,
+                                               fixed_width_integer_t<typename chrono_duration_of<Chrono>::type::rep>,
+                                               typename chrono_duration_of<Chrono>::type::rep>;
+
+constexpr std::size_t binaryHeaderSize = 24;
+constexpr std::size_t binaryReferenceSize = 16;
+constexpr uint16_t binaryFormatVersion = 1;
+constexpr std::size_t maxBinaryNestingDepth = 1024;
+
+constexpr std::size_t alignBinaryOffset(std::size_t offset, std::size_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+template<typename T>
+constexpr std::size_t binarySizeOf();
+
+template<typename T>
+constexpr std::size_t binaryAlignOf();
+
+template<std::size_t MemberCount>
+struct BinaryRecordLayout {
+    std::array<std::size_t, MemberCount> offsets{};
+    std::size_t size = 0;
+    std::size_t alignment = 1;
+};
+
+// Records are never empty, so that every element of a container takes at least a byte
+template<typename... MemberDescriptors>
+constexpr auto computeBinaryRecordLayout(TypeList<MemberDescriptors...>) {
+    constexpr std::size_t sizes[] = { binarySizeOf<member_type_t<decltype(MemberDescriptors::pointer())>>()..., 0 };
+    constexpr std::size_t alignments[] = { binaryAlignOf<member_type_t<decltype(MemberDescriptors::pointer())>>()..., 1 };
+
+    BinaryRecordLayout<sizeof...(MemberDescriptors)> layout;
+    for (std::size_t i = 0; i < sizeof...(MemberDescriptors); ++i) {
+        layout.offsets[i] = alignBinaryOffset(layout.size, alignments[i]);
+        layout.size = layout.offsets[i] + sizes[i];
+        layout.alignment = alignments[i] > layout.alignment ? alignments[i] : layout.alignment;
+    }
+
+    layout.size = alignBinaryOffset(layout.size == 0 ? 1 : layout.size, layout.alignment);
+    return layout;
+}
+
+template<typename Struct>
+constexpr auto binary_record_layout_v = computeBinaryRecordLayout(Descriptor<Struct>::member_descriptors);
+
+template<typename T>
+constexpr std::size_t binarySizeOf() {
+    using Type = std::remove_const_t<T>;
+    constexpr BinaryKind kind = binaryKindOf<Type>();
+    static_assert(kind != BinaryKind::Unsupported,
+                  "Variants, tuples, views and members with codecs aren't supported by the compact binary format");
+
+    if constexpr (kind == BinaryKind::Scalar)          return sizeof(Type);
+    else if constexpr (kind == BinaryKind::Chrono)     return sizeof(binary_chrono_rep_t<Type>);
+    else if constexpr (kind == BinaryKind::Record)     return binary_record_layout_v<Type>.size;
+    else if constexpr (kind == BinaryKind::FixedArray) return std::tuple_size_v<Type> * binarySizeOf<typename Type::value_type>();
+    else                                               return binaryReferenceSize;
+}
+
+template<typename T>
+constexpr std::size_t binaryAlignOf() {
+    using Type = std::remove_const_t<T>;
+    constexpr BinaryKind kind = binaryKindOf<Type>();
+
+    if constexpr (kind == BinaryKind::Scalar || kind == BinaryKind::Chrono) return binarySizeOf<Type>();
+    else if constexpr (kind == BinaryKind::Record)                          return binary_record_layout_v<Type>.alignment;
+    else if constexpr (kind == BinaryKind::FixedArray)                      return binaryAlignOf<typename Type::value_type>();
+    else                                                                    return 8;
+}
+
+// Its address identifies T among the structs appendBinarySchema is describing
+template<typename T>
+inline constexpr char binary_schema_tag = 0;
+
+/**
+ * Appends the canonical description of T hashed by binary_fingerprint, e.g. {id:u32,tags:[]s}.
+ * Structs already being described are referred to by how many levels up they are, e.g. ^1, so
+ * that recursive structs have a finite schema.
+ */
+template<typename T>
+void appendBinarySchema(std::string& schema, std::vector<const void*>& openStructs) {
+    using Type = std::remove_const_t<T>;
+    constexpr BinaryKind kind = binaryKindOf<Type>();
+
+    if constexpr (kind == BinaryKind::Scalar) {
+        if constexpr (std::is_same_v<Type, bool>)
+            schema += "b";
+        else if constexpr (std::is_same_v<Type, std::byte>)
+            schema += "y";
+        else
+            schema += (std::is_floating_point_v<Type> ? "f" : std::is_signed_v<Type> ? "i" : "u") + std::to_string(sizeof(Type) * 8);
+    }
+    else if constexpr (kind == BinaryKind::Chrono) {
+        using Period = typename chrono_duration_of<Type>::type::period;
+
+        schema += is_chrono_time_point_v<Type> ? "t(" : "d(";
+        appendBinarySchema<binary_chrono_rep_t<Type>>(schema, openStructs);
+        schema += "*" + std::to_string(Period::num) + "/" + std::to_string(Period::den) + ")";
+    }
+    else if constexpr (kind == BinaryKind::String)
+        schema += "s";
+    else if constexpr (kind == BinaryKind::Record) {
+        const void* tag = &binary_schema_tag<Type>;
+
+        for (std::size_t level = 0; level < openStructs.size(); ++level) {
+            if (openStructs[openStructs.size() - 1 - level] == tag) {
+                schema += "^" + std::to_string(level);
+                return;
+            }
+        }
+
+        openStructs.push_back(tag);
+        schema += "{";
+
+        bool isFirst = true;
+        for_each(Descriptor<Type>::member_descriptors, [&schema, &openStructs, &isFirst](auto descriptor) {
+                     schema += isFirst ? "" : ",";
+                     schema += descriptor.name();
+                     schema += ":";
+                     appendBinarySchema<member_type_t<decltype(descriptor.pointer())>>(schema, openStructs);
+                     isFirst = false;
+                 });
+
+        schema += "}";
+        openStructs.pop_back();
+    }
+    else if constexpr (kind == BinaryKind::FixedArray) {
+        schema += "[" + std::to_string(std::tuple_size_v<Type>) + "]";
+        appendBinarySchema<typename Type::value_type>(schema, openStructs);
+    }
+    else if constexpr (kind == BinaryKind::Sequence) {
+        schema += "[]";
+        appendBinarySchema<typename Type::value_type>(schema, openStructs);
+    }
+    else {
+        schema += "?";
+        appendBinarySchema<remove_nullable_wrapper_t<Type>>(schema, openStructs);
+    }
+}
+
+// 64-bit FNV-1a
+inline uint64_t hashBinarySchema(std::string_view schema) {
+    uint64_t hash = 14695981039346656037ull;
+
+    for (char c : schema) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+
+/**
+ * @brief Writes the compact binary format
+ *
+ * Every value is written into the slot its parent reserved for it, at an offset into the buffer
+ * rather than a pointer, as the buffer grows while the variable-size data is appended. Padding
+ * is zeroed, so the same struct always produces the same bytes.
+ */
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::vector<uint8_t>& buffer);
+
+    template<typename Struct>
+    void writeRoot(const Struct& s);
+
+private:
+    template<typename T>
+    void write(std::size_t at, const T& value);
+
+    template<typename Scalar>
+    void writeScalar(std::size_t at, Scalar value);
+
+    void writeReference(std::size_t at, std::size_t offset, std::size_t count);
+    std::size_t allocate(std::size_t size, std::size_t alignment);
+
+    std::vector<uint8_t>& buffer;
+};
+
+
+/**
+ * @brief Checks and follows the references of the compact binary format
+ *
+ * References may only point forward, past the slot holding them, so that malformed data can't
+ * make readers loop. Their elements must lie within the data and be aligned to their size, which
+ * lets binary_array hand out pointers to numbers in place. They may still overlap each other,
+ * which readers that decode everything have to guard against.
+ */
+struct BinaryData {
+    const uint8_t* data;
+    std::size_t size;
+
+    struct Reference {
+        std::size_t offset;
+        std::size_t count;
+    };
+
+    Reference readReference(std::size_t at, std::size_t elementSize, std::size_t elementAlignment) const;
+
+    template<typename Scalar>
+    Scalar readScalar(std::size_t at) const;
+
+    template<typename Struct>
+    void validateHeader() const;
+};
+
+
+/**
+ * @brief Decodes the compact binary format into C++ objects
+ *
+ * Follows the references of the data, with nesting limited to maxBinaryNestingDepth, as only
+ * recursive structs can nest as deeply as the data says. The data written by marshal_binary
+ * refers to every byte at most once, so the bytes of all references followed are charged
+ * against the size of the data; references that alias each other to decode the same bytes
+ * over and over run out of it. Containers are resized to counts checked this way, so the
+ * strings and elements decoded never take more bytes than the data has.
+ */
+class BinaryReader {
+public:
+    explicit BinaryReader(BinaryData data);
+
+    template<typename T>
+    void read(std::size_t at, T& value, std::size_t depth);
+
+private:
+    void charge(std::size_t at, std::size_t bytes);
+
+    BinaryData data;
+    std::size_t budget;
+};
+
+
+/**
+ * @brief Reads a value of type T in place from the slot at offset at, as binary_record::get does
+ *
+ * Numbers, bools and std::chrono values are returned by value, strings as std::string_view,
+ * structs as binary_record, std::array and resizable containers as binary_array and nullable
+ * members as std::optional of any of these.
+ */
+template<typename T>
+struct binary_access {
+    using Type = std::remove_const_t<T>;
+    static constexpr BinaryKind kind = binaryKindOf<Type>();
+
+    static auto get(const BinaryData& data, std::size_t at) {
+        if constexpr (kind == BinaryKind::Scalar)
+            return data.readScalar<Type>(at);
+        else if constexpr (kind == BinaryKind::Chrono) {
+            typename chrono_duration_of<Type>::type duration(data.readScalar<binary_chrono_rep_t<Type>>(at));
+
+            if constexpr (is_chrono_time_point_v<Type>)
+                return Type(duration);
+            else
+                return duration;
+        }
+        else if constexpr (kind == BinaryKind::String) {
+            auto reference = data.readReference(at, 1, 1);
+            return std::string_view(reinterpret_cast<const char*>(data.data + reference.offset), reference.count);
+        }
+        else if constexpr (kind == BinaryKind::Record)
+            return binary_record<Type>(data, at);
+        else if constexpr (kind == BinaryKind::FixedArray)
+            return binary_array<typename Type::value_type>(data, at, std::tuple_size_v<Type>);
+        else if constexpr (kind == BinaryKind::Sequence) {
+            using Element = typename Type::value_type;
+
+            auto reference = data.readReference(at, binarySizeOf<Element>(), binaryAlignOf<Element>());
+            return binary_array<Element>(data, reference.offset, reference.count);
+        }
+        else {
+            using Element = remove_nullable_wrapper_t<Type>;
+            using Result = std::optional<decltype(binary_access<Element>::get(data, at))>;
+
+            auto reference = data.readReference(at, binarySizeOf<Element>(), binaryAlignOf<Element>());
+            if (reference.count > 1)
+                throw InvalidBinaryException("Nullable member at offset " + std::to_string(at) + " holds " +
+                                             std::to_string(reference.count) + " values");
+
+            return reference.count == 0 ? Result() : Result(binary_access<Element>::get(data, reference.offset));
+        }
+    }
+};
+
+
+/**
+ * @brief A file mapped read-only into memory, or nothing once moved from
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path);
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    const uint8_t* data() const { return address; }
+    std::size_t size() const { return length; }
+
+private:
+    void unmap();
+
+    const uint8_t* address = nullptr;
+    std::size_t length = 0;
+};
+
+}  // namespace detail
+
+
+/**
+ * @brief A struct record in the compact binary format, whose members are read in place
+ *
+ * @code
+ * auto view = rapidjson_util::binary_view<Snapshot>::open("snapshot.bin");
+ * uint32_t version = view.get<&Snapshot::version>();
+ * std::string_view name = view.get<&Snapshot::owner>().get<&Owner::name>();
+ * @endcode
+ */
+template<typename Struct>
+class binary_record {
+public:
+    binary_record(const detail::BinaryData& data, std::size_t offset);
+
+    /**
+     * @brief Reads a member in place, see detail::binary_access for the type returned
+     *
+     * @throws InvalidBinaryException if the member refers outside the data
+     */
+    template<auto Member>
+    auto get() const;
+
+    /**
+     * @brief Decodes the whole record, as unmarshal_binary does for the root record
+     */
+    void decode(Struct& s) const;
+
+private:
+    detail::BinaryData data;
+    std::size_t offset;
+};
+
+
+/**
+ * @brief The elements of a std::array or resizable container in the compact binary format
+ *
+ * Elements are read in place as binary_record::get reads members. Arrays of numbers and
+ * std::byte also expose them as a pointer into the data.
+ */
+template<typename Element>
+class binary_array {
+public:
+    using value_type = decltype(detail::binary_access<Element>::get(std::declval<const detail::BinaryData&>(), 0));
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = typename binary_array::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        iterator(const binary_array* array, std::size_t index) : array(array), index(index) {}
+
+        value_type operator*() const { return (*array)[index]; }
+        iterator& operator++() { ++index; return *this; }
+        bool operator==(const iterator& other) const { return index == other.index; }
+        bool operator!=(const iterator& other) const { return index != other.index; }
+
+    private:
+        const binary_array* array;
+        std::size_t index;
+    };
+
+    binary_array(const detail::BinaryData& data, std::size_t offset, std::size_t count);
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    value_type operator[](std::size_t index) const;
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, count); }
+
+    /**
+     * @return The numbers in place, which are aligned to their size
+     */
+    template<typename Number = Element, typename = std::enable_if_t<detail::is_binary_plain_v<Number>>>
+    const Number* data() const {
+        return reinterpret_cast<const Number*>(binaryData.data + offset);
+    }
+
+private:
+    detail::BinaryData binaryData;
+    std::size_t offset;
+    std::size_t count;
+};
+
+
+/**
+ * @brief Reads the members of a struct in the compact binary format in place, from a file
+ *        mapped into memory or from data kept alive by the caller
+ *
+ * Nothing is decoded up front: the header is checked against the schema fingerprint of Struct
+ * and every member is read when it is accessed, so only the pages touched are loaded.
+ */
+template<typename Struct>
+class binary_view {
+public:
+    /**
+     * @param data The binary data, aligned to 8 bytes, which must outlive the view
+     * @throws InvalidBinaryException if data wasn't written for the members of Struct
+     */
+    binary_view(const uint8_t* data, std::size_t size);
+
+    /**
+     * @brief Maps the file at path read-only into memory
+     *
+     * @throws std::system_error if the file can't be mapped, InvalidBinaryException if it
+     *         wasn't written for the members of Struct
+     */
+    static binary_view open(const std::string& path);
+
+    template<auto Member>
+    auto get() const {
+        return root().template get<Member>();
+    }
+
+    binary_record<Struct> root() const {
+        return binary_record<Struct>(data, detail::binaryHeaderSize);
+    }
+
+    void decode(Struct& s) const {
+        root().decode(s);
+    }
+
+private:
+    explicit binary_view(detail::MappedFile&& file);
+
+    detail::MappedFile file;
+    detail::BinaryData data;
+};
+
+
+namespace detail {
+
+inline BinaryWriter::BinaryWriter(std::vector<uint8_t>& _buffer) : buffer(_buffer) {
+}
+
+inline std::size_t BinaryWriter::allocate(std::size_t size, std::size_t alignment) {
+    std::size_t offset = alignBinaryOffset(buffer.size(), alignment);
+    buffer.resize(offset + size);
+
+    return offset;
+}
+
+template<typename Scalar>
+void BinaryWriter::writeScalar(std::size_t at, Scalar value) {
+    copyLittleEndian<Scalar>(&value, buffer.data() + at, 1);
+}
+
+inline void BinaryWriter::writeReference(std::size_t at, std::size_t offset, std::size_t count) {
+    writeScalar(at, static_cast<uint64_t>(offset));
+    writeScalar(at + 8, static_cast<uint64_t>(count));
+}
+
+template<typename Struct>
+void BinaryWriter::writeRoot(const Struct& s) {
+    static const uint64_t fingerprint = binary_fingerprint<Struct>();
+
+    allocate(binaryHeaderSize, 8);
+    std::memcpy(buffer.data(), "RJUB", 4);
+    writeScalar(4, binaryFormatVersion);
+    writeScalar(8, fingerprint);
+
+    write(allocate(binarySizeOf<Struct>(), binaryAlignOf<Struct>()), s);
+
+    writeScalar(16, static_cast<uint64_t>(buffer.size()));
+}
+
+template<typename T>
+void BinaryWriter::write(std::size_t at, const T& value) {
+    constexpr BinaryKind kind = binaryKindOf<T>();
+
+    if constexpr (kind == BinaryKind::Scalar) {
+        if constexpr (std::is_same_v<T, bool>)
+            buffer[at] = value ? 1 : 0;
+        else
+            writeScalar(at, value);
+    }
+    else if constexpr (kind == BinaryKind::Chrono) {
+        if constexpr (is_chrono_time_point_v<T>)
+            writeScalar(at, static_cast<binary_chrono_rep_t<T>>(value.time_since_epoch().count()));
+        else
+            writeScalar(at, static_cast<binary_chrono_rep_t<T>>(value.count()));
+    }
+    else if constexpr (kind == BinaryKind::String) {
+        std::string_view str;
+        if constexpr (is_json_inline_string_v<T>)
+            str = inline_string_traits<T>::view(&value);
+        else
+            str = value;
+
+        std::size_t offset = allocate(str.length(), 1);
+        if (!str.empty())
+            std::memcpy(buffer.data() + offset, str.data(), str.length());
+        writeReference(at, offset, str.length());
+    }
+    else if constexpr (kind == BinaryKind::Record) {
+        std::size_t index = 0;
+
+        for_each(Descriptor<T>::member_descriptors, [this, at, &value, &index](auto descriptor) {
+                     write(at + binary_record_layout_v<T>.offsets[index++], value.*(descriptor.pointer()));
+                 });
+    }
+    else if constexpr (kind == BinaryKind::FixedArray) {
+        using Element = typename T::value_type;
+
+        if constexpr (is_binary_plain_v<Element>)
+            copyLittleEndian<Element>(value.data(), buffer.data() + at, value.size());
+        else
+            for (std::size_t i = 0; i < value.size(); ++i)
+                write(at + i * binarySizeOf<Element>(), value[i]);
+    }
+    else if constexpr (kind == BinaryKind::Sequence) {
+        using Element = typename T::value_type;
+
+        const std::size_t count = value.size();
+        const std::size_t offset = allocate(count * binarySizeOf<Element>(), binaryAlignOf<Element>());
+
+        if constexpr (is_binary_plain_v<Element> && is_contiguous_resizable_container<T>::value)
+            copyLittleEndian<Element>(value.data(), buffer.data() + offset, count);
+        else {
+            std::size_t i = 0;
+            for (auto&& element : value)
+                write<Element>(offset + i++ * binarySizeOf<Element>(), element);
+        }
+
+        writeReference(at, offset, count);
+    }
+    else {
+        using Element = remove_nullable_wrapper_t<T>;
+
+        if (!hasReferencedValue(value))
+            return writeReference(at, 0, 0);
+
+        const std::size_t offset = allocate(binarySizeOf<Element>(), binaryAlignOf<Element>());
+        write(offset, *value);
+        writeReference(at, offset, 1);
+    }
+}
+
+
+inline BinaryData::Reference BinaryData::readReference(std::size_t at, std::size_t elementSize,
+                                                       std::size_t elementAlignment) const {
+    const uint64_t offset = readScalar<uint64_t>(at);
+    const uint64_t count = readScalar<uint64_t>(at + 8);
+
+    if (count == 0)
+        return Reference { 0, 0 };
+
+    if (offset < at + binaryReferenceSize || offset > size || offset % elementAlignment != 0 ||
+        count > (size - offset) / elementSize)
+        throw InvalidBinaryException("Reference at offset " + std::to_string(at) + " to " + std::to_string(count) +
+                                     " elements at offset " + std::to_string(offset) + " exceeds the data");
+
+    return Reference { static_cast<std::size_t>(offset), static_cast<std::size_t>(count) };
+}
+
+template<typename Scalar>
+Scalar BinaryData::readScalar(std::size_t at) const {
+    if constexpr (std::is_same_v<Scalar, bool>)
+        return data[at] != 0;
+    else {
+        Scalar value;
+        copyLittleEndian<Scalar>(data + at, &value, 1);
+
+        return value;
+    }
+}
+
+template<typename Struct>
+void BinaryData::validateHeader() const {
+    static const uint64_t fingerprint = binary_fingerprint<Struct>();
+
+    if (reinterpret_cast<std::uintptr_t>(data) % 8 != 0)
+        throw InvalidBinaryException("Binary data must be aligned to 8 bytes to be read in place");
+    if (size < binaryHeaderSize || std::memcmp(data, "RJUB", 4) != 0)
+        throw InvalidBinaryException("Data of " + std::to_string(size) + " bytes isn't in the compact binary format");
+
+    const uint16_t version = readScalar<uint16_t>(4);
+    if (version != binaryFormatVersion)
+        throw InvalidBinaryException("Expected binary format version " + std::to_string(binaryFormatVersion) +
+                                     ", got " + std::to_string(version));
+
+    const uint64_t schema = readScalar<uint64_t>(8);
+    if (schema != fingerprint)
+        throw InvalidBinaryException("Binary data was written for another schema of " + std::string(Descriptor<Struct>::name()) +
+                                     ", expected fingerprint " + std::to_string(fingerprint) + ", got " + std::to_string(schema));
+
+    const uint64_t expectedSize = readScalar<uint64_t>(16);
+    if (expectedSize != size)
+        throw InvalidBinaryException("Binary data of " + std::to_string(size) + " bytes, expected " +
+                                     std::to_string(expectedSize) + " bytes");
+    if (size < binaryHeaderSize + binarySizeOf<Struct>())
+        throw InvalidBinaryException("Binary data of " + std::to_string(size) + " bytes can't hold the record of " +
+                                     std::string(Descriptor<Struct>::name()));
+}
+
+
+inline BinaryReader::BinaryReader(BinaryData _data) : data(_data), budget(_data.size) {
+}
+
+inline void BinaryReader::charge(std::size_t at, std::size_t bytes) {
+    if (bytes > budget)
+        throw InvalidBinaryException("Reference at offset " + std::to_string(at) + " overlaps others, the references of the data "
+                                     "add up to more than its " + std::to_string(data.size) + " bytes");
+
+    budget -= bytes;
+}
+
+template<typename T>
+void BinaryReader::read(std::size_t at, T& value, std::size_t depth) {
+    constexpr BinaryKind kind = binaryKindOf<T>();
+
+    if constexpr (kind == BinaryKind::Scalar || kind == BinaryKind::Chrono)
+        value = binary_access<T>::get(data, at);
+    else if constexpr (kind == BinaryKind::String) {
+        std::string_view str = binary_access<T>::get(data, at);
+        charge(at, str.length());
+
+        if constexpr (is_json_inline_string_v<T>) {
+            if (str.length() > inline_string_traits<T>::capacity)
+                throw StringLengthExceededException("String length mismatch: binary data contains " + std::to_string(str.length()) +
+                                                    " characters, but given string has fixed capacity of " +
+                                                    std::to_string(inline_string_traits<T>::capacity) + " characters.");
+
+            inline_string_traits<T>::assign(&value, str);
+        }
+        else
+            value.assign(str.data(), str.length());
+    }
+    else if constexpr (kind == BinaryKind::Record) {
+        if (depth > maxBinaryNestingDepth)
+            throw InvalidBinaryException("Binary data nests deeper than " + std::to_string(maxBinaryNestingDepth) +
+                                         " levels at offset " + std::to_string(at));
+
+        std::size_t index = 0;
+
+        for_each(Descriptor<T>::member_descriptors, [this, at, &value, &index, depth](auto descriptor) {
+                     read(at + binary_record_layout_v<T>.offsets[index++], value.*(descriptor.pointer()), depth + 1);
+                 });
+    }
+    else if constexpr (kind == BinaryKind::FixedArray) {
+        using Element = typename T::value_type;
+
+        if constexpr (is_binary_plain_v<Element>)
+            copyLittleEndian<Element>(data.data + at, value.data(), value.size());
+        else
+            for (std::size_t i = 0; i < value.size(); ++i)
+                read(at + i * binarySizeOf<Element>(), value[i], depth + 1);
+    }
+    else if constexpr (kind == BinaryKind::Sequence) {
+        using Element = typename T::value_type;
+
+        auto reference = data.readReference(at, binarySizeOf<Element>(), binaryAlignOf<Element>());
+        if (reference.count > value.max_size())
+            throw capacityExceeded(reference.count, value.max_size());
+
+        charge(at, reference.count * binarySizeOf<Element>());
+        resizeSequence(value, reference.count, nullptr);
+
+        if constexpr (is_binary_plain_v<Element> && is_contiguous_resizable_container<T>::value)
+            copyLittleEndian<Element>(data.data + reference.offset, value.data(), reference.count);
+        else {
+            // Assigned rather than read into, as the elements of std::vector<bool> are proxies
+            constexpr bool isScalar = binaryKindOf<Element>() == BinaryKind::Scalar || binaryKindOf<Element>() == BinaryKind::Chrono;
+
+            std::size_t i = 0;
+            for (auto&& element : value) {
+                const std::size_t at = reference.offset + i++ * binarySizeOf<Element>();
+
+                if constexpr (isScalar)
+                    element = binary_access<Element>::get(data, at);
+                else
+                    read(at, element, depth + 1);
+            }
+        }
+    }
+    else {
+        using Element = remove_nullable_wrapper_t<T>;
+
+        auto reference = data.readReference(at, binarySizeOf<Element>(), binaryAlignOf<Element>());
+        if (reference.count > 1)
+            throw InvalidBinaryException("Nullable member at offset " + std::to_string(at) + " holds " +
+                                         std::to_string(reference.count) + " values");
+
+        if (reference.count == 0)
+            value = T();
+        else {
+            charge(at, binarySizeOf<Element>());
+            read(reference.offset, emplaceReferencedValue(value), depth + 1);
+        }
+    }
+}
+
+
+#if defined(_WIN32)
+
+inline MappedFile::MappedFile(const std::string& path) {
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "Cannot open " + path);
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize)) {
+        DWORD error = GetLastError();
+        CloseHandle(handle);
+        throw std::system_error(static_cast<int>(error), std::system_category(), "Cannot read the size of " + path);
+    }
+
+    length = static_cast<std::size_t>(fileSize.QuadPart);
+    if (length != 0) {
+        HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        DWORD error = GetLastError();
+
+        if (mapping != nullptr) {
+            address = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            error = GetLastError();
+            CloseHandle(mapping);
+        }
+
+        if (address == nullptr) {
+            CloseHandle(handle);
+            throw std::system_error(static_cast<int>(error), std::system_category(), "Cannot map " + path);
+        }
+    }
+
+    CloseHandle(handle);
+}
+
+inline void MappedFile::unmap() {
+    if (address != nullptr)
+        UnmapViewOfFile(address);
+}
+
+#else
+
+inline MappedFile::MappedFile(const std::string& path) {
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        throw std::system_error(errno, std::generic_category(), "Cannot open " + path);
+
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0) {
+        int error = errno;
+        ::close(descriptor);
+        throw std::system_error(error, std::generic_category(), "Cannot read the size of " + path);
+    }
+
+    length = static_cast<std::size_t>(status.st_size);
+    if (length != 0) {
+        void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED) {
+            int error = errno;
+            ::close(descriptor);
+            throw std::system_error(error, std::generic_category(), "Cannot map " + path);
+        }
+
+        address = static_cast<const uint8_t*>(mapping);
+    }
+
+    ::close(descriptor);
+}
+
+inline void MappedFile::unmap() {
+    if (address != nullptr)
+        ::munmap(const_cast<uint8_t*>(address), length);
+}
+
+#endif
+
+inline MappedFile::MappedFile(MappedFile&& other) noexcept : address(other.address), length(other.length) {
+    other.address = nullptr;
+    other.length = 0;
+}
+
+inline MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        address = std::exchange(other.address, nullptr);
+        length = std::exchange(other.length, 0);
+    }
+
+    return *this;
+}
+
+inline MappedFile::~MappedFile() {
+    unmap();
+}
+
+
+template<typename Struct>
+void marshalBinaryImpl(const Struct& s, std::vector<uint8_t>& buffer) {
+    static_assert(RAPIDJSON_UTIL_LITTLE_ENDIAN, "The compact binary format is read in place, which requires a little-endian host");
+    static_assert(is_describable_struct_v<Struct>, "Use the RAPIDJSON_UTIL_DESCRIBE_MEMBERS macro to declare serializable struct members");
+
+    buffer.clear();
+
+    BinaryWriter writer(buffer);
+    writer.writeRoot(s);
+}
+
+template<typename Struct>
+void unmarshalBinaryImpl(const uint8_t* data, std::size_t size, Struct& s) {
+    binary_view<Struct>(data, size).decode(s);
+}
+
+}  // namespace detail
+
+
+template<typename Struct>
+binary_record<Struct>::binary_record(const detail::BinaryData& _data, std::size_t _offset) : data(_data), offset(_offset) {
+}
+
+template<typename Struct>
+template<auto Member>
+auto binary_record<Struct>::get() const {
+    constexpr std::size_t index = detail::describedMemberIndex<Member>(detail::Descriptor<Struct>::member_descriptors);
+    static_assert(index < detail::binary_record_layout_v<Struct>.offsets.size(),
+                  "Only members described by RAPIDJSON_UTIL_DESCRIBE_MEMBERS can be read");
+
+    using MemberType = detail::member_type_t<decltype(Member)>;
+    return detail::binary_access<MemberType>::get(data, offset + detail::binary_record_layout_v<Struct>.offsets[index]);
+}
+
+template<typename Struct>
+void binary_record<Struct>::decode(Struct& s) const {
+    detail::BinaryReader reader(data);
+    reader.read(offset, s, 0);
+}
+
+
+template<typename Element>
+binary_array<Element>::binary_array(const detail::BinaryData& data, std::size_t _offset, std::size_t _count) :
+    binaryData(data), offset(_offset), count(_count) {
+}
+
+template<typename Element>
+typename binary_array<Element>::value_type binary_array<Element>::operator[](std::size_t index) const {
+    assert(index < count);
+
+    return detail::binary_access<Element>::get(binaryData, offset + index * detail::binarySizeOf<Element>());
+}
+
+
+template<typename Struct>
+binary_view<Struct>::binary_view(const uint8_t* _data, std::size_t size) : data{ _data, size } {
+    static_assert(RAPIDJSON_UTIL_LITTLE_ENDIAN, "The compact binary format is read in place, which requires a little-endian host");
+
+    data.template validateHeader<Struct>();
+}
+
+template<typename Struct>
+binary_view<Struct>::binary_view(detail::MappedFile&& _file) : binary_view(_file.data(), _file.size()) {
+    file = std::move(_file);
+}
+
+template<typename Struct>
+binary_view<Struct> binary_view<Struct>::open(const std::string& path) {
+    return binary_view(detail::MappedFile(path));
+}
+
+
+template<typename Struct>
+void marshal_binary(const Struct& s, std::vector<uint8_t>& buffer) {
+    detail::marshalBinaryImpl(s, buffer);
+}
+
+template<typename Struct>
+std::vector<uint8_t> marshal_binary(const Struct& s) {
+    std::vector<uint8_t> buffer;
+    detail::marshalBinaryImpl(s, buffer);
+
+    return buffer;
+}
+
+template<typename Struct>
+void unmarshal_binary(const uint8_t* data, std::size_t size, Struct& s) {
+    detail::unmarshalBinaryImpl(data, size, s);
+}
+
+template<typename Struct>
+void unmarshal_binary(const std::vector<uint8_t>& data, Struct& s) {
+    detail::unmarshalBinaryImpl(data.data(), data.size(), s);
+}
+
+template<typename Struct>
+uint64_t binary_fingerprint() {
+    std::string schema = "RJUB" + std::to_string(detail::binaryFormatVersion);
+    std::vector<const void*> openStructs;
+    detail::appendBinarySchema<Struct>(schema, openStructs);
+
+    return detail::hashBinarySchema(schema);
+}
+
+inline InvalidBinaryException::InvalidBinaryException(std::string_view what) :
+    std::logic_error(what.data()) {
+}
+
+}  // namespace rapidjson_util
+
+#endif
@@ -0,0 +1,1470 @@
+// Copyright (C) 2025 Liu Wu. All rights reserved.
+//
+// Licensed under the zlib License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/Zlib
+//
+// This software is provided as-is, without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+
+
+#ifndef __RAPIDJSON_UTIL_CBOR_H__
+#define __RAPIDJSON_UTIL_CBOR_H__
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "rapid_util.h"
+#include "rapid_util_typed_array.h"
+
+
+namespace rapidjson_util {
+
+class InvalidCborException : public std::logic_error {
+public:
+    InvalidCborException(std::string_view what);
+};
+
+
+/**
+ * @brief Serialize a C++ struct to CBOR (RFC 8949)
+ *
+ * Members are described by the RAPIDJSON_UTIL_DESCRIBE_MEMBERS macro, just as for marshal, and
+ * encoded the way marshal encodes them to JSON: structs become maps keyed by member name, tuples
+ * arrays and null members null. Integers take their shortest head, floats and doubles are written
+ * as single and double precision. Contiguous number arrays, binary members and RFC 3339 time
+ * points are the exceptions, see unmarshal_cbor.
+ *
+ * @param s The struct instance to serialize
+ * @param buffer Receives the encoded bytes, its previous content is discarded but its capacity
+ *               is reused, so encoding into the same buffer repeatedly doesn't allocate
+ */
+template<typename Struct>
+void marshal_cbor(const Struct& s, std::vector<uint8_t>& buffer);
+
+/**
+ * @brief Serialize a C++ struct to CBOR (RFC 8949)
+ *
+ * @return The encoded bytes
+ */
+template<typename Struct>
+std::vector<uint8_t> marshal_cbor(const Struct& s);
+
+/**
+ * @brief Deserialize CBOR data to populate a C++ struct
+ *
+ * Accepts what marshal_cbor writes, as well as CBOR from other encoders: indefinite-length
+ * arrays, maps and text strings, half-precision floats and tagged values, whose tags are ignored.
+ *
+ * std::vector<double>, std::array<float, N> and other contiguous number arrays are written as
+ * RFC 8746 typed arrays, which hold the little-endian numbers back to back in a byte string, so
+ * that they are copied with a single memcpy on little-endian hosts. Arrays of more than one
+ * dimension are written as a single row-major typed array inside an RFC 8746 multi-dimensional
+ * array (tag 40). Typed arrays of either byte order, nested arrays and plain arrays of numbers
+ * are read as well. Binary members are written as byte strings, and their base64 or hex text
+ * is read as well; time points encoded as RFC 3339 are written as tagged date/time strings.
+ *
+ * @param data CBOR data, which must hold exactly one map
+ * @param size Number of bytes in data
+ * @param s The struct instance to populate
+ * @param resource Memory resource for std::pmr strings and containers, see unmarshal
+ * @throws InvalidCborException if data is truncated, malformed or nested too deeply, and the
+ *         exceptions unmarshal throws for members of the wrong type or size
+ */
+template<typename Struct>
+void unmarshal_cbor(const uint8_t* data, std::size_t size, Struct& s, std::pmr::memory_resource* resource = nullptr);
+
+template<typename Struct>
+void unmarshal_cbor(const std::vector<uint8_t>& data, Struct& s, std::pmr::memory_resource* resource = nullptr);
+
+
+namespace detail {
+
+enum CborMajorType : uint8_t {
+    CborUnsigned = 0,
+    CborNegative,
+    CborBytes,
+    CborText,
+    CborArray,
+    CborMap,
+    CborTag,
+    CborSimple
+};
+
+// The tag of RFC 8746 multi-dimensional arrays in row-major order
+constexpr uint64_t cborMultiDimensionalTag = 40;
+
+// The tag of RFC 3339 date/time strings
+constexpr uint64_t cborDateTimeTag = 0;
+
+// The additional information of indefinite lengths, and of the break ending them
+constexpr uint8_t cborIndefinite = 31;
+constexpr uint8_t cborBreak = 0xff;
+
+// RFC 8949 Appendix D
+inline double decodeHalfFloat(uint16_t half) {
+    const int exponent = (half >> 10) & 0x1f;
+    const int mantissa = half & 0x3ff;
+
+    double value;
+    if (exponent == 0)       value = std::ldexp(mantissa, -24);
+    else if (exponent != 31) value = std::ldexp(mantissa + 1024, exponent - 25);
+    else                     value = mantissa == 0 ? HUGE_VAL : std::nan("");
+
+    return half & 0x8000 ? -value : value;
+}
+
+
+/**
+ * @brief Serializes C++ struct objects to CBOR
+ *
+ * Traverses the same object hierarchy as JsonWriter and appends every value to the buffer
+ * as soon as it is visited. The RapidJSON value passed along by the visitor is not used,
+ * except for members encoded by a codec, which are encoded to JSON first. Binary members
+ * are written as byte strings instead, and RFC 3339 time points are tagged as such (tag 0).
+ */
+class CborWriter : public JsonVisitor {
+public:
+    explicit CborWriter(std::vector<uint8_t>& buffer);
+
+    void writeToCbor(JsonObject* root);
+
+    void visit(JsonPrimitiveValue* primitiveValue, rapidjson::Value&) override;
+    void visit(JsonObject* object, rapidjson::Value&) override;
+    void visit(JsonNullableObject* object, rapidjson::Value&) override;
+    void visit(JsonArray* array, rapidjson::Value&) override;
+    void visit(JsonNullableArray* array, rapidjson::Value&) override;
+    void visit(JsonNumberArray* array, rapidjson::Value&) override;
+    void visit(JsonInlineString* string, rapidjson::Value&) override;
+    void visit(JsonNullableInlineString* string, rapidjson::Value&) override;
+    void visit(JsonCustomValue* value, rapidjson::Value&) override;
+    void visit(JsonNullableCustomValue* value, rapidjson::Value&) override;
+    void visit(JsonVariant* variant, rapidjson::Value&) override;
+    void visit(JsonNullableVariant* variant, rapidjson::Value&) override;
+
+private:
+    void writeObjectMembers(JsonObject* object);
+    void appendObjectMembers(const std::vector<JsonAttribute>& members);
+    void writeArrayMembers(JsonArray* array);
+    void writeVariantAlternative(JsonVariant* variant);
+    void writeCustomValue(JsonCustomValue* value);
+    void writeJsonValue(const rapidjson::Value& value);
+
+    template<typename Number>
+    void writeNumberArray(const Number* numbers, const std::vector<std::size_t>& extents);
+
+    template<typename Number>
+    void writeTypedArray(const Number* numbers, std::size_t count);
+
+    void writeNull();
+    void writeBool(bool boolean);
+    void writeUnsigned(uint64_t number);
+    void writeSigned(int64_t number);
+    void writeFloat(float number);
+    void writeDouble(double number);
+    void writeString(std::string_view str);
+    void writeBytes(std::pair<const uint8_t*, std::size_t> bytes);
+    void writeHead(CborMajorType majorType, uint64_t argument);
+
+    template<typename Number>
+    void writeNumber(Number number);
+
+    template<typename Unsigned>
+    void writeBigEndian(uint8_t initialByte, Unsigned number);
+
+    uint8_t* grow(std::size_t length);
+
+    std::vector<uint8_t>& buffer;
+    rapidjson::Document customValues;
+    rapidjson::Value unused;
+};
+
+
+/**
+ * @brief Deserializes CBOR to C++ struct objects
+ *
+ * Reads the values straight from the input in the order they occur. Object members are matched
+ * by name, in declaration order first, so out-of-order and unknown members are accepted as in
+ * JSON. Every length is checked against the remaining input before anything is resized, and
+ * nesting is limited to maxNestingDepth, so malformed input can neither make it allocate more
+ * than the input could describe nor exhaust the stack. Indefinite-length arrays and maps are
+ * counted by skipping over their items once before they are read. Checks throw from plain if
+ * statements, as ThrowUnless would build the exception message for every value read.
+ */
+class CborReader : public JsonVisitor {
+public:
+    static constexpr std::size_t maxNestingDepth = 512;
+
+    CborReader(const uint8_t* data, std::size_t size, std::pmr::memory_resource* resource = nullptr);
+
+    void readFromCbor(JsonObject* root);
+
+    void visit(JsonPrimitiveValue* primitiveValue, rapidjson::Value&) override;
+    void visit(JsonObject* object, rapidjson::Value&) override;
+    void visit(JsonNullableObject* object, rapidjson::Value&) override;
+    void visit(JsonArray* array, rapidjson::Value&) override;
+    void visit(JsonNullableArray* array, rapidjson::Value&) override;
+    void visit(JsonNumberArray* array, rapidjson::Value&) override;
+    void visit(JsonInlineString* string, rapidjson::Value&) override;
+    void visit(JsonNullableInlineString* string, rapidjson::Value&) override;
+    void visit(JsonCustomValue* value, rapidjson::Value&) override;
+    void visit(JsonNullableCustomValue* value, rapidjson::Value&) override;
+    void visit(JsonVariant* variant, rapidjson::Value&) override;
+    void visit(JsonNullableVariant* variant, rapidjson::Value&) override;
+
+private:
+    struct Head {
+        CborMajorType majorType;
+        uint8_t additionalInfo;
+        uint64_t argument;
+
+        bool isIndefinite() const { return additionalInfo == cborIndefinite; }
+    };
+
+    struct Container {
+        std::size_t length;
+        bool isIndefinite;
+    };
+
+    static constexpr uint64_t noTag = UINT64_MAX;
+
+    void readObjectMembers(JsonObject* object);
+    void readArrayElements(JsonArray* array);
+    void readVariantAlternative(JsonVariant* variant);
+    void readInlineString(JsonInlineString* string);
+    void readCustomValue(JsonCustomValue* value);
+    void readJsonValue(rapidjson::Value& value);
+
+    template<typename Number>
+    void readNumberArray(JsonNumberArray* array);
+
+    template<typename Number>
+    std::size_t readNumberArrayLength(std::size_t dimensions);
+
+    template<typename Number>
+    Number* readNumbers(Number* numbers, const std::vector<std::size_t>& extents, std::size_t dimension, uint64_t tag);
+
+    template<typename Number>
+    Number* readNumberRow(Number* numbers, std::size_t count, uint64_t tag);
+
+    template<typename Number>
+    std::size_t readTypedArrayHeader(uint64_t tag, bool& isLittleEndian);
+
+    template<typename Number>
+    Number readNumber();
+
+    bool isNullNext();
+    bool readBool();
+    std::string_view readString();
+    std::string_view readStringChunks();
+    Container readArrayHeader();
+    Container readMapHeader();
+    void readContainerEnd(const Container& container);
+    std::size_t countIndefiniteItems(std::size_t valuesPerItem);
+    void readNumberValue(rapidjson::Value& number);
+    void skipValue();
+
+    void enterNesting();
+    void leaveNesting();
+
+    uint8_t peekValue();
+    uint64_t readTags();
+    Head readHead();
+    uint8_t peekByte();
+    uint8_t readByte();
+    const uint8_t* readBytes(uint64_t length);
+
+    template<typename Unsigned>
+    Unsigned readBigEndian();
+
+    std::string offsetText(const uint8_t* position) const;
+    std::string nextTypeName();
+    TypeMismatchException typeMismatch(const std::string& expectedType);
+
+    const uint8_t* begin;
+    const uint8_t* cursor;
+    const uint8_t* end;
+    std::size_t depth = 0;
+    std::string chunks;
+    std::pmr::memory_resource* resource;
+    rapidjson::Document customValues;
+    rapidjson::Value unused;
+};
+
+
+inline CborWriter::CborWriter(std::vector<uint8_t>& _buffer) : buffer(_buffer) {
+}
+
+inline void CborWriter::writeToCbor(JsonObject* root) {
+    root->accept(*this, unused);
+}
+
+inline uint8_t* CborWriter::grow(std::size_t length) {
+    std::size_t size = buffer.size();
+    buffer.resize(size + length);
+
+    return buffer.data() + size;
+}
+
+template<typename Unsigned>
+void CborWriter::writeBigEndian(uint8_t initialByte, Unsigned number) {
+    uint8_t* out = grow(1 + sizeof(Unsigned));
+    *out++ = initialByte;
+
+    for (std::size_t byte = sizeof(Unsigned); byte-- > 0; number = static_cast<Unsigned>(number >> 8))
+        out[byte] = static_cast<uint8_t>(number);
+}
+
+// Writes the initial byte and the argument following it in as few bytes as possible
+inline void CborWriter::writeHead(CborMajorType majorType, uint64_t argument) {
+    const uint8_t initialByte = static_cast<uint8_t>(majorType << 5);
+
+    if (argument < 24)                  buffer.push_back(static_cast<uint8_t>(initialByte | argument));
+    else if (argument <= UINT8_MAX)     writeBigEndian(initialByte | 24, static_cast<uint8_t>(argument));
+    else if (argument <= UINT16_MAX)    writeBigEndian(initialByte | 25, static_cast<uint16_t>(argument));
+    else if (argument <= UINT32_MAX)    writeBigEndian(initialByte | 26, static_cast<uint32_t>(argument));
+    else                                writeBigEndian(initialByte | 27, argument);
+}
+
+inline void CborWriter::writeNull() {
+    buffer.push_back(0xf6);
+}
+
+inline void CborWriter::writeBool(bool boolean) {
+    buffer.push_back(boolean ? 0xf5 : 0xf4);
+}
+
+inline void CborWriter::writeUnsigned(uint64_t number) {
+    writeHead(CborUnsigned, number);
+}
+
+// Negative integers are encoded as -1 - n, which can't overflow for any int64_t
+inline void CborWriter::writeSigned(int64_t number) {
+    if (number >= 0)
+        writeHead(CborUnsigned, static_cast<uint64_t>(number));
+    else
+        writeHead(CborNegative, static_cast<uint64_t>(-1 - number));
+}
+
+inline void CborWriter::writeFloat(float number) {
+    uint32_t bits;
+    std::memcpy(&bits, &number, sizeof(bits));
+    writeBigEndian(0xfa, bits);
+}
+
+inline void CborWriter::writeDouble(double number) {
+    uint64_t bits;
+    std::memcpy(&bits, &number, sizeof(bits));
+    writeBigEndian(0xfb, bits);
+}
+
+template<typename Number>
+void CborWriter::writeNumber(Number number) {
+    if constexpr (std::is_same_v<Number, float>)       writeFloat(number);
+    else if constexpr (std::is_same_v<Number, double>) writeDouble(number);
+    else if constexpr (std::is_signed_v<Number>)       writeSigned(number);
+    else                                               writeUnsigned(number);
+}
+
+inline void CborWriter::writeString(std::string_view str) {
+    writeHead(CborText, str.length());
+
+    if (!str.empty())
+        std::memcpy(grow(str.length()), str.data(), str.length());
+}
+
+inline void CborWriter::writeBytes(std::pair<const uint8_t*, std::size_t> bytes) {
+    auto [data, size] = bytes;
+    writeHead(CborBytes, size);
+
+    if (size != 0)
+        std::memcpy(grow(size), data, size);
+}
+
+inline void CborWriter::visit(JsonPrimitiveValue* primitiveValue, rapidjson::Value&) {
+    assert(primitiveValue->isPointToConst());
+
+    if (primitiveValue->isReferencedValueNull())
+        return writeNull();
+
+    #define WRITE_NUMBER(storedType, CXXType)                                                  \
+        case JsonPrimitiveValue::StoredType::storedType:                                       \
+            writeNumber(*primitiveValue->unwrapConstPointer<CXXType>());                       \
+            break;
+
+    switch (primitiveValue->storedType()) {
+        RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(WRITE_NUMBER)
+
+        case JsonPrimitiveValue::StoredType::BoolPtr:
+            writeBool(*primitiveValue->unwrapConstPointer<bool>());
+            break;
+
+        case JsonPrimitiveValue::StoredType::StringPtr:
+            writeString(*primitiveValue->unwrapConstPointer<std::string>());
+            break;
+
+        case JsonPrimitiveValue::StoredType::PmrStringPtr:
+            writeString(*primitiveValue->unwrapConstPointer<std::pmr::string>());
+            break;
+
+        case JsonPrimitiveValue::StoredType::StringViewPtr:
+            writeString(*primitiveValue->unwrapConstPointer<std::string_view>());
+            break;
+    }
+
+    #undef WRITE_NUMBER
+}
+
+inline void CborWriter::appendObjectMembers(const std::vector<JsonAttribute>& members) {
+    for (auto&& member : members) {
+        writeString(member.name);
+        member.value->accept(*this, unused);
+    }
+}
+
+inline void CborWriter::writeObjectMembers(JsonObject* object) {
+    auto members = object->getWrittenMembers(Omission::None);
+
+    writeHead(CborMap, members.size());
+    appendObjectMembers(members);
+}
+
+inline void CborWriter::visit(JsonObject* object, rapidjson::Value&) {
+    writeObjectMembers(object);
+}
+
+inline void CborWriter::visit(JsonNullableObject* object, rapidjson::Value&) {
+    if (object->isReferencedValueNull())
+        return writeNull();
+
+    writeObjectMembers(object);
+}
+
+inline void CborWriter::writeArrayMembers(JsonArray* array) {
+    writeHead(CborArray, array->size());
+
+    for (auto&& element : array->getElements())
+        element->accept(*this, unused);
+}
+
+inline void CborWriter::visit(JsonArray* array, rapidjson::Value&) {
+    writeArrayMembers(array);
+}
+
+inline void CborWriter::visit(JsonNullableArray* array, rapidjson::Value&) {
+    if (array->isReferencedValueNull())
+        return writeNull();
+
+    writeArrayMembers(array);
+}
+
+inline void CborWriter::visit(JsonNumberArray* array, rapidjson::Value&) {
+    #define WRITE_NUMBERS(storedType, CXXType)                                                 \
+        case JsonPrimitiveValue::StoredType::storedType:                                       \
+            writeNumberArray(array->unwrapConstPointer<CXXType>(), array->getExtents());       \
+            break;
+
+    switch (array->storedType()) {
+        RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(WRITE_NUMBERS)
+        default: assert(false && "Only numbers are stored contiguously");
+    }
+
+    #undef WRITE_NUMBERS
+}
+
+// Arrays of several dimensions become [extents, typed array] tagged as multi-dimensional arrays
+template<typename Number>
+void CborWriter::writeNumberArray(const Number* numbers, const std::vector<std::size_t>& extents) {
+    std::size_t count = 1;
+    for (auto extent : extents)
+        count *= extent;
+
+    if (extents.size() > 1) {
+        writeHead(CborTag, cborMultiDimensionalTag);
+        writeHead(CborArray, 2);
+        writeHead(CborArray, extents.size());
+
+        for (auto extent : extents)
+            writeUnsigned(extent);
+    }
+
+    writeTypedArray(numbers, count);
+}
+
+template<typename Number>
+void CborWriter::writeTypedArray(const Number* numbers, std::size_t count) {
+    const std::size_t length = count * sizeof(Number);
+
+    writeHead(CborTag, typedArrayTag<Number>());
+    writeHead(CborBytes, length);
+
+    if (count != 0)
+        copyLittleEndian<Number>(numbers, grow(length), count);
+}
+
+inline void CborWriter::visit(JsonInlineString* string, rapidjson::Value&) {
+    writeString(string->view());
+}
+
+inline void CborWriter::visit(JsonNullableInlineString* string, rapidjson::Value&) {
+    if (string->isReferencedValueNull())
+        return writeNull();
+
+    writeString(string->view());
+}
+
+inline void CborWriter::writeCustomValue(JsonCustomValue* value) {
+    if (value->isBytes())
+        return writeBytes(value->bytes());
+    if (value->isTime())
+        writeHead(CborTag, cborDateTimeTag);
+
+    rapidjson::Value json;
+    value->encode(json, customValues.GetAllocator());
+
+    writeJsonValue(json);
+}
+
+inline void CborWriter::writeJsonValue(const rapidjson::Value& value) {
+    switch (value.GetType()) {
+        case rapidjson::kNullType:   writeNull(); break;
+        case rapidjson::kFalseType:  writeBool(false); break;
+        case rapidjson::kTrueType:   writeBool(true); break;
+        case rapidjson::kStringType: writeString(std::string_view(value.GetString(), value.GetStringLength())); break;
+
+        case rapidjson::kNumberType:
+            if (value.IsDouble())       writeDouble(value.GetDouble());
+            else if (value.IsUint64())  writeUnsigned(value.GetUint64());
+            else                        writeSigned(value.GetInt64());
+            break;
+
+        case rapidjson::kArrayType:
+            writeHead(CborArray, value.Size());
+            for (auto&& element : value.GetArray())
+                writeJsonValue(element);
+            break;
+
+        case rapidjson::kObjectType:
+            writeHead(CborMap, value.MemberCount());
+            for (auto member = value.MemberBegin(); member != value.MemberEnd(); ++member) {
+                writeString(std::string_view(member->name.GetString(), member->name.GetStringLength()));
+                writeJsonValue(member->value);
+            }
+            break;
+    }
+}
+
+inline void CborWriter::visit(JsonCustomValue* value, rapidjson::Value&) {
+    writeCustomValue(value);
+}
+
+inline void CborWriter::visit(JsonNullableCustomValue* value, rapidjson::Value&) {
+    if (value->isReferencedValueNull())
+        return writeNull();
+
+    writeCustomValue(value);
+}
+
+inline void CborWriter::writeVariantAlternative(JsonVariant* variant) {
+    auto members = variant->getAlternative()->getWrittenMembers(Omission::None);
+
+    if (VariantTagging::Internal == variant->taggingStyle()) {
+        writeHead(CborMap, members.size() + 1);
+        writeString(variant->discriminatorName());
+        writeString(variant->alternativeTag());
+        appendObjectMembers(members);
+    }
+    else {
+        writeHead(CborMap, 1);
+        writeString(variant->alternativeTag());
+        writeHead(CborMap, members.size());
+        appendObjectMembers(members);
+    }
+}
+
+inline void CborWriter::visit(JsonVariant* variant, rapidjson::Value&) {
+    writeVariantAlternative(variant);
+}
+
+inline void CborWriter::visit(JsonNullableVariant* variant, rapidjson::Value&) {
+    if (variant->isReferencedValueNull())
+        return writeNull();
+
+    writeVariantAlternative(variant);
+}
+
+
+inline CborReader::CborReader(const uint8_t* data, std::size_t size, std::pmr::memory_resource* _resource) :
+    begin(data), cursor(data), end(data + size), resource(_resource) {
+}
+
+inline void CborReader::readFromCbor(JsonObject* root) {
+    root->accept(*this, unused);
+
+    if (cursor != end)
+        throw InvalidCborException("CBOR data has " + std::to_string(end - cursor) + " trailing bytes after the root map");
+}
+
+inline std::string CborReader::offsetText(const uint8_t* position) const {
+    return std::to_string(position - begin);
+}
+
+inline uint8_t CborReader::peekByte() {
+    if (cursor == end)
+        throw InvalidCborException("CBOR data is truncated at offset " + offsetText(cursor));
+
+    return *cursor;
+}
+
+inline uint8_t CborReader::readByte() {
+    uint8_t byte = peekByte();
+    ++cursor;
+
+    return byte;
+}
+
+inline const uint8_t* CborReader::readBytes(uint64_t length) {
+    if (length > static_cast<uint64_t>(end - cursor))
+        throw InvalidCborException("CBOR data is truncated at offset " + offsetText(cursor) +
+                                   ", expected " + std::to_string(length) + " more bytes");
+
+    const uint8_t* bytes = cursor;
+    cursor += length;
+
+    return bytes;
+}
+
+template<typename Unsigned>
+Unsigned CborReader::readBigEndian() {
+    const uint8_t* bytes = readBytes(sizeof(Unsigned));
+
+    Unsigned number = 0;
+    for (std::size_t byte = 0; byte < sizeof(Unsigned); ++byte)
+        number = static_cast<Unsigned>(number << 8 | bytes[byte]);
+
+    return number;
+}
+
+inline CborReader::Head CborReader::readHead() {
+    const uint8_t initialByte = readByte();
+
+    Head head { static_cast<CborMajorType>(initialByte >> 5), static_cast<uint8_t>(initialByte & 0x1f), 0 };
+    switch (head.additionalInfo) {
+        case 24: head.argument = readBigEndian<uint8_t>(); break;
+        case 25: head.argument = readBigEndian<uint16_t>(); break;
+        case 26: head.argument = readBigEndian<uint32_t>(); break;
+        case 27: head.argument = readBigEndian<uint64_t>(); break;
+
+        case 28: case 29: case 30:
+            throw InvalidCborException("Invalid CBOR initial byte " + std::to_string(initialByte) + " at offset " +
+                                       offsetText(cursor - 1));
+
+        case cborIndefinite:
+            if (head.majorType <= CborNegative || head.majorType == CborTag)
+                throw InvalidCborException("Invalid CBOR initial byte " + std::to_string(initialByte) + " at offset " +
+                                           offsetText(cursor - 1));
+            break;
+
+        default: head.argument = head.additionalInfo;
+    }
+
+    return head;
+}
+
+/**
+ * Reads the tags in front of the next value.
+ *
+ * @return The innermost tag, or noTag if the value isn't tagged
+ */
+inline uint64_t CborReader::readTags() {
+    uint64_t tag = noTag;
+
+    while ((peekByte() >> 5) == CborTag)
+        tag = readHead().argument;
+
+    return tag;
+}
+
+// Tags carry no meaning for the members they are read into, so they are skipped before every value
+inline uint8_t CborReader::peekValue() {
+    readTags();
+    return peekByte();
+}
+
+inline void CborReader::enterNesting() {
+    if (++depth > maxNestingDepth)
+        throw InvalidCborException("CBOR data nests deeper than " + std::to_string(maxNestingDepth) +
+                                   " levels at offset " + offsetText(cursor));
+}
+
+inline void CborReader::leaveNesting() {
+    --depth;
+}
+
+inline std::string CborReader::nextTypeName() {
+    const uint8_t initialByte = peekValue();
+
+    switch (initialByte >> 5) {
+        case CborUnsigned:
+        case CborNegative: {
+            const uint8_t* start = cursor;
+            rapidjson::Value number;
+            readNumberValue(number);
+            cursor = start;
+
+            return RapidjsonValueTypeValidator::getTypeFrom(number);
+        }
+        case CborBytes: return "Binary";
+        case CborText:  return "String";
+        case CborArray: return "Array";
+        case CborMap:   return "Object";
+    }
+
+    switch (initialByte) {
+        case 0xf4: case 0xf5: return "Boolean";
+        case 0xf6:            return "Null";
+        case 0xf7:            return "Undefined";
+        case 0xf9:            return "Half";
+        case 0xfa:            return "Float";
+        case 0xfb:            return "Double";
+        case cborBreak:       return "Break";
+        default:              return "Simple value";
+    }
+}
+
+inline TypeMismatchException CborReader::typeMismatch(const std::string& expectedType) {
+    return TypeMismatchException("Expected " + expectedType + ", got " + nextTypeName());
+}
+
+inline bool CborReader::isNullNext() {
+    if (peekValue() != 0xf6)
+        return false;
+
+    ++cursor;
+    return true;
+}
+
+inline bool CborReader::readBool() {
+    uint8_t initialByte = peekValue();
+    if (initialByte != 0xf4 && initialByte != 0xf5)
+        throw typeMismatch("Bool");
+
+    ++cursor;
+    return initialByte == 0xf5;
+}
+
+inline std::string_view CborReader::readString() {
+    if ((peekValue() >> 5) != CborText)
+        throw typeMismatch("String");
+
+    return readStringChunks();
+}
+
+// Reads a text or byte string. Indefinite-length strings are joined in chunks, whose size is
+// bounded by the input.
+inline std::string_view CborReader::readStringChunks() {
+    Head head = readHead();
+    if (!head.isIndefinite())
+        return std::string_view(reinterpret_cast<const char*>(readBytes(head.argument)), head.argument);
+
+    chunks.clear();
+    while (peekByte() != cborBreak) {
+        Head chunk = readHead();
+        if (chunk.majorType != head.majorType || chunk.isIndefinite())
+            throw InvalidCborException("Invalid chunk of an indefinite-length CBOR string at offset " + offsetText(cursor));
+
+        chunks.append(reinterpret_cast<const char*>(readBytes(chunk.argument)), chunk.argument);
+    }
+    ++cursor;
+
+    return chunks;
+}
+
+// Counts the items of an indefinite-length array or map, leaving the cursor where it was
+inline std::size_t CborReader::countIndefiniteItems(std::size_t valuesPerItem) {
+    const uint8_t* start = cursor;
+    std::size_t count = 0;
+
+    for (; peekByte() != cborBreak; ++count)
+        for (std::size_t i = 0; i < valuesPerItem; ++i)
+            skipValue();
+
+    cursor = start;
+    return count;
+}
+
+// Array elements and map entries take at least one byte each, so a length beyond the remaining
+// input is rejected before the destination is resized to it
+inline CborReader::Container CborReader::readArrayHeader() {
+    if ((peekValue() >> 5) != CborArray)
+        throw typeMismatch("Array");
+
+    Head head = readHead();
+    if (head.isIndefinite())
+        return Container { countIndefiniteItems(1), true };
+
+    if (head.argument > static_cast<uint64_t>(end - cursor))
+        throw InvalidCborException("CBOR array of " + std::to_string(head.argument) + " elements exceeds the data");
+    return Container { static_cast<std::size_t>(head.argument), false };
+}
+
+inline CborReader::Container CborReader::readMapHeader() {
+    if ((peekValue() >> 5) != CborMap)
+        throw typeMismatch("Object");
+
+    Head head = readHead();
+    if (head.isIndefinite())
+        return Container { countIndefiniteItems(2), true };
+
+    if (head.argument > static_cast<uint64_t>(end - cursor) / 2)
+        throw InvalidCborException("CBOR map of " + std::to_string(head.argument) + " entries exceeds the data");
+    return Container { static_cast<std::size_t>(head.argument), false };
+}
+
+inline void CborReader::readContainerEnd(const Container& container) {
+    if (container.isIndefinite && readByte() != cborBreak)
+        throw InvalidCborException("Expected the CBOR break ending an indefinite-length item at offset " +
+                                   offsetText(cursor - 1));
+}
+
+// Reads any integer or float into a RapidJSON number, so that the JSON type checks apply
+inline void CborReader::readNumberValue(rapidjson::Value& number) {
+    Head head = readHead();
+
+    switch (head.majorType) {
+        case CborUnsigned:
+            number.SetUint64(head.argument);
+            break;
+
+        case CborNegative:
+            if (head.argument <= static_cast<uint64_t>(INT64_MAX))
+                number.SetInt64(-1 - static_cast<int64_t>(head.argument));
+            else
+                number.SetDouble(-1.0 - static_cast<double>(head.argument));
+            break;
+
+        default:
+            if (head.additionalInfo == 25)
+                number.SetDouble(decodeHalfFloat(static_cast<uint16_t>(head.argument)));
+            else if (head.additionalInfo == 26) {
+                uint32_t bits = static_cast<uint32_t>(head.argument);
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                number.SetDouble(value);
+            }
+            else {
+                double value;
+                std::memcpy(&value, &head.argument, sizeof(value));
+                number.SetDouble(value);
+            }
+    }
+}
+
+template<typename Number>
+Number CborReader::readNumber() {
+    uint8_t initialByte = peekValue();
+    if ((initialByte >> 5) > CborNegative && (initialByte < 0xf9 || initialByte > 0xfb))
+        throw typeMismatch(numberTypeName<Number>());
+
+    rapidjson::Value number;
+    readNumberValue(number);
+
+    if constexpr (std::is_same_v<Number, float>) {
+        RapidjsonValueTypeValidator::validate(number, QueryType::IsFloat);
+        return number.GetFloat();
+    }
+    else if constexpr (std::is_same_v<Number, double>) {
+        RapidjsonValueTypeValidator::validate(number, QueryType::IsDouble);
+        return number.GetDouble();
+    }
+    else
+        return RapidjsonValueTypeValidator::narrow<Number>(number);
+}
+
+inline void CborReader::skipValue() {
+    readTags();
+    Head head = readHead();
+
+    switch (head.majorType) {
+        case CborBytes:
+        case CborText:
+            if (!head.isIndefinite())
+                readBytes(head.argument);
+            else {
+                while (peekByte() != cborBreak) {
+                    Head chunk = readHead();
+                    if (chunk.majorType != head.majorType || chunk.isIndefinite())
+                        throw InvalidCborException("Invalid chunk of an indefinite-length CBOR string at offset " +
+                                                   offsetText(cursor));
+                    readBytes(chunk.argument);
+                }
+                ++cursor;
+            }
+            break;
+
+        case CborArray:
+        case CborMap: {
+            const uint64_t valuesPerItem = head.majorType == CborMap ? 2 : 1;
+
+            enterNesting();
+            if (head.isIndefinite()) {
+                while (peekByte() != cborBreak)
+                    for (uint64_t i = 0; i < valuesPerItem; ++i)
+                        skipValue();
+                ++cursor;
+            }
+            else {
+                // Every value takes at least one byte, so the loop ends once the input is exhausted
+                for (uint64_t item = 0; item < head.argument; ++item)
+                    for (uint64_t i = 0; i < valuesPerItem; ++i)
+                        skipValue();
+            }
+            leaveNesting();
+            break;
+        }
+
+        case CborSimple:
+            if (head.isIndefinite())
+                throw InvalidCborException("Unexpected CBOR break at offset " + offsetText(cursor - 1));
+            break;
+
+        default:
+            break;
+    }
+}
+
+inline void CborReader::visit(JsonPrimitiveValue* primitiveValue, rapidjson::Value&) {
+    assert(!primitiveValue->isPointToConst());
+
+    if (primitiveValue->ownershipType() != JsonPrimitiveValue::OwnershipType::Raw && isNullNext())
+        return primitiveValue->resetReferencedValue();
+
+    #define READ_NUMBER(storedType, CXXType)                                                   \
+        case JsonPrimitiveValue::StoredType::storedType:                                       \
+            *primitiveValue->unwrapPointer<CXXType>() = readNumber<CXXType>();                 \
+            break;
+
+    switch (primitiveValue->storedType()) {
+        RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(READ_NUMBER)
+
+        case JsonPrimitiveValue::StoredType::BoolPtr: {
+            bool boolean = readBool();
+            *primitiveValue->unwrapPointer<bool>() = boolean;
+            break;
+        }
+
+        case JsonPrimitiveValue::StoredType::StringPtr: {
+            auto str = readString();
+            primitiveValue->unwrapPointer<std::string>()->assign(str.data(), str.length());
+            break;
+        }
+
+        case JsonPrimitiveValue::StoredType::PmrStringPtr: {
+            auto str = readString();
+            auto value = primitiveValue->unwrapPointer<std::pmr::string>();
+            rebindMemoryResource(*value, resource);
+            value->assign(str.data(), str.length());
+            break;
+        }
+
+        case JsonPrimitiveValue::StoredType::StringViewPtr:
+            assert(false && "Views are marshal-only");
+            break;
+    }
+
+    #undef READ_NUMBER
+}
+
+inline void CborReader::readObjectMembers(JsonObject* object) {
+    const Container map = readMapHeader();
+    enterNesting();
+
+    auto members = object->getMembers();
+    std::vector<bool> isRead(members.size());
+    std::size_t next = 0;
+
+    for (std::size_t entry = 0; entry < map.length; ++entry) {
+        // Members are named by text strings, entries under other keys can't match any of them
+        if ((peekValue() >> 5) != CborText) {
+            skipValue();
+            skipValue();
+            continue;
+        }
+
+        auto name = readString();
+
+        if (next == members.size() || members[next].name != name) {
+            next = 0;
+            while (next < members.size() && members[next].name != name)
+                ++next;
+        }
+
+        if (next == members.size()) {
+            skipValue();
+            continue;
+        }
+
+        try {
+            members[next].value->accept(*this, unused);
+        }
+        catch (std::logic_error& e) {
+            throw MemberSerializationFailure(std::string("Deserialization of member \"") +
+                members[next].name + "\" failed: " + e.what());
+        }
+
+        isRead[next++] = true;
+    }
+
+    readContainerEnd(map);
+    leaveNesting();
+
+    for (std::size_t i = 0; i < members.size(); ++i)
+        if (!isRead[i] && !members[i].omitter.omit(Omission::None))
+            throw MemberNotFoundException(members[i].name);
+}
+
+inline void CborReader::visit(JsonObject* object, rapidjson::Value&) {
+    readObjectMembers(object);
+}
+
+inline void CborReader::visit(JsonNullableObject* object, rapidjson::Value&) {
+    if (isNullNext())
+        return object->resetReferencedValue();
+
+    if (object->isReferencedValueNull())
+        object->reinitializeReferencedValue();
+
+    readObjectMembers(object);
+}
+
+inline void CborReader::readArrayElements(JsonArray* array) {
+    const Container header = readArrayHeader();
+    const std::size_t length = header.length;
+
+    if (length != array->size() && !array->isResizable())
+        throw fixedCapacityMismatch(length, array->size());
+    if (length > array->maxSize())
+        throw capacityExceeded(length, array->maxSize());
+
+    if (isResizeNeeded(array, length, resource))
+        array->resize(length, resource);
+
+    enterNesting();
+
+    for (auto&& element : array->getElements()) {
+        if (!array->hasOptionalElements() && peekValue() == 0xf6)
+            throw TypeMismatchException("CBOR array contains null elements");
+
+        element->accept(*this, unused);
+    }
+
+    readContainerEnd(header);
+    leaveNesting();
+}
+
+inline void CborReader::visit(JsonArray* array, rapidjson::Value&) {
+    readArrayElements(array);
+}
+
+inline void CborReader::visit(JsonNullableArray* array, rapidjson::Value&) {
+    if (isNullNext())
+        return array->resetReferencedValue();
+
+    if (array->isReferencedValueNull())
+        array->reinitializeReferencedValue();
+
+    readArrayElements(array);
+}
+
+inline void CborReader::visit(JsonNumberArray* array, rapidjson::Value&) {
+    assert(!array->isPointToConst());
+
+    #define READ_NUMBERS(storedType, CXXType)                                                  \
+        case JsonPrimitiveValue::StoredType::storedType:                                       \
+            readNumberArray<CXXType>(array);                                                   \
+            break;
+
+    switch (array->storedType()) {
+        RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(READ_NUMBERS)
+        default: assert(false && "Only numbers are stored contiguously");
+    }
+
+    #undef READ_NUMBERS
+}
+
+template<typename Number>
+void CborReader::readNumberArray(JsonNumberArray* array) {
+    const auto& extents = array->getExtents();
+
+    const uint8_t* start = cursor;
+    std::size_t length = readNumberArrayLength<Number>(extents.size());
+    cursor = start;
+
+    if (length != array->size() && !array->isResizable())
+        throw fixedCapacityMismatch(length, array->size());
+    if (length > array->maxSize())
+        throw capacityExceeded(length, array->maxSize());
+
+    if (isResizeNeeded(array, length, resource))
+        array->resize(length, resource);
+
+    Number* numbers = array->unwrapPointer<Number>();
+
+    const uint64_t tag = readTags();
+    if (tag != cborMultiDimensionalTag) {
+        readNumbers(numbers, extents, 0, tag);
+        return;
+    }
+
+    // [extents, elements], the extents were checked against the data above but not against each other
+    Container pair = readArrayHeader();
+    Container dimensions = readArrayHeader();
+    if (pair.length != 2 || dimensions.length != extents.size())
+        throw InvalidCborException("Expected a multi-dimensional array of " + std::to_string(extents.size()) +
+                                   " dimensions at offset " + offsetText(cursor));
+
+    std::size_t count = 1;
+    for (std::size_t extent : extents) {
+        uint64_t dimension = readNumber<uint64_t>();
+        if (dimension != extent)
+            throw fixedCapacityMismatch(static_cast<std::size_t>(dimension), extent);
+        count *= extent;
+    }
+    readContainerEnd(dimensions);
+
+    readNumberRow(numbers, count, readTags());
+    readContainerEnd(pair);
+}
+
+/**
+ * Reads the length of the outermost dimension of a number array, which may be a typed array,
+ * an RFC 8746 multi-dimensional array or an array of numbers or of nested arrays.
+ */
+template<typename Number>
+std::size_t CborReader::readNumberArrayLength(std::size_t dimensions) {
+    const uint64_t tag = readTags();
+
+    if (tag == cborMultiDimensionalTag) {
+        readArrayHeader();
+        if (readArrayHeader().length != dimensions)
+            throw InvalidCborException("Expected a multi-dimensional array of " + std::to_string(dimensions) +
+                                       " dimensions at offset " + offsetText(cursor));
+
+        uint64_t length = readNumber<uint64_t>();
+        if (length > static_cast<uint64_t>(end - cursor))
+            throw InvalidCborException("CBOR array of " + std::to_string(length) + " elements exceeds the data");
+        return static_cast<std::size_t>(length);
+    }
+
+    bool isLittleEndian;
+    if (dimensions == 1 && tag >= 64 && tag <= 87)
+        return readTypedArrayHeader<Number>(tag, isLittleEndian);
+
+    return readArrayHeader().length;
+}
+
+// Reads a dimension of a number array, whose tag has been read already
+template<typename Number>
+Number* CborReader::readNumbers(Number* numbers, const std::vector<std::size_t>& extents, std::size_t dimension,
+                               uint64_t tag) {
+    if (dimension + 1 == extents.size())
+        return readNumberRow(numbers, extents[dimension], tag);
+
+    Container header = readArrayHeader();
+    if (header.length != extents[dimension])
+        throw fixedCapacityMismatch(header.length, extents[dimension]);
+
+    for (std::size_t i = 0; i < header.length; ++i)
+        numbers = readNumbers(numbers, extents, dimension + 1, readTags());
+
+    readContainerEnd(header);
+    return numbers;
+}
+
+// Reads count numbers from a typed array, copied in one go, or from an array of numbers
+template<typename Number>
+Number* CborReader::readNumberRow(Number* numbers, std::size_t count, uint64_t tag) {
+    if (tag >= 64 && tag <= 87) {
+        bool isLittleEndian;
+        std::size_t length = readTypedArrayHeader<Number>(tag, isLittleEndian);
+        if (length != count)
+            throw fixedCapacityMismatch(length, count);
+
+        const uint8_t* bytes = readBytes(count * sizeof(Number));
+        if (isLittleEndian)
+            copyLittleEndian<Number>(bytes, numbers, count);
+        else
+            copyBigEndian<Number>(bytes, numbers, count);
+
+        return numbers + count;
+    }
+
+    Container header = readArrayHeader();
+    if (header.length != count)
+        throw fixedCapacityMismatch(header.length, count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (peekValue() == 0xf6)
+            throw TypeMismatchException("CBOR array contains null elements");
+        *numbers++ = readNumber<Number>();
+    }
+
+    readContainerEnd(header);
+    return numbers;
+}
+
+/**
+ * Reads the byte string header of a typed array holding numbers of type Number.
+ *
+ * @return The number of elements, the cursor is left at the first of them
+ */
+template<typename Number>
+std::size_t CborReader::readTypedArrayHeader(uint64_t tag, bool& isLittleEndian) {
+    if (!isTypedArrayOf<Number>(tag, isLittleEndian))
+        throw TypeMismatchException(std::string("Expected typed array of ") + numberTypeName<Number>() +
+                                    ", got tag " + std::to_string(tag));
+
+    Head head = readHead();
+    if (head.majorType != CborBytes || head.isIndefinite())
+        throw InvalidCborException("Typed array at offset " + offsetText(cursor) +
+                                   " isn't a definite-length byte string");
+    if (head.argument % sizeof(Number) != 0 || head.argument > static_cast<uint64_t>(end - cursor))
+        throw InvalidCborException("Typed array of " + std::to_string(head.argument) + " bytes doesn't fit " +
+                                   numberTypeName<Number>() + " elements or exceeds the data");
+
+    return static_cast<std::size_t>(head.argument / sizeof(Number));
+}
+
+inline void CborReader::readInlineString(JsonInlineString* string) {
+    auto str = readString();
+
+    if (str.length() > string->capacity())
+        throw StringLengthExceededException("String length mismatch: CBOR contains " + std::to_string(str.length()) +
+                                            " characters, but given string has fixed capacity of " +
+                                            std::to_string(string->capacity()) + " characters.");
+
+    string->assign(str);
+}
+
+inline void CborReader::visit(JsonInlineString* string, rapidjson::Value&) {
+    readInlineString(string);
+}
+
+inline void CborReader::visit(JsonNullableInlineString* string, rapidjson::Value&) {
+    if (isNullNext())
+        return string->resetReferencedValue();
+
+    if (string->isReferencedValueNull())
+        string->reinitializeReferencedValue();
+
+    readInlineString(string);
+}
+
+// Codecs decode from JSON, so the value is converted to JSON first. Bytes are read from byte
+// strings directly, or else from their base64 or hex text.
+inline void CborReader::readCustomValue(JsonCustomValue* value) {
+    if (value->isBytes() && (peekValue() >> 5) == CborBytes) {
+        auto bytes = readStringChunks();
+        return value->assignBytes(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+    }
+
+    rapidjson::Value json;
+    readJsonValue(json);
+
+    value->decode(json);
+}
+
+inline void CborReader::readJsonValue(rapidjson::Value& value) {
+    auto& allocator = customValues.GetAllocator();
+    const uint8_t initialByte = peekValue();
+
+    switch (initialByte >> 5) {
+        case CborUnsigned:
+        case CborNegative:
+            readNumberValue(value);
+            return;
+
+        case CborText: {
+            auto str = readString();
+            value.SetString(str.data(), static_cast<rapidjson::SizeType>(str.length()), allocator);
+            return;
+        }
+
+        case CborMap: {
+            const Container map = readMapHeader();
+            enterNesting();
+            value.SetObject();
+
+            for (std::size_t entry = 0; entry < map.length; ++entry) {
+                auto key = readString();
+                rapidjson::Value name(key.data(), static_cast<rapidjson::SizeType>(key.length()), allocator);
+
+                rapidjson::Value member;
+                readJsonValue(member);
+                value.AddMember(name, member, allocator);
+            }
+
+            readContainerEnd(map);
+            leaveNesting();
+            return;
+        }
+
+        case CborArray: {
+            const Container array = readArrayHeader();
+            enterNesting();
+            value.SetArray();
+
+            for (std::size_t element = 0; element < array.length; ++element) {
+                rapidjson::Value item;
+                readJsonValue(item);
+                value.PushBack(item, allocator);
+            }
+
+            readContainerEnd(array);
+            leaveNesting();
+            return;
+        }
+    }
+
+    if (initialByte == 0xf6) {
+        ++cursor;
+        value.SetNull();
+    }
+    else if (initialByte == 0xf4 || initialByte == 0xf5)
+        value.SetBool(readBool());
+    else if (initialByte >= 0xf9 && initialByte <= 0xfb)
+        readNumberValue(value);
+    else
+        throw typeMismatch("a value representable in JSON");
+}
+
+inline void CborReader::visit(JsonCustomValue* value, rapidjson::Value&) {
+    readCustomValue(value);
+}
+
+inline void CborReader::visit(JsonNullableCustomValue* value, rapidjson::Value&) {
+    if (isNullNext())
+        return value->resetReferencedValue();
+
+    if (value->isReferencedValueNull())
+        value->reinitializeReferencedValue();
+
+    readCustomValue(value);
+}
+
+inline void CborReader::readVariantAlternative(JsonVariant* variant) {
+    auto select = [variant](std::string_view tag) {
+        if (!variant->selectAlternative(tag))
+            throw TypeMismatchException(std::string("Unknown variant alternative \"").append(tag) + "\"");
+    };
+
+    readTags();
+    const uint8_t* start = cursor;
+    const Container map = readMapHeader();
+
+    if (VariantTagging::Internal == variant->taggingStyle()) {
+        std::string tag;
+        bool hasTag = false;
+
+        // The discriminator selects the alternative whose members are read, so it is looked up first
+        for (std::size_t entry = 0; entry < map.length && !hasTag; ++entry) {
+            if ((peekValue() >> 5) != CborText)
+                skipValue();
+            else if (readString() == variant->discriminatorName()) {
+                tag = readString();
+                hasTag = true;
+                continue;
+            }
+
+            skipValue();
+        }
+
+        if (!hasTag)
+            throw MemberNotFoundException(variant->discriminatorName());
+
+        select(tag);
+        cursor = start;
+        readObjectMembers(variant->getAlternative().get());
+    }
+    else {
+        if (map.length != 1)
+            throw TypeMismatchException("Expected an object with a single variant tag, got " + std::to_string(map.length) +
+                                        " members");
+
+        enterNesting();
+        select(readString());
+        readObjectMembers(variant->getAlternative().get());
+        readContainerEnd(map);
+        leaveNesting();
+    }
+}
+
+inline void CborReader::visit(JsonVariant* variant, rapidjson::Value&) {
+    readVariantAlternative(variant);
+}
+
+inline void CborReader::visit(JsonNullableVariant* variant, rapidjson::Value&) {
+    if (isNullNext())
+        return variant->resetReferencedValue();
+
+    readVariantAlternative(variant);
+}
+
+
+template<typename Struct>
+void marshalCborImpl(const Struct& s, std::vector<uint8_t>& buffer) {
+    JsonObject root(buildJsonTreeFrom(s));
+
+    buffer.clear();
+
+    CborWriter writer(buffer);
+    writer.writeToCbor(&root);
+}
+
+template<typename Struct>
+void unmarshalCborImpl(const uint8_t* data, std::size_t size, Struct& s, std::pmr::memory_resource* resource) {
+    CborReader reader(data, size, resource);
+
+    JsonObject root(buildJsonTreeFrom(s));
+    reader.readFromCbor(&root);
+}
+
+}  // namespace detail
+
+
+template<typename Struct>
+void marshal_cbor(const Struct& s, std::vector<uint8_t>& buffer) {
+    detail::marshalCborImpl(s, buffer);
+}
+
+template<typename Struct>
+std::vector<uint8_t> marshal_cbor(const Struct& s) {
+    std::vector<uint8_t> buffer;
+    detail::marshalCborImpl(s, buffer);
+
+    return buffer;
+}
+
+template<typename Struct>
+void unmarshal_cbor(const uint8_t* data, std::size_t size, Struct& s, std::pmr::memory_resource* resource) {
+    detail::unmarshalCborImpl(data, size, s, resource);
+}
+
+template<typename Struct>
+void unmarshal_cbor(const std::vector<uint8_t>& data, Struct& s, std::pmr::memory_resource* resource) {
+    detail::unmarshalCborImpl(data.data(), data.size(), s, resource);
+}
+
+inline InvalidCborException::InvalidCborException(std::string_view what) :
+    std::logic_error(what.data()) {
+}
+
+}  // namespace rapidjson_util
+
+#endif
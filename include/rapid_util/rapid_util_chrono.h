@@ -0,0 +1,373 @@
+// Copyright (C) 2025 Liu Wu. All rights reserved.
+//
+// Licensed under the zlib License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/Zlib
+//
+// This software is provided as-is, without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+
+
+#ifndef __RAPIDJSON_UTIL_CHRONO_H__
+#define __RAPIDJSON_UTIL_CHRONO_H__
+
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <ratio>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "rapid_util_parser.h"
+
+namespace rapidjson_util {
+namespace detail {
+
+struct CivilDate {
+    int64_t year;
+    unsigned month;    // [1, 12]
+    unsigned day;      // [1, 31]
+};
+
+// Days since 1970-01-01 of a date in the proleptic Gregorian calendar. The calendar repeats
+// every 400 years (an era of 146097 days), and years are counted from March, so that the leap
+// day is the last day of a year and the day of the year follows from the month arithmetically.
+constexpr int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) noexcept {
+    year -= month <= 2;
+
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);                          // [0, 399]
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;    // [0, 365]
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;     // [0, 146096]
+
+    return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+// Inverse of daysFromCivil
+constexpr CivilDate civilFromDays(int64_t days) noexcept {
+    days += 719468;
+
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);                                        // [0, 146096]
+    const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;        // [0, 399]
+    const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);                   // [0, 365]
+    const unsigned monthFromMarch = (5 * dayOfYear + 2) / 153;                                                   // [0, 11]
+    const unsigned day = dayOfYear - (153 * monthFromMarch + 2) / 5 + 1;
+    const unsigned month = monthFromMarch < 10 ? monthFromMarch + 3 : monthFromMarch - 9;
+
+    return CivilDate{ static_cast<int64_t>(yearOfEra) + era * 400 + (month <= 2), month, day };
+}
+
+constexpr unsigned lastDayOfMonth(int64_t year, unsigned month) noexcept {
+    const bool isLeapYear = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+
+    return month == 2 ? 28 + isLeapYear : 30 + ((month ^ (month >> 3)) & 1);
+}
+
+
+constexpr uint32_t powersOf10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+// "YYYY-MM-DDTHH:MM:SS.nnnnnnnnnZ"
+constexpr std::size_t maxRfc3339Length = 30;
+
+inline char* writeDigits(char* out, uint32_t value, int width) noexcept {
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+
+    return out + width;
+}
+
+// Reads exactly width digits; every character is consumed, and the result is only valid if true is returned
+inline bool readDigits(const char* in, int width, uint32_t& value) noexcept {
+    uint32_t result = 0;
+    bool isDigits = true;
+
+    for (int i = 0; i < width; ++i) {
+        uint32_t digit = static_cast<uint32_t>(static_cast<unsigned char>(in[i])) - '0';
+
+        isDigits &= digit <= 9;
+        result = result * 10 + digit;
+    }
+
+    value = result;
+    return isDigits;
+}
+
+/**
+ * Number of fractional second digits written for time points of Duration: none for whole
+ * seconds, 3 for milliseconds, 6 for microseconds and 9 for nanoseconds or finer, or for
+ * floating-point ticks, which hold fractions of any period.
+ */
+template<typename Duration>
+constexpr int fractionDigits() {
+    using Period = typename Duration::period;
+
+    if (std::is_floating_point_v<typename Duration::rep>)
+        return 9;
+
+    int digits = 0;
+    for (std::intmax_t scale = 1; scale < Period::den && digits < 9; scale *= 10)
+        ++digits;
+
+    return digits;
+}
+
+/**
+ * @brief Writes timePoint as an RFC 3339 UTC timestamp, e.g. 2024-01-15T10:30:00.250Z
+ *
+ * The fraction has a fixed number of digits given by the precision of Duration, so timestamps
+ * round-trip exactly. RFC 3339 has four digit years, so time points outside years [0, 9999]
+ * throw UnserializableValueException.
+ *
+ * @return Number of characters written to out, at most maxRfc3339Length
+ */
+template<typename Duration>
+std::size_t formatRfc3339(std::chrono::time_point<std::chrono::system_clock, Duration> timePoint, char* out) {
+    constexpr int digits = fractionDigits<Duration>();
+
+    const auto wholeSeconds = std::chrono::floor<std::chrono::seconds>(timePoint);
+    const int64_t seconds = wholeSeconds.time_since_epoch().count();
+    const int64_t days = (seconds >= 0 ? seconds : seconds - 86399) / 86400;
+    const auto secondOfDay = static_cast<uint32_t>(seconds - days * 86400);
+
+    const CivilDate date = civilFromDays(days);
+    if (date.year < 0 || date.year > 9999)
+        throw UnserializableValueException("Expected a time point in years 0 to 9999, got one in year " + std::to_string(date.year));
+
+    char* end = writeDigits(out, static_cast<uint32_t>(date.year), 4);
+    *end++ = '-';
+    end = writeDigits(end, date.month, 2);
+    *end++ = '-';
+    end = writeDigits(end, date.day, 2);
+    *end++ = 'T';
+    end = writeDigits(end, secondOfDay / 3600, 2);
+    *end++ = ':';
+    end = writeDigits(end, secondOfDay / 60 % 60, 2);
+    *end++ = ':';
+    end = writeDigits(end, secondOfDay % 60, 2);
+
+    if constexpr (digits > 0) {
+        auto nanoseconds = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(timePoint - wholeSeconds).count());
+
+        *end++ = '.';
+        end = writeDigits(end, nanoseconds / powersOf10[9 - digits], digits);
+    }
+
+    *end++ = 'Z';
+
+    return static_cast<std::size_t>(end - out);
+}
+
+
+/**
+ * @brief Parses an RFC 3339 timestamp such as 2024-01-15T10:30:00.250+01:00
+ *
+ * Accepts any number of fraction digits, of which the first 9 are kept, and a Z or numeric
+ * UTC offset. Returns false if text is not a valid timestamp.
+ */
+inline bool parseRfc3339(std::string_view text, UnixTime& time) noexcept {
+    if (text.size() < 20)
+        return false;
+
+    const char* in = text.data();
+    uint32_t year, month, day, hour, minute, second;
+
+    bool isValid = readDigits(in, 4, year) & (in[4] == '-') & readDigits(in + 5, 2, month) & (in[7] == '-') &
+                   readDigits(in + 8, 2, day) & (in[10] == 'T' || in[10] == 't' || in[10] == ' ') &
+                   readDigits(in + 11, 2, hour) & (in[13] == ':') & readDigits(in + 14, 2, minute) & (in[16] == ':') &
+                   readDigits(in + 17, 2, second);
+
+    // Second 60 is a leap second, which counts as the first second of the next minute
+    isValid = isValid && month - 1 < 12 && hour < 24 && minute < 60 && second <= 60;
+    if (!isValid || day - 1 >= lastDayOfMonth(year, month))
+        return false;
+
+    std::size_t position = 19;
+    uint32_t nanoseconds = 0;
+
+    if (in[position] == '.') {
+        const std::size_t first = ++position;
+
+        for (; position < text.size() && static_cast<unsigned>(in[position] - '0') <= 9; ++position)
+            if (position - first < 9)
+                nanoseconds = nanoseconds * 10 + static_cast<uint32_t>(in[position] - '0');
+
+        const std::size_t count = position - first;
+        if (count == 0)
+            return false;
+        if (count < 9)
+            nanoseconds *= powersOf10[9 - count];
+    }
+
+    if (position == text.size())
+        return false;
+
+    int64_t offset = 0;
+    const char zone = in[position++];
+
+    if (zone == '+' || zone == '-') {
+        uint32_t offsetHour, offsetMinute;
+
+        if (text.size() - position != 5 ||
+            !(readDigits(in + position, 2, offsetHour) & (in[position + 2] == ':') & readDigits(in + position + 3, 2, offsetMinute)) ||
+            offsetHour > 23 || offsetMinute > 59)
+            return false;
+
+        offset = (zone == '-' ? -1 : 1) * static_cast<int64_t>(offsetHour * 3600 + offsetMinute * 60);
+        position += 5;
+    }
+    else if (zone != 'Z' && zone != 'z')
+        return false;
+
+    if (position != text.size())
+        return false;
+
+    time.seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+    time.nanoseconds = nanoseconds;
+    return true;
+}
+
+
+template<typename T>
+struct chrono_duration_of {
+    using type = T;
+};
+
+template<typename Clock, typename Duration>
+struct chrono_duration_of<std::chrono::time_point<Clock, Duration>> {
+    using type = Duration;
+};
+
+template<ChronoEncoding Encoding, typename Chrono>
+struct chrono_duration_of<chrono_as<Encoding, Chrono>> : chrono_duration_of<Chrono> {};
+
+template<typename Chrono>
+constexpr bool is_chrono_time_point_v = !std::is_same_v<chrono_underlying_t<Chrono>, typename chrono_duration_of<Chrono>::type>;
+
+/**
+ * @brief Encodes and decodes a std::chrono time point or duration in its chrono_encoding_of
+ */
+template<typename Chrono>
+struct chrono_codec {
+    using Duration = typename chrono_duration_of<Chrono>::type;
+
+    static constexpr bool is_time_point = is_chrono_time_point_v<Chrono>;
+    static constexpr ChronoEncoding encoding = chrono_encoding_of<Chrono>::value;
+
+    static_assert(encoding != ChronoEncoding::Rfc3339 || is_time_point, "RFC 3339 encodes time points, not durations");
+
+    // Counts of floating-point ticks are JSON doubles, so that fractions of a tick survive
+    static constexpr bool is_fractional_count = encoding == ChronoEncoding::Count && std::is_floating_point_v<typename Duration::rep>;
+
+    // The integer JSON value counts ticks of EncodedDuration
+    using EncodedDuration = std::conditional_t<encoding == ChronoEncoding::Milliseconds, std::chrono::duration<int64_t, std::milli>,
+                            std::conditional_t<encoding == ChronoEncoding::Nanoseconds, std::chrono::duration<int64_t, std::nano>,
+                                               std::chrono::duration<fixed_width_integer_t<typename Duration::rep>,
+                                                                     typename Duration::period>>>;
+
+    static void encode(const void* value, rapidjson::Value& jsonOutput, rapidjson::Document::AllocatorType& allocator) {
+        const Chrono& chrono = *static_cast<const Chrono*>(value);
+
+        if constexpr (encoding == ChronoEncoding::Rfc3339) {
+            char text[maxRfc3339Length];
+            std::size_t length = formatRfc3339(chrono, text);
+
+            jsonOutput.SetString(text, static_cast<rapidjson::SizeType>(length), allocator);
+        }
+        else if constexpr (is_fractional_count)
+            jsonOutput.SetDouble(static_cast<double>(durationOf(chrono).count()));
+        else {
+            auto count = std::chrono::floor<EncodedDuration>(durationOf(chrono)).count();
+
+            if constexpr (std::is_signed_v<decltype(count)>)
+                jsonOutput.SetInt64(count);
+            else
+                jsonOutput.SetUint64(count);
+        }
+    }
+
+    static void decode(void* value, const rapidjson::Value& jsonInput) {
+        Chrono& chrono = *static_cast<Chrono*>(value);
+
+        if constexpr (encoding == ChronoEncoding::Rfc3339) {
+            RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsString);
+
+            std::string_view text(jsonInput.GetString(), jsonInput.GetStringLength());
+            UnixTime time;
+
+            ThrowUnless(parseRfc3339(text, time),
+                        TypeMismatchException(std::string("Expected RFC 3339 timestamp, got \"").append(text) + "\""));
+            ThrowUnless(isRepresentable(time.seconds),
+                        TypeMismatchException(std::string("Timestamp \"").append(text) + "\" is out of range"));
+
+            chrono = timePointOf(time);
+        }
+        else if constexpr (is_fractional_count) {
+            RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsDouble);
+
+            chrono = Chrono(Duration(static_cast<typename Duration::rep>(jsonInput.GetDouble())));
+        }
+        else {
+            using Integer = typename EncodedDuration::rep;
+
+            EncodedDuration encoded(RapidjsonValueTypeValidator::narrow<Integer>(jsonInput));
+            chrono = Chrono(std::chrono::floor<Duration>(encoded));
+        }
+    }
+
+    // MessagePack and CBOR write RFC 3339 time points as their native timestamps instead
+    static UnixTime time(const void* value) {
+        const Duration sinceEpoch = static_cast<const Chrono*>(value)->time_since_epoch();
+        const auto wholeSeconds = std::chrono::floor<std::chrono::seconds>(sinceEpoch);
+
+        return { static_cast<int64_t>(wholeSeconds.count()),
+                 static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch - wholeSeconds).count()) };
+    }
+
+    static void assignTime(void* value, UnixTime time) {
+        if (!isRepresentable(time.seconds) || time.nanoseconds > 999999999)
+            throw TypeMismatchException("Timestamp of " + std::to_string(time.seconds) + " seconds and " +
+                                        std::to_string(time.nanoseconds) + " nanoseconds is out of range");
+
+        *static_cast<Chrono*>(value) = timePointOf(time);
+    }
+
+    static constexpr JsonCustomValue::NativeAccess native() {
+        if constexpr (encoding == ChronoEncoding::Rfc3339)
+            return { nullptr, nullptr, &time, &assignTime };
+        else
+            return {};
+    }
+
+private:
+    static Chrono timePointOf(UnixTime time) {
+        return Chrono(std::chrono::floor<Duration>(std::chrono::seconds(time.seconds)) +
+                      std::chrono::floor<Duration>(std::chrono::nanoseconds(time.nanoseconds)));
+    }
+
+    static Duration durationOf(const Chrono& chrono) {
+        if constexpr (is_time_point)
+            return chrono.time_since_epoch();
+        else
+            return chrono;
+    }
+
+    // Only durations finer than a second can overflow when whole seconds are converted to them
+    static bool isRepresentable(int64_t seconds) {
+        if constexpr (std::ratio_less_v<typename Duration::period, std::ratio<1>>)
+            return seconds > std::chrono::ceil<std::chrono::seconds>(Duration::min()).count() &&
+                   seconds < std::chrono::floor<std::chrono::seconds>(Duration::max()).count();
+        else
+            return true;
+    }
+};
+
+}  // namespace detail
+}  // namespace rapidjson_util
+
+#endif
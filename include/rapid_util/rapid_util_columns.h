@@ -0,0 +1,601 @@
+// Copyright (C) 2025 Liu Wu. All rights reserved.
+//
+// Licensed under the zlib License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/Zlib
+//
+// This software is provided as-is, without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+
+
+#ifndef __RAPIDJSON_UTIL_COLUMNS_H__
+#define __RAPIDJSON_UTIL_COLUMNS_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "rapid_util.h"
+
+
+namespace rapidjson_util {
+
+/**
+ * @brief Exception thrown when a line of NDJSON fails to deserialize
+ */
+class LineDeserializationFailure : public std::logic_error {
+public:
+    LineDeserializationFailure(std::string_view what);
+};
+
+
+template<typename Struct>
+class columns;
+
+namespace detail {
+
+struct ColumnsAccess;
+
+/**
+ * Validity of the rows of a column, as an Arrow validity bitmap: bit i of byte i / 8, counting
+ * from the least significant bit, is set if row i holds a value. It is only allocated when the
+ * first null is appended, until then every row is valid.
+ */
+class ColumnValidity {
+public:
+    const uint8_t* data() const noexcept {
+        return nullCount == 0 ? nullptr : bits.data();
+    }
+
+    bool isValid(std::size_t row) const noexcept {
+        return nullCount == 0 || (bits[row / 8] >> (row % 8)) & 1;
+    }
+
+    std::size_t countNulls() const noexcept {
+        return nullCount;
+    }
+
+    void append(std::size_t row, bool valid) {
+        if (valid && nullCount == 0)
+            return;
+
+        if (nullCount == 0)
+            setValidUpTo(row);
+
+        bits.resize(row / 8 + 1, 0);
+        if (valid)
+            bits[row / 8] |= static_cast<uint8_t>(1u << (row % 8));
+        else
+            ++nullCount;
+    }
+
+    void truncate(std::size_t rows) {
+        if (nullCount == 0)
+            return;
+
+        bits.resize((rows + 7) / 8);
+        if (rows % 8 != 0)
+            bits.back() &= static_cast<uint8_t>((1u << (rows % 8)) - 1);
+
+        nullCount = 0;
+        for (std::size_t row = 0; row < rows; ++row)
+            nullCount += (bits[row / 8] >> (row % 8) & 1) == 0;
+
+        if (nullCount == 0)
+            bits.clear();
+    }
+
+private:
+    // The rows before the first null become valid
+    void setValidUpTo(std::size_t rows) {
+        bits.assign(rows / 8, 0xFF);
+        if (rows % 8 != 0)
+            bits.push_back(static_cast<uint8_t>((1u << (rows % 8)) - 1));
+    }
+
+    std::vector<uint8_t> bits;
+    std::size_t nullCount = 0;
+};
+
+}  // namespace detail
+
+
+/**
+ * @brief A column of numbers or bools, stored contiguously so that kernels can run over data()
+ *
+ * bools are stored as one uint8_t of 0 or 1 each. Rows without a value hold 0 and are cleared
+ * in the validity bitmap.
+ */
+template<typename Number>
+class number_column {
+public:
+    using value_type = Number;
+    using storage_type = std::conditional_t<std::is_same_v<Number, bool>, uint8_t, Number>;
+
+    std::size_t size() const noexcept { return values.size(); }
+    bool empty() const noexcept { return values.empty(); }
+    const storage_type* data() const noexcept { return values.data(); }
+    Number operator[](std::size_t row) const { return static_cast<Number>(values[row]); }
+
+    /**
+     * @brief The Arrow validity bitmap of the column, or nullptr if every row holds a value
+     */
+    const uint8_t* validity() const noexcept { return rowValidity.data(); }
+    bool is_valid(std::size_t row) const noexcept { return rowValidity.isValid(row); }
+    std::size_t null_count() const noexcept { return rowValidity.countNulls(); }
+
+    void reserve(std::size_t rows) { values.reserve(rows); }
+
+    void append(Number value) {
+        rowValidity.append(values.size(), true);
+        values.push_back(static_cast<storage_type>(value));
+    }
+
+    void append_null() {
+        rowValidity.append(values.size(), false);
+        values.push_back(storage_type{});
+    }
+
+private:
+    friend struct detail::ColumnsAccess;
+
+    void truncate(std::size_t rows) {
+        values.resize(rows);
+        rowValidity.truncate(rows);
+    }
+
+    std::vector<storage_type> values;
+    detail::ColumnValidity rowValidity;
+};
+
+
+/**
+ * @brief A column of strings, laid out as Arrow large strings: the characters of all rows one
+ *        after another, and size() + 1 offsets where each row starts and the last one ends
+ *
+ * Rows without a value are empty strings and are cleared in the validity bitmap.
+ */
+class string_column {
+public:
+    using value_type = std::string_view;
+
+    std::size_t size() const noexcept { return stringOffsets.size() - 1; }
+    bool empty() const noexcept { return size() == 0; }
+    const int64_t* offsets() const noexcept { return stringOffsets.data(); }
+    const char* chars() const noexcept { return characters.data(); }
+
+    std::string_view operator[](std::size_t row) const {
+        auto offset = static_cast<std::size_t>(stringOffsets[row]);
+        return std::string_view(characters.data() + offset, static_cast<std::size_t>(stringOffsets[row + 1]) - offset);
+    }
+
+    /**
+     * @brief The Arrow validity bitmap of the column, or nullptr if every row holds a value
+     */
+    const uint8_t* validity() const noexcept { return rowValidity.data(); }
+    bool is_valid(std::size_t row) const noexcept { return rowValidity.isValid(row); }
+    std::size_t null_count() const noexcept { return rowValidity.countNulls(); }
+
+    void reserve(std::size_t rows) { stringOffsets.reserve(rows + 1); }
+
+    void append(std::string_view value) {
+        rowValidity.append(size(), true);
+        characters.append(value.data(), value.size());
+        stringOffsets.push_back(static_cast<int64_t>(characters.size()));
+    }
+
+    void append_null() {
+        rowValidity.append(size(), false);
+        stringOffsets.push_back(stringOffsets.back());
+    }
+
+private:
+    friend struct detail::ColumnsAccess;
+
+    void truncate(std::size_t rows) {
+        stringOffsets.resize(rows + 1);
+        characters.resize(static_cast<std::size_t>(stringOffsets.back()));
+        rowValidity.truncate(rows);
+    }
+
+    std::vector<int64_t> stringOffsets{ 0 };
+    std::string characters;
+    detail::ColumnValidity rowValidity;
+};
+
+
+namespace detail {
+
+// Stands in for the members that aren't exported to a column
+struct UnexportedColumn {
+    void reserve(std::size_t) {}
+};
+
+template<typename Member, typename = void>
+struct column_type {
+    using type = UnexportedColumn;
+};
+
+template<typename Member>
+struct column_type<Member, std::enable_if_t<!has_json_codec_v<Member> &&
+                                            std::is_arithmetic_v<remove_nullable_wrapper_t<Member>> &&
+                                            is_json_primitive_core_type_v<remove_nullable_wrapper_t<Member>>>> {
+    using type = number_column<remove_nullable_wrapper_t<Member>>;
+};
+
+template<typename Member>
+struct column_type<Member, std::enable_if_t<!has_json_codec_v<Member> &&
+                                            (std::is_same_v<remove_nullable_wrapper_t<Member>, std::string> ||
+                                             std::is_same_v<remove_nullable_wrapper_t<Member>, std::pmr::string> ||
+                                             is_json_inline_string_v<Member>)>> {
+    using type = string_column;
+};
+
+template<typename Member>
+using column_type_t = typename column_type<std::remove_const_t<Member>>::type;
+
+template<typename... MemberDescriptors>
+auto makeColumnTuple(TypeList<MemberDescriptors...>)
+    -> std::tuple<column_type_t<member_type_t<decltype(MemberDescriptors::pointer())>>...>;
+
+template<typename Struct>
+using column_tuple_t = decltype(makeColumnTuple(Descriptor<Struct>::member_descriptors));
+
+template<typename Tuple, typename F, typename... MemberDescriptors, std::size_t... Indices>
+void forEachColumn(Tuple& columnTuple, TypeList<MemberDescriptors...>, std::index_sequence<Indices...>, F&& f) {
+    (..., f(MemberDescriptors{}, std::get<Indices>(columnTuple)));
+}
+
+template<typename Tuple, typename F, typename... MemberDescriptors>
+void forEachColumn(Tuple& columnTuple, TypeList<MemberDescriptors...> members, F&& f) {
+    forEachColumn(columnTuple, members, std::index_sequence_for<MemberDescriptors...>{}, std::forward<F>(f));
+}
+
+template<typename Value>
+std::string_view viewColumnString(const Value& value) {
+    if constexpr (is_json_inline_string_v<Value>)
+        return inline_string_traits<Value>::view(&value);
+    else
+        return std::string_view(value.data(), value.size());
+}
+
+template<typename Member, typename Column>
+void appendColumnValue(Column& column, const Member& member) {
+    if constexpr (is_nullable_wrapper_v<Member>) {
+        if (!member)
+            column.append_null();
+        else
+            appendColumnValue(column, *member);
+    }
+    else if constexpr (std::is_same_v<Column, string_column>)
+        column.append(viewColumnString(member));
+    else
+        column.append(member);
+}
+
+template<typename Member, typename Column>
+void readColumnValue(Column& column, const rapidjson::Value& value) {
+    using Type = std::remove_const_t<remove_nullable_wrapper_t<Member>>;
+
+    if constexpr (is_nullable_wrapper_v<Member>) {
+        if (value.IsNull())
+            return column.append_null();
+    }
+
+    if constexpr (std::is_same_v<Column, string_column>) {
+        RapidjsonValueTypeValidator::validate(value, QueryType::IsString);
+
+        std::size_t length = value.GetStringLength();
+        if constexpr (is_json_inline_string_v<Type>) {
+            constexpr std::size_t capacity = inline_string_traits<Type>::capacity;
+            ThrowUnless(length <= capacity, StringLengthExceededException(
+                            "String length mismatch: JSON contains " + std::to_string(length) + " characters, but given string "
+                            "has fixed capacity of " + std::to_string(capacity) + " characters."));
+        }
+
+        column.append(std::string_view(value.GetString(), length));
+    }
+    else if constexpr (std::is_same_v<Type, bool>) {
+        RapidjsonValueTypeValidator::validate(value, QueryType::IsBool);
+        column.append(value.GetBool());
+    }
+    else if constexpr (std::is_same_v<Type, float>) {
+        RapidjsonValueTypeValidator::validate(value, QueryType::IsFloat);
+        column.append(value.GetFloat());
+    }
+    else if constexpr (std::is_same_v<Type, double>) {
+        RapidjsonValueTypeValidator::validate(value, QueryType::IsDouble);
+        column.append(value.GetDouble());
+    }
+    else
+        column.append(RapidjsonValueTypeValidator::narrow<Type>(value));
+}
+
+// Appends the value a member missing from the JSON is left out with, see Omission
+template<typename Struct, typename Desc, typename Column>
+bool appendOmittedColumnValue(Column& column) {
+    using Member = member_type_t<decltype(Desc::pointer())>;
+    constexpr Omission omission = member_omission<Struct>::style;
+
+    if constexpr (omission == Omission::Nulls && is_nullable_wrapper_v<Member>) {
+        column.append_null();
+        return true;
+    }
+    else if constexpr (omission == Omission::Defaults && std::is_default_constructible_v<Struct> &&
+                       defaultOmissionOf<Member>() != DefaultOmission::Never) {
+        appendColumnValue(column, valueInitialized<Struct>().*Desc::pointer());
+        return true;
+    }
+    else
+        return false;
+}
+
+struct ColumnsAccess {
+    template<typename Struct>
+    static void appendStruct(columns<Struct>& table, const Struct& s) {
+        forEachColumn(table.memberColumns, Descriptor<Struct>::member_descriptors, [&](auto descriptor, auto& column) {
+            using Column = std::remove_reference_t<decltype(column)>;
+
+            if constexpr (!std::is_same_v<Column, UnexportedColumn>)
+                appendColumnValue(column, s.*decltype(descriptor)::pointer());
+        });
+
+        ++table.rows;
+    }
+
+    // Every exported member is required unless the Omission of Struct leaves it out, like unmarshal does.
+    // A failing object leaves no partial row behind.
+    template<typename Struct>
+    static void appendJson(columns<Struct>& table, const rapidjson::Value& object) {
+        RapidjsonValueTypeValidator::validate(object, QueryType::IsObject);
+
+        try {
+            forEachColumn(table.memberColumns, Descriptor<Struct>::member_descriptors, [&](auto descriptor, auto& column) {
+                using Column = std::remove_reference_t<decltype(column)>;
+                using MemberType = member_type_t<decltype(decltype(descriptor)::pointer())>;
+
+                if constexpr (!std::is_same_v<Column, UnexportedColumn>) {
+                    auto name = wireNameOf<Struct>(descriptor);
+                    auto member = object.FindMember(name);
+
+                    if (member == object.MemberEnd()) {
+                        ThrowUnless(appendOmittedColumnValue<Struct, decltype(descriptor)>(column), MemberNotFoundException(name));
+                        return;
+                    }
+
+                    try {
+                        readColumnValue<MemberType>(column, member->value);
+                    }
+                    catch (std::logic_error& e) {
+                        throw MemberSerializationFailure(std::string("Deserialization of member \"") +
+                            name + "\" failed: " + e.what());
+                    }
+                }
+            });
+        }
+        catch (...) {
+            truncate(table, table.rows);
+            throw;
+        }
+
+        ++table.rows;
+    }
+
+    template<typename Struct>
+    static void truncate(columns<Struct>& table, std::size_t rows) {
+        forEachColumn(table.memberColumns, Descriptor<Struct>::member_descriptors, [&](auto, auto& column) {
+            if constexpr (!std::is_same_v<std::remove_reference_t<decltype(column)>, UnexportedColumn>)
+                column.truncate(rows);
+        });
+    }
+};
+
+/**
+ * Parses NDJSON line by line into the same document. Its values and the stacks Parse works on
+ * are allocated from buffers that are reused for every line, so that short lines don't allocate
+ * at all; longer ones take chunks from the heap, which are released before the next line.
+ */
+class JsonLinesDecoder {
+public:
+    JsonLinesDecoder() : allocator(buffer, sizeof(buffer)), stackAllocator(stackBuffer, sizeof(stackBuffer)),
+                         document(&allocator, Document::kDefaultStackCapacity, &stackAllocator) {
+    }
+
+    // lineNumber counts from 1, blank lines included
+    template<typename Struct>
+    void decode(std::string_view line, std::size_t lineNumber, columns<Struct>& table) {
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+
+        if (line.find_first_not_of(" \t") == std::string_view::npos)
+            return;
+
+        try {
+            allocator.Clear();
+            stackAllocator.Clear();
+
+            // Checked with a plain if statement, as ThrowUnless would build the exception for every line
+            if (document.Parse(line.data(), line.size()).HasParseError())
+                throw InvalidJsonException("The provided JSON text has invalid syntax");
+
+            ColumnsAccess::appendJson(table, document);
+        }
+        catch (std::logic_error& e) {
+            throw LineDeserializationFailure("Deserialization of line " + std::to_string(lineNumber) + " failed: " + e.what());
+        }
+    }
+
+private:
+    using Allocator = rapidjson::MemoryPoolAllocator<>;
+    using Document = rapidjson::GenericDocument<rapidjson::UTF8<>, Allocator, Allocator>;
+
+    alignas(std::max_align_t) char buffer[4096];
+    alignas(std::max_align_t) char stackBuffer[4096];
+    Allocator allocator;
+    Allocator stackAllocator;
+    Document document;
+};
+
+}  // namespace detail
+
+
+/**
+ * @brief The members of a sequence of structs, as one column per member
+ *
+ * Members are exported as described by RAPIDJSON_UTIL_DESCRIBE_MEMBERS: numbers and bools to a
+ * number_column, std::string, std::pmr::string and inline strings to a string_column. Rows of
+ * std::optional and smart pointer members that are null are marked in the validity bitmap of
+ * their column. Other members, such as nested structs, containers or members with a
+ * json_codec, have no column.
+ *
+ * @code
+ * struct Trade {
+ *     std::string symbol;
+ *     double price;
+ *     std::optional<int> venue;
+ * };
+ * RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Trade, (symbol, price, venue))
+ *
+ * auto table = to_columns(trades);
+ * const double* prices = table.get<&Trade::price>().data();
+ * const uint8_t* venueValidity = table.get<&Trade::venue>().validity();
+ * @endcode
+ */
+template<typename Struct>
+class columns {
+    static_assert(detail::is_describable_struct_v<Struct>,
+                  "Struct must be described by RAPIDJSON_UTIL_DESCRIBE_MEMBERS");
+
+    using ColumnTuple = detail::column_tuple_t<Struct>;
+
+public:
+    std::size_t size() const noexcept { return rows; }
+    bool empty() const noexcept { return rows == 0; }
+
+    /**
+     * @brief The column of Member, a number_column or a string_column
+     */
+    template<auto Member>
+    const auto& get() const {
+        constexpr std::size_t index = detail::describedMemberIndex<Member>(detail::Descriptor<Struct>::member_descriptors);
+        static_assert(index < std::tuple_size_v<ColumnTuple>,
+                      "Only members described by RAPIDJSON_UTIL_DESCRIBE_MEMBERS have columns");
+        static_assert(!std::is_same_v<std::tuple_element_t<index, ColumnTuple>, detail::UnexportedColumn>,
+                      "Only members of numbers, bools and strings have columns");
+
+        return std::get<index>(memberColumns);
+    }
+
+    void append(const Struct& s) {
+        detail::ColumnsAccess::appendStruct(*this, s);
+    }
+
+    void reserve(std::size_t rowCount) {
+        std::apply([&](auto&... column) { (..., column.reserve(rowCount)); }, memberColumns);
+    }
+
+private:
+    friend struct detail::ColumnsAccess;
+
+    ColumnTuple memberColumns;
+    std::size_t rows = 0;
+};
+
+
+/**
+ * @brief Export the members of structs to one contiguous column per member
+ *
+ * @param structs The structs, each becomes a row
+ * @return The columns, see columns for which members have one
+ */
+template<typename Struct, typename Allocator>
+columns<Struct> to_columns(const std::vector<Struct, Allocator>& structs);
+
+/**
+ * @brief Deserialize NDJSON, one JSON object per line, straight into columns
+ *
+ * The objects are decoded member by member into the columns of Struct, without constructing a
+ * Struct for each of them. The members that have a column are required, as unmarshal requires
+ * them unless RAPIDJSON_UTIL_DESCRIBE_OMISSION leaves them out, and the others are ignored.
+ * Blank lines are skipped and line ends may be "\r\n".
+ *
+ * @param ndjson The lines of JSON objects
+ * @param table The columns the rows are appended to
+ * @throws LineDeserializationFailure naming the line that has invalid syntax or doesn't match
+ *         Struct. The lines before it stay appended
+ */
+template<typename Struct>
+void unmarshal_lines_columnar(std::string_view ndjson, columns<Struct>& table);
+
+/**
+ * @brief Deserialize NDJSON read from a stream straight into columns, one line at a time
+ */
+template<typename Struct>
+void unmarshal_lines_columnar(std::istream& input, columns<Struct>& table);
+
+/**
+ * @brief Deserialize NDJSON straight into columns
+ *
+ * @return The columns of the rows
+ */
+template<typename Struct>
+columns<Struct> unmarshal_lines_columnar(std::string_view ndjson);
+
+
+template<typename Struct, typename Allocator>
+columns<Struct> to_columns(const std::vector<Struct, Allocator>& structs) {
+    columns<Struct> table;
+    table.reserve(structs.size());
+
+    for (const auto& s : structs)
+        table.append(s);
+
+    return table;
+}
+
+template<typename Struct>
+void unmarshal_lines_columnar(std::string_view ndjson, columns<Struct>& table) {
+    detail::JsonLinesDecoder decoder;
+    std::size_t lineNumber = 0;
+
+    while (!ndjson.empty()) {
+        std::size_t end = std::min(ndjson.find('\n'), ndjson.size());
+
+        decoder.decode(ndjson.substr(0, end), ++lineNumber, table);
+        ndjson.remove_prefix(std::min(end + 1, ndjson.size()));
+    }
+}
+
+template<typename Struct>
+void unmarshal_lines_columnar(std::istream& input, columns<Struct>& table) {
+    detail::JsonLinesDecoder decoder;
+    std::size_t lineNumber = 0;
+    std::string line;
+
+    while (std::getline(input, line))
+        decoder.decode(line, ++lineNumber, table);
+}
+
+template<typename Struct>
+columns<Struct> unmarshal_lines_columnar(std::string_view ndjson) {
+    columns<Struct> table;
+    unmarshal_lines_columnar(ndjson, table);
+
+    return table;
+}
+
+inline LineDeserializationFailure::LineDeserializationFailure(std::string_view what) :
+    std::logic_error(what.data()) {
+}
+
+}  // namespace rapidjson_util
+
+#endif
@@ -0,0 +1,568 @@
+// Copyright (C) 2025 Liu Wu. All rights reserved.
+//
+// Licensed under the zlib License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/Zlib
+//
+// This software is provided as-is, without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+
+
+#ifndef __RAPIDJSON_UTIL_CONTAINERS_H__
+#define __RAPIDJSON_UTIL_CONTAINERS_H__
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <new>
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace rapidjson_util {
+
+/**
+ * @brief A string of at most N characters stored inline, without heap allocation
+ *
+ * Accepted as a string member by marshal and unmarshal, which read and write the
+ * characters in place. The characters are always followed by a null terminator.
+ */
+template<std::size_t N>
+class fixed_string {
+public:
+    using value_type = char;
+    using size_type = std::size_t;
+    using iterator = char*;
+    using const_iterator = const char*;
+
+    constexpr fixed_string() noexcept = default;
+
+    fixed_string(const char* str) : fixed_string(std::string_view(str)) {
+    }
+
+    fixed_string(std::string_view str) {
+        assign(str.data(), str.size());
+    }
+
+    /**
+      * Replaces the content with count characters starting at str.
+      *
+      * @throw std::length_error if count exceeds the capacity N
+      */
+    fixed_string& assign(const char* str, size_type count) {
+        if (count > N)
+            throw std::length_error("fixed_string capacity of " + std::to_string(N) + " characters exceeded");
+
+        std::memmove(storage, str, count);
+        storage[count] = '\0';
+        length = count;
+
+        return *this;
+    }
+
+    fixed_string& operator=(std::string_view str) {
+        return assign(str.data(), str.size());
+    }
+
+    fixed_string& operator=(const char* str) {
+        return *this = std::string_view(str);
+    }
+
+    void clear() noexcept {
+        storage[0] = '\0';
+        length = 0;
+    }
+
+    const char* data() const noexcept { return storage; }
+    char* data() noexcept { return storage; }
+    const char* c_str() const noexcept { return storage; }
+
+    size_type size() const noexcept { return length; }
+    bool empty() const noexcept { return length == 0; }
+    static constexpr size_type capacity() noexcept { return N; }
+    static constexpr size_type max_size() noexcept { return N; }
+
+    iterator begin() noexcept { return storage; }
+    iterator end() noexcept { return storage + length; }
+    const_iterator begin() const noexcept { return storage; }
+    const_iterator end() const noexcept { return storage + length; }
+
+    operator std::string_view() const noexcept {
+        return std::string_view(storage, length);
+    }
+
+    friend bool operator==(const fixed_string& lhs, std::string_view rhs) noexcept {
+        return std::string_view(lhs) == rhs;
+    }
+
+    friend bool operator!=(const fixed_string& lhs, std::string_view rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    size_type length = 0;
+    char storage[N + 1] = {};
+};
+
+namespace detail {
+
+// Constructs, relocates and destroys elements in the raw storage of static_vector and small_vector
+template<typename T>
+struct uninitialized_elements {
+    template<typename... Args>
+    static void construct(T* at, Args&&... args) {
+        ::new (static_cast<void*>(at)) T(std::forward<Args>(args)...);
+    }
+
+    static void destroy(T* first, T* last) noexcept {
+        for (; first != last; ++first)
+            first->~T();
+    }
+
+    // Moves [first, last) into uninitialized storage at out and destroys the sources
+    static void relocate(T* first, T* last, T* out) {
+        for (auto it = first; it != last; ++it, ++out)
+            construct(out, std::move_if_noexcept(*it));
+
+        destroy(first, last);
+    }
+};
+
+}  // namespace detail
+
+
+/**
+ * @brief A vector with fixed capacity N whose elements are stored inline, so it never
+ *        allocates
+ *
+ * Growing past N throws std::length_error. When unmarshalled, a JSON array with more
+ * than N elements is rejected with ArrayLengthMismatchException before any element is read.
+ */
+template<typename T, std::size_t N>
+class static_vector {
+    using elements = detail::uninitialized_elements<T>;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static_vector() noexcept = default;
+
+    static_vector(std::initializer_list<T> init) {
+        for (auto&& value : init)
+            push_back(value);
+    }
+
+    static_vector(const static_vector& other) {
+        for (auto&& value : other)
+            push_back(value);
+    }
+
+    static_vector(static_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        for (auto&& value : other)
+            push_back(std::move(value));
+    }
+
+    static_vector& operator=(const static_vector& other) {
+        if (this != &other) {
+            clear();
+            for (auto&& value : other)
+                push_back(value);
+        }
+
+        return *this;
+    }
+
+    static_vector& operator=(static_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            for (auto&& value : other)
+                push_back(std::move(value));
+        }
+
+        return *this;
+    }
+
+    ~static_vector() {
+        clear();
+    }
+
+    T* data() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+    const T* data() const noexcept { return std::launder(reinterpret_cast<const T*>(storage)); }
+
+    iterator begin() noexcept { return data(); }
+    iterator end() noexcept { return data() + count; }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + count; }
+
+    size_type size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+    static constexpr size_type capacity() noexcept { return N; }
+    static constexpr size_type max_size() noexcept { return N; }
+
+    reference operator[](size_type index) { return data()[index]; }
+    const_reference operator[](size_type index) const { return data()[index]; }
+    reference front() { return data()[0]; }
+    const_reference front() const { return data()[0]; }
+    reference back() { return data()[count - 1]; }
+    const_reference back() const { return data()[count - 1]; }
+
+    template<typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (count == N)
+            throw std::length_error("static_vector capacity of " + std::to_string(N) + " elements exceeded");
+
+        elements::construct(data() + count, std::forward<Args>(args)...);
+        return data()[count++];
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back() {
+        elements::destroy(data() + count - 1, data() + count);
+        --count;
+    }
+
+    /**
+      * @throw std::length_error if newSize exceeds the capacity N
+      */
+    void resize(size_type newSize) {
+        if (newSize > N)
+            throw std::length_error("static_vector capacity of " + std::to_string(N) + " elements exceeded");
+
+        while (count < newSize)
+            emplace_back();
+
+        elements::destroy(data() + newSize, data() + count);
+        count = newSize;
+    }
+
+    void clear() noexcept {
+        elements::destroy(data(), data() + count);
+        count = 0;
+    }
+
+    friend bool operator==(const static_vector& lhs, const static_vector& rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    friend bool operator!=(const static_vector& lhs, const static_vector& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    alignas(T) unsigned char storage[sizeof(T) * (N > 0 ? N : 1)];
+    size_type count = 0;
+};
+
+
+/**
+ * @brief A vector that stores up to N elements inline and moves them to the heap only
+ *        when it grows beyond N
+ */
+template<typename T, std::size_t N>
+class small_vector {
+    using elements = detail::uninitialized_elements<T>;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    small_vector() noexcept = default;
+
+    small_vector(std::initializer_list<T> init) {
+        reserve(init.size());
+        for (auto&& value : init)
+            push_back(value);
+    }
+
+    small_vector(const small_vector& other) {
+        reserve(other.size());
+        for (auto&& value : other)
+            push_back(value);
+    }
+
+    small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        take(std::move(other));
+    }
+
+    small_vector& operator=(const small_vector& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.size());
+            for (auto&& value : other)
+                push_back(value);
+        }
+
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            release();
+            take(std::move(other));
+        }
+
+        return *this;
+    }
+
+    ~small_vector() {
+        release();
+    }
+
+    T* data() noexcept { return heap ? heap : inlineData(); }
+    const T* data() const noexcept { return heap ? heap : inlineData(); }
+
+    iterator begin() noexcept { return data(); }
+    iterator end() noexcept { return data() + count; }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + count; }
+
+    size_type size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+    size_type capacity() const noexcept { return heap ? heapCapacity : N; }
+    size_type max_size() const noexcept { return std::allocator_traits<std::allocator<T>>::max_size(std::allocator<T>{}); }
+
+    /**
+      * @return true while the elements are stored inline
+      */
+    bool is_inline() const noexcept { return heap == nullptr; }
+
+    reference operator[](size_type index) { return data()[index]; }
+    const_reference operator[](size_type index) const { return data()[index]; }
+    reference front() { return data()[0]; }
+    const_reference front() const { return data()[0]; }
+    reference back() { return data()[count - 1]; }
+    const_reference back() const { return data()[count - 1]; }
+
+    void reserve(size_type newCapacity) {
+        if (newCapacity <= capacity())
+            return;
+
+        std::allocator<T> allocator;
+        T* grown = allocator.allocate(newCapacity);
+
+        elements::relocate(data(), data() + count, grown);
+        if (heap)
+            allocator.deallocate(heap, heapCapacity);
+
+        heap = grown;
+        heapCapacity = newCapacity;
+    }
+
+    template<typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (count == capacity())
+            reserve(std::max<size_type>(2 * capacity(), 1));
+
+        elements::construct(data() + count, std::forward<Args>(args)...);
+        return data()[count++];
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back() {
+        elements::destroy(data() + count - 1, data() + count);
+        --count;
+    }
+
+    void resize(size_type newSize) {
+        reserve(newSize);
+
+        while (count < newSize)
+            emplace_back();
+
+        elements::destroy(data() + newSize, data() + count);
+        count = newSize;
+    }
+
+    void clear() noexcept {
+        elements::destroy(data(), data() + count);
+        count = 0;
+    }
+
+    friend bool operator==(const small_vector& lhs, const small_vector& rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    friend bool operator!=(const small_vector& lhs, const small_vector& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    T* inlineData() noexcept { return std::launder(reinterpret_cast<T*>(buffer)); }
+    const T* inlineData() const noexcept { return std::launder(reinterpret_cast<const T*>(buffer)); }
+
+    void release() noexcept {
+        clear();
+
+        if (heap)
+            std::allocator<T>{}.deallocate(heap, heapCapacity);
+
+        heap = nullptr;
+        heapCapacity = 0;
+    }
+
+    // Steals the heap block of other, or moves its inline elements one by one
+    void take(small_vector&& other) {
+        if (other.heap) {
+            heap = std::exchange(other.heap, nullptr);
+            heapCapacity = std::exchange(other.heapCapacity, 0);
+        }
+        else
+            elements::relocate(other.inlineData(), other.inlineData() + other.count, inlineData());
+
+        count = std::exchange(other.count, 0);
+    }
+
+    alignas(T) unsigned char buffer[sizeof(T) * (N > 0 ? N : 1)];
+    T* heap = nullptr;
+    size_type heapCapacity = 0;
+    size_type count = 0;
+};
+
+
+/**
+ * @brief Text encodings of binary data in JSON strings
+ */
+enum class BinaryEncoding {
+    Base64,    // RFC 4648 base64 with padding, e.g. "3q2+7w=="
+    Hex        // Lowercase hexadecimal, e.g. "deadbeef"; either case is accepted when reading
+};
+
+/**
+ * @brief A byte buffer marshalled as a single encoded JSON string instead of an array of numbers
+ *
+ * It is a std::vector<Byte>, with Byte being std::byte, unsigned char or uint8_t. A plain
+ * std::vector<std::byte> member is encoded as base64 as well, whereas std::vector<uint8_t>
+ * remains an array of numbers unless declared as basic_bytes<Encoding, uint8_t>.
+ */
+template<BinaryEncoding Encoding, typename Byte = std::byte>
+class basic_bytes : public std::vector<Byte> {
+    static_assert(sizeof(Byte) == 1 && (std::is_same_v<Byte, std::byte> || std::is_unsigned_v<Byte>),
+                  "basic_bytes holds std::byte, unsigned char or uint8_t");
+
+public:
+    using std::vector<Byte>::vector;
+};
+
+using bytes = basic_bytes<BinaryEncoding::Base64>;
+using hex_bytes = basic_bytes<BinaryEncoding::Hex>;
+
+
+/**
+ * @brief A container of described structs marshalled as an array per member instead of an
+ *        object per element, e.g. {"id": ["P1", "P2"], "price": [9.5, 3.0]}
+ *
+ * It is the Sequence it wraps, such as columnar<std::vector<Product>>, so the layout belongs to
+ * the members declared with it while every other std::vector<Product> keeps an object per
+ * element. Columns write every member name once instead of once per element, which shrinks
+ * large tables of small structs; the columns must all be present and of the same length when
+ * read.
+ */
+template<typename Sequence>
+class columnar : public Sequence {
+public:
+    using Sequence::Sequence;
+
+    columnar() = default;
+    columnar(const Sequence& sequence) : Sequence(sequence) {}
+    columnar(Sequence&& sequence) : Sequence(std::move(sequence)) {}
+};
+
+
+
+/**
+ * @brief JSON encodings of std::chrono time points and durations
+ */
+enum class ChronoEncoding {
+    Rfc3339,        // "2024-01-15T10:30:00.250Z", time points only
+    Count,          // Count of the type's own ticks, e.g. 250 for std::chrono::milliseconds(250), a double if they are floating-point
+    Milliseconds,   // Integer milliseconds, since the Unix epoch for time points
+    Nanoseconds     // Integer nanoseconds, since the Unix epoch for time points
+};
+
+/**
+ * @brief A std::chrono time point or duration marshalled in Encoding instead of the default
+ *        of its type, e.g. chrono_as<ChronoEncoding::Milliseconds, std::chrono::system_clock::time_point>
+ *
+ * It is the Chrono it wraps, so the encoding belongs to the members declared with it while
+ * every other system_clock time point stays an RFC 3339 string and every other duration a
+ * count of its ticks.
+ */
+template<ChronoEncoding Encoding, typename Chrono>
+class chrono_as : public Chrono {
+public:
+    using Chrono::Chrono;
+
+    chrono_as() = default;
+    chrono_as(const Chrono& chrono) : Chrono(chrono) {}
+};
+
+// Discriminator member of internally_tagged variants that name no other
+inline constexpr char default_discriminator[] = "type";
+
+/**
+ * @brief A std::variant of described structs marshalled with a Discriminator member inside
+ *        the object of its alternative, e.g. {"type": "Circle", "radius": 1.0} rather than
+ *        {"Circle": {"radius": 1.0}}
+ *
+ * It is the Variant it wraps, so the tagging belongs to the members declared with it. C++17
+ * takes no string literal as a template argument, so another discriminator is named by a
+ * constexpr char array, e.g. internally_tagged<Shape, kind> after
+ * inline constexpr char kind[] = "kind". It must differ from the members of the alternatives.
+ */
+template<typename Variant, const char* Discriminator = default_discriminator>
+class internally_tagged : public Variant {
+public:
+    using Variant::Variant;
+
+    internally_tagged() = default;
+    internally_tagged(const Variant& variant) : Variant(variant) {}
+    internally_tagged(Variant&& variant) : Variant(std::move(variant)) {}
+};
+
+}  // namespace rapidjson_util
+
+// Readers of fixed-size arrays take their size from std::tuple_size, a columnar std::array keeps it
+namespace std {
+
+template<typename Element, std::size_t N>
+struct tuple_size<rapidjson_util::columnar<std::array<Element, N>>> : std::integral_constant<std::size_t, N> {};
+
+// std::visit and the readers of variants take the alternatives of an internally_tagged variant
+// from the one it wraps
+template<typename Variant, const char* Discriminator>
+struct variant_size<rapidjson_util::internally_tagged<Variant, Discriminator>> : variant_size<Variant> {};
+
+template<std::size_t I, typename Variant, const char* Discriminator>
+struct variant_alternative<I, rapidjson_util::internally_tagged<Variant, Discriminator>> : variant_alternative<I, Variant> {};
+
+}  // namespace std
+
+#endif
@@ -0,0 +1,1303 @@
+// Copyright (C) 2025 Liu Wu. All rights reserved.
+//
+// Licensed under the zlib License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/Zlib
+//
+// This software is provided as-is, without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+
+
+#ifndef __RAPIDJSON_UTIL_MSGPACK_H__
+#define __RAPIDJSON_UTIL_MSGPACK_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "rapid_util.h"
+#include "rapid_util_typed_array.h"
+
+
+namespace rapidjson_util {
+
+class InvalidMsgpackException : public std::logic_error {
+public:
+    InvalidMsgpackException(std::string_view what);
+};
+
+
+/**
+ * @brief Serialize a C++ struct to MessagePack
+ *
+ * Members are described by the RAPIDJSON_UTIL_DESCRIBE_MEMBERS macro, just as for marshal, and
+ * encoded the way marshal encodes them to JSON: structs become maps keyed by member name,
+ * null members become nil. Contiguous number arrays, binary members and RFC 3339 time points
+ * are the exceptions, see unmarshal_msgpack.
+ *
+ * @param s The struct instance to serialize
+ * @param buffer Receives the encoded bytes, its previous content is discarded but its capacity
+ *               is reused, so encoding into the same buffer repeatedly doesn't allocate
+ */
+template<typename Struct>
+void marshal_msgpack(const Struct& s, std::vector<uint8_t>& buffer);
+
+/**
+ * @brief Serialize a C++ struct to MessagePack
+ *
+ * @return The encoded bytes
+ */
+template<typename Struct>
+std::vector<uint8_t> marshal_msgpack(const Struct& s);
+
+/**
+ * @brief Deserialize MessagePack data to populate a C++ struct
+ *
+ * Accepts what marshal_msgpack writes, as well as MessagePack from other encoders. The rows of
+ * numbers in std::vector<double>, std::array<float, N> and other contiguous number arrays are
+ * written as extension values holding the little-endian numbers back to back, so that they are
+ * copied with a single memcpy on little-endian hosts. Their extension type is the RFC 8746 CBOR
+ * tag of the same typed array, e.g. 86 for doubles. Plain arrays of numbers are read as well.
+ * Binary members are written as bin values and time points encoded as RFC 3339 as timestamp
+ * extension values, of type -1; their base64, hex and RFC 3339 strings are read as well.
+ *
+ * @param data MessagePack data, which must hold exactly one map
+ * @param size Number of bytes in data
+ * @param s The struct instance to populate
+ * @param resource Memory resource for std::pmr strings and containers, see unmarshal
+ * @throws InvalidMsgpackException if data is truncated or malformed, and the exceptions unmarshal
+ *         throws for members of the wrong type or size
+ */
+template<typename Struct>
+void unmarshal_msgpack(const uint8_t* data, std::size_t size, Struct& s, std::pmr::memory_resource* resource = nullptr);
+
+template<typename Struct>
+void unmarshal_msgpack(const std::vector<uint8_t>& data, Struct& s, std::pmr::memory_resource* resource = nullptr);
+
+
+namespace detail {
+
+constexpr bool isMsgpackNumber(uint8_t marker) {
+    return marker <= 0x7f || marker >= 0xe0 || (marker >= 0xca && marker <= 0xd3);
+}
+
+constexpr bool isMsgpackExtension(uint8_t marker) {
+    return (marker >= 0xc7 && marker <= 0xc9) || (marker >= 0xd4 && marker <= 0xd8);
+}
+
+
+/**
+ * @brief Serializes C++ struct objects to MessagePack
+ *
+ * Traverses the same object hierarchy as JsonWriter and appends every value to the buffer
+ * as soon as it is visited. The RapidJSON value passed along by the visitor is not used,
+ * except for members encoded by a codec, which are encoded to JSON first. Binary members
+ * and RFC 3339 time points are written as bin and timestamp extension values instead.
+ */
+class MsgpackWriter : public JsonVisitor {
+public:
+    explicit MsgpackWriter(std::vector<uint8_t>& buffer);
+
+    void writeToMsgpack(JsonObject* root);
+
+    void visit(JsonPrimitiveValue* primitiveValue, rapidjson::Value&) override;
+    void visit(JsonObject* object, rapidjson::Value&) override;
+    void visit(JsonNullableObject* object, rapidjson::Value&) override;
+    void visit(JsonArray* array, rapidjson::Value&) override;
+    void visit(JsonNullableArray* array, rapidjson::Value&) override;
+    void visit(JsonNumberArray* array, rapidjson::Value&) override;
+    void visit(JsonInlineString* string, rapidjson::Value&) override;
+    void visit(JsonNullableInlineString* string, rapidjson::Value&) override;
+    void visit(JsonCustomValue* value, rapidjson::Value&) override;
+    void visit(JsonNullableCustomValue* value, rapidjson::Value&) override;
+    void visit(JsonVariant* variant, rapidjson::Value&) override;
+    void visit(JsonNullableVariant* variant, rapidjson::Value&) override;
+
+private:
+    void writeObjectMembers(JsonObject* object);
+    void appendObjectMembers(const std::vector<JsonAttribute>& members);
+    void writeArrayMembers(JsonArray* array);
+    void writeVariantAlternative(JsonVariant* variant);
+    void writeCustomValue(JsonCustomValue* value);
+    void writeJsonValue(const rapidjson::Value& value);
+    void writeBinary(std::pair<const uint8_t*, std::size_t> bytes);
+    void writeTimestamp(UnixTime time);
+
+    template<typename Number>
+    const Number* writeNumbers(const Number* numbers, const std::vector<std::size_t>& extents, std::size_t dimension);
+
+    void writeNil();
+    void writeBool(bool boolean);
+    void writeUnsigned(uint64_t number);
+    void writeSigned(int64_t number);
+    void writeFloat(float number);
+    void writeDouble(double number);
+    void writeString(std::string_view str);
+    void writeHeader(uint8_t fixMarker, std::size_t fixLimit, uint8_t marker16, std::size_t length);
+
+    template<typename Number>
+    void writeNumber(Number number);
+
+    template<typename Unsigned>
+    void writeBigEndian(uint8_t marker, Unsigned number);
+
+    template<typename Unsigned>
+    void writeBigEndian(Unsigned number);
+
+    uint8_t* grow(std::size_t length);
+
+    std::vector<uint8_t>& buffer;
+    rapidjson::Document customValues;
+    rapidjson::Value unused;
+};
+
+
+/**
+ * @brief Deserializes MessagePack to C++ struct objects
+ *
+ * Reads the values straight from the input in the order they occur. Object members are matched
+ * by name, in declaration order first, so out-of-order and unknown members are accepted as in
+ * JSON. Every length is checked against the remaining input before anything is resized, and
+ * nesting is limited to maxNestingDepth, so malformed input can neither make it allocate more
+ * than the input could describe nor exhaust the stack. Checks throw from plain if statements,
+ * as ThrowUnless would build the exception message for every value read.
+ */
+class MsgpackReader : public JsonVisitor {
+public:
+    static constexpr std::size_t maxNestingDepth = 512;
+
+    MsgpackReader(const uint8_t* data, std::size_t size, std::pmr::memory_resource* resource = nullptr);
+
+    void readFromMsgpack(JsonObject* root);
+
+    void visit(JsonPrimitiveValue* primitiveValue, rapidjson::Value&) override;
+    void visit(JsonObject* object, rapidjson::Value&) override;
+    void visit(JsonNullableObject* object, rapidjson::Value&) override;
+    void visit(JsonArray* array, rapidjson::Value&) override;
+    void visit(JsonNullableArray* array, rapidjson::Value&) override;
+    void visit(JsonNumberArray* array, rapidjson::Value&) override;
+    void visit(JsonInlineString* string, rapidjson::Value&) override;
+    void visit(JsonNullableInlineString* string, rapidjson::Value&) override;
+    void visit(JsonCustomValue* value, rapidjson::Value&) override;
+    void visit(JsonNullableCustomValue* value, rapidjson::Value&) override;
+    void visit(JsonVariant* variant, rapidjson::Value&) override;
+    void visit(JsonNullableVariant* variant, rapidjson::Value&) override;
+
+private:
+    void readObjectMembers(JsonObject* object);
+    void readArrayElements(JsonArray* array);
+    void readVariantAlternative(JsonVariant* variant);
+    void readInlineString(JsonInlineString* string);
+    void readCustomValue(JsonCustomValue* value);
+    void readJsonValue(rapidjson::Value& value);
+    UnixTime readTimestamp();
+
+    template<typename Number>
+    void readNumberArray(JsonNumberArray* array);
+
+    template<typename Number>
+    Number* readNumbers(Number* numbers, const std::vector<std::size_t>& extents, std::size_t dimension);
+
+    template<typename Number>
+    std::size_t readTypedArrayHeader();
+
+    template<typename Number>
+    Number readNumber();
+
+    bool isNilNext();
+    bool readBool();
+    std::string_view readString();
+    std::size_t readArrayHeader();
+    std::size_t readMapHeader();
+    void readNumberValue(rapidjson::Value& number);
+    void skipValue();
+
+    void enterNesting();
+    void leaveNesting();
+
+    uint8_t peekByte();
+    uint8_t readByte();
+    const uint8_t* readBytes(std::size_t length);
+    std::size_t readLength(std::size_t lengthBytes);
+
+    template<typename Unsigned>
+    Unsigned readBigEndian();
+
+    std::string nextTypeName();
+    TypeMismatchException typeMismatch(const std::string& expectedType);
+
+    const uint8_t* begin;
+    const uint8_t* cursor;
+    const uint8_t* end;
+    std::pmr::memory_resource* resource;
+    rapidjson::Document customValues;
+    rapidjson::Value unused;
+    std::size_t depth = 0;
+};
+
+
+inline MsgpackWriter::MsgpackWriter(std::vector<uint8_t>& _buffer) : buffer(_buffer) {
+}
+
+inline void MsgpackWriter::writeToMsgpack(JsonObject* root) {
+    root->accept(*this, unused);
+}
+
+inline uint8_t* MsgpackWriter::grow(std::size_t length) {
+    std::size_t size = buffer.size();
+    buffer.resize(size + length);
+
+    return buffer.data() + size;
+}
+
+template<typename Unsigned>
+void MsgpackWriter::writeBigEndian(uint8_t marker, Unsigned number) {
+    buffer.push_back(marker);
+    writeBigEndian(number);
+}
+
+template<typename Unsigned>
+void MsgpackWriter::writeBigEndian(Unsigned number) {
+    uint8_t* out = grow(sizeof(Unsigned));
+
+    for (std::size_t byte = sizeof(Unsigned); byte-- > 0; number = static_cast<Unsigned>(number >> 8))
+        out[byte] = static_cast<uint8_t>(number);
+}
+
+inline void MsgpackWriter::writeNil() {
+    buffer.push_back(0xc0);
+}
+
+inline void MsgpackWriter::writeBool(bool boolean) {
+    buffer.push_back(boolean ? 0xc3 : 0xc2);
+}
+
+inline void MsgpackWriter::writeUnsigned(uint64_t number) {
+    if (number < 0x80)                buffer.push_back(static_cast<uint8_t>(number));
+    else if (number <= UINT8_MAX)     writeBigEndian(0xcc, static_cast<uint8_t>(number));
+    else if (number <= UINT16_MAX)    writeBigEndian(0xcd, static_cast<uint16_t>(number));
+    else if (number <= UINT32_MAX)    writeBigEndian(0xce, static_cast<uint32_t>(number));
+    else                              writeBigEndian(0xcf, number);
+}
+
+inline void MsgpackWriter::writeSigned(int64_t number) {
+    if (number >= 0)                  writeUnsigned(static_cast<uint64_t>(number));
+    else if (number >= -32)           buffer.push_back(static_cast<uint8_t>(number));
+    else if (number >= INT8_MIN)      writeBigEndian(0xd0, static_cast<uint8_t>(number));
+    else if (number >= INT16_MIN)     writeBigEndian(0xd1, static_cast<uint16_t>(number));
+    else if (number >= INT32_MIN)     writeBigEndian(0xd2, static_cast<uint32_t>(number));
+    else                              writeBigEndian(0xd3, static_cast<uint64_t>(number));
+}
+
+inline void MsgpackWriter::writeFloat(float number) {
+    uint32_t bits;
+    std::memcpy(&bits, &number, sizeof(bits));
+    writeBigEndian(0xca, bits);
+}
+
+inline void MsgpackWriter::writeDouble(double number) {
+    uint64_t bits;
+    std::memcpy(&bits, &number, sizeof(bits));
+    writeBigEndian(0xcb, bits);
+}
+
+template<typename Number>
+void MsgpackWriter::writeNumber(Number number) {
+    if constexpr (std::is_same_v<Number, float>)       writeFloat(number);
+    else if constexpr (std::is_same_v<Number, double>) writeDouble(number);
+    else if constexpr (std::is_signed_v<Number>)       writeSigned(number);
+    else                                               writeUnsigned(number);
+}
+
+// Writes the header of a str, array or map, whose 16 and 32-bit length markers follow each other
+inline void MsgpackWriter::writeHeader(uint8_t fixMarker, std::size_t fixLimit, uint8_t marker16, std::size_t length) {
+    if (length < fixLimit)            buffer.push_back(static_cast<uint8_t>(fixMarker | length));
+    else if (length <= UINT16_MAX)    writeBigEndian(marker16, static_cast<uint16_t>(length));
+    else                              writeBigEndian(marker16 + 1, static_cast<uint32_t>(length));
+}
+
+inline void MsgpackWriter::writeString(std::string_view str) {
+    if (str.length() >= 32 && str.length() <= UINT8_MAX)
+        writeBigEndian(0xd9, static_cast<uint8_t>(str.length()));
+    else
+        writeHeader(0xa0, 32, 0xda, str.length());
+
+    if (!str.empty())
+        std::memcpy(grow(str.length()), str.data(), str.length());
+}
+
+inline void MsgpackWriter::visit(JsonPrimitiveValue* primitiveValue, rapidjson::Value&) {
+    assert(primitiveValue->isPointToConst());
+
+    if (primitiveValue->isReferencedValueNull())
+        return writeNil();
+
+    #define WRITE_NUMBER(storedType, CXXType)                                                  \
+        case JsonPrimitiveValue::StoredType::storedType:                                       \
+            writeNumber(*primitiveValue->unwrapConstPointer<CXXType>());                       \
+            break;
+
+    switch (primitiveValue->storedType()) {
+        RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(WRITE_NUMBER)
+
+        case JsonPrimitiveValue::StoredType::BoolPtr:
+            writeBool(*primitiveValue->unwrapConstPointer<bool>());
+            break;
+
+        case JsonPrimitiveValue::StoredType::StringPtr:
+            writeString(*primitiveValue->unwrapConstPointer<std::string>());
+            break;
+
+        case JsonPrimitiveValue::StoredType::PmrStringPtr:
+            writeString(*primitiveValue->unwrapConstPointer<std::pmr::string>());
+            break;
+
+        case JsonPrimitiveValue::StoredType::StringViewPtr:
+            writeString(*primitiveValue->unwrapConstPointer<std::string_view>());
+            break;
+    }
+
+    #undef WRITE_NUMBER
+}
+
+inline void MsgpackWriter::appendObjectMembers(const std::vector<JsonAttribute>& members) {
+    for (auto&& member : members) {
+        writeString(member.name);
+        member.value->accept(*this, unused);
+    }
+}
+
+inline void MsgpackWriter::writeObjectMembers(JsonObject* object) {
+    auto members = object->getWrittenMembers(Omission::None);
+
+    writeHeader(0x80, 16, 0xde, members.size());
+    appendObjectMembers(members);
+}
+
+inline void MsgpackWriter::visit(JsonObject* object, rapidjson::Value&) {
+    writeObjectMembers(object);
+}
+
+inline void MsgpackWriter::visit(JsonNullableObject* object, rapidjson::Value&) {
+    if (object->isReferencedValueNull())
+        return writeNil();
+
+    writeObjectMembers(object);
+}
+
+inline void MsgpackWriter::writeArrayMembers(JsonArray* array) {
+    writeHeader(0x90, 16, 0xdc, array->size());
+
+    for (auto&& element : array->getElements())
+        element->accept(*this, unused);
+}
+
+inline void MsgpackWriter::visit(JsonArray* array, rapidjson::Value&) {
+    writeArrayMembers(array);
+}
+
+inline void MsgpackWriter::visit(JsonNullableArray* array, rapidjson::Value&) {
+    if (array->isReferencedValueNull())
+        return writeNil();
+
+    writeArrayMembers(array);
+}
+
+inline void MsgpackWriter::visit(JsonNumberArray* array, rapidjson::Value&) {
+    #define WRITE_NUMBERS(storedType, CXXType)                                                 \
+        case JsonPrimitiveValue::StoredType::storedType:                                       \
+            writeNumbers(array->unwrapConstPointer<CXXType>(), array->getExtents(), 0);        \
+            break;
+
+    switch (array->storedType()) {
+        RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(WRITE_NUMBERS)
+        default: assert(false && "Only numbers are stored contiguously");
+    }
+
+    #undef WRITE_NUMBERS
+}
+
+// The innermost rows become typed array extensions, the outer dimensions plain arrays
+template<typename Number>
+const Number* MsgpackWriter::writeNumbers(const Number* numbers, const std::vector<std::size_t>& extents,
+                                          std::size_t dimension) {
+    const std::size_t count = extents[dimension];
+
+    if (dimension + 1 < extents.size()) {
+        writeHeader(0x90, 16, 0xdc, count);
+
+        for (std::size_t i = 0; i < count; ++i)
+            numbers = writeNumbers(numbers, extents, dimension + 1);
+
+        return numbers;
+    }
+
+    const std::size_t length = count * sizeof(Number);
+    switch (length) {
+        case 1:  buffer.push_back(0xd4); break;
+        case 2:  buffer.push_back(0xd5); break;
+        case 4:  buffer.push_back(0xd6); break;
+        case 8:  buffer.push_back(0xd7); break;
+        case 16: buffer.push_back(0xd8); break;
+        default:
+            if (length <= UINT8_MAX)       writeBigEndian(0xc7, static_cast<uint8_t>(length));
+            else if (length <= UINT16_MAX) writeBigEndian(0xc8, static_cast<uint16_t>(length));
+            else                           writeBigEndian(0xc9, static_cast<uint32_t>(length));
+    }
+
+    buffer.push_back(typedArrayTag<Number>());
+    if (count != 0)
+        copyLittleEndian<Number>(numbers, grow(length), count);
+
+    return numbers + count;
+}
+
+inline void MsgpackWriter::visit(JsonInlineString* string, rapidjson::Value&) {
+    writeString(string->view());
+}
+
+inline void MsgpackWriter::visit(JsonNullableInlineString* string, rapidjson::Value&) {
+    if (string->isReferencedValueNull())
+        return writeNil();
+
+    writeString(string->view());
+}
+
+inline void MsgpackWriter::writeCustomValue(JsonCustomValue* value) {
+    if (value->isBytes())
+        return writeBinary(value->bytes());
+    if (value->isTime())
+        return writeTimestamp(value->time());
+
+    rapidjson::Value json;
+    value->encode(json, customValues.GetAllocator());
+
+    writeJsonValue(json);
+}
+
+inline void MsgpackWriter::writeBinary(std::pair<const uint8_t*, std::size_t> bytes) {
+    auto [data, size] = bytes;
+
+    if (size <= UINT8_MAX)            writeBigEndian(0xc4, static_cast<uint8_t>(size));
+    else if (size <= UINT16_MAX)      writeBigEndian(0xc5, static_cast<uint16_t>(size));
+    else                              writeBigEndian(0xc6, static_cast<uint32_t>(size));
+
+    if (size != 0)
+        std::memcpy(grow(size), data, size);
+}
+
+// Writes the timestamp extension, type -1, in the smallest of its 32, 64 and 96-bit forms
+inline void MsgpackWriter::writeTimestamp(UnixTime time) {
+    if (time.seconds >= 0 && time.seconds < (int64_t(1) << 34)) {
+        const uint64_t packed = uint64_t(time.nanoseconds) << 34 | static_cast<uint64_t>(time.seconds);
+
+        if (packed <= UINT32_MAX) {
+            buffer.push_back(0xd6);
+            writeBigEndian(0xff, static_cast<uint32_t>(packed));
+        }
+        else {
+            buffer.push_back(0xd7);
+            writeBigEndian(0xff, packed);
+        }
+    }
+    else {
+        writeBigEndian(0xc7, uint8_t(12));
+        writeBigEndian(0xff, time.nanoseconds);
+        writeBigEndian(static_cast<uint64_t>(time.seconds));
+    }
+}
+
+inline void MsgpackWriter::writeJsonValue(const rapidjson::Value& value) {
+    switch (value.GetType()) {
+        case rapidjson::kNullType:   writeNil(); break;
+        case rapidjson::kFalseType:  writeBool(false); break;
+        case rapidjson::kTrueType:   writeBool(true); break;
+        case rapidjson::kStringType: writeString(std::string_view(value.GetString(), value.GetStringLength())); break;
+
+        case rapidjson::kNumberType:
+            if (value.IsDouble())       writeDouble(value.GetDouble());
+            else if (value.IsUint64())  writeUnsigned(value.GetUint64());
+            else                        writeSigned(value.GetInt64());
+            break;
+
+        case rapidjson::kArrayType:
+            writeHeader(0x90, 16, 0xdc, value.Size());
+            for (auto&& element : value.GetArray())
+                writeJsonValue(element);
+            break;
+
+        case rapidjson::kObjectType:
+            writeHeader(0x80, 16, 0xde, value.MemberCount());
+            for (auto member = value.MemberBegin(); member != value.MemberEnd(); ++member) {
+                writeString(std::string_view(member->name.GetString(), member->name.GetStringLength()));
+                writeJsonValue(member->value);
+            }
+            break;
+    }
+}
+
+inline void MsgpackWriter::visit(JsonCustomValue* value, rapidjson::Value&) {
+    writeCustomValue(value);
+}
+
+inline void MsgpackWriter::visit(JsonNullableCustomValue* value, rapidjson::Value&) {
+    if (value->isReferencedValueNull())
+        return writeNil();
+
+    writeCustomValue(value);
+}
+
+inline void MsgpackWriter::writeVariantAlternative(JsonVariant* variant) {
+    auto members = variant->getAlternative()->getWrittenMembers(Omission::None);
+
+    if (VariantTagging::Internal == variant->taggingStyle()) {
+        writeHeader(0x80, 16, 0xde, members.size() + 1);
+        writeString(variant->discriminatorName());
+        writeString(variant->alternativeTag());
+        appendObjectMembers(members);
+    }
+    else {
+        buffer.push_back(0x81);
+        writeString(variant->alternativeTag());
+        writeHeader(0x80, 16, 0xde, members.size());
+        appendObjectMembers(members);
+    }
+}
+
+inline void MsgpackWriter::visit(JsonVariant* variant, rapidjson::Value&) {
+    writeVariantAlternative(variant);
+}
+
+inline void MsgpackWriter::visit(JsonNullableVariant* variant, rapidjson::Value&) {
+    if (variant->isReferencedValueNull())
+        return writeNil();
+
+    writeVariantAlternative(variant);
+}
+
+
+inline MsgpackReader::MsgpackReader(const uint8_t* data, std::size_t size, std::pmr::memory_resource* _resource) :
+    begin(data), cursor(data), end(data + size), resource(_resource) {
+}
+
+inline void MsgpackReader::readFromMsgpack(JsonObject* root) {
+    root->accept(*this, unused);
+
+    if (cursor != end)
+        throw InvalidMsgpackException("MessagePack data has " + std::to_string(end - cursor) + " trailing bytes after the root map");
+}
+
+inline uint8_t MsgpackReader::peekByte() {
+    if (cursor == end)
+        throw InvalidMsgpackException("MessagePack data is truncated at offset " + std::to_string(cursor - begin));
+
+    return *cursor;
+}
+
+inline uint8_t MsgpackReader::readByte() {
+    uint8_t byte = peekByte();
+    ++cursor;
+
+    return byte;
+}
+
+inline const uint8_t* MsgpackReader::readBytes(std::size_t length) {
+    if (length > static_cast<std::size_t>(end - cursor))
+        throw InvalidMsgpackException("MessagePack data is truncated at offset " + std::to_string(cursor - begin) +
+                                      ", expected " + std::to_string(length) + " more bytes");
+
+    const uint8_t* bytes = cursor;
+    cursor += length;
+
+    return bytes;
+}
+
+template<typename Unsigned>
+Unsigned MsgpackReader::readBigEndian() {
+    const uint8_t* bytes = readBytes(sizeof(Unsigned));
+
+    Unsigned number = 0;
+    for (std::size_t byte = 0; byte < sizeof(Unsigned); ++byte)
+        number = static_cast<Unsigned>(number << 8 | bytes[byte]);
+
+    return number;
+}
+
+inline std::size_t MsgpackReader::readLength(std::size_t lengthBytes) {
+    switch (lengthBytes) {
+        case 1:  return readBigEndian<uint8_t>();
+        case 2:  return readBigEndian<uint16_t>();
+        default: return readBigEndian<uint32_t>();
+    }
+}
+
+inline void MsgpackReader::enterNesting() {
+    if (++depth > maxNestingDepth)
+        throw InvalidMsgpackException("MessagePack data nests deeper than " + std::to_string(maxNestingDepth) +
+                                      " levels at offset " + std::to_string(cursor - begin));
+}
+
+inline void MsgpackReader::leaveNesting() {
+    --depth;
+}
+
+inline std::string MsgpackReader::nextTypeName() {
+    uint8_t marker = peekByte();
+
+    if (isMsgpackNumber(marker)) {
+        const uint8_t* start = cursor;
+        rapidjson::Value number;
+        readNumberValue(number);
+        cursor = start;
+
+        return RapidjsonValueTypeValidator::getTypeFrom(number);
+    }
+
+    if (marker <= 0x8f || marker == 0xde || marker == 0xdf) return "Object";
+    if (marker <= 0x9f || marker == 0xdc || marker == 0xdd) return "Array";
+    if (marker <= 0xbf || (marker >= 0xd9 && marker <= 0xdb)) return "String";
+    if (marker == 0xc0) return "Null";
+    if (marker == 0xc2 || marker == 0xc3) return "Boolean";
+    if (marker >= 0xc4 && marker <= 0xc6) return "Binary";
+    if (marker == 0xc1) return "Unknown";
+    return "Extension";
+}
+
+inline TypeMismatchException MsgpackReader::typeMismatch(const std::string& expectedType) {
+    return TypeMismatchException("Expected " + expectedType + ", got " + nextTypeName());
+}
+
+inline bool MsgpackReader::isNilNext() {
+    if (peekByte() != 0xc0)
+        return false;
+
+    ++cursor;
+    return true;
+}
+
+inline bool MsgpackReader::readBool() {
+    uint8_t marker = peekByte();
+    if (marker != 0xc2 && marker != 0xc3)
+        throw typeMismatch("Bool");
+
+    ++cursor;
+    return marker == 0xc3;
+}
+
+inline std::string_view MsgpackReader::readString() {
+    uint8_t marker = peekByte();
+    if ((marker < 0xa0 || marker > 0xbf) && (marker < 0xd9 || marker > 0xdb))
+        throw typeMismatch("String");
+
+    ++cursor;
+    std::size_t length = marker <= 0xbf ? marker & 0x1f : readLength(std::size_t(1) << (marker - 0xd9));
+
+    return std::string_view(reinterpret_cast<const char*>(readBytes(length)), length);
+}
+
+// Array elements and map entries take at least one byte each, so a length beyond the remaining
+// input is rejected before the destination is resized to it
+inline std::size_t MsgpackReader::readArrayHeader() {
+    uint8_t marker = peekByte();
+    std::size_t length;
+
+    if (marker >= 0x90 && marker <= 0x9f) {
+        ++cursor;
+        length = marker & 0x0f;
+    }
+    else {
+        if (marker != 0xdc && marker != 0xdd)
+            throw typeMismatch("Array");
+        ++cursor;
+        length = readLength(marker == 0xdc ? 2 : 4);
+    }
+
+    if (length > static_cast<std::size_t>(end - cursor))
+        throw InvalidMsgpackException("MessagePack array of " + std::to_string(length) + " elements exceeds the data");
+    return length;
+}
+
+inline std::size_t MsgpackReader::readMapHeader() {
+    uint8_t marker = peekByte();
+    std::size_t length;
+
+    if (marker >= 0x80 && marker <= 0x8f) {
+        ++cursor;
+        length = marker & 0x0f;
+    }
+    else {
+        if (marker != 0xde && marker != 0xdf)
+            throw typeMismatch("Object");
+        ++cursor;
+        length = readLength(marker == 0xde ? 2 : 4);
+    }
+
+    if (length > static_cast<std::size_t>(end - cursor) / 2)
+        throw InvalidMsgpackException("MessagePack map of " + std::to_string(length) + " entries exceeds the data");
+    return length;
+}
+
+// Reads any integer or float into a RapidJSON number, so that the JSON type checks apply
+inline void MsgpackReader::readNumberValue(rapidjson::Value& number) {
+    uint8_t marker = readByte();
+
+    if (marker <= 0x7f)
+        number.SetUint64(marker);
+    else if (marker >= 0xe0)
+        number.SetInt64(static_cast<int8_t>(marker));
+    else {
+        switch (marker) {
+            case 0xca: {
+                uint32_t bits = readBigEndian<uint32_t>();
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                number.SetDouble(value);
+                break;
+            }
+            case 0xcb: {
+                uint64_t bits = readBigEndian<uint64_t>();
+                double value;
+                std::memcpy(&value, &bits, sizeof(value));
+                number.SetDouble(value);
+                break;
+            }
+            case 0xcc: number.SetUint64(readBigEndian<uint8_t>()); break;
+            case 0xcd: number.SetUint64(readBigEndian<uint16_t>()); break;
+            case 0xce: number.SetUint64(readBigEndian<uint32_t>()); break;
+            case 0xcf: number.SetUint64(readBigEndian<uint64_t>()); break;
+            case 0xd0: number.SetInt64(static_cast<int8_t>(readBigEndian<uint8_t>())); break;
+            case 0xd1: number.SetInt64(static_cast<int16_t>(readBigEndian<uint16_t>())); break;
+            case 0xd2: number.SetInt64(static_cast<int32_t>(readBigEndian<uint32_t>())); break;
+            case 0xd3: number.SetInt64(static_cast<int64_t>(readBigEndian<uint64_t>())); break;
+            default: assert(false && "Not a number marker");
+        }
+    }
+}
+
+template<typename Number>
+Number MsgpackReader::readNumber() {
+    uint8_t marker = peekByte();
+    if (!isMsgpackNumber(marker))
+        throw typeMismatch(numberTypeName<Number>());
+
+    rapidjson::Value number;
+    readNumberValue(number);
+
+    if constexpr (std::is_same_v<Number, float>) {
+        RapidjsonValueTypeValidator::validate(number, QueryType::IsFloat);
+        return number.GetFloat();
+    }
+    else if constexpr (std::is_same_v<Number, double>) {
+        RapidjsonValueTypeValidator::validate(number, QueryType::IsDouble);
+        return number.GetDouble();
+    }
+    else
+        return RapidjsonValueTypeValidator::narrow<Number>(number);
+}
+
+// Skips a whole value, with the arrays and maps nested in it
+inline void MsgpackReader::skipValue() {
+    const uint8_t marker = readByte();
+    std::size_t items;
+
+    if (marker <= 0x7f || marker >= 0xe0 || marker == 0xc0 || marker == 0xc2 || marker == 0xc3)
+        return;
+
+    if (marker <= 0x8f)      items = 2 * std::size_t(marker & 0x0f);
+    else if (marker <= 0x9f) items = marker & 0x0f;
+    else if (marker <= 0xbf) {
+        readBytes(marker & 0x1f);
+        return;
+    }
+    else {
+        switch (marker) {
+            case 0xc4: case 0xc5: case 0xc6: readBytes(readLength(std::size_t(1) << (marker - 0xc4))); return;
+            case 0xc7: case 0xc8: case 0xc9: readBytes(readLength(std::size_t(1) << (marker - 0xc7)) + 1); return;
+            case 0xca: case 0xce: case 0xd2: readBytes(4); return;
+            case 0xcb: case 0xcf: case 0xd3: readBytes(8); return;
+            case 0xcc: case 0xd0:            readBytes(1); return;
+            case 0xcd: case 0xd1:            readBytes(2); return;
+            case 0xd4: case 0xd5: case 0xd6: case 0xd7: case 0xd8:
+                readBytes((std::size_t(1) << (marker - 0xd4)) + 1);
+                return;
+            case 0xd9: case 0xda: case 0xdb: readBytes(readLength(std::size_t(1) << (marker - 0xd9))); return;
+            case 0xdc: items = readLength(2); break;
+            case 0xdd: items = readLength(4); break;
+            case 0xde: items = 2 * readLength(2); break;
+            case 0xdf: items = 2 * readLength(4); break;
+            default:
+                throw InvalidMsgpackException("Invalid MessagePack marker 0xc1 at offset " + std::to_string(cursor - begin - 1));
+        }
+    }
+
+    // Every value takes at least one byte, so the loop ends once the input is exhausted
+    enterNesting();
+    for (; items > 0; --items)
+        skipValue();
+    leaveNesting();
+}
+
+inline void MsgpackReader::visit(JsonPrimitiveValue* primitiveValue, rapidjson::Value&) {
+    assert(!primitiveValue->isPointToConst());
+
+    if (primitiveValue->ownershipType() != JsonPrimitiveValue::OwnershipType::Raw && isNilNext())
+        return primitiveValue->resetReferencedValue();
+
+    #define READ_NUMBER(storedType, CXXType)                                                   \
+        case JsonPrimitiveValue::StoredType::storedType:                                       \
+            *primitiveValue->unwrapPointer<CXXType>() = readNumber<CXXType>();                 \
+            break;
+
+    switch (primitiveValue->storedType()) {
+        RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(READ_NUMBER)
+
+        case JsonPrimitiveValue::StoredType::BoolPtr: {
+            bool boolean = readBool();
+            *primitiveValue->unwrapPointer<bool>() = boolean;
+            break;
+        }
+
+        case JsonPrimitiveValue::StoredType::StringPtr: {
+            auto str = readString();
+            primitiveValue->unwrapPointer<std::string>()->assign(str.data(), str.length());
+            break;
+        }
+
+        case JsonPrimitiveValue::StoredType::PmrStringPtr: {
+            auto str = readString();
+            auto value = primitiveValue->unwrapPointer<std::pmr::string>();
+            rebindMemoryResource(*value, resource);
+            value->assign(str.data(), str.length());
+            break;
+        }
+
+        case JsonPrimitiveValue::StoredType::StringViewPtr:
+            assert(false && "Views are marshal-only");
+            break;
+    }
+
+    #undef READ_NUMBER
+}
+
+inline void MsgpackReader::readObjectMembers(JsonObject* object) {
+    const std::size_t entries = readMapHeader();
+    enterNesting();
+
+    auto members = object->getMembers();
+    std::vector<bool> isRead(members.size());
+    std::size_t next = 0;
+
+    for (std::size_t entry = 0; entry < entries; ++entry) {
+        auto name = readString();
+
+        if (next == members.size() || members[next].name != name) {
+            next = 0;
+            while (next < members.size() && members[next].name != name)
+                ++next;
+        }
+
+        if (next == members.size()) {
+            skipValue();
+            continue;
+        }
+
+        try {
+            members[next].value->accept(*this, unused);
+        }
+        catch (std::logic_error& e) {
+            throw MemberSerializationFailure(std::string("Deserialization of member \"") +
+                members[next].name + "\" failed: " + e.what());
+        }
+
+        isRead[next++] = true;
+    }
+
+    leaveNesting();
+
+    for (std::size_t i = 0; i < members.size(); ++i)
+        if (!isRead[i] && !members[i].omitter.omit(Omission::None))
+            throw MemberNotFoundException(members[i].name);
+}
+
+inline void MsgpackReader::visit(JsonObject* object, rapidjson::Value&) {
+    readObjectMembers(object);
+}
+
+inline void MsgpackReader::visit(JsonNullableObject* object, rapidjson::Value&) {
+    if (isNilNext())
+        return object->resetReferencedValue();
+
+    if (object->isReferencedValueNull())
+        object->reinitializeReferencedValue();
+
+    readObjectMembers(object);
+}
+
+inline void MsgpackReader::readArrayElements(JsonArray* array) {
+    const std::size_t length = readArrayHeader();
+
+    if (length != array->size() && !array->isResizable())
+        throw fixedCapacityMismatch(length, array->size());
+    if (length > array->maxSize())
+        throw capacityExceeded(length, array->maxSize());
+
+    if (isResizeNeeded(array, length, resource))
+        array->resize(length, resource);
+
+    enterNesting();
+
+    for (auto&& element : array->getElements()) {
+        if (!array->hasOptionalElements() && peekByte() == 0xc0)
+            throw TypeMismatchException("MessagePack array contains null elements");
+
+        element->accept(*this, unused);
+    }
+
+    leaveNesting();
+}
+
+inline void MsgpackReader::visit(JsonArray* array, rapidjson::Value&) {
+    readArrayElements(array);
+}
+
+inline void MsgpackReader::visit(JsonNullableArray* array, rapidjson::Value&) {
+    if (isNilNext())
+        return array->resetReferencedValue();
+
+    if (array->isReferencedValueNull())
+        array->reinitializeReferencedValue();
+
+    readArrayElements(array);
+}
+
+inline void MsgpackReader::visit(JsonNumberArray* array, rapidjson::Value&) {
+    assert(!array->isPointToConst());
+
+    #define READ_NUMBERS(storedType, CXXType)                                                  \
+        case JsonPrimitiveValue::StoredType::storedType:                                       \
+            readNumberArray<CXXType>(array);                                                   \
+            break;
+
+    switch (array->storedType()) {
+        RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(READ_NUMBERS)
+        default: assert(false && "Only numbers are stored contiguously");
+    }
+
+    #undef READ_NUMBERS
+}
+
+template<typename Number>
+void MsgpackReader::readNumberArray(JsonNumberArray* array) {
+    const uint8_t* start = cursor;
+    std::size_t length = array->getExtents().size() == 1 && isMsgpackExtension(peekByte()) ? readTypedArrayHeader<Number>()
+                                                                                          : readArrayHeader();
+    cursor = start;
+
+    if (length != array->size() && !array->isResizable())
+        throw fixedCapacityMismatch(length, array->size());
+    if (length > array->maxSize())
+        throw capacityExceeded(length, array->maxSize());
+
+    if (isResizeNeeded(array, length, resource))
+        array->resize(length, resource);
+
+    readNumbers(array->unwrapPointer<Number>(), array->getExtents(), 0);
+}
+
+/**
+ * Reads the header of a typed array extension holding numbers of type Number.
+ *
+ * @return The number of elements, the cursor is left at the first of them
+ */
+template<typename Number>
+std::size_t MsgpackReader::readTypedArrayHeader() {
+    uint8_t marker = readByte();
+    std::size_t length = marker >= 0xd4 ? std::size_t(1) << (marker - 0xd4) : readLength(std::size_t(1) << (marker - 0xc7));
+
+    uint8_t type = readByte();
+    if (type != typedArrayTag<Number>())
+        throw TypeMismatchException(std::string("Expected typed array of ") + numberTypeName<Number>() +
+                                    ", got extension type " + std::to_string(type));
+    if (length % sizeof(Number) != 0 || length > static_cast<std::size_t>(end - cursor))
+        throw InvalidMsgpackException("Typed array of " + std::to_string(length) + " bytes doesn't fit " +
+                                      numberTypeName<Number>() + " elements or exceeds the data");
+
+    return length / sizeof(Number);
+}
+
+template<typename Number>
+Number* MsgpackReader::readNumbers(Number* numbers, const std::vector<std::size_t>& extents, std::size_t dimension) {
+    const bool isInnermost = dimension + 1 == extents.size();
+
+    if (isInnermost && isMsgpackExtension(peekByte())) {
+        std::size_t count = readTypedArrayHeader<Number>();
+        if (count != extents[dimension])
+            throw fixedCapacityMismatch(count, extents[dimension]);
+
+        copyLittleEndian<Number>(readBytes(count * sizeof(Number)), numbers, count);
+        return numbers + count;
+    }
+
+    std::size_t length = readArrayHeader();
+    if (length != extents[dimension])
+        throw fixedCapacityMismatch(length, extents[dimension]);
+
+    for (std::size_t i = 0; i < length; ++i) {
+        if (isInnermost) {
+            if (peekByte() == 0xc0)
+                throw TypeMismatchException("MessagePack array contains null elements");
+            *numbers++ = readNumber<Number>();
+        }
+        else
+            numbers = readNumbers(numbers, extents, dimension + 1);
+    }
+
+    return numbers;
+}
+
+inline void MsgpackReader::readInlineString(JsonInlineString* string) {
+    auto str = readString();
+
+    if (str.length() > string->capacity())
+        throw StringLengthExceededException("String length mismatch: MessagePack contains " + std::to_string(str.length()) +
+                                            " characters, but given string has fixed capacity of " +
+                                            std::to_string(string->capacity()) + " characters.");
+
+    string->assign(str);
+}
+
+inline void MsgpackReader::visit(JsonInlineString* string, rapidjson::Value&) {
+    readInlineString(string);
+}
+
+inline void MsgpackReader::visit(JsonNullableInlineString* string, rapidjson::Value&) {
+    if (isNilNext())
+        return string->resetReferencedValue();
+
+    if (string->isReferencedValueNull())
+        string->reinitializeReferencedValue();
+
+    readInlineString(string);
+}
+
+// Codecs decode from JSON, so the value is converted to JSON first. Bytes and time points are
+// read from bin and timestamp extension values directly, or else from their JSON strings.
+inline void MsgpackReader::readCustomValue(JsonCustomValue* value) {
+    const uint8_t marker = peekByte();
+
+    if (value->isBytes() && marker >= 0xc4 && marker <= 0xc6) {
+        ++cursor;
+        std::size_t length = readLength(std::size_t(1) << (marker - 0xc4));
+
+        return value->assignBytes(readBytes(length), length);
+    }
+
+    if (value->isTime() && isMsgpackExtension(marker))
+        return value->assignTime(readTimestamp());
+
+    rapidjson::Value json;
+    readJsonValue(json);
+
+    value->decode(json);
+}
+
+inline void MsgpackReader::readJsonValue(rapidjson::Value& value) {
+    auto& allocator = customValues.GetAllocator();
+    uint8_t marker = peekByte();
+
+    if (isMsgpackNumber(marker))
+        readNumberValue(value);
+    else if (marker == 0xc0) {
+        ++cursor;
+        value.SetNull();
+    }
+    else if (marker == 0xc2 || marker == 0xc3)
+        value.SetBool(readBool());
+    else if (marker <= 0x8f || marker == 0xde || marker == 0xdf) {
+        std::size_t entries = readMapHeader();
+        enterNesting();
+        value.SetObject();
+
+        for (; entries > 0; --entries) {
+            auto key = readString();
+            rapidjson::Value name(key.data(), static_cast<rapidjson::SizeType>(key.length()), allocator);
+
+            rapidjson::Value member;
+            readJsonValue(member);
+            value.AddMember(name, member, allocator);
+        }
+
+        leaveNesting();
+    }
+    else if (marker <= 0x9f || marker == 0xdc || marker == 0xdd) {
+        std::size_t length = readArrayHeader();
+        enterNesting();
+        value.SetArray();
+
+        for (; length > 0; --length) {
+            rapidjson::Value element;
+            readJsonValue(element);
+            value.PushBack(element, allocator);
+        }
+
+        leaveNesting();
+    }
+    else if (marker <= 0xbf || (marker >= 0xd9 && marker <= 0xdb)) {
+        auto str = readString();
+        value.SetString(str.data(), static_cast<rapidjson::SizeType>(str.length()), allocator);
+    }
+    else
+        throw typeMismatch("a value representable in JSON");
+}
+
+inline UnixTime MsgpackReader::readTimestamp() {
+    uint8_t marker = readByte();
+    std::size_t length = marker >= 0xd4 ? std::size_t(1) << (marker - 0xd4) : readLength(std::size_t(1) << (marker - 0xc7));
+
+    uint8_t type = readByte();
+    if (type != 0xff)
+        throw TypeMismatchException("Expected timestamp, got extension type " + std::to_string(static_cast<int8_t>(type)));
+
+    switch (length) {
+        case 4:
+            return { readBigEndian<uint32_t>(), 0 };
+
+        case 8: {
+            uint64_t packed = readBigEndian<uint64_t>();
+            return { static_cast<int64_t>(packed & ((uint64_t(1) << 34) - 1)), static_cast<uint32_t>(packed >> 34) };
+        }
+
+        case 12: {
+            uint32_t nanoseconds = readBigEndian<uint32_t>();
+            return { static_cast<int64_t>(readBigEndian<uint64_t>()), nanoseconds };
+        }
+
+        default:
+            throw InvalidMsgpackException("Timestamp extension of " + std::to_string(length) + " bytes at offset " +
+                                          std::to_string(cursor - begin));
+    }
+}
+
+inline void MsgpackReader::visit(JsonCustomValue* value, rapidjson::Value&) {
+    readCustomValue(value);
+}
+
+inline void MsgpackReader::visit(JsonNullableCustomValue* value, rapidjson::Value&) {
+    if (isNilNext())
+        return value->resetReferencedValue();
+
+    if (value->isReferencedValueNull())
+        value->reinitializeReferencedValue();
+
+    readCustomValue(value);
+}
+
+inline void MsgpackReader::readVariantAlternative(JsonVariant* variant) {
+    auto select = [variant](std::string_view tag) {
+        if (!variant->selectAlternative(tag))
+            throw TypeMismatchException(std::string("Unknown variant alternative \"").append(tag) + "\"");
+    };
+
+    const uint8_t* start = cursor;
+    const std::size_t entries = readMapHeader();
+
+    if (VariantTagging::Internal == variant->taggingStyle()) {
+        std::string_view tag;
+        bool hasTag = false;
+
+        // The discriminator selects the alternative whose members are read, so it is looked up first
+        for (std::size_t entry = 0; entry < entries && !hasTag; ++entry) {
+            if (readString() == variant->discriminatorName()) {
+                tag = readString();
+                hasTag = true;
+            }
+            else
+                skipValue();
+        }
+
+        if (!hasTag)
+            throw MemberNotFoundException(variant->discriminatorName());
+
+        select(tag);
+        cursor = start;
+        readObjectMembers(variant->getAlternative().get());
+    }
+    else {
+        if (entries != 1)
+            throw TypeMismatchException("Expected an object with a single variant tag, got " + std::to_string(entries) +
+                                        " members");
+
+        enterNesting();
+        select(readString());
+        readObjectMembers(variant->getAlternative().get());
+        leaveNesting();
+    }
+}
+
+inline void MsgpackReader::visit(JsonVariant* variant, rapidjson::Value&) {
+    readVariantAlternative(variant);
+}
+
+inline void MsgpackReader::visit(JsonNullableVariant* variant, rapidjson::Value&) {
+    if (isNilNext())
+        return variant->resetReferencedValue();
+
+    readVariantAlternative(variant);
+}
+
+
+template<typename Struct>
+void marshalMsgpackImpl(const Struct& s, std::vector<uint8_t>& buffer) {
+    JsonObject root(buildJsonTreeFrom(s));
+
+    buffer.clear();
+
+    MsgpackWriter writer(buffer);
+    writer.writeToMsgpack(&root);
+}
+
+template<typename Struct>
+void unmarshalMsgpackImpl(const uint8_t* data, std::size_t size, Struct& s, std::pmr::memory_resource* resource) {
+    MsgpackReader reader(data, size, resource);
+
+    JsonObject root(buildJsonTreeFrom(s));
+    reader.readFromMsgpack(&root);
+}
+
+}  // namespace detail
+
+
+template<typename Struct>
+void marshal_msgpack(const Struct& s, std::vector<uint8_t>& buffer) {
+    detail::marshalMsgpackImpl(s, buffer);
+}
+
+template<typename Struct>
+std::vector<uint8_t> marshal_msgpack(const Struct& s) {
+    std::vector<uint8_t> buffer;
+    detail::marshalMsgpackImpl(s, buffer);
+
+    return buffer;
+}
+
+template<typename Struct>
+void unmarshal_msgpack(const uint8_t* data, std::size_t size, Struct& s, std::pmr::memory_resource* resource) {
+    detail::unmarshalMsgpackImpl(data, size, s, resource);
+}
+
+template<typename Struct>
+void unmarshal_msgpack(const std::vector<uint8_t>& data, Struct& s, std::pmr::memory_resource* resource) {
+    detail::unmarshalMsgpackImpl(data.data(), data.size(), s, resource);
+}
+
+inline InvalidMsgpackException::InvalidMsgpackException(std::string_view what) :
+    std::logic_error(what.data()) {
+}
+
+}  // namespace rapidjson_util
+
+#endif
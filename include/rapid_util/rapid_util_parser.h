@@ -22,6 +22,11 @@
 #include <cstdint>
 #include <any>
 #include <stdexcept>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include <utility>
 
 namespace rapidjson_util {
 
@@ -61,6 +66,15 @@ public:
 };
 
 
+/**
+ * @brief Exception thrown when a JSON string is longer than the fixed capacity of a string member
+ */
+class StringLengthExceededException : public std::logic_error {
+public:
+	StringLengthExceededException(std::string_view what);
+};
+
+
 /**
  * @brief Exception thrown when the JSON input has invalid syntax
  */
@@ -79,6 +93,83 @@ public:
 };
 
 
+/**
+ * @brief Exception thrown when a member holds a value that has no encoding, such as a
+ *        std::variant that is valueless by exception
+ */
+class UnserializableValueException : public std::logic_error {
+public:
+	UnserializableValueException(std::string_view what);
+};
+
+
+/**
+ * @brief Exception thrown when a path of a FieldMask doesn't select a member of the struct
+ */
+class InvalidFieldPathException : public std::logic_error {
+public:
+	InvalidFieldPathException(std::string_view what);
+};
+
+
+/**
+ * @brief Writes the JSON value of a member through its json_codec
+ *
+ * Strings are copied into the document. value() and allocator() give access to the underlying
+ * RapidJSON value for anything else, such as objects or arrays.
+ */
+class JsonValueWriter {
+public:
+	JsonValueWriter(rapidjson::Value& _value, rapidjson::Document::AllocatorType& _allocator);
+
+	void writeNull();
+	void writeBool(bool boolean);
+	void writeInt(int64_t number);
+	void writeUint(uint64_t number);
+	void writeDouble(double number);
+	void writeString(std::string_view str);
+
+	rapidjson::Value& value();
+	rapidjson::Document::AllocatorType& allocator();
+
+private:
+	rapidjson::Value& jsonOutput;
+	rapidjson::Document::AllocatorType& documentAllocator;
+};
+
+
+/**
+ * @brief Reads the JSON value of a member through its json_codec
+ *
+ * Every read function throws TypeMismatchException if the JSON value has a different type.
+ */
+class JsonValueReader {
+public:
+	explicit JsonValueReader(const rapidjson::Value& _value);
+
+	bool isNull() const;
+	bool readBool() const;
+
+	/**
+	  * @brief Reads an integer, throwing TypeMismatchException if it doesn't fit into Integer
+	  */
+	template<typename Integer>
+	Integer readInteger() const;
+
+	double readDouble() const;
+
+	/**
+	  * @return The characters of the JSON string, valid while the input is being deserialized
+	  */
+	std::string_view readString() const;
+
+	const rapidjson::Value& value() const;
+
+private:
+	const rapidjson::Value& jsonInput;
+};
+
+
 namespace detail {
 
 class JsonPrimitiveValue;
@@ -86,6 +177,13 @@ class JsonObject;
 class JsonNullableObject;
 class JsonArray;
 class JsonNullableArray;
+class JsonNumberArray;
+class JsonInlineString;
+class JsonNullableInlineString;
+class JsonCustomValue;
+class JsonNullableCustomValue;
+class JsonVariant;
+class JsonNullableVariant;
 
 template<typename Exception>
 void ThrowUnless(bool condition, Exception&& exception) {
@@ -107,6 +205,13 @@ public:
 	virtual void visit(JsonNullableObject* object, rapidjson::Value& rapidjsonValue) = 0;
 	virtual void visit(JsonArray*, rapidjson::Value& rapidjsonValue) = 0;
 	virtual void visit(JsonNullableArray* array, rapidjson::Value& rapidjsonValue) = 0;
+	virtual void visit(JsonNumberArray* array, rapidjson::Value& rapidjsonValue) = 0;
+	virtual void visit(JsonInlineString* string, rapidjson::Value& rapidjsonValue) = 0;
+	virtual void visit(JsonNullableInlineString* string, rapidjson::Value& rapidjsonValue) = 0;
+	virtual void visit(JsonCustomValue* value, rapidjson::Value& rapidjsonValue) = 0;
+	virtual void visit(JsonNullableCustomValue* value, rapidjson::Value& rapidjsonValue) = 0;
+	virtual void visit(JsonVariant* variant, rapidjson::Value& rapidjsonValue) = 0;
+	virtual void visit(JsonNullableVariant* variant, rapidjson::Value& rapidjsonValue) = 0;
 
 	virtual ~JsonVisitor() = default;
 };
@@ -122,6 +227,11 @@ public:
 class JsonWriter : public JsonVisitor {
 public:
 
+	/**
+      * @param omission Members left out of structs that don't have an Omission style of their own
+      */
+	JsonWriter(Omission omission = Omission::None);
+
 	/**
       * @brief Serialize a JSON object hierarchy to JSON string 
       *
@@ -139,12 +249,30 @@ public:
 	void visit(JsonNullableObject* object, rapidjson::Value& jsonOutput) override;
 	void visit(JsonArray* array, rapidjson::Value& jsonOutput) override;
 	void visit(JsonNullableArray* array, rapidjson::Value& jsonOutput) override;
+	void visit(JsonNumberArray* array, rapidjson::Value& jsonOutput) override;
+	void visit(JsonInlineString* string, rapidjson::Value& jsonOutput) override;
+	void visit(JsonNullableInlineString* string, rapidjson::Value& jsonOutput) override;
+	void visit(JsonCustomValue* value, rapidjson::Value& jsonOutput) override;
+	void visit(JsonNullableCustomValue* value, rapidjson::Value& jsonOutput) override;
+	void visit(JsonVariant* variant, rapidjson::Value& jsonOutput) override;
+	void visit(JsonNullableVariant* variant, rapidjson::Value& jsonOutput) override;
 
 private:
 	void writeObjectMembers(JsonObject* object, rapidjson::Value& jsonOutput);
+	void appendObjectMembers(JsonObject* object, rapidjson::Value& jsonOutput);
 	void writeArrayMembers(JsonArray* array, rapidjson::Value& jsonOutput);
+	void writeVariantAlternative(JsonVariant* variant, rapidjson::Value& jsonOutput);
+	void writeInlineString(JsonInlineString* string, rapidjson::Value& jsonOutput);
+
+	template<typename Number>
+	const Number* writeNumbers(const Number* numbers, const std::vector<std::size_t>& extents,
+	                           std::size_t dimension, rapidjson::Value& jsonOutput);
+
+	template<typename Number>
+	static void writeNumber(Number number, rapidjson::Value& jsonOutput);
 
 	rapidjson::Document rapidjsonDocument;
+	Omission omission;
 };
 
 
@@ -159,8 +287,14 @@ public:
       * @brief Construct a JsonReader with JSON input for parsing
       *
       * @param jsonInput JSON string to parse and deserialize
+      * @param resource Memory resource that std::pmr strings and containers constructed or
+      *                 resized during deserialization allocate from, nullptr to leave their
+      *                 allocators untouched
+      * @param omission Members that may be missing from structs that don't have an Omission
+      *                 style of their own
       */
-	JsonReader(std::string_view jsonInput);
+	JsonReader(std::string_view jsonInput, std::pmr::memory_resource* resource = nullptr,
+	           Omission omission = Omission::None);
 
 	/**
       * @brief Deserializes JSON input provided during construction and updates corresponding 
@@ -179,12 +313,30 @@ public:
 	void visit(JsonNullableObject* object, rapidjson::Value& jsonInput) override;
 	void visit(JsonArray* array, rapidjson::Value& jsonInput) override;
 	void visit(JsonNullableArray* array, rapidjson::Value& jsonInput) override;
+	void visit(JsonNumberArray* array, rapidjson::Value& jsonInput) override;
+	void visit(JsonInlineString* string, rapidjson::Value& jsonInput) override;
+	void visit(JsonNullableInlineString* string, rapidjson::Value& jsonInput) override;
+	void visit(JsonCustomValue* value, rapidjson::Value& jsonInput) override;
+	void visit(JsonNullableCustomValue* value, rapidjson::Value& jsonInput) override;
+	void visit(JsonVariant* variant, rapidjson::Value& jsonInput) override;
+	void visit(JsonNullableVariant* variant, rapidjson::Value& jsonInput) override;
 
 private:
 	void readObjectMembers(JsonObject* object, rapidjson::Value& jsonInput);
 	void readArrayElements(JsonArray* array, rapidjson::Value& jsonInput);
+	void readVariantAlternative(JsonVariant* variant, rapidjson::Value& jsonInput);
+	void readInlineString(JsonInlineString* string, rapidjson::Value& jsonInput);
+
+	template<typename Number>
+	Number* readNumbers(Number* numbers, const std::vector<std::size_t>& extents,
+	                    std::size_t dimension, const rapidjson::Value& jsonInput);
+
+	template<typename Number>
+	static Number readNumber(const rapidjson::Value& jsonInput);
 
 	rapidjson::Document rapidjsonDocument;
+	std::pmr::memory_resource* resource;
+	Omission omission;
 };
 
 
@@ -201,29 +353,80 @@ public:
 };
 
 
+/**
+ * @brief Re-seats a std::pmr string or container on resource, so that everything it allocates
+ *        from now on comes from there
+ *
+ * The previous content is discarded, callers overwrite it right afterwards. Nothing happens if
+ * resource is nullptr or already in use.
+ */
+template<typename PmrType>
+void rebindMemoryResource(PmrType& object, std::pmr::memory_resource* resource) {
+	if (resource == nullptr || object.get_allocator().resource() == resource)
+		return;
+
+	std::destroy_at(&object);
+	::new (static_cast<void*>(&object)) PmrType(resource);
+}
+
+/**
+ * @brief Whether a reader resizes array to newSize before reading into it
+ *
+ * The resizer of a std::pmr container re-seats it on resource, so when reading with a resource
+ * the container is resized even to its own size. Otherwise it would keep its previous resource
+ * while the elements read into it take the new one.
+ */
+template<typename Array>
+bool isResizeNeeded(const Array* array, std::size_t newSize, std::pmr::memory_resource* resource) {
+	return newSize != array->size() || (resource != nullptr && array->isResizable());
+}
+
+
+// Expands X(storedType, CXXType) for every number type a JsonPrimitiveValue or JsonNumberArray may point to.
+// long is int64_t on LP64 and a 32-bit type of its own on LLP64, long long is the other way round
+#define RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(X)                                                              \
+	X(Int8Ptr, int8_t) X(Int16Ptr, int16_t) X(IntPtr, int) X(Int64Ptr, int64_t) X(LongPtr, long)            \
+	X(LongLongPtr, long long) X(Uint8Ptr, uint8_t) X(Uint16Ptr, uint16_t) X(Uint32Ptr, uint32_t)            \
+	X(Uint64Ptr, uint64_t) X(UlongPtr, unsigned long) X(UlongLongPtr, unsigned long long)                   \
+	X(FloatPtr, float) X(DoublePtr, double)
+
+
 class JsonPrimitiveValue : public JsonValue {
 public:
 	enum class StoredType {
+		Int8Ptr,
+		Int16Ptr,
 		IntPtr,
 		Int64Ptr,
+		LongPtr,
+		LongLongPtr,
+		Uint8Ptr,
+		Uint16Ptr,
+		Uint32Ptr,
 		Uint64Ptr,
+		UlongPtr,
+		UlongLongPtr,
 		FloatPtr,
 		DoublePtr,
 		BoolPtr,
-		StringPtr
+		StringPtr,
+		PmrStringPtr,
+		StringViewPtr
 	};
 
 	enum class OwnershipType {
 		Raw, 
-		StdOptional
+		StdOptional,
+		StdUniquePtr,
+		StdSharedPtr
 	};
 
 	/**
       * Constructs a JsonPrimitiveValue that maintains a pointer to a struct member.
-      * The member can be a regular attribute or a optional wrapper, only std::optional
-	  * members are allowed to be null.
+      * The member can be a regular attribute or a nullable wrapper, only std::optional,
+	  * std::unique_ptr and std::shared_ptr members are allowed to be null.
       *
-      * @template param T The member type (e.g. int, std::optional<int>, const std::string, etc.)
+      * @template param T The member type (e.g. int, std::optional<int>, std::unique_ptr<std::string>, etc.)
       * @param _value Pointer to the struct member that will be updated
       */
 	template<typename T>
@@ -249,7 +452,35 @@ public:
 	}
 
 	/**
-      * @return How the member is owned (raw pointer or pointer to a optional wrapper)
+	  * @return The StoredType used for members of type T, nullable wrappers are looked through
+	  */
+	template<typename T>
+	static constexpr StoredType getStoredType() {
+		using BaseType = remove_nullable_wrapper_t<std::remove_const_t<T>>;
+
+		if constexpr (std::is_same_v<BaseType, int8_t>)        return StoredType::Int8Ptr;
+		else if constexpr (std::is_same_v<BaseType, int16_t>)  return StoredType::Int16Ptr;
+		else if constexpr (std::is_same_v<BaseType, int>)      return StoredType::IntPtr;
+		else if constexpr (std::is_same_v<BaseType, int64_t>)  return StoredType::Int64Ptr;
+		else if constexpr (std::is_same_v<BaseType, uint8_t>)  return StoredType::Uint8Ptr;
+		else if constexpr (std::is_same_v<BaseType, uint16_t>) return StoredType::Uint16Ptr;
+		else if constexpr (std::is_same_v<BaseType, uint32_t>) return StoredType::Uint32Ptr;
+		else if constexpr (std::is_same_v<BaseType, uint64_t>) return StoredType::Uint64Ptr;
+		else if constexpr (std::is_same_v<BaseType, long>)               return StoredType::LongPtr;
+		else if constexpr (std::is_same_v<BaseType, unsigned long>)      return StoredType::UlongPtr;
+		else if constexpr (std::is_same_v<BaseType, long long>)          return StoredType::LongLongPtr;
+		else if constexpr (std::is_same_v<BaseType, unsigned long long>) return StoredType::UlongLongPtr;
+		else if constexpr (std::is_same_v<BaseType, bool>)     return StoredType::BoolPtr;
+		else if constexpr (std::is_same_v<BaseType, float>)    return StoredType::FloatPtr;
+		else if constexpr (std::is_same_v<BaseType, double>)   return StoredType::DoublePtr;
+		else if constexpr (std::is_same_v<BaseType, std::string>) return StoredType::StringPtr;
+		else if constexpr (std::is_same_v<BaseType, std::pmr::string>) return StoredType::PmrStringPtr;
+		else if constexpr (std::is_same_v<BaseType, std::string_view>) return StoredType::StringViewPtr;
+		else static_assert(false, "Unsupported type");
+	}
+
+	/**
+      * @return How the member is owned (raw pointer or pointer to a nullable wrapper)
       */
 	OwnershipType ownershipType() const {
 		return ptrOwnershipType;
@@ -285,7 +516,7 @@ public:
 	}
 
 	/**
-	 * Resets referenced std::optional struct's member to std::nullopt.
+	 * Resets referenced nullable struct's member to std::nullopt or nullptr.
 	 *
 	 * @pre isPointToConst() must be false (struct's member must be non-const qualified)
 	 *
@@ -297,20 +528,18 @@ public:
 			return;
 
 		#define RESET_TO_NULL(storedType, CXXType)												\
-		    case StoredType::storedType: {														\
-				auto value = std::any_cast<std::optional<CXXType>*>(storedValue());			    \
-				value->reset();																    \
-				break;                                                                          \
-			}
+		    case StoredType::storedType:														\
+				resetNullable<CXXType>();													    \
+				break;
 
 		switch (storedType()) {
-			RESET_TO_NULL(IntPtr, int)
-			RESET_TO_NULL(Int64Ptr, int64_t)
-			RESET_TO_NULL(Uint64Ptr, uint64_t)
-			RESET_TO_NULL(FloatPtr, float)
-			RESET_TO_NULL(DoublePtr, double)
+			RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(RESET_TO_NULL)
 			RESET_TO_NULL(BoolPtr, bool)
 			RESET_TO_NULL(StringPtr, std::string)
+			RESET_TO_NULL(PmrStringPtr, std::pmr::string)
+			case StoredType::StringViewPtr:
+				assert(false && "Views are marshal-only");
+				break;
 		}
 
         #undef RESET_TO_NULL
@@ -329,11 +558,16 @@ public:
 		assert(isPointToConst());
 		assert(!isReferencedValueNull());
 
-		if (OwnershipType::Raw == ownershipType())
-			return std::any_cast<const T*>(storedValue());
-
-		const std::optional<T>* opt = std::any_cast<const std::optional<T>*>(storedValue());
-		return const_cast<const T*>(&(opt->value()));
+		switch (ownershipType()) {
+			case OwnershipType::StdOptional:
+				return &(std::any_cast<const std::optional<T>*>(storedValue())->value());
+			case OwnershipType::StdUniquePtr:
+				return std::any_cast<const std::unique_ptr<T>*>(storedValue())->get();
+			case OwnershipType::StdSharedPtr:
+				return std::any_cast<const std::shared_ptr<T>*>(storedValue())->get();
+			default:
+				return std::any_cast<const T*>(storedValue());
+		}
 	}
 
 	/**
@@ -349,9 +583,15 @@ public:
 			return std::any_cast<T*>(storedValue());
 
 		initializeIfReferencedValueIsNull();
-		std::optional<T>* opt = std::any_cast<std::optional<T>*>(storedValue());
 
-		return &(opt->value());
+		switch (ownershipType()) {
+			case OwnershipType::StdOptional:
+				return &(std::any_cast<std::optional<T>*>(storedValue())->value());
+			case OwnershipType::StdUniquePtr:
+				return std::any_cast<std::unique_ptr<T>*>(storedValue())->get();
+			default:
+				return std::any_cast<std::shared_ptr<T>*>(storedValue())->get();
+		}
 	}
 
 private:
@@ -363,8 +603,8 @@ private:
 
 	template<typename T>
 	bool checkIsNull(const T* value) {
-		if constexpr (is_std_optional_v<T>)
-			return !value->has_value();  
+		if constexpr (is_nullable_wrapper_v<T>)
+			return !static_cast<bool>(*value);  
 		else
 			return false;
 	}
@@ -372,23 +612,11 @@ private:
 	template<typename T>
 	constexpr OwnershipType getOwnershipType() {
 		if constexpr (is_std_optional_v<T>) return OwnershipType::StdOptional;
+		else if constexpr (is_std_unique_ptr_v<T>) return OwnershipType::StdUniquePtr;
+		else if constexpr (is_std_shared_ptr_v<T>) return OwnershipType::StdSharedPtr;
 		else return OwnershipType::Raw;
 	}
 
-	template<typename T>
-	constexpr StoredType getStoredType() {
-		using BaseType = remove_std_optional_t<std::remove_const_t<T>>;
-
-		if constexpr (std::is_same_v<BaseType, int>)       return StoredType::IntPtr;
-		else if constexpr (std::is_same_v<BaseType, int64_t>)  return StoredType::Int64Ptr;
-		else if constexpr (std::is_same_v<BaseType, uint64_t>) return StoredType::Uint64Ptr;
-		else if constexpr (std::is_same_v<BaseType, bool>)     return StoredType::BoolPtr;
-		else if constexpr (std::is_same_v<BaseType, float>)    return StoredType::FloatPtr;
-		else if constexpr (std::is_same_v<BaseType, double>)   return StoredType::DoublePtr;
-		else if constexpr (std::is_same_v<BaseType, std::string>) return StoredType::StringPtr;
-		else static_assert(false, "Unsupported type");
-	}
-
 	void initializeIfReferencedValueIsNull() {
 		assert(!isPointToConst());
 
@@ -396,32 +624,71 @@ private:
 			return;
 
         #define REINITIALIZE(storedType, CXXType)                                           \
-		    case JsonPrimitiveValue::StoredType::storedType: {                              \
-				auto value = std::any_cast<std::optional<CXXType>*>(storedValue());         \
-				*value = CXXType{};                                                         \
-				break;                                                                      \
-			}
+		    case JsonPrimitiveValue::StoredType::storedType:                                \
+				reinitializeNullable<CXXType>();                                            \
+				break;
 
 		switch (storedType()) {
-			REINITIALIZE(IntPtr, int)
-			REINITIALIZE(Int64Ptr, int64_t)
-			REINITIALIZE(Uint64Ptr, uint64_t)
-			REINITIALIZE(FloatPtr, float)
-			REINITIALIZE(DoublePtr, double)
+			RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(REINITIALIZE)
 			REINITIALIZE(BoolPtr, bool)
 			REINITIALIZE(StringPtr, std::string)
+			REINITIALIZE(PmrStringPtr, std::pmr::string)
+			case StoredType::StringViewPtr:
+				assert(false && "Views are marshal-only");
+				break;
 		}
 
         #undef REINITIALIZE
 
 		isNull = false;
 	}
+
+	template<typename CXXType>
+	void resetNullable() {
+		switch (ownershipType()) {
+			case OwnershipType::StdOptional:  std::any_cast<std::optional<CXXType>*>(storedValue())->reset();   break;
+			case OwnershipType::StdUniquePtr: std::any_cast<std::unique_ptr<CXXType>*>(storedValue())->reset(); break;
+			case OwnershipType::StdSharedPtr: std::any_cast<std::shared_ptr<CXXType>*>(storedValue())->reset(); break;
+			default: break;
+		}
+	}
+
+	// Only allocates for the smart pointers, and only once a non-null JSON value is read
+	template<typename CXXType>
+	void reinitializeNullable() {
+		switch (ownershipType()) {
+			case OwnershipType::StdOptional:  *std::any_cast<std::optional<CXXType>*>(storedValue()) = CXXType{};                 break;
+			case OwnershipType::StdUniquePtr: *std::any_cast<std::unique_ptr<CXXType>*>(storedValue()) = std::make_unique<CXXType>(); break;
+			case OwnershipType::StdSharedPtr: *std::any_cast<std::shared_ptr<CXXType>*>(storedValue()) = std::make_shared<CXXType>(); break;
+			default: break;
+		}
+	}
+};
+
+
+/**
+ * @brief Leaves a member of a described struct out under an Omission
+ *
+ * When the struct is written, omit() tells whether the member is left out. When it is read and
+ * the member is missing, omit() restores it to the value it is left out with, and tells whether
+ * it may be missing at all.
+ */
+struct JsonMemberOmitter {
+	Omission style = Omission::None;
+	const void* object = nullptr;
+	bool (*omitMember)(const void* object, Omission omission) = nullptr;
+
+	bool omit(Omission callOmission) const {
+		Omission omission = style != Omission::None ? style : callOmission;
+		return omission != Omission::None && omitMember != nullptr && omitMember(object, omission);
+	}
 };
 
 
 struct JsonAttribute {
 	std::string name;
 	std::shared_ptr<JsonValue> value;
+	JsonMemberOmitter omitter = {};
 };
 
 
@@ -439,6 +706,18 @@ public:
 		return members;
 	}
 
+	// The members that aren't left out under the Omission of the call
+	std::vector<JsonAttribute> getWrittenMembers(Omission omission) const {
+		std::vector<JsonAttribute> written;
+		written.reserve(members.size());
+
+		for (auto&& member : members)
+			if (!member.omitter.omit(omission))
+				written.push_back(member);
+
+		return written;
+	}
+
 	void accept(JsonVisitor& visitor, rapidjson::Value& rapidjsonValue) override {
 		visitor.visit(this, rapidjsonValue);
 	}
@@ -502,24 +781,35 @@ private:
 
 class JsonArray : public JsonValue {
 public:
-	using ArrayResizer = std::function<std::vector<std::shared_ptr<JsonValue>>(std::size_t)>;
+	using ArrayResizer = std::function<std::vector<std::shared_ptr<JsonValue>>(std::size_t, std::pmr::memory_resource*)>;
 
 	JsonArray(const std::vector<std::shared_ptr<JsonValue>>& _elements = {}, bool _hasOptionalElems = false) :
 		elements(_elements), hasOptionalElems(_hasOptionalElems) {
 	}
 
-	void setArrayResizer(ArrayResizer _resizer) {
+	/**
+	  * @param _maxSize Largest size the resizer accepts, i.e. max_size() of the container
+	  */
+	void setArrayResizer(ArrayResizer _resizer, std::size_t _maxSize = std::numeric_limits<std::size_t>::max()) {
 		assert(_resizer != nullptr);
 
 		resizer = _resizer;
+		maxElements = _maxSize;
 	}
 
 	bool isResizable() const {
 		return resizer != nullptr;
 	}
 
-	void resize(std::size_t newSize) {
-		elements = resizer(newSize);
+	std::size_t maxSize() const {
+		return isResizable() ? maxElements : size();
+	}
+
+	/**
+	  * @param resource Memory resource a std::pmr container is re-seated on before it grows, may be nullptr
+	  */
+	void resize(std::size_t newSize, std::pmr::memory_resource* resource = nullptr) {
+		elements = resizer(newSize, resource);
 	}
 
 	std::size_t size() const {
@@ -543,6 +833,7 @@ public:
 protected:
 	std::vector<std::shared_ptr<JsonValue>> elements;
 	ArrayResizer resizer = nullptr;
+	std::size_t maxElements = 0;
 	bool hasOptionalElems;
 };
 
@@ -601,139 +892,776 @@ private:
 };
 
 
-inline std::string JsonWriter::witeToJson(JsonObject* root) {
-	root->accept(*this, rapidjsonDocument);
-
-	rapidjson::StringBuffer buffer;
+/**
+ * @brief The values of one member across the elements of a container laid out as columns
+ *
+ * The elements are taken from the container whenever the column is visited, as reading a
+ * column before this one may have resized, and so moved, the container. The columns of a
+ * container share its length, once a column is read the others must have the same length.
+ */
+class JsonColumn : public JsonArray {
+public:
+	using ElementsBuilder = std::function<std::vector<std::shared_ptr<JsonValue>>()>;
+	using SequenceResizer = std::function<void(std::size_t, std::pmr::memory_resource*)>;
+	using SharedLength = std::shared_ptr<std::optional<std::size_t>>;
 
-	rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-	rapidjsonDocument.Accept(writer);
+	JsonColumn(ElementsBuilder _builder, bool _hasOptionalElems, SharedLength _length) :
+		JsonArray({}, _hasOptionalElems), builder(_builder), length(_length) {
+		assert(builder != nullptr);
+	}
 
-	return buffer.GetString();
-}
+	/**
+	  * @param _maxSize Largest size the resizer accepts, i.e. max_size() of the container
+	  */
+	void setSequenceResizer(SequenceResizer _resizer, std::size_t _maxSize) {
+		assert(_resizer != nullptr);
 
-inline void JsonWriter::visit(JsonPrimitiveValue* primitiveValue, rapidjson::Value& jsonOutput) {
-	assert(primitiveValue->isPointToConst());
+		setArrayResizer([this, _resizer](std::size_t newSize, std::pmr::memory_resource* resource) {
+			                if (*length && **length != newSize)
+				                throw ArrayLengthMismatchException("Column length mismatch: JSON contains " + std::to_string(newSize) +
+				                                                   " elements, but the columns before contain " +
+				                                                   std::to_string(**length) + " elements.");
 
-	if (JsonPrimitiveValue::OwnershipType::Raw != primitiveValue->ownershipType() && primitiveValue->isReferencedValueNull()) {
-		jsonOutput.SetNull();
-		return;
+			                _resizer(newSize, resource);
+			                return builder();
+		                }, _maxSize);
 	}
-		
-	switch (primitiveValue->storedType()) {
-		case JsonPrimitiveValue::StoredType::IntPtr: {
-			auto value = primitiveValue->unwrapConstPointer<int>();
-			jsonOutput.SetInt(*value);
-			break;
-		}
 
-		case JsonPrimitiveValue::StoredType::Int64Ptr: {
-			auto value = primitiveValue->unwrapConstPointer<int64_t>();
-			jsonOutput.SetInt64(*value);
-			break;
-		}
+	void accept(JsonVisitor& visitor, rapidjson::Value& rapidjsonValue) override {
+		elements = builder();
 
-		case JsonPrimitiveValue::StoredType::Uint64Ptr: {
-			auto value = primitiveValue->unwrapConstPointer<uint64_t>();
-			jsonOutput.SetUint64(*value);
-			break;
-		}
+		visitor.visit(static_cast<JsonArray*>(this), rapidjsonValue);
 
-		case JsonPrimitiveValue::StoredType::BoolPtr: {
-			auto value = primitiveValue->unwrapConstPointer<bool>();
-			jsonOutput.SetBool(*value);
-			break;
-		}
+		if (!*length)
+			*length = size();
+	}
 
-		case JsonPrimitiveValue::StoredType::FloatPtr: {
-			auto value = primitiveValue->unwrapConstPointer<float>();
-			jsonOutput.SetFloat(*value);
-			break;
-		}
+private:
+	ElementsBuilder builder;
+	SharedLength length;
+};
 
-		case JsonPrimitiveValue::StoredType::DoublePtr: {
-			auto value = primitiveValue->unwrapConstPointer<double>();
-			jsonOutput.SetDouble(*value);
-			break;
-		}
 
-		case JsonPrimitiveValue::StoredType::StringPtr: {
-			auto value = primitiveValue->unwrapConstPointer<std::string>();
-			jsonOutput.SetString(value->c_str(), static_cast<rapidjson::SizeType>(value->length()),
-				                     rapidjsonDocument.GetAllocator());
-			break;
-		}
+/**
+ * @brief A string member with fixed inline capacity: char[N], std::array<char, N> or fixed_string<N>
+ *
+ * The characters are viewed and assigned in place through the inline_string_traits of the
+ * member type, so neither direction constructs a std::string.
+ */
+class JsonInlineString : public JsonValue {
+public:
+	using Viewer = std::string_view (*)(const void*);
+	using Assigner = void (*)(void*, std::string_view);
+
+	template<typename T>
+	JsonInlineString(T* _value) :
+		value(const_cast<std::remove_const_t<T>*>(_value)),
+		maxLength(inline_string_traits<std::remove_const_t<T>>::capacity),
+		viewer(&inline_string_traits<std::remove_const_t<T>>::view),
+		assigner(&inline_string_traits<std::remove_const_t<T>>::assign),
+		pointToConst(std::is_const_v<T>) {
 	}
-}
 
-inline void JsonWriter::writeObjectMembers(JsonObject* object, rapidjson::Value& jsonOutput)
-{
-	jsonOutput.SetObject();
+	bool isPointToConst() const {
+		return pointToConst;
+	}
 
-	for (auto&& member : object->getMembers()) {
-		rapidjson::Value name(member.name.c_str(), rapidjsonDocument.GetAllocator());
+	/**
+	  * @return The maximum number of characters the member can hold
+	  */
+	std::size_t capacity() const {
+		return maxLength;
+	}
 
-		rapidjson::Value value;
-		member.value->accept(*this, value);
+	std::string_view view() const {
+		assert(value != nullptr);
 
-		jsonOutput.AddMember(name, value, rapidjsonDocument.GetAllocator());
+		return viewer(value);
 	}
-}
 
-inline void JsonWriter::visit(JsonObject* object, rapidjson::Value& jsonOutput) {
-	writeObjectMembers(object, jsonOutput);
-}
+	void assign(std::string_view str) {
+		assert(value != nullptr && !isPointToConst());
+		assert(str.size() <= maxLength);
 
-inline void JsonWriter::visit(JsonNullableObject* object, rapidjson::Value& jsonOutput) {
-	if (object->isReferencedValueNull()) {
-		jsonOutput.SetNull();
-		return;
+		assigner(value, str);
 	}
 
-	writeObjectMembers(object, jsonOutput);
-}
+	void accept(JsonVisitor& visitor, rapidjson::Value& rapidjsonValue) override {
+		visitor.visit(this, rapidjsonValue);
+	}
 
-inline void JsonWriter::writeArrayMembers(JsonArray* array, rapidjson::Value& jsonOutput)
-{
-	jsonOutput.SetArray();
+	virtual ~JsonInlineString() = default;
 
-	for (auto&& element : array->getElements()) {
-		rapidjson::Value value;
-		element->accept(*this, value);
+protected:
+	void* value;
 
-		jsonOutput.PushBack(value, rapidjsonDocument.GetAllocator());
+private:
+	std::size_t maxLength;
+	Viewer viewer;
+	Assigner assigner;
+	bool pointToConst;
+};
+
+
+class JsonNullableInlineString : public JsonInlineString {
+public:
+	using ReferencedValueResetter = std::function<void()>;
+	using ReferencedValueReinitializer = std::function<void*()>;
+
+	/**
+	  * @param _value Pointer to the string held by the nullable wrapper, nullptr if the wrapper is empty
+	  */
+	template<typename T>
+	JsonNullableInlineString(T* _value) : JsonInlineString(_value), isNull(_value == nullptr) {
 	}
-}
 
-inline void JsonWriter::visit(JsonArray* array, rapidjson::Value& jsonOutput) {
-	writeArrayMembers(array, jsonOutput);
-}
+	void setReferencedValueHandlers(ReferencedValueReinitializer _reinitializer, ReferencedValueResetter _resetter) {
+		assert(_reinitializer != nullptr);
+		assert(_resetter != nullptr);
 
-inline void JsonWriter::visit(JsonNullableArray* array, rapidjson::Value& jsonOutput)
-{
-	if (array->isReferencedValueNull()) {
-		jsonOutput.SetNull();
-		return;
+		reinitializer = _reinitializer;
+		resetter = _resetter;
 	}
 
-	writeArrayMembers(array, jsonOutput);
-}
+	bool isReferencedValueNull() const {
+		return isNull;
+	}
 
+	void resetReferencedValue() {
+		if (!resetter) return;
 
-inline JsonReader::JsonReader(std::string_view json) {
-	if (json.empty())
-		throw EmptyJsonStringException{};
+		resetter();
 
-	if (rapidjsonDocument.Parse(json.data()).HasParseError())
-		throw InvalidJsonException("The provided JSON text has invalid syntax");
-}
+		value = nullptr;
+		isNull = true;
+	}
 
-inline void JsonReader::readFromJson(JsonObject* root) {
-	root->accept(*this, rapidjsonDocument);
-}
+	void reinitializeReferencedValue() {
+		if (!reinitializer) return;
 
+		value = reinitializer();
+		isNull = false;
+	}
 
-enum class QueryType {
+	void accept(JsonVisitor& visitor, rapidjson::Value& rapidjsonValue) override {
+		visitor.visit(this, rapidjsonValue);
+	}
+
+private:
+	bool isNull;
+	ReferencedValueResetter resetter = nullptr;
+	ReferencedValueReinitializer reinitializer = nullptr;
+};
+
+
+struct UnixTime {
+	int64_t seconds;
+	uint32_t nanoseconds;
+};
+
+
+/**
+ * @brief A member encoded by a codec, such as a std::chrono time point or duration
+ *
+ * The codec's encode and decode functions convert between the member and its JSON value
+ * directly, the node itself knows nothing about the member type.
+ */
+class JsonCustomValue : public JsonValue {
+public:
+	using Encoder = void (*)(const void*, rapidjson::Value&, rapidjson::Document::AllocatorType&);
+	using Decoder = void (*)(void*, const rapidjson::Value&);
+
+	/**
+	  * @brief Access to the member for formats that have a native type for it, so that
+	  *        MessagePack and CBOR write bytes as byte strings rather than their base64 text
+	  *
+	  * Binary members set the byte functions and time points encoded as RFC 3339 the time
+	  * functions, any other codec leaves them null.
+	  */
+	struct NativeAccess {
+		std::pair<const uint8_t*, std::size_t> (*bytes)(const void*) = nullptr;
+		void (*assignBytes)(void*, const uint8_t*, std::size_t) = nullptr;
+		UnixTime (*time)(const void*) = nullptr;
+		void (*assignTime)(void*, UnixTime) = nullptr;
+	};
+
+	template<typename T>
+	JsonCustomValue(T* _value, Encoder _encoder, Decoder _decoder, NativeAccess _native) :
+		value(const_cast<std::remove_const_t<T>*>(_value)), encoder(_encoder), decoder(_decoder), native(_native),
+		pointToConst(std::is_const_v<T>) {
+		assert(encoder != nullptr && decoder != nullptr);
+	}
+
+	bool isPointToConst() const {
+		return pointToConst;
+	}
+
+	void encode(rapidjson::Value& jsonOutput, rapidjson::Document::AllocatorType& allocator) const {
+		assert(value != nullptr);
+
+		encoder(value, jsonOutput, allocator);
+	}
+
+	void decode(const rapidjson::Value& jsonInput) {
+		assert(value != nullptr && !isPointToConst());
+
+		decoder(value, jsonInput);
+	}
+
+	bool isBytes() const {
+		return native.bytes != nullptr;
+	}
+
+	std::pair<const uint8_t*, std::size_t> bytes() const {
+		assert(value != nullptr && isBytes());
+
+		return native.bytes(value);
+	}
+
+	void assignBytes(const uint8_t* data, std::size_t size) {
+		assert(value != nullptr && !isPointToConst() && isBytes());
+
+		native.assignBytes(value, data, size);
+	}
+
+	bool isTime() const {
+		return native.time != nullptr;
+	}
+
+	UnixTime time() const {
+		assert(value != nullptr && isTime());
+
+		return native.time(value);
+	}
+
+	void assignTime(UnixTime time) {
+		assert(value != nullptr && !isPointToConst() && isTime());
+
+		native.assignTime(value, time);
+	}
+
+	void accept(JsonVisitor& visitor, rapidjson::Value& rapidjsonValue) override {
+		visitor.visit(this, rapidjsonValue);
+	}
+
+	virtual ~JsonCustomValue() = default;
+
+protected:
+	void* value;
+
+private:
+	Encoder encoder;
+	Decoder decoder;
+	NativeAccess native;
+	bool pointToConst;
+};
+
+
+class JsonNullableCustomValue : public JsonCustomValue {
+public:
+	using ReferencedValueResetter = std::function<void()>;
+	using ReferencedValueReinitializer = std::function<void*()>;
+
+	/**
+	  * @param _value Pointer to the value held by the nullable wrapper, nullptr if the wrapper is empty
+	  */
+	template<typename T>
+	JsonNullableCustomValue(T* _value, Encoder _encoder, Decoder _decoder, NativeAccess _native) :
+		JsonCustomValue(_value, _encoder, _decoder, _native), isNull(_value == nullptr) {
+	}
+
+	void setReferencedValueHandlers(ReferencedValueReinitializer _reinitializer, ReferencedValueResetter _resetter) {
+		assert(_reinitializer != nullptr);
+		assert(_resetter != nullptr);
+
+		reinitializer = _reinitializer;
+		resetter = _resetter;
+	}
+
+	bool isReferencedValueNull() const {
+		return isNull;
+	}
+
+	void resetReferencedValue() {
+		if (!resetter) return;
+
+		resetter();
+
+		value = nullptr;
+		isNull = true;
+	}
+
+	void reinitializeReferencedValue() {
+		if (!reinitializer) return;
+
+		value = reinitializer();
+		isNull = false;
+	}
+
+	void accept(JsonVisitor& visitor, rapidjson::Value& rapidjsonValue) override {
+		visitor.visit(this, rapidjsonValue);
+	}
+
+private:
+	bool isNull;
+	ReferencedValueResetter resetter = nullptr;
+	ReferencedValueReinitializer reinitializer = nullptr;
+};
+
+
+/**
+ * @brief A contiguous, row-major array of numbers, such as std::vector<double> or
+ *        std::array<std::array<float, 4>, 4>
+ *
+ * The numbers are read and written in place through this single node, instead of a
+ * JsonPrimitiveValue per number and a JsonArray per inner array. extents holds the
+ * length of every dimension, outermost first; only the outermost one can be resized.
+ */
+class JsonNumberArray : public JsonValue {
+public:
+	using StoredType = JsonPrimitiveValue::StoredType;
+	using ArrayResizer = std::function<void*(std::size_t, std::pmr::memory_resource*)>;
+
+	template<typename T>
+	JsonNumberArray(T* _numbers, const std::vector<std::size_t>& _extents) :
+		numbers(const_cast<std::remove_const_t<T>*>(_numbers)), extents(_extents),
+		type(JsonPrimitiveValue::getStoredType<T>()), pointToConst(std::is_const_v<T>) {
+		assert(!extents.empty());
+	}
+
+	/**
+	  * @param _maxSize Largest size the resizer accepts, i.e. max_size() of the container
+	  */
+	void setArrayResizer(ArrayResizer _resizer, std::size_t _maxSize = std::numeric_limits<std::size_t>::max()) {
+		assert(_resizer != nullptr);
+
+		resizer = _resizer;
+		maxElements = _maxSize;
+	}
+
+	bool isResizable() const {
+		return resizer != nullptr;
+	}
+
+	std::size_t maxSize() const {
+		return isResizable() ? maxElements : size();
+	}
+
+	void resize(std::size_t newSize, std::pmr::memory_resource* resource = nullptr) {
+		numbers = resizer(newSize, resource);
+		extents.front() = newSize;
+	}
+
+	std::size_t size() const {
+		return extents.front();
+	}
+
+	const std::vector<std::size_t>& getExtents() const {
+		return extents;
+	}
+
+	bool isPointToConst() const {
+		return pointToConst;
+	}
+
+	StoredType storedType() const {
+		return type;
+	}
+
+	template<typename Number>
+	const Number* unwrapConstPointer() const {
+		return static_cast<const Number*>(numbers);
+	}
+
+	template<typename Number>
+	Number* unwrapPointer() {
+		assert(!isPointToConst());
+
+		return static_cast<Number*>(numbers);
+	}
+
+	void accept(JsonVisitor& visitor, rapidjson::Value& rapidjsonValue) override {
+		visitor.visit(this, rapidjsonValue);
+	}
+
+private:
+	void* numbers;
+	std::vector<std::size_t> extents;
+	StoredType type;
+	bool pointToConst;
+	ArrayResizer resizer = nullptr;
+	std::size_t maxElements = 0;
+};
+
+
+/**
+ * @brief A std::variant member holding one of several described structs
+ *
+ * The active alternative is exposed as a JsonObject together with its tag. When
+ * deserializing, the alternative selector emplaces the alternative matching the tag
+ * read from JSON and returns the object hierarchy of the newly emplaced value.
+ */
+class JsonVariant : public JsonValue {
+public:
+	using AlternativeSelector = std::function<std::shared_ptr<JsonObject>(std::string_view)>;
+
+	JsonVariant(VariantTagging _tagging, std::string_view _discriminator) :
+		tagging(_tagging), discriminator(_discriminator) {
+	}
+
+	void setAlternative(std::string_view _tag, std::shared_ptr<JsonObject> _alternative) {
+		tag = _tag;
+		alternative = _alternative;
+	}
+
+	void setAlternativeSelector(AlternativeSelector _selector) {
+		assert(_selector != nullptr);
+
+		selector = _selector;
+	}
+
+	/**
+	  * Emplaces the alternative tagged by the given name.
+	  *
+	  * @return false if none of the alternatives is tagged by the given name
+	  */
+	virtual bool selectAlternative(std::string_view _tag) {
+		assert(selector != nullptr);
+
+		auto selected = selector(_tag);
+		if (!selected)
+			return false;
+
+		setAlternative(_tag, selected);
+		return true;
+	}
+
+	VariantTagging taggingStyle() const {
+		return tagging;
+	}
+
+	std::string_view discriminatorName() const {
+		return discriminator;
+	}
+
+	std::string_view alternativeTag() const {
+		return tag;
+	}
+
+	std::shared_ptr<JsonObject> getAlternative() const {
+		return alternative;
+	}
+
+	void accept(JsonVisitor& visitor, rapidjson::Value& rapidjsonValue) override {
+		visitor.visit(this, rapidjsonValue);
+	}
+
+	virtual ~JsonVariant() = default;
+
+private:
+	VariantTagging tagging;
+	std::string_view discriminator;
+	std::string_view tag;
+	std::shared_ptr<JsonObject> alternative;
+	AlternativeSelector selector = nullptr;
+};
+
+
+class JsonNullableVariant : public JsonVariant {
+public:
+	using ReferencedValueResetter = std::function<void()>;
+
+	JsonNullableVariant(VariantTagging _tagging, std::string_view _discriminator, bool _isNull) :
+		JsonVariant(_tagging, _discriminator), isNull(_isNull) {
+	}
+
+	void setReferencedValueResetter(ReferencedValueResetter _resetter) {
+		assert(_resetter != nullptr);
+
+		resetter = _resetter;
+	}
+
+	bool isReferencedValueNull() const {
+		return isNull;
+	}
+
+	void resetReferencedValue() {
+		if (!resetter) return;
+
+		resetter();
+
+		setAlternative({}, nullptr);
+		isNull = true;
+	}
+
+	bool selectAlternative(std::string_view _tag) override {
+		if (!JsonVariant::selectAlternative(_tag))
+			return false;
+
+		isNull = false;
+		return true;
+	}
+
+	void accept(JsonVisitor& visitor, rapidjson::Value& rapidjsonValue) override {
+		visitor.visit(this, rapidjsonValue);
+	}
+
+private:
+	bool isNull;
+	ReferencedValueResetter resetter = nullptr;
+};
+
+
+inline JsonWriter::JsonWriter(Omission _omission) : omission(_omission) {
+}
+
+inline std::string JsonWriter::witeToJson(JsonObject* root) {
+	root->accept(*this, rapidjsonDocument);
+
+	rapidjson::StringBuffer buffer;
+
+	rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+	rapidjsonDocument.Accept(writer);
+
+	return buffer.GetString();
+}
+
+inline void JsonWriter::visit(JsonPrimitiveValue* primitiveValue, rapidjson::Value& jsonOutput) {
+	assert(primitiveValue->isPointToConst());
+
+	if (JsonPrimitiveValue::OwnershipType::Raw != primitiveValue->ownershipType() && primitiveValue->isReferencedValueNull()) {
+		jsonOutput.SetNull();
+		return;
+	}
+
+    #define WRITE_NUMBER(storedType, CXXType)                                                  \
+	    case JsonPrimitiveValue::StoredType::storedType:                                       \
+			writeNumber(*primitiveValue->unwrapConstPointer<CXXType>(), jsonOutput);           \
+			break;
+
+	switch (primitiveValue->storedType()) {
+		RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(WRITE_NUMBER)
+
+		case JsonPrimitiveValue::StoredType::BoolPtr: {
+			auto value = primitiveValue->unwrapConstPointer<bool>();
+			jsonOutput.SetBool(*value);
+			break;
+		}
+
+		case JsonPrimitiveValue::StoredType::StringPtr: {
+			auto value = primitiveValue->unwrapConstPointer<std::string>();
+			jsonOutput.SetString(value->c_str(), static_cast<rapidjson::SizeType>(value->length()),
+				                     rapidjsonDocument.GetAllocator());
+			break;
+		}
+
+		case JsonPrimitiveValue::StoredType::PmrStringPtr: {
+			auto value = primitiveValue->unwrapConstPointer<std::pmr::string>();
+			jsonOutput.SetString(value->c_str(), static_cast<rapidjson::SizeType>(value->length()),
+				                     rapidjsonDocument.GetAllocator());
+			break;
+		}
+
+		case JsonPrimitiveValue::StoredType::StringViewPtr: {
+			// The document only lives while writing, so it can refer to the viewed characters
+			// instead of copying them. RapidJSON asserts on null strings, which empty views may hold.
+			auto value = primitiveValue->unwrapConstPointer<std::string_view>();
+			jsonOutput.SetString(value->data() != nullptr ? value->data() : "", static_cast<rapidjson::SizeType>(value->length()));
+			break;
+		}
+	}
+
+    #undef WRITE_NUMBER
+}
+
+inline void JsonWriter::writeObjectMembers(JsonObject* object, rapidjson::Value& jsonOutput)
+{
+	jsonOutput.SetObject();
+
+	appendObjectMembers(object, jsonOutput);
+}
+
+inline void JsonWriter::appendObjectMembers(JsonObject* object, rapidjson::Value& jsonOutput)
+{
+	for (auto&& member : object->getMembers()) {
+		if (member.omitter.omit(omission))
+			continue;
+
+		rapidjson::Value name(member.name.c_str(), rapidjsonDocument.GetAllocator());
+
+		rapidjson::Value value;
+		member.value->accept(*this, value);
+
+		jsonOutput.AddMember(name, value, rapidjsonDocument.GetAllocator());
+	}
+}
+
+inline void JsonWriter::visit(JsonObject* object, rapidjson::Value& jsonOutput) {
+	writeObjectMembers(object, jsonOutput);
+}
+
+inline void JsonWriter::visit(JsonNullableObject* object, rapidjson::Value& jsonOutput) {
+	if (object->isReferencedValueNull()) {
+		jsonOutput.SetNull();
+		return;
+	}
+
+	writeObjectMembers(object, jsonOutput);
+}
+
+inline void JsonWriter::writeArrayMembers(JsonArray* array, rapidjson::Value& jsonOutput)
+{
+	jsonOutput.SetArray();
+
+	for (auto&& element : array->getElements()) {
+		rapidjson::Value value;
+		element->accept(*this, value);
+
+		jsonOutput.PushBack(value, rapidjsonDocument.GetAllocator());
+	}
+}
+
+inline void JsonWriter::visit(JsonArray* array, rapidjson::Value& jsonOutput) {
+	writeArrayMembers(array, jsonOutput);
+}
+
+inline void JsonWriter::visit(JsonNullableArray* array, rapidjson::Value& jsonOutput)
+{
+	if (array->isReferencedValueNull()) {
+		jsonOutput.SetNull();
+		return;
+	}
+
+	writeArrayMembers(array, jsonOutput);
+}
+
+inline void JsonWriter::visit(JsonNumberArray* array, rapidjson::Value& jsonOutput) {
+    #define WRITE_NUMBERS(storedType, CXXType)                                                         \
+	    case JsonPrimitiveValue::StoredType::storedType:                                               \
+			writeNumbers(array->unwrapConstPointer<CXXType>(), array->getExtents(), 0, jsonOutput);    \
+			break;
+
+	switch (array->storedType()) {
+		RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(WRITE_NUMBERS)
+		default: assert(false && "Only numbers are stored contiguously");
+	}
+
+    #undef WRITE_NUMBERS
+}
+
+template<typename Number>
+const Number* JsonWriter::writeNumbers(const Number* numbers, const std::vector<std::size_t>& extents,
+                                       std::size_t dimension, rapidjson::Value& jsonOutput) {
+	bool isInnermost = dimension + 1 == extents.size();
+
+	jsonOutput.SetArray();
+	jsonOutput.Reserve(static_cast<rapidjson::SizeType>(extents[dimension]), rapidjsonDocument.GetAllocator());
+
+	for (std::size_t i = 0; i < extents[dimension]; ++i) {
+		rapidjson::Value value;
+
+		if (isInnermost)
+			writeNumber(*numbers++, value);
+		else
+			numbers = writeNumbers(numbers, extents, dimension + 1, value);
+
+		jsonOutput.PushBack(value, rapidjsonDocument.GetAllocator());
+	}
+
+	return numbers;
+}
+
+template<typename Number>
+void JsonWriter::writeNumber(Number number, rapidjson::Value& jsonOutput) {
+	if constexpr (std::is_same_v<Number, float>)       jsonOutput.SetFloat(number);
+	else if constexpr (std::is_same_v<Number, double>) jsonOutput.SetDouble(number);
+	else if constexpr (std::is_signed_v<Number>)       jsonOutput.SetInt64(number);
+	else                                               jsonOutput.SetUint64(number);
+}
+
+inline void JsonWriter::writeInlineString(JsonInlineString* string, rapidjson::Value& jsonOutput) {
+	auto value = string->view();
+	jsonOutput.SetString(value.data(), static_cast<rapidjson::SizeType>(value.length()), rapidjsonDocument.GetAllocator());
+}
+
+inline void JsonWriter::visit(JsonInlineString* string, rapidjson::Value& jsonOutput) {
+	writeInlineString(string, jsonOutput);
+}
+
+inline void JsonWriter::visit(JsonNullableInlineString* string, rapidjson::Value& jsonOutput) {
+	if (string->isReferencedValueNull()) {
+		jsonOutput.SetNull();
+		return;
+	}
+
+	writeInlineString(string, jsonOutput);
+}
+
+inline void JsonWriter::visit(JsonCustomValue* value, rapidjson::Value& jsonOutput) {
+	value->encode(jsonOutput, rapidjsonDocument.GetAllocator());
+}
+
+inline void JsonWriter::visit(JsonNullableCustomValue* value, rapidjson::Value& jsonOutput) {
+	if (value->isReferencedValueNull()) {
+		jsonOutput.SetNull();
+		return;
+	}
+
+	value->encode(jsonOutput, rapidjsonDocument.GetAllocator());
+}
+
+inline void JsonWriter::writeVariantAlternative(JsonVariant* variant, rapidjson::Value& jsonOutput)
+{
+	auto tag = variant->alternativeTag();
+	rapidjson::Value tagValue(tag.data(), static_cast<rapidjson::SizeType>(tag.length()), rapidjsonDocument.GetAllocator());
+
+	jsonOutput.SetObject();
+
+	if (VariantTagging::Internal == variant->taggingStyle()) {
+		auto discriminator = variant->discriminatorName();
+		rapidjson::Value name(discriminator.data(), static_cast<rapidjson::SizeType>(discriminator.length()),
+			                  rapidjsonDocument.GetAllocator());
+
+		jsonOutput.AddMember(name, tagValue, rapidjsonDocument.GetAllocator());
+		appendObjectMembers(variant->getAlternative().get(), jsonOutput);
+	}
+	else {
+		rapidjson::Value value;
+		writeObjectMembers(variant->getAlternative().get(), value);
+
+		jsonOutput.AddMember(tagValue, value, rapidjsonDocument.GetAllocator());
+	}
+}
+
+inline void JsonWriter::visit(JsonVariant* variant, rapidjson::Value& jsonOutput) {
+	writeVariantAlternative(variant, jsonOutput);
+}
+
+inline void JsonWriter::visit(JsonNullableVariant* variant, rapidjson::Value& jsonOutput) {
+	if (variant->isReferencedValueNull()) {
+		jsonOutput.SetNull();
+		return;
+	}
+
+	writeVariantAlternative(variant, jsonOutput);
+}
+
+
+inline JsonReader::JsonReader(std::string_view json, std::pmr::memory_resource* _resource, Omission _omission) :
+	resource(_resource), omission(_omission) {
+	if (json.empty())
+		throw EmptyJsonStringException{};
+
+	if (rapidjsonDocument.Parse(json.data()).HasParseError())
+		throw InvalidJsonException("The provided JSON text has invalid syntax");
+}
+
+inline void JsonReader::readFromJson(JsonObject* root) {
+	root->accept(*this, rapidjsonDocument);
+}
+
+
+enum class QueryType {
 	IsInt,
 	IsInt64,
 	IsUint64,
@@ -768,7 +1696,54 @@ public:
         #undef RAPIDJSON_VALUE_VALIDATE
 	}
 
-private:
+	/**
+	  * Converts a JSON integer to Integer, throwing TypeMismatchException if the value is not an
+	  * integer or doesn't fit. RapidJSON keeps every parsed integer as a 64-bit value, so a single
+	  * comparison against the limits of Integer decides. The checks throw from plain if statements,
+	  * as ThrowUnless would build the exception message for every integer read.
+	  */
+	template<typename Integer>
+	static Integer narrow(const rapidjson::Value& value) {
+		using Limits = std::numeric_limits<Integer>;
+
+		const char* expectedType = integerTypeName<Integer>();
+		if (!value.IsInt64() && !value.IsUint64())
+			throw TypeMismatchException(std::string("Expected ") + expectedType + ", got " + getTypeFrom(value));
+
+		if (value.IsInt64()) {
+			int64_t number = value.GetInt64();
+			bool isInRange = number < 0 ? number >= static_cast<int64_t>(Limits::min())
+			                            : static_cast<uint64_t>(number) <= static_cast<uint64_t>(Limits::max());
+			if (!isInRange)
+				throw TypeMismatchException("Value " + std::to_string(number) + " is out of range for " + expectedType);
+
+			return static_cast<Integer>(number);
+		}
+
+		uint64_t number = value.GetUint64();
+		if (number > static_cast<uint64_t>(Limits::max()))
+			throw TypeMismatchException("Value " + std::to_string(number) + " is out of range for " + expectedType);
+
+		return static_cast<Integer>(number);
+	}
+
+	// Type names used in TypeMismatchException messages, also by the other encodings
+
+	template<typename Integer>
+	static constexpr const char* integerTypeName() {
+		using Fixed = fixed_width_integer_t<Integer>;
+
+		if constexpr (!std::is_integral_v<Integer>)         static_assert(false, "Unsupported integer type");
+		else if constexpr (std::is_same_v<Fixed, int8_t>)   return "Int8";
+		else if constexpr (std::is_same_v<Fixed, int16_t>)  return "Int16";
+		else if constexpr (std::is_same_v<Fixed, int>)      return "Int";
+		else if constexpr (std::is_same_v<Fixed, int64_t>)  return "Int64";
+		else if constexpr (std::is_same_v<Fixed, uint8_t>)  return "Uint8";
+		else if constexpr (std::is_same_v<Fixed, uint16_t>) return "Uint16";
+		else if constexpr (std::is_same_v<Fixed, uint32_t>) return "Uint32";
+		else                                                return "Uint64";
+	}
+
 	static std::string getTypeFrom(const rapidjson::Value& value) {
 		if (value.IsNumber()) {
 			if (value.IsInt())    return "Int";
@@ -796,46 +1771,13 @@ inline void JsonReader::visit(JsonPrimitiveValue* primitiveValue, rapidjson::Val
 	if (jsonInput.IsNull() && primitiveValue->ownershipType() != JsonPrimitiveValue::OwnershipType::Raw)
 		return primitiveValue->resetReferencedValue();
 
-	switch (primitiveValue->storedType()) {
-		case JsonPrimitiveValue::StoredType::IntPtr: {
-			RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsInt);
-
-			auto value = primitiveValue->unwrapPointer<int>();
-			*value = jsonInput.GetInt();
-			break;
-		} 
-
-		case JsonPrimitiveValue::StoredType::Int64Ptr: {
-			RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsInt64);
-
-			auto value = primitiveValue->unwrapPointer<int64_t>();
-			*value = jsonInput.GetInt64();
-			break;
-		}
-
-		case JsonPrimitiveValue::StoredType::Uint64Ptr: {
-			RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsUint64);
-
-			auto value = primitiveValue->unwrapPointer<uint64_t>();
-			*value = jsonInput.GetUint64();
+    #define READ_NUMBER(storedType, CXXType)                                                   \
+	    case JsonPrimitiveValue::StoredType::storedType:                                       \
+			*primitiveValue->unwrapPointer<CXXType>() = readNumber<CXXType>(jsonInput);        \
 			break;
-		}
-
-		case JsonPrimitiveValue::StoredType::FloatPtr: {
-			RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsFloat);
-
-			auto value = primitiveValue->unwrapPointer<float>();
-			*value = jsonInput.GetFloat();
-			break;
-		}
-
-		case JsonPrimitiveValue::StoredType::DoublePtr: {
-			RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsDouble);
 
-			auto value = primitiveValue->unwrapPointer<double>();
-			*value = jsonInput.GetDouble();
-			break;
-		}
+	switch (primitiveValue->storedType()) {
+		RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(READ_NUMBER)
 
 		case JsonPrimitiveValue::StoredType::BoolPtr: {
 			RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsBool);
@@ -852,7 +1794,22 @@ inline void JsonReader::visit(JsonPrimitiveValue* primitiveValue, rapidjson::Val
 			*value = jsonInput.GetString();
 			break;
 		}
+
+		case JsonPrimitiveValue::StoredType::PmrStringPtr: {
+			RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsString);
+
+			auto value = primitiveValue->unwrapPointer<std::pmr::string>();
+			rebindMemoryResource(*value, resource);
+			value->assign(jsonInput.GetString(), jsonInput.GetStringLength());
+			break;
+		}
+
+		case JsonPrimitiveValue::StoredType::StringViewPtr:
+			assert(false && "Views are marshal-only");
+			break;
 	}
+
+    #undef READ_NUMBER
 }
 
 inline void  JsonReader::readObjectMembers(JsonObject* object, rapidjson::Value& jsonInput) {
@@ -860,10 +1817,15 @@ inline void  JsonReader::readObjectMembers(JsonObject* object, rapidjson::Value&
 
 	for (auto&& member : object->getMembers()) {
 		auto name = member.name.c_str();
-		ThrowUnless(jsonInput.HasMember(name), MemberNotFoundException(name));
+		auto jsonMember = jsonInput.FindMember(name);
+
+		if (jsonMember == jsonInput.MemberEnd()) {
+			ThrowUnless(member.omitter.omit(omission), MemberNotFoundException(name));
+			continue;
+		}
 
 		try {
-			member.value->accept(*this, jsonInput[name]);
+			member.value->accept(*this, jsonMember->value);
 		}
 		catch (std::logic_error& e) {
 			throw MemberSerializationFailure(std::string("Deserialization of member \"") +
@@ -898,6 +1860,17 @@ inline bool hasNullElements(const rapidjson::Value& value) {
 	return false;
 }
 
+inline ArrayLengthMismatchException fixedCapacityMismatch(std::size_t jsonSize, std::size_t capacity) {
+	return ArrayLengthMismatchException("Array size mismatch: JSON contains " + std::to_string(jsonSize) +
+	                                    " elements, but given array has fixed capacity of " + std::to_string(capacity) +
+	                                    " elements and cannot be resized.");
+}
+
+inline ArrayLengthMismatchException capacityExceeded(std::size_t jsonSize, std::size_t maxSize) {
+	return ArrayLengthMismatchException("Array size mismatch: JSON contains " + std::to_string(jsonSize) +
+	                                    " elements, but given array can hold at most " + std::to_string(maxSize) + " elements.");
+}
+
 inline void JsonReader::readArrayElements(JsonArray* array, rapidjson::Value& jsonInput) {
 	RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsArray);
 
@@ -905,13 +1878,12 @@ inline void JsonReader::readArrayElements(JsonArray* array, rapidjson::Value& js
 		ThrowUnless(!hasNullElements(jsonInput), TypeMismatchException("JSON array contains null elements"));
 
 	auto jsonArray = jsonInput.GetArray();
-	ThrowUnless(jsonArray.Size() == array->size() || array->isResizable(), ArrayLengthMismatchException(
-									"Array size mismatch: JSON contains " + std::to_string(jsonArray.Size()) +
-									" elements, but given array has fixed capacity of " + std::to_string(array->size()) +
-									" elements and cannot be resized."));
+	ThrowUnless(jsonArray.Size() == array->size() || array->isResizable(),
+	            fixedCapacityMismatch(jsonArray.Size(), array->size()));
+	ThrowUnless(jsonArray.Size() <= array->maxSize(), capacityExceeded(jsonArray.Size(), array->maxSize()));
 
-	if (jsonArray.Size() != array->size())
-		array->resize(jsonArray.Size());
+	if (isResizeNeeded(array, jsonArray.Size(), resource))
+		array->resize(jsonArray.Size(), resource);
 
 	auto elements = array->getElements();
 	size_t elemIndex = 0;
@@ -934,8 +1906,221 @@ inline void JsonReader::visit(JsonNullableArray* array, rapidjson::Value& jsonIn
 	readArrayElements(array, jsonInput);
 }
 
+inline void JsonReader::visit(JsonNumberArray* array, rapidjson::Value& jsonInput) {
+	assert(!array->isPointToConst());
+
+	RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsArray);
+
+	// Checked with plain if statements, as ThrowUnless would build the exception message for
+	// every array and number read
+	auto jsonSize = jsonInput.GetArray().Size();
+	if (jsonSize != array->size() && !array->isResizable())
+		throw fixedCapacityMismatch(jsonSize, array->size());
+	if (jsonSize > array->maxSize())
+		throw capacityExceeded(jsonSize, array->maxSize());
+
+	if (isResizeNeeded(array, jsonSize, resource))
+		array->resize(jsonSize, resource);
+
+    #define READ_NUMBERS(storedType, CXXType)                                                    \
+	    case JsonPrimitiveValue::StoredType::storedType:                                         \
+			readNumbers(array->unwrapPointer<CXXType>(), array->getExtents(), 0, jsonInput);     \
+			break;
+
+	switch (array->storedType()) {
+		RAPIDJSON_UTIL_FOR_EACH_NUMBER_TYPE(READ_NUMBERS)
+		default: assert(false && "Only numbers are stored contiguously");
+	}
+
+    #undef READ_NUMBERS
+}
+
+template<typename Number>
+Number* JsonReader::readNumbers(Number* numbers, const std::vector<std::size_t>& extents,
+                                std::size_t dimension, const rapidjson::Value& jsonInput) {
+	RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsArray);
+
+	auto jsonArray = jsonInput.GetArray();
+	if (jsonArray.Size() != extents[dimension])
+		throw fixedCapacityMismatch(jsonArray.Size(), extents[dimension]);
+
+	bool isInnermost = dimension + 1 == extents.size();
+
+	for (auto&& value : jsonArray) {
+		if (isInnermost) {
+			if (value.IsNull())
+				throw TypeMismatchException("JSON array contains null elements");
+			*numbers++ = readNumber<Number>(value);
+		}
+		else
+			numbers = readNumbers(numbers, extents, dimension + 1, value);
+	}
+
+	return numbers;
+}
+
+template<typename Number>
+Number JsonReader::readNumber(const rapidjson::Value& jsonInput) {
+	if constexpr (std::is_same_v<Number, float>) {
+		RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsFloat);
+		return jsonInput.GetFloat();
+	}
+	else if constexpr (std::is_same_v<Number, double>) {
+		RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsDouble);
+		return jsonInput.GetDouble();
+	}
+	else
+		return RapidjsonValueTypeValidator::narrow<Number>(jsonInput);
+}
+
+inline void JsonReader::readInlineString(JsonInlineString* string, rapidjson::Value& jsonInput) {
+	RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsString);
+
+	std::size_t length = jsonInput.GetStringLength();
+	ThrowUnless(length <= string->capacity(), StringLengthExceededException(
+	                "String length mismatch: JSON contains " + std::to_string(length) + " characters, but given string "
+	                "has fixed capacity of " + std::to_string(string->capacity()) + " characters."));
+
+	string->assign(std::string_view(jsonInput.GetString(), length));
+}
+
+inline void JsonReader::visit(JsonInlineString* string, rapidjson::Value& jsonInput) {
+	readInlineString(string, jsonInput);
+}
+
+inline void JsonReader::visit(JsonNullableInlineString* string, rapidjson::Value& jsonInput) {
+	if (jsonInput.IsNull())
+		return string->resetReferencedValue();
+
+	if (string->isReferencedValueNull())
+		string->reinitializeReferencedValue();
+
+	readInlineString(string, jsonInput);
+}
+
+inline void JsonReader::visit(JsonCustomValue* value, rapidjson::Value& jsonInput) {
+	value->decode(jsonInput);
+}
+
+inline void JsonReader::visit(JsonNullableCustomValue* value, rapidjson::Value& jsonInput) {
+	if (jsonInput.IsNull())
+		return value->resetReferencedValue();
+
+	if (value->isReferencedValueNull())
+		value->reinitializeReferencedValue();
+
+	value->decode(jsonInput);
+}
+
+inline void JsonReader::readVariantAlternative(JsonVariant* variant, rapidjson::Value& jsonInput) {
+	RapidjsonValueTypeValidator::validate(jsonInput, QueryType::IsObject);
+
+	auto select = [variant](const rapidjson::Value& tag) {
+		RapidjsonValueTypeValidator::validate(tag, QueryType::IsString);
+
+		std::string_view name(tag.GetString(), tag.GetStringLength());
+		ThrowUnless(variant->selectAlternative(name),
+			        TypeMismatchException(std::string("Unknown variant alternative \"").append(name) + "\""));
+	};
+
+	if (VariantTagging::Internal == variant->taggingStyle()) {
+		std::string discriminator(variant->discriminatorName());
+		ThrowUnless(jsonInput.HasMember(discriminator.c_str()), MemberNotFoundException(discriminator));
+
+		select(jsonInput[discriminator.c_str()]);
+		readObjectMembers(variant->getAlternative().get(), jsonInput);
+	}
+	else {
+		ThrowUnless(jsonInput.MemberCount() == 1, TypeMismatchException("Expected an object with a single variant tag, got " +
+			                                                            std::to_string(jsonInput.MemberCount()) + " members"));
+
+		auto tagged = jsonInput.MemberBegin();
+		select(tagged->name);
+		readObjectMembers(variant->getAlternative().get(), tagged->value);
+	}
+}
+
+inline void JsonReader::visit(JsonVariant* variant, rapidjson::Value& jsonInput) {
+	readVariantAlternative(variant, jsonInput);
+}
+
+inline void JsonReader::visit(JsonNullableVariant* variant, rapidjson::Value& jsonInput) {
+	if (jsonInput.IsNull())
+		return variant->resetReferencedValue();
+
+	readVariantAlternative(variant, jsonInput);
+}
+
 }  // namespace detail
 
+inline JsonValueWriter::JsonValueWriter(rapidjson::Value& _value, rapidjson::Document::AllocatorType& _allocator) :
+	jsonOutput(_value), documentAllocator(_allocator) {
+}
+
+inline void JsonValueWriter::writeNull() {
+	jsonOutput.SetNull();
+}
+
+inline void JsonValueWriter::writeBool(bool boolean) {
+	jsonOutput.SetBool(boolean);
+}
+
+inline void JsonValueWriter::writeInt(int64_t number) {
+	jsonOutput.SetInt64(number);
+}
+
+inline void JsonValueWriter::writeUint(uint64_t number) {
+	jsonOutput.SetUint64(number);
+}
+
+inline void JsonValueWriter::writeDouble(double number) {
+	jsonOutput.SetDouble(number);
+}
+
+inline void JsonValueWriter::writeString(std::string_view str) {
+	// RapidJSON asserts on null strings, which empty views may hold
+	jsonOutput.SetString(str.data() != nullptr ? str.data() : "", static_cast<rapidjson::SizeType>(str.length()), documentAllocator);
+}
+
+inline rapidjson::Value& JsonValueWriter::value() {
+	return jsonOutput;
+}
+
+inline rapidjson::Document::AllocatorType& JsonValueWriter::allocator() {
+	return documentAllocator;
+}
+
+inline JsonValueReader::JsonValueReader(const rapidjson::Value& _value) : jsonInput(_value) {
+}
+
+inline bool JsonValueReader::isNull() const {
+	return jsonInput.IsNull();
+}
+
+inline bool JsonValueReader::readBool() const {
+	detail::RapidjsonValueTypeValidator::validate(jsonInput, detail::QueryType::IsBool);
+	return jsonInput.GetBool();
+}
+
+template<typename Integer>
+Integer JsonValueReader::readInteger() const {
+	return detail::RapidjsonValueTypeValidator::narrow<Integer>(jsonInput);
+}
+
+inline double JsonValueReader::readDouble() const {
+	detail::RapidjsonValueTypeValidator::validate(jsonInput, detail::QueryType::IsDouble);
+	return jsonInput.GetDouble();
+}
+
+inline std::string_view JsonValueReader::readString() const {
+	detail::RapidjsonValueTypeValidator::validate(jsonInput, detail::QueryType::IsString);
+	return std::string_view(jsonInput.GetString(), jsonInput.GetStringLength());
+}
+
+inline const rapidjson::Value& JsonValueReader::value() const {
+	return jsonInput;
+}
+
 inline MemberSerializationFailure::MemberSerializationFailure(std::string_view what):
 	std::logic_error(what.data())
 {
@@ -956,6 +2141,11 @@ inline ArrayLengthMismatchException::ArrayLengthMismatchException(std::string_vi
 {
 }
 
+inline StringLengthExceededException::StringLengthExceededException(std::string_view what) :
+	std::logic_error(what.data())
+{
+}
+
 inline InvalidJsonException::InvalidJsonException(std::string_view what) :
 	std::logic_error(what.data())
 {
@@ -966,6 +2156,16 @@ inline EmptyJsonStringException::EmptyJsonStringException() :
 {
 }
 
+inline UnserializableValueException::UnserializableValueException(std::string_view what) :
+	std::logic_error(what.data())
+{
+}
+
+inline InvalidFieldPathException::InvalidFieldPathException(std::string_view what) :
+	std::logic_error(what.data())
+{
+}
+
 }  // namespace rapidjson_util 
 
 
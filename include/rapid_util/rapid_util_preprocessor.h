@@ -13,14 +13,107 @@
 #define __RAPIDJSON_UTIL_PREPROCESSOR_H__
 
 #include <string>
+#include <memory_resource>
 #include <list>
 #include <vector>
 #include <array>
 #include <type_traits>
+#include <cstdint>
 #include <optional>
+#include <memory>
+#include <variant>
+#include <chrono>
+#include <string_view>
+#include <functional>
+#include <utility>
+#include <cstring>
+#include "rapid_util_containers.h"
+#if __has_include(<span>)
+#include <span>
+#endif
 
 namespace rapidjson_util {
 
+/**
+ * @brief JSON shapes used to tag the active alternative of a std::variant member
+ */
+enum class VariantTagging {
+    External,   // {"Circle": {"radius": 1.0}}
+    Internal    // {"type": "Circle", "radius": 1.0}
+};
+
+/**
+ * @brief Members of a struct left out of the output to shrink it
+ */
+enum class Omission {
+    None,       // Every member is written
+    Nulls,      // Members that are null are left out, and read back as null
+    Defaults    // Members equal to those of a value-initialized struct are left out, and read back as those
+};
+
+/**
+ * @brief Omission of the members of a described struct, none by default
+ *
+ * Specialize it directly or with the RAPIDJSON_UTIL_DESCRIBE_OMISSION macro. The style of a
+ * struct takes precedence over the omission passed to marshal and unmarshal, which applies to
+ * the structs that have none.
+ */
+template<typename Struct>
+struct member_omission {
+    static constexpr Omission style = Omission::None;
+};
+
+/**
+ * @brief Names the members of a described struct are written with, their own names by default
+ *
+ * Specialize it with the RAPIDJSON_UTIL_DESCRIBE_WIRE_NAMES macro, e.g. to shorten the keys of
+ * frequent messages.
+ */
+template<typename Struct>
+struct wire_names {
+    static constexpr bool is_described = false;
+};
+
+/**
+ * @brief Subset of the members of a described struct written by marshal<View>, none by default
+ *
+ * Specialize it with the RAPIDJSON_UTIL_DESCRIBE_VIEW macro, which also declares the View tag,
+ * e.g. to write the public members of a struct without copying them into a struct of their own.
+ * The members keep the wire names and the omission of the struct.
+ */
+template<typename View>
+struct marshal_view {
+    static constexpr bool is_described = false;
+};
+
+class JsonValueWriter;
+class JsonValueReader;
+
+/**
+ * @brief Extension point for member types the library does not support natively, such as
+ *        decimal prices, UUIDs or IP addresses
+ *
+ * Specialize it with two static functions, which are called for every member of type T,
+ * including those held by std::optional, smart pointers and containers:
+ *
+ * @code
+ * template<> struct rapidjson_util::json_codec<Uuid> {
+ *     static void write(JsonValueWriter& writer, const Uuid& uuid) { writer.writeString(uuid.str()); }
+ *     static void read(JsonValueReader& reader, Uuid& uuid) { uuid = Uuid::parse(reader.readString()); }
+ * };
+ * @endcode
+ *
+ * A specialization takes precedence over the built-in handling of T. Exceptions derived from
+ * std::logic_error thrown by read are reported as a failure of the member being read.
+ *
+ * JSON calls the codec through one function pointer, which writes and reads the member's value
+ * in place. MessagePack and CBOR have no writer of their own for codecs: they convert the value
+ * through a rapidjson::Value, which makes a codec slower there than a built-in member.
+ */
+template<typename T>
+struct json_codec {
+};
+
 namespace detail {
 
 template<typename... Types>
@@ -61,6 +154,31 @@ struct member_type<T C::*> {
 template<typename T>
 using member_type_t = typename member_type<T>::type;
 
+template<auto Member, typename MemberDescriptor>
+constexpr bool isDescribedMember() {
+    if constexpr (std::is_same_v<decltype(MemberDescriptor::pointer()), decltype(Member)>)
+        return MemberDescriptor::pointer() == Member;
+    else
+        return false;
+}
+
+// The position of Member among the described members, or their count if it isn't one of them
+template<typename... MemberDescriptors>
+constexpr std::size_t describedMemberCount(TypeList<MemberDescriptors...>) {
+    return sizeof...(MemberDescriptors);
+}
+
+template<auto Member, typename... MemberDescriptors>
+constexpr std::size_t describedMemberIndex(TypeList<MemberDescriptors...>) {
+    constexpr bool matches[] = { isDescribedMember<Member, MemberDescriptors>()..., false };
+
+    for (std::size_t i = 0; i < sizeof...(MemberDescriptors); ++i)
+        if (matches[i])
+            return i;
+
+    return sizeof...(MemberDescriptors);
+}
+
 
 template<template<typename> typename Wrapper, typename T>
 struct is_wrapper : std::false_type {};
@@ -100,24 +218,96 @@ template<typename T>
 using remove_std_optional_t = typename remove_std_optional<T>::type;
 
 
+template<typename T>
+struct is_std_unique_ptr_impl : std::false_type {};
+
+template<typename T>
+struct is_std_unique_ptr_impl<std::unique_ptr<T>> : std::true_type {};
+
+template<typename T>
+struct is_std_unique_ptr : is_std_unique_ptr_impl<remove_const_and_reference_t<T>> {};
+
+template<typename T>
+constexpr bool is_std_unique_ptr_v = is_std_unique_ptr<T>::value;
+
+
+template<typename T>
+struct is_std_shared_ptr_impl : is_wrapper<std::shared_ptr, T> {};
+
+template<typename T>
+struct is_std_shared_ptr : is_std_shared_ptr_impl<remove_const_and_reference_t<T>> {};
+
+template<typename T>
+constexpr bool is_std_shared_ptr_v = is_std_shared_ptr<T>::value;
+
+
+// Wrappers mapped to nullable JSON values: std::optional, std::unique_ptr and std::shared_ptr
+template<typename T>
+constexpr bool is_nullable_wrapper_v = is_std_optional_v<T> || is_std_unique_ptr_v<T> || is_std_shared_ptr_v<T>;
+
+
+template<typename T>
+struct remove_nullable_wrapper_impl {
+    using type = T;
+};
+
+template<typename T>
+struct remove_nullable_wrapper_impl<std::optional<T>> {
+    using type = T;
+};
+
+template<typename T>
+struct remove_nullable_wrapper_impl<std::unique_ptr<T>> {
+    using type = T;
+};
+
+template<typename T>
+struct remove_nullable_wrapper_impl<std::shared_ptr<T>> {
+    using type = T;
+};
+
+template<typename T>
+struct remove_nullable_wrapper : remove_nullable_wrapper_impl<remove_const_and_reference_t<T>> {};
+
+template<typename T>
+using remove_nullable_wrapper_t = typename remove_nullable_wrapper<T>::type;
+
+
 // Use for debugging type inspection
 template<typename Type>
 struct type_displayer {
 };
 
 
+// The fixed-width integer of the size and signedness of Integer, long and long long are named and tagged as it
+template<typename Integer>
+using fixed_width_integer_t =
+    std::conditional_t<sizeof(Integer) == 1, std::conditional_t<std::is_signed_v<Integer>, int8_t, uint8_t>,
+    std::conditional_t<sizeof(Integer) == 2, std::conditional_t<std::is_signed_v<Integer>, int16_t, uint16_t>,
+    std::conditional_t<sizeof(Integer) == 4, std::conditional_t<std::is_signed_v<Integer>, int, uint32_t>,
+                                             std::conditional_t<std::is_signed_v<Integer>, int64_t, uint64_t>>>>;
+
 template<typename T>
 constexpr bool is_json_primitive_core_type_v = std::disjunction_v<std::is_same<T, int>,
                                                              std::is_same<T, int8_t>,
+                                                             std::is_same<T, int16_t>,
                                                              std::is_same<T, int32_t>,
                                                              std::is_same<T, int64_t>,
+                                                             std::is_same<T, uint8_t>,
+                                                             std::is_same<T, uint16_t>,
+                                                             std::is_same<T, uint32_t>,
                                                              std::is_same<T, uint64_t>,
+                                                             std::is_same<T, long>,
+                                                             std::is_same<T, unsigned long>,
+                                                             std::is_same<T, long long>,
+                                                             std::is_same<T, unsigned long long>,
                                                              std::is_same<T, bool>,
                                                              std::is_same<T, std::string>,
+                                                             std::is_same<T, std::pmr::string>,
                                                              std::is_same<T, float>,
                                                              std::is_same<T, double>>;
 template<typename T>
-constexpr bool is_json_primitive_type_v = is_json_primitive_core_type_v<remove_std_optional_t<T>>;
+constexpr bool is_json_primitive_type_v = is_json_primitive_core_type_v<remove_nullable_wrapper_t<T>>;
 
 template<typename T>
 constexpr bool is_json_serializable_primitive_type_v =  is_json_primitive_type_v<T>
@@ -127,7 +317,191 @@ constexpr bool is_json_serializable_primitive_type_v =  is_json_primitive_type_v
 
 
 template<typename T>
-constexpr bool is_describable_struct_v = Descriptor<std::remove_reference_t<remove_std_optional_t<T>>>::is_describable;
+constexpr bool is_describable_struct_v = Descriptor<std::remove_reference_t<remove_nullable_wrapper_t<T>>>::is_describable;
+
+
+/**
+ * @brief Buffer operations of string members with fixed inline capacity: char[N], std::array<char, N>
+ *        and fixed_string<N>
+ *
+ * The operations are type-erased so a single JSON node can read and write any of them in place.
+ * Character arrays hold a null-terminated string which, for std::array, may fill the whole array;
+ * the unused tail is zeroed on assignment.
+ */
+template<typename T>
+struct inline_string_traits {
+    static constexpr bool value = false;
+};
+
+template<std::size_t N>
+struct char_array_string_traits {
+    static constexpr bool value = true;
+
+    static std::string_view view(const void* str) {
+        auto chars = static_cast<const char*>(str);
+        auto terminator = static_cast<const char*>(std::memchr(chars, '\0', N));
+
+        return std::string_view(chars, terminator ? terminator - chars : N);
+    }
+
+    static void assign(void* str, std::string_view value) {
+        auto chars = static_cast<char*>(str);
+
+        std::memcpy(chars, value.data(), value.size());
+        std::memset(chars + value.size(), '\0', N - value.size());
+    }
+};
+
+template<std::size_t N>
+struct inline_string_traits<char[N]> : char_array_string_traits<N> {
+    static constexpr std::size_t capacity = N - 1;
+};
+
+template<std::size_t N>
+struct inline_string_traits<std::array<char, N>> : char_array_string_traits<N> {
+    static constexpr std::size_t capacity = N;
+};
+
+template<std::size_t N>
+struct inline_string_traits<fixed_string<N>> {
+    static constexpr bool value = true;
+    static constexpr std::size_t capacity = N;
+
+    static std::string_view view(const void* str) {
+        return *static_cast<const fixed_string<N>*>(str);
+    }
+
+    static void assign(void* str, std::string_view value) {
+        static_cast<fixed_string<N>*>(str)->assign(value.data(), value.size());
+    }
+};
+
+template<typename T>
+constexpr bool is_json_inline_string_v = inline_string_traits<remove_nullable_wrapper_t<T>>::value;
+
+
+template<typename T>
+struct is_json_chrono_impl : std::false_type {};
+
+template<typename Rep, typename Period>
+struct is_json_chrono_impl<std::chrono::duration<Rep, Period>>
+    : std::bool_constant<std::is_arithmetic_v<Rep> && !std::is_same_v<Rep, bool>> {};
+
+// Only system_clock counts from the Unix epoch, which the encodings rely on
+template<typename Duration>
+struct is_json_chrono_impl<std::chrono::time_point<std::chrono::system_clock, Duration>> : is_json_chrono_impl<Duration> {};
+
+template<ChronoEncoding Encoding, typename Chrono>
+struct is_json_chrono_impl<chrono_as<Encoding, Chrono>> : is_json_chrono_impl<Chrono> {};
+
+template<typename T>
+constexpr bool is_json_chrono_v = is_json_chrono_impl<remove_nullable_wrapper_t<T>>::value;
+
+/**
+ * @brief Encoding of a std::chrono member, RFC 3339 strings for time points and counts of
+ *        ticks for durations unless it is wrapped in chrono_as
+ */
+template<typename Chrono>
+struct chrono_encoding_of : std::integral_constant<ChronoEncoding, ChronoEncoding::Count> {};
+
+template<typename Duration>
+struct chrono_encoding_of<std::chrono::time_point<std::chrono::system_clock, Duration>>
+    : std::integral_constant<ChronoEncoding, ChronoEncoding::Rfc3339> {};
+
+template<ChronoEncoding Encoding, typename Chrono>
+struct chrono_encoding_of<chrono_as<Encoding, Chrono>> : std::integral_constant<ChronoEncoding, Encoding> {};
+
+// The std::chrono type that a chrono_as holds, T itself for the others
+template<typename T>
+struct chrono_underlying {
+    using type = T;
+};
+
+template<ChronoEncoding Encoding, typename Chrono>
+struct chrono_underlying<chrono_as<Encoding, Chrono>> {
+    using type = Chrono;
+};
+
+template<typename T>
+using chrono_underlying_t = typename chrono_underlying<T>::type;
+
+
+template<typename T>
+struct binary_traits {
+    static constexpr bool value = false;
+};
+
+template<>
+struct binary_traits<std::vector<std::byte>> {
+    static constexpr bool value = true;
+    static constexpr BinaryEncoding encoding = BinaryEncoding::Base64;
+};
+
+template<BinaryEncoding Encoding, typename Byte>
+struct binary_traits<basic_bytes<Encoding, Byte>> {
+    static constexpr bool value = true;
+    static constexpr BinaryEncoding encoding = Encoding;
+};
+
+template<typename T>
+constexpr bool is_json_binary_v = binary_traits<remove_nullable_wrapper_t<T>>::value;
+
+
+template<typename T, typename = void>
+struct has_json_codec_impl : std::false_type {};
+
+template<typename T>
+struct has_json_codec_impl<T, std::void_t<decltype(json_codec<T>::write(std::declval<JsonValueWriter&>(), std::declval<const T&>())),
+                                          decltype(json_codec<T>::read(std::declval<JsonValueReader&>(), std::declval<T&>()))>>
+    : std::true_type {};
+
+template<typename T>
+constexpr bool has_json_codec_v = has_json_codec_impl<remove_nullable_wrapper_t<T>>::value;
+
+
+// Members read and written by a codec through JsonCustomValue
+template<typename T>
+constexpr bool is_json_codec_value_v = has_json_codec_v<T> || is_json_chrono_v<T> || is_json_binary_v<T>;
+
+
+template<typename T>
+struct is_json_serializable_variant_impl : std::false_type {};
+
+template<typename... Alternatives>
+struct is_json_serializable_variant_impl<std::variant<Alternatives...>>
+    : std::bool_constant<(... && (is_describable_struct_v<Alternatives> && !is_nullable_wrapper_v<Alternatives>))> {};
+
+template<typename Variant, const char* Discriminator>
+struct is_json_serializable_variant_impl<internally_tagged<Variant, Discriminator>> : is_json_serializable_variant_impl<Variant> {};
+
+template<typename T>
+struct is_json_serializable_variant
+    : is_json_serializable_variant_impl<std::remove_reference_t<remove_nullable_wrapper_t<T>>> {};
+
+template<typename T>
+constexpr bool is_json_serializable_variant_v = is_json_serializable_variant<T>::value;
+
+/**
+ * @brief Tagging of a std::variant member, externally tagged unless it is wrapped in
+ *        internally_tagged
+ */
+template<typename Variant>
+struct variant_tagging_of {
+    static constexpr VariantTagging style = VariantTagging::External;
+    static constexpr std::string_view discriminator = default_discriminator;
+};
+
+template<typename Variant, const char* Discriminator>
+struct variant_tagging_of<internally_tagged<Variant, Discriminator>> {
+    static constexpr VariantTagging style = VariantTagging::Internal;
+    static constexpr std::string_view discriminator = Discriminator;
+};
+
+
+// Containers may hold any serializable type, including other containers and tuples,
+// so their element checks refer to the complete trait defined at the end of this file.
+template<typename T>
+struct is_json_serializable;
 
 
 template<typename T, typename = void>
@@ -135,44 +509,64 @@ struct is_json_serializable_fixed_array_impl : std::false_type {};
 
 template<typename Elem, std::size_t N>
 struct is_json_serializable_fixed_array_impl<std::array<Elem, N>>
-    : std::bool_constant<is_json_serializable_primitive_type_v<Elem> || is_describable_struct_v<Elem>> {};
+    : std::bool_constant<is_json_serializable<Elem>::value> {};
+
+template<typename Elem, std::size_t N>
+struct is_json_serializable_fixed_array_impl<columnar<std::array<Elem, N>>>
+    : is_json_serializable_fixed_array_impl<std::array<Elem, N>> {};
 
 template<typename T>
 struct is_json_serializable_fixed_array
-    : is_json_serializable_fixed_array_impl<std::remove_reference_t<remove_std_optional_t<T>>> {};
+    : is_json_serializable_fixed_array_impl<std::remove_reference_t<remove_nullable_wrapper_t<T>>> {};
 
 template<typename Array>
 constexpr bool is_json_serializable_fixed_array_v = is_json_serializable_fixed_array<Array>::value;
 
 
+/**
+ * @brief Detects resizable sequence containers
+ *
+ * Besides std::vector, std::list and std::deque, any type modelling this concept is accepted
+ * as a JSON array, such as static_vector and small_vector:
+ *   - a nested value_type naming the element type
+ *   - begin() and end() iterating the elements in order
+ *   - size() and max_size(), the latter bounding the number of elements a JSON array may hold
+ *   - resize(n), default-constructing appended elements
+ */
 template<typename T, typename = void>
-struct is_json_serializable_vector_impl : std::false_type {};
-
-template<typename Elem, typename Alloc>
-struct is_json_serializable_vector_impl<std::vector<Elem, Alloc>>
-    : std::bool_constant<is_json_serializable_primitive_type_v<Elem> || is_describable_struct_v<Elem>> {};
+struct is_resizable_sequence_container : std::false_type {};
 
 template<typename T>
-struct is_json_serializable_vector
-    : is_json_serializable_vector_impl< std::remove_reference_t<remove_std_optional_t<T>>> {};
+struct is_resizable_sequence_container<T, std::void_t<typename T::value_type,
+                                                       decltype(std::declval<T&>().begin()),
+                                                       decltype(std::declval<T&>().end()),
+                                                       decltype(std::declval<const T&>().size()),
+                                                       decltype(std::declval<const T&>().max_size()),
+                                                       decltype(std::declval<T&>().resize(std::size_t{}))>>
+    : std::true_type {};
 
 
 template<typename T, typename = void>
-struct is_json_serializable_list_impl : std::false_type {};
+struct uses_polymorphic_allocator : std::false_type {};
 
-template<typename Elem, typename Alloc>
-struct is_json_serializable_list_impl<std::list<Elem, Alloc>>
-      : std::bool_constant<is_json_serializable_primitive_type_v<Elem> || is_describable_struct_v<Elem>> {};
+template<typename T>
+struct uses_polymorphic_allocator<T, std::void_t<typename T::allocator_type, typename T::value_type>>
+    : std::is_same<typename T::allocator_type, std::pmr::polymorphic_allocator<typename T::value_type>> {};
 
 template<typename T>
-struct is_json_serializable_list
-    : is_json_serializable_list_impl<std::remove_reference_t<remove_std_optional_t<T>>> {};
+constexpr bool uses_polymorphic_allocator_v = uses_polymorphic_allocator<T>::value;
 
 
+template<typename T, typename = void>
+struct is_json_serializable_dynamic_array_impl : std::false_type {};
+
+template<typename Container>
+struct is_json_serializable_dynamic_array_impl<Container, std::enable_if_t<is_resizable_sequence_container<Container>::value>>
+    : std::bool_constant<is_json_serializable<typename Container::value_type>::value> {};
+
 template<typename Container>
 struct is_json_serializable_dynamic_array
-    : std::bool_constant<is_json_serializable_list<Container>::value || 
-                         is_json_serializable_vector<Container>::value > {};
+    : is_json_serializable_dynamic_array_impl<std::remove_reference_t<remove_nullable_wrapper_t<Container>>> {};
 
 template<typename Container>
 constexpr bool is_json_serializable_dynamic_array_v = is_json_serializable_dynamic_array<Container>::value;
@@ -182,29 +576,127 @@ template<typename T>
 constexpr bool is_json_serializable_sequential_container_v = is_json_serializable_fixed_array_v<T> || is_json_serializable_dynamic_array_v<T>;
 
 
+template<typename T>
+struct is_json_columnar_array_impl : std::false_type {};
+
+template<typename Sequence>
+struct is_json_columnar_array_impl<columnar<Sequence>> : std::true_type {};
+
+/**
+ * @brief Detects containers wrapped in columnar, possibly held by a nullable wrapper
+ */
+template<typename T>
+constexpr bool is_json_columnar_array_v = is_json_columnar_array_impl<std::remove_const_t<remove_nullable_wrapper_t<T>>>::value;
+
+
+template<typename T>
+constexpr bool is_json_number_v = is_json_primitive_core_type_v<T> && std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+
+template<std::size_t... I>
+constexpr std::array<std::size_t, sizeof...(I) + 1> prepend_extent(std::size_t extent,
+                                                                   const std::array<std::size_t, sizeof...(I)>& extents,
+                                                                   std::index_sequence<I...>) {
+    return { extent, extents[I]... };
+}
+
+/**
+ * @brief Describes containers whose numbers are laid out contiguously in row-major order:
+ *        std::array of numbers, nested std::array of numbers, and std::vector or other
+ *        contiguous resizable containers of either.
+ *
+ * extents holds the length of every dimension, outermost first. The outermost extent of a
+ * resizable container is only known at runtime, so its entry is a placeholder.
+ */
 template<typename T, typename = void>
-struct has_optional_elements_impl : std::false_type {};
+struct contiguous_number_array_traits {
+    static constexpr bool value = false;
+    static constexpr bool is_resizable = false;
+};
 
-template<template<typename, typename> typename Container, typename Alloc, typename U>
-struct has_optional_elements_impl<Container<std::optional<U>, Alloc>,
-                               std::enable_if_t<is_json_serializable_dynamic_array_v<Container<std::optional<U>, Alloc>>>>
-    : std::true_type {};
+template<typename Number, std::size_t N>
+struct contiguous_number_array_traits<std::array<Number, N>, std::enable_if_t<is_json_number_v<Number>>> {
+    static constexpr bool value = true;
+    static constexpr bool is_resizable = false;
+    using number_type = Number;
+    static constexpr std::size_t count = N;
+    static constexpr std::array<std::size_t, 1> extents{ N };
+};
 
-template<template<typename, size_t> typename Array, size_t N, typename U>
-struct has_optional_elements_impl<Array<std::optional<U>, N>,
-                               std::enable_if_t<is_json_serializable_fixed_array_v<Array<std::optional<U>, N>>>>
-    : std::true_type {};
+template<typename Inner, std::size_t N>
+struct contiguous_number_array_traits<std::array<Inner, N>,
+                                      std::enable_if_t<contiguous_number_array_traits<Inner>::value &&
+                                                       !contiguous_number_array_traits<Inner>::is_resizable>> {
+    static constexpr bool value = true;
+    static constexpr bool is_resizable = false;
+    using number_type = typename contiguous_number_array_traits<Inner>::number_type;
+    static constexpr std::size_t count = N * contiguous_number_array_traits<Inner>::count;
+    static_assert(sizeof(Inner) == sizeof(number_type) * contiguous_number_array_traits<Inner>::count,
+                  "Nested std::array must not contain padding to be read in place");
+    static constexpr auto extents = prepend_extent(N, contiguous_number_array_traits<Inner>::extents,
+                                                   std::make_index_sequence<contiguous_number_array_traits<Inner>::extents.size()>{});
+};
+
+// Resizable containers whose data() points to all elements, such as std::vector and static_vector
+template<typename T, typename = void>
+struct is_contiguous_resizable_container : std::false_type {};
+
+template<typename T>
+struct is_contiguous_resizable_container<T, std::void_t<typename T::value_type, decltype(std::declval<T&>().data())>>
+    : std::bool_constant<is_resizable_sequence_container<T>::value &&
+                         std::is_same_v<decltype(std::declval<T&>().data()), typename T::value_type*>> {};
 
 template<typename Container>
-struct has_optional_elements_impl<std::optional<Container>,
-                               std::enable_if_t<has_optional_elements_impl<Container>::value>>
-                               : std::true_type {};
+struct contiguous_number_array_traits<Container,
+                                      std::enable_if_t<is_contiguous_resizable_container<Container>::value &&
+                                                       (is_json_number_v<typename Container::value_type> ||
+                                                        (contiguous_number_array_traits<typename Container::value_type>::value &&
+                                                         !contiguous_number_array_traits<typename Container::value_type>::is_resizable))>> {
+private:
+    using row_traits = contiguous_number_array_traits<std::array<typename Container::value_type, 1>>;
+
+public:
+    static constexpr bool value = true;
+    static constexpr bool is_resizable = true;
+    using number_type = typename row_traits::number_type;
+    static constexpr auto extents = row_traits::extents;
+};
+
+template<typename T>
+constexpr bool is_contiguous_number_array_v = contiguous_number_array_traits<std::remove_const_t<T>>::value;
+
+
+template<typename T, typename = void>
+struct has_optional_elements_impl : std::false_type {};
+
+template<typename Container>
+struct has_optional_elements_impl<Container,
+                               std::enable_if_t<!is_nullable_wrapper_v<Container> &&
+                                                is_json_serializable_sequential_container_v<Container>>>
+    : std::bool_constant<is_nullable_wrapper_v<typename Container::value_type>> {};
+
+template<typename Container>
+struct has_optional_elements_impl<Container, std::enable_if_t<is_nullable_wrapper_v<Container>>>
+    : has_optional_elements_impl<remove_nullable_wrapper_t<Container>> {};
 
 template<typename Container>
 struct has_std_optional_elements :
     has_optional_elements_impl<remove_const_and_reference_t<Container>> {};
 
 
+template<typename T>
+struct is_std_array : std::false_type {};
+
+template<typename Element, std::size_t N>
+struct is_std_array<std::array<Element, N>> : std::true_type {};
+
+template<typename Element, std::size_t N>
+struct is_std_array<columnar<std::array<Element, N>>> : std::true_type {};
+
+template<typename T>
+constexpr bool is_std_array_v = is_std_array<T>::value;
+
+
 template<typename T>
 struct is_std_tuple : std::false_type {};
 
@@ -224,12 +716,7 @@ template<typename First, typename... Remaining >
 struct is_json_serializable_tuple_impl<std::tuple<First, Remaining...>> {
 private:
     static constexpr bool check_first() {
-        if constexpr (is_std_tuple_v<First>) 
-            return is_json_serializable_tuple_impl<First>::value;
-        else 
-            return is_json_serializable_primitive_type_v<First> ||
-                   is_json_serializable_sequential_container_v<First> ||
-                   is_describable_struct_v<First>;
+        return is_json_serializable<First>::value;
     }
 
     static constexpr bool check_remaining() {
@@ -245,7 +732,7 @@ public:
 
 template<typename T>
 struct is_json_serializable_tuple {
-    static constexpr bool value = is_json_serializable_tuple_impl<std::remove_reference_t<remove_std_optional_t<T>>>::value;
+    static constexpr bool value = is_json_serializable_tuple_impl<std::remove_reference_t<remove_nullable_wrapper_t<T>>>::value;
 };
 
 template<typename T>
@@ -253,8 +740,45 @@ constexpr bool is_json_serializable_tuple_v = is_json_serializable_tuple<T>::val
 
 
 template<typename T>
-constexpr bool is_json_serializable_v = is_json_serializable_primitive_type_v<T> || is_json_serializable_sequential_container_v<T>
-                                        || is_json_serializable_tuple_v<T> || is_describable_struct_v<T>;
+struct is_std_reference_wrapper : is_wrapper<std::reference_wrapper, remove_const_and_reference_t<T>> {};
+
+template<typename T>
+constexpr bool is_std_reference_wrapper_v = is_std_reference_wrapper<T>::value;
+
+
+/**
+ * @brief Detects view members, which refer to memory owned elsewhere
+ *
+ * std::string_view, std::span<const T> (C++20) and std::reference_wrapper<const T> are
+ * serialized straight from the referenced memory. They cannot be deserialized into, as
+ * there is nothing they own to store the JSON values in.
+ */
+template<typename T>
+struct is_json_view_impl : std::false_type {};
+
+template<>
+struct is_json_view_impl<std::string_view> : std::true_type {};
+
+template<typename T>
+struct is_json_view_impl<std::reference_wrapper<const T>> : std::bool_constant<is_json_serializable<T>::value> {};
+
+#if defined(__cpp_lib_span)
+template<typename T, std::size_t Extent>
+struct is_json_view_impl<std::span<const T, Extent>> : std::bool_constant<is_json_serializable<T>::value> {};
+#endif
+
+template<typename T>
+constexpr bool is_json_view_v = is_json_view_impl<std::remove_const_t<T>>::value;
+
+
+template<typename T>
+struct is_json_serializable
+    : std::bool_constant<is_json_serializable_primitive_type_v<T> || is_json_inline_string_v<T> || is_json_codec_value_v<T>
+                         || is_json_serializable_sequential_container_v<T> || is_json_serializable_tuple_v<T>
+                         || is_json_serializable_variant_v<T> || is_describable_struct_v<T> || is_json_view_v<T>> {};
+
+template<typename T>
+constexpr bool is_json_serializable_v = is_json_serializable<T>::value;
 
 }  // namespace detail
 }  // namespace rapidjson_util 
@@ -329,4 +853,17 @@ constexpr bool is_json_serializable_v = is_json_serializable_primitive_type_v<T>
 #define RAPIDJSON_UTIL_FOR_EACH_II() RAPIDJSON_UTIL_FOR_EACH_I
 
 
+#define RAPIDJSON_UTIL_IS_PAREN(x) RAPIDJSON_UTIL_IS_PROBE(RAPIDJSON_UTIL_IS_PAREN_PROBE x)
+#define RAPIDJSON_UTIL_IS_PAREN_PROBE(...) RAPIDJSON_UTIL_PROBE
+
+
+// RAPIDJSON_UTIL_FOR_EACH for lists of parenthesized tuples, which RAPIDJSON_UTIL_IS_EMPTY can't test
+#define RAPIDJSON_UTIL_FOR_EACH_TUPLE(F, C, x, ...)   RAPIDJSON_UTIL_EVAL(RAPIDJSON_UTIL_FOR_EACH_TUPLE_I(F, C, x, __VA_ARGS__))
+#define RAPIDJSON_UTIL_FOR_EACH_TUPLE_I(F, C, x, ...) F(C, x)                                                   \
+        RAPIDJSON_UTIL_IF_ELSE(RAPIDJSON_UTIL_NOT(RAPIDJSON_UTIL_IS_PAREN(RAPIDJSON_UTIL_GET_FIRST_ARG(__VA_ARGS__ ,)))) \
+        ( /* Do nothing, just terminate */ )                                                                     \
+        (, RAPIDJSON_UTIL_FOR_EACH_TUPLE_II RAPIDJSON_UTIL_EMPTY () (F, C, __VA_ARGS__))
+#define RAPIDJSON_UTIL_FOR_EACH_TUPLE_II() RAPIDJSON_UTIL_FOR_EACH_TUPLE_I
+
+
 #endif
\ No newline at end of file
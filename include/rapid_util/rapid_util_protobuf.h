@@ -0,0 +1,1185 @@
+// Copyright (C) 2025 Liu Wu. All rights reserved.
+//
+// Licensed under the zlib License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/Zlib
+//
+// This software is provided as-is, without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+
+
+#ifndef __RAPIDJSON_UTIL_PROTOBUF_H__
+#define __RAPIDJSON_UTIL_PROTOBUF_H__
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "rapid_util.h"
+#include "rapid_util_typed_array.h"
+
+
+namespace rapidjson_util {
+
+class InvalidProtobufException : public std::logic_error {
+public:
+    InvalidProtobufException(std::string_view what);
+};
+
+/**
+ * @brief Wire encodings of integer fields, named after the protobuf scalar types they produce
+ */
+enum class ProtobufEncoding {
+    Default,    // int32, int64, uint32, uint64 and bool varints; float and double
+    ZigZag,     // sint32 and sint64, for signed integers that are often negative
+    Fixed       // fixed32, fixed64, sfixed32 and sfixed64, for 32 and 64-bit integers that are often large
+};
+
+/**
+ * @brief Protobuf field numbers and encodings of the members of Struct
+ *
+ * Specialize it with the RAPIDJSON_UTIL_DESCRIBE_PROTOBUF_FIELDS macro. Without a specialization
+ * the members described by RAPIDJSON_UTIL_DESCRIBE_MEMBERS are numbered from 1 in declaration
+ * order, with the default encoding.
+ */
+template<typename Struct>
+struct protobuf_fields {
+    static constexpr bool is_described = false;
+};
+
+
+/**
+ * @brief Serialize a C++ struct to the protobuf wire format
+ *
+ * Fields are numbered by RAPIDJSON_UTIL_DESCRIBE_PROTOBUF_FIELDS and encoded as the protobuf
+ * types they correspond to:
+ *   - bool and integers as varints, or as set by their ProtobufEncoding; 8 and 16-bit integers
+ *     as int32 and uint32
+ *   - float and double as float and double
+ *   - std::string, std::pmr::string and inline strings as string, rapidjson_util::bytes and
+ *     the other binary data types as bytes
+ *   - structs as embedded messages, std::chrono time points as google.protobuf.Timestamp and
+ *     durations as google.protobuf.Duration
+ *   - containers and std::array as repeated fields, packed for numbers
+ *
+ * std::optional and smart pointer members have explicit presence: they are written whenever
+ * they hold a value. Numbers, strings and containers are omitted when zero or empty, as proto3
+ * does. Variants, tuples, views, nested containers and members with a json_codec aren't
+ * supported.
+ *
+ * @param s The struct instance to serialize
+ * @param buffer Receives the encoded bytes, its previous content is discarded but its capacity
+ *               is reused
+ */
+template<typename Struct>
+void marshal_protobuf(const Struct& s, std::vector<uint8_t>& buffer);
+
+/**
+ * @brief Serialize a C++ struct to the protobuf wire format
+ *
+ * @return The encoded bytes
+ */
+template<typename Struct>
+std::vector<uint8_t> marshal_protobuf(const Struct& s);
+
+/**
+ * @brief Deserialize a protobuf message to populate a C++ struct
+ *
+ * Numbered members missing from the message are reset to zero, empty or null, as protobuf
+ * defaults them, and members without a field number are left alone. Unknown fields are
+ * skipped, repeated numbers are accepted packed or not, and embedded messages occurring more
+ * than once are merged, as protobuf parsers do. Nesting is limited to 100 levels.
+ *
+ * @param data The protobuf message
+ * @param size Number of bytes in data
+ * @param s The struct instance to populate
+ * @param resource Memory resource for std::pmr strings and containers, see unmarshal
+ * @throws InvalidProtobufException if data is truncated or malformed
+ */
+template<typename Struct>
+void unmarshal_protobuf(const uint8_t* data, std::size_t size, Struct& s, std::pmr::memory_resource* resource = nullptr);
+
+template<typename Struct>
+void unmarshal_protobuf(const std::vector<uint8_t>& data, Struct& s, std::pmr::memory_resource* resource = nullptr);
+
+
+namespace detail {
+
+enum ProtobufWireType : uint8_t {
+    ProtobufVarint = 0,
+    ProtobufI64 = 1,
+    ProtobufLen = 2,
+    ProtobufStartGroup = 3,
+    ProtobufEndGroup = 4,
+    ProtobufI32 = 5
+};
+
+constexpr uint32_t maxProtobufFieldNumber = (1u << 29) - 1;
+
+enum class ProtobufKind {
+    Number,
+    Chrono,
+    String,
+    Bytes,
+    Message,
+    Repeated,
+    Nullable,
+    Unsupported
+};
+
+template<typename T>
+constexpr bool is_protobuf_message_v = protobuf_fields<T>::is_described || is_describable_struct_v<T>;
+
+template<typename T>
+constexpr ProtobufKind protobufKindOf() {
+    using Type = std::remove_const_t<T>;
+
+    if constexpr (has_json_codec_v<Type>)
+        return ProtobufKind::Unsupported;
+    else if constexpr (is_nullable_wrapper_v<Type>)
+        return ProtobufKind::Nullable;
+    else if constexpr (std::is_arithmetic_v<Type> && is_json_primitive_core_type_v<Type>)
+        return ProtobufKind::Number;
+    else if constexpr (is_json_chrono_v<Type>)
+        return ProtobufKind::Chrono;
+    else if constexpr (std::is_same_v<Type, std::string> || std::is_same_v<Type, std::pmr::string> ||
+                       is_json_inline_string_v<Type>)
+        return ProtobufKind::String;
+    else if constexpr (is_json_binary_v<Type>)
+        return ProtobufKind::Bytes;
+    else if constexpr (is_protobuf_message_v<Type>)
+        return ProtobufKind::Message;
+    else if constexpr (is_std_array_v<Type> || is_resizable_sequence_container<Type>::value)
+        return ProtobufKind::Repeated;
+    else
+        return ProtobufKind::Unsupported;
+}
+
+// The type a repeated or nullable field holds, or T itself
+template<typename T, ProtobufKind = protobufKindOf<T>()>
+struct protobuf_scalar {
+    using type = std::remove_const_t<T>;
+};
+
+template<typename T>
+struct protobuf_scalar<T, ProtobufKind::Nullable> {
+    using type = remove_nullable_wrapper_t<T>;
+};
+
+template<typename T>
+struct protobuf_scalar<T, ProtobufKind::Repeated> {
+    using type = typename std::remove_const_t<T>::value_type;
+};
+
+template<typename T>
+using protobuf_scalar_t = typename protobuf_scalar<T>::type;
+
+template<typename T>
+constexpr bool isProtobufFieldType() {
+    constexpr ProtobufKind kind = protobufKindOf<T>();
+
+    if constexpr (kind == ProtobufKind::Nullable || kind == ProtobufKind::Repeated) {
+        constexpr ProtobufKind scalarKind = protobufKindOf<protobuf_scalar_t<T>>();
+        return scalarKind != ProtobufKind::Nullable && scalarKind != ProtobufKind::Repeated && scalarKind != ProtobufKind::Unsupported;
+    }
+    else
+        return kind != ProtobufKind::Unsupported;
+}
+
+template<typename T>
+constexpr bool isProtobufEncodingOf(ProtobufEncoding encoding) {
+    using Scalar = protobuf_scalar_t<T>;
+
+    if (encoding == ProtobufEncoding::ZigZag)
+        return std::is_integral_v<Scalar> && std::is_signed_v<Scalar>;
+    if (encoding == ProtobufEncoding::Fixed)
+        return std::is_arithmetic_v<Scalar> && !std::is_same_v<Scalar, bool> && (sizeof(Scalar) == 4 || sizeof(Scalar) == 8);
+
+    return true;
+}
+
+template<typename... Fields>
+constexpr bool areValidProtobufFieldNumbers(TypeList<Fields...>) {
+    constexpr uint32_t numbers[] = { Fields::number()..., 0 };
+
+    for (std::size_t i = 0; i < sizeof...(Fields); ++i) {
+        if (numbers[i] == 0 || numbers[i] > maxProtobufFieldNumber || (numbers[i] >= 19000 && numbers[i] <= 19999))
+            return false;
+
+        for (std::size_t j = 0; j < i; ++j)
+            if (numbers[j] == numbers[i])
+                return false;
+    }
+
+    return true;
+}
+
+template<typename... Fields>
+constexpr bool areProtobufFieldTypes(TypeList<Fields...>) {
+    return (isProtobufFieldType<member_type_t<decltype(Fields::pointer())>>() && ...);
+}
+
+template<typename... Fields>
+constexpr bool areProtobufFieldEncodings(TypeList<Fields...>) {
+    return (isProtobufEncodingOf<member_type_t<decltype(Fields::pointer())>>(Fields::encoding()) && ...);
+}
+
+// A member numbered by its position, for structs without RAPIDJSON_UTIL_DESCRIBE_PROTOBUF_FIELDS
+template<typename MemberDescriptor, uint32_t Number>
+struct ProtobufPositionalField {
+    static constexpr auto pointer() noexcept { return MemberDescriptor::pointer(); }
+    static constexpr auto name() noexcept { return MemberDescriptor::name(); }
+    static constexpr uint32_t number() noexcept { return Number; }
+    static constexpr ProtobufEncoding encoding() noexcept { return ProtobufEncoding::Default; }
+};
+
+template<typename... MemberDescriptors, std::size_t... I>
+constexpr auto numberByPosition(TypeList<MemberDescriptors...>, std::index_sequence<I...>) {
+    return TypeList<ProtobufPositionalField<MemberDescriptors, static_cast<uint32_t>(I + 1)>...> {};
+}
+
+template<typename... MemberDescriptors>
+constexpr auto numberByPosition(TypeList<MemberDescriptors...> members) {
+    return numberByPosition(members, std::index_sequence_for<MemberDescriptors...> {});
+}
+
+template<typename Struct>
+constexpr auto protobufFieldsOf() {
+    static_assert(is_protobuf_message_v<Struct>,
+                  "Use the RAPIDJSON_UTIL_DESCRIBE_MEMBERS or RAPIDJSON_UTIL_DESCRIBE_PROTOBUF_FIELDS macro to number struct members");
+
+    if constexpr (protobuf_fields<Struct>::is_described)
+        return protobuf_fields<Struct>::field_descriptors;
+    else
+        return numberByPosition(Descriptor<Struct>::member_descriptors);
+}
+
+template<typename... Fields>
+constexpr std::size_t typeListSize(TypeList<Fields...>) {
+    return sizeof...(Fields);
+}
+
+template<typename Struct>
+using protobuf_field_list_t = decltype(protobufFieldsOf<Struct>());
+
+template<typename Struct>
+constexpr void checkProtobufFields() {
+    static_assert(areProtobufFieldTypes(protobuf_field_list_t<Struct> {}),
+                  "Variants, tuples, views, nested containers, nullable containers and members with a json_codec "
+                  "have no protobuf encoding");
+    static_assert(areProtobufFieldEncodings(protobuf_field_list_t<Struct> {}),
+                  "ZigZag applies to signed integers and Fixed to 32 and 64-bit numbers");
+}
+
+template<typename T>
+constexpr ProtobufWireType protobufWireTypeOf(ProtobufEncoding encoding) {
+    if (std::is_floating_point_v<T> || encoding == ProtobufEncoding::Fixed)
+        return sizeof(T) == 4 ? ProtobufI32 : ProtobufI64;
+
+    return ProtobufVarint;
+}
+
+// Numbers whose packed elements all take sizeof(T) bytes, so that they are copied at once
+template<typename T, ProtobufEncoding Encoding>
+constexpr bool is_protobuf_fixed_width_v = is_json_number_v<T> && protobufWireTypeOf<T>(Encoding) != ProtobufVarint;
+
+template<typename T, typename = void>
+struct has_emplace_back : std::false_type {};
+
+template<typename T>
+struct has_emplace_back<T, std::void_t<decltype(std::declval<T&>().emplace_back())>> : std::true_type {};
+
+inline const char* protobufWireTypeName(uint64_t wireType) {
+    constexpr const char* names[] = { "VARINT", "I64", "LEN", "SGROUP", "EGROUP", "I32", "6", "7" };
+    return names[wireType & 7];
+}
+
+
+/**
+ * @brief Writes described structs in the protobuf wire format
+ *
+ * Embedded messages and packed varints are written before their length is known: a single
+ * byte is reserved for it, and the content is moved forward in the rare case it takes 128
+ * bytes or more.
+ */
+class ProtobufWriter {
+public:
+    explicit ProtobufWriter(std::vector<uint8_t>& buffer);
+
+    template<typename Struct>
+    void writeMessage(const Struct& s);
+
+private:
+    template<typename Field, typename T>
+    void writeField(const T& value, bool hasPresence);
+
+    template<typename Number, ProtobufEncoding Encoding>
+    void writeNumber(Number number);
+
+    template<typename Field, typename Sequence>
+    void writePacked(const Sequence& numbers);
+
+    template<typename Chrono>
+    void writeChrono(const Chrono& value);
+
+    void writeVarint(uint64_t value);
+    void writeTag(uint32_t number, ProtobufWireType wireType);
+    void writeBytes(const void* data, std::size_t length);
+
+    std::size_t beginLengthDelimited();
+    void endLengthDelimited(std::size_t start);
+
+    std::vector<uint8_t>& buffer;
+};
+
+
+/**
+ * @brief Reads protobuf messages into described structs
+ *
+ * Every read is bounded by the end of the innermost length-delimited field, so that lengths
+ * can't make it read past the data, nor allocate more than the data could hold.
+ */
+class ProtobufReader {
+public:
+    ProtobufReader(const uint8_t* data, std::size_t size, std::pmr::memory_resource* resource = nullptr);
+
+    template<typename Struct>
+    void readFromProtobuf(Struct& s);
+
+    static constexpr std::size_t maxNestingDepth = 100;
+
+private:
+    template<typename Struct>
+    void readMessage(Struct& s);
+
+    template<typename Field, typename T>
+    void readField(ProtobufWireType wireType, T& value, std::size_t& filled);
+
+    template<typename Number, ProtobufEncoding Encoding>
+    Number readNumber();
+
+    template<typename Field, typename Sequence>
+    void readPacked(Sequence& numbers, std::size_t& filled);
+
+    template<typename Chrono>
+    Chrono readChrono();
+
+    template<typename String>
+    void readString(String& value);
+
+    template<typename Sequence>
+    auto& appendElement(Sequence& sequence, std::size_t& filled);
+
+    template<typename Sequence, typename Value>
+    void appendValue(Sequence& sequence, const Value& value, std::size_t& filled);
+
+    template<typename Sequence>
+    void checkAppendable(Sequence& sequence, std::size_t count);
+
+    template<typename T>
+    void resetField(T& value);
+
+    template<typename Struct>
+    void resetMessage(Struct& s);
+
+    uint64_t readVarint();
+    std::size_t readLength();
+    void readFixed(void* value, std::size_t size);
+    void expectWireType(ProtobufWireType wireType, ProtobufWireType expected);
+    void skipField(uint64_t number, ProtobufWireType wireType);
+    void enterNesting();
+    void leaveNesting();
+
+    std::size_t offset() const { return static_cast<std::size_t>(cursor - begin); }
+    InvalidProtobufException truncated() const;
+
+    const uint8_t* begin;
+    const uint8_t* cursor;
+    const uint8_t* limit;
+    std::pmr::memory_resource* resource;
+    std::size_t depth = 0;
+};
+
+
+inline ProtobufWriter::ProtobufWriter(std::vector<uint8_t>& _buffer) : buffer(_buffer) {
+}
+
+inline void ProtobufWriter::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+
+    buffer.push_back(static_cast<uint8_t>(value));
+}
+
+inline void ProtobufWriter::writeTag(uint32_t number, ProtobufWireType wireType) {
+    writeVarint((static_cast<uint64_t>(number) << 3) | wireType);
+}
+
+inline void ProtobufWriter::writeBytes(const void* data, std::size_t length) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + length);
+}
+
+inline std::size_t ProtobufWriter::beginLengthDelimited() {
+    buffer.push_back(0);
+    return buffer.size();
+}
+
+inline void ProtobufWriter::endLengthDelimited(std::size_t start) {
+    const std::size_t length = buffer.size() - start;
+
+    if (length < 0x80) {
+        buffer[start - 1] = static_cast<uint8_t>(length);
+        return;
+    }
+
+    uint8_t varint[10];
+    std::size_t varintSize = 0;
+    for (uint64_t value = length; value != 0; value >>= 7)
+        varint[varintSize++] = static_cast<uint8_t>(value | 0x80);
+    varint[varintSize - 1] &= 0x7f;
+
+    buffer.insert(buffer.begin() + static_cast<std::ptrdiff_t>(start), varintSize - 1, 0);
+    std::memcpy(buffer.data() + start - 1, varint, varintSize);
+}
+
+template<typename Struct>
+void ProtobufWriter::writeMessage(const Struct& s) {
+    checkProtobufFields<Struct>();
+
+    for_each(protobufFieldsOf<Struct>(), [this, &s](auto field) {
+                 using Field = decltype(field);
+                 writeField<Field>(s.*(Field::pointer()), false);
+             });
+}
+
+template<typename Number, ProtobufEncoding Encoding>
+void ProtobufWriter::writeNumber(Number number) {
+    if constexpr (protobufWireTypeOf<Number>(Encoding) != ProtobufVarint) {
+        uint8_t bytes[sizeof(Number)];
+        copyLittleEndian<Number>(&number, bytes, 1);
+        writeBytes(bytes, sizeof(Number));
+    }
+    else if constexpr (std::is_same_v<Number, bool>)
+        writeVarint(number ? 1 : 0);
+    else if constexpr (Encoding == ProtobufEncoding::ZigZag) {
+        if constexpr (sizeof(Number) <= 4) {
+            const auto value = static_cast<int32_t>(number);
+            writeVarint((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+        }
+        else {
+            const auto value = static_cast<int64_t>(number);
+            writeVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+    }
+    else if constexpr (std::is_signed_v<Number>)
+        writeVarint(static_cast<uint64_t>(static_cast<int64_t>(number)));   // Negative int32 take 10 bytes, as in protobuf
+    else
+        writeVarint(number);
+}
+
+template<typename Chrono>
+void ProtobufWriter::writeChrono(const Chrono& value) {
+    using Duration = typename chrono_duration_of<Chrono>::type;
+    constexpr bool isTimePoint = is_chrono_time_point_v<Chrono>;
+
+    Duration duration;
+    if constexpr (isTimePoint)
+        duration = value.time_since_epoch();
+    else
+        duration = value;
+
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(duration);
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(duration - seconds);
+
+    // Timestamp nanos are never negative, Duration nanos have the sign of the seconds
+    if (isTimePoint && nanos.count() < 0) {
+        seconds -= std::chrono::seconds(1);
+        nanos += std::chrono::seconds(1);
+    }
+
+    if (seconds.count() != 0) {
+        writeTag(1, ProtobufVarint);
+        writeNumber<int64_t, ProtobufEncoding::Default>(seconds.count());
+    }
+
+    if (nanos.count() != 0) {
+        writeTag(2, ProtobufVarint);
+        writeNumber<int32_t, ProtobufEncoding::Default>(static_cast<int32_t>(nanos.count()));
+    }
+}
+
+template<typename Field, typename Sequence>
+void ProtobufWriter::writePacked(const Sequence& numbers) {
+    using Number = typename Sequence::value_type;
+    constexpr ProtobufEncoding encoding = Field::encoding();
+
+    writeTag(Field::number(), ProtobufLen);
+
+    if constexpr (is_protobuf_fixed_width_v<Number, encoding> &&
+                  (is_std_array_v<Sequence> || is_contiguous_resizable_container<Sequence>::value)) {
+        const std::size_t length = numbers.size() * sizeof(Number);
+        writeVarint(length);
+
+        const std::size_t start = buffer.size();
+        buffer.resize(start + length);
+        copyLittleEndian<Number>(numbers.data(), buffer.data() + start, numbers.size());
+    }
+    else {
+        const std::size_t start = beginLengthDelimited();
+        for (Number number : numbers)
+            writeNumber<Number, encoding>(number);
+        endLengthDelimited(start);
+    }
+}
+
+template<typename Field, typename T>
+void ProtobufWriter::writeField(const T& value, bool hasPresence) {
+    constexpr ProtobufKind kind = protobufKindOf<T>();
+
+    if constexpr (kind == ProtobufKind::Number) {
+        if (!hasPresence) {
+            if constexpr (std::is_floating_point_v<T>) {
+                if (value == 0 && !std::signbit(value))
+                    return;
+            }
+            else if (value == 0)
+                return;
+        }
+
+        writeTag(Field::number(), protobufWireTypeOf<T>(Field::encoding()));
+        writeNumber<T, Field::encoding()>(value);
+    }
+    else if constexpr (kind == ProtobufKind::Chrono) {
+        writeTag(Field::number(), ProtobufLen);
+
+        const std::size_t start = beginLengthDelimited();
+        writeChrono(value);
+        endLengthDelimited(start);
+    }
+    else if constexpr (kind == ProtobufKind::String) {
+        std::string_view str;
+        if constexpr (is_json_inline_string_v<T>)
+            str = inline_string_traits<T>::view(&value);
+        else
+            str = value;
+
+        if (!hasPresence && str.empty())
+            return;
+
+        writeTag(Field::number(), ProtobufLen);
+        writeVarint(str.length());
+        writeBytes(str.data(), str.length());
+    }
+    else if constexpr (kind == ProtobufKind::Bytes) {
+        if (!hasPresence && value.empty())
+            return;
+
+        writeTag(Field::number(), ProtobufLen);
+        writeVarint(value.size());
+        writeBytes(value.data(), value.size());
+    }
+    else if constexpr (kind == ProtobufKind::Message) {
+        writeTag(Field::number(), ProtobufLen);
+
+        const std::size_t start = beginLengthDelimited();
+        writeMessage(value);
+        endLengthDelimited(start);
+    }
+    else if constexpr (kind == ProtobufKind::Repeated) {
+        using Element = typename T::value_type;
+
+        if (value.size() == 0)
+            return;
+
+        if constexpr (protobufKindOf<Element>() == ProtobufKind::Number)
+            writePacked<Field>(value);
+        else
+            for (const Element& element : value)
+                writeField<Field, Element>(element, true);
+    }
+    else {
+        if (hasReferencedValue(value))
+            writeField<Field>(*value, true);
+    }
+}
+
+
+inline ProtobufReader::ProtobufReader(const uint8_t* data, std::size_t size, std::pmr::memory_resource* _resource) :
+    begin(data), cursor(data), limit(data + size), resource(_resource) {
+}
+
+inline InvalidProtobufException ProtobufReader::truncated() const {
+    return InvalidProtobufException("Protobuf data is truncated at offset " + std::to_string(offset()));
+}
+
+inline uint64_t ProtobufReader::readVarint() {
+    const std::size_t start = offset();
+    uint64_t value = 0;
+
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (cursor == limit)
+            throw truncated();
+
+        const uint8_t byte = *cursor++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+        if ((byte & 0x80) == 0)
+            return value;
+    }
+
+    throw InvalidProtobufException("Varint at offset " + std::to_string(start) + " is longer than 10 bytes");
+}
+
+inline std::size_t ProtobufReader::readLength() {
+    const std::size_t start = offset();
+    const uint64_t length = readVarint();
+
+    if (length > static_cast<uint64_t>(limit - cursor))
+        throw InvalidProtobufException("Length " + std::to_string(length) + " at offset " + std::to_string(start) +
+                                       " exceeds the data");
+
+    return static_cast<std::size_t>(length);
+}
+
+inline void ProtobufReader::readFixed(void* value, std::size_t size) {
+    if (static_cast<std::size_t>(limit - cursor) < size)
+        throw truncated();
+
+    std::memcpy(value, cursor, size);
+    cursor += size;
+}
+
+inline void ProtobufReader::expectWireType(ProtobufWireType wireType, ProtobufWireType expected) {
+    if (wireType != expected)
+        throw InvalidProtobufException(std::string("Expected wire type ") + protobufWireTypeName(expected) + ", got " +
+                                       protobufWireTypeName(wireType));
+}
+
+inline void ProtobufReader::enterNesting() {
+    if (++depth > maxNestingDepth)
+        throw InvalidProtobufException("Protobuf data nests deeper than " + std::to_string(maxNestingDepth) +
+                                       " levels at offset " + std::to_string(offset()));
+}
+
+inline void ProtobufReader::leaveNesting() {
+    --depth;
+}
+
+inline void ProtobufReader::skipField(uint64_t number, ProtobufWireType wireType) {
+    uint8_t fixed[8];
+
+    switch (wireType) {
+        case ProtobufVarint:
+            readVarint();
+            break;
+
+        case ProtobufI64:
+            readFixed(fixed, 8);
+            break;
+
+        case ProtobufI32:
+            readFixed(fixed, 4);
+            break;
+
+        case ProtobufLen:
+            cursor += readLength();
+            break;
+
+        case ProtobufStartGroup:
+            enterNesting();
+            for (;;) {
+                const uint64_t tag = readVarint();
+                const auto innerWireType = static_cast<ProtobufWireType>(tag & 7);
+
+                if (innerWireType == ProtobufEndGroup) {
+                    if ((tag >> 3) != number)
+                        throw InvalidProtobufException("Group " + std::to_string(number) + " ends with field " +
+                                                       std::to_string(tag >> 3) + " at offset " + std::to_string(offset()));
+                    break;
+                }
+
+                skipField(tag >> 3, innerWireType);
+            }
+            leaveNesting();
+            break;
+
+        default:
+            throw InvalidProtobufException(std::string("Unexpected wire type ") + protobufWireTypeName(wireType) +
+                                           " of field " + std::to_string(number) + " at offset " + std::to_string(offset()));
+    }
+}
+
+template<typename Number, ProtobufEncoding Encoding>
+Number ProtobufReader::readNumber() {
+    if constexpr (protobufWireTypeOf<Number>(Encoding) != ProtobufVarint) {
+        uint8_t bytes[sizeof(Number)];
+        readFixed(bytes, sizeof(Number));
+
+        Number number;
+        copyLittleEndian<Number>(bytes, &number, 1);
+        return number;
+    }
+    else if constexpr (std::is_same_v<Number, bool>)
+        return readVarint() != 0;
+    else {
+        // Varints of 32-bit fields are truncated to their low 32 bits, as protobuf parsers do
+        using Wide = std::conditional_t<sizeof(Number) <= 4, std::conditional_t<std::is_signed_v<Number>, int32_t, uint32_t>,
+                                                             std::conditional_t<std::is_signed_v<Number>, int64_t, uint64_t>>;
+        using Bits = std::make_unsigned_t<Wide>;
+
+        const auto bits = static_cast<Bits>(readVarint());
+
+        Wide value;
+        if constexpr (Encoding == ProtobufEncoding::ZigZag)
+            value = static_cast<Wide>((bits >> 1) ^ (Bits(0) - (bits & 1)));
+        else
+            value = static_cast<Wide>(bits);
+
+        if (value < std::numeric_limits<Number>::min() || value > std::numeric_limits<Number>::max())
+            throw InvalidProtobufException("Value " + std::to_string(value) + " is out of range for " + numberTypeName<Number>());
+
+        return static_cast<Number>(value);
+    }
+}
+
+/**
+ * Converts google.protobuf.Duration seconds and nanoseconds to a std::chrono::duration, which
+ * must be able to hold them
+ */
+template<typename Duration>
+Duration protobufDurationOf(int64_t seconds, int32_t nanos) {
+    using Rep = typename Duration::rep;
+    using Period = typename Duration::period;
+
+    if constexpr (std::is_floating_point_v<Rep>)
+        return std::chrono::duration_cast<Duration>(std::chrono::duration<long double>(seconds + nanos / 1e9L));
+    else {
+        // Whole seconds strictly between these fit Rep, whatever the nanoseconds add
+        constexpr intmax_t maxRep = static_cast<intmax_t>(std::min<uintmax_t>(std::numeric_limits<Rep>::max(), INTMAX_MAX));
+        constexpr intmax_t minRep = static_cast<intmax_t>(std::numeric_limits<Rep>::min());
+        constexpr intmax_t maxSeconds = maxRep / Period::den > INTMAX_MAX / Period::num ? INTMAX_MAX : maxRep / Period::den * Period::num;
+        constexpr intmax_t minSeconds = minRep / Period::den < INTMAX_MIN / Period::num ? INTMAX_MIN : minRep / Period::den * Period::num;
+
+        const bool isInRange = std::is_unsigned_v<Rep> ? seconds >= 0 && nanos >= 0 && seconds < maxSeconds
+                                                       : seconds > minSeconds && seconds < maxSeconds;
+        if (!isInRange)
+            throw InvalidProtobufException("Time of " + std::to_string(seconds) + " seconds and " + std::to_string(nanos) +
+                                           " nanoseconds doesn't fit the member type");
+
+        return std::chrono::duration_cast<Duration>(std::chrono::seconds(seconds)) +
+               std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(nanos));
+    }
+}
+
+template<typename Chrono>
+Chrono ProtobufReader::readChrono() {
+    using Duration = typename chrono_duration_of<Chrono>::type;
+    constexpr bool isTimePoint = is_chrono_time_point_v<Chrono>;
+
+    const std::size_t length = readLength();
+    const uint8_t* outerLimit = limit;
+    limit = cursor + length;
+
+    int64_t seconds = 0;
+    int32_t nanos = 0;
+
+    while (cursor < limit) {
+        const uint64_t tag = readVarint();
+        const auto wireType = static_cast<ProtobufWireType>(tag & 7);
+
+        if (tag >> 3 == 1 && wireType == ProtobufVarint)
+            seconds = readNumber<int64_t, ProtobufEncoding::Default>();
+        else if (tag >> 3 == 2 && wireType == ProtobufVarint)
+            nanos = readNumber<int32_t, ProtobufEncoding::Default>();
+        else
+            skipField(tag >> 3, wireType);
+    }
+
+    limit = outerLimit;
+
+    if (nanos <= -1000000000 || nanos >= 1000000000 || (isTimePoint && nanos < 0))
+        throw InvalidProtobufException("Nanoseconds " + std::to_string(nanos) + " out of range");
+
+    if constexpr (isTimePoint)
+        return Chrono(protobufDurationOf<Duration>(seconds, nanos));
+    else
+        return protobufDurationOf<Duration>(seconds, nanos);
+}
+
+template<typename String>
+void ProtobufReader::readString(String& value) {
+    const std::size_t length = readLength();
+    const std::string_view str(reinterpret_cast<const char*>(cursor), length);
+
+    if constexpr (is_json_inline_string_v<String>) {
+        if (length > inline_string_traits<String>::capacity)
+            throw StringLengthExceededException("String length mismatch: protobuf data contains " + std::to_string(length) +
+                                                " characters, but given string has fixed capacity of " +
+                                                std::to_string(inline_string_traits<String>::capacity) + " characters.");
+
+        inline_string_traits<String>::assign(&value, str);
+    }
+    else {
+        if constexpr (uses_polymorphic_allocator_v<String>)
+            rebindMemoryResource(value, resource);
+
+        value.assign(str.data(), str.length());
+    }
+
+    cursor += length;
+}
+
+template<typename Sequence>
+void ProtobufReader::checkAppendable(Sequence& sequence, std::size_t count) {
+    if (count > sequence.max_size() - sequence.size())
+        throw capacityExceeded(sequence.size() + count, sequence.max_size());
+
+    // Containers are re-seated on the memory resource before their first element, as they are cleared first
+    if constexpr (uses_polymorphic_allocator_v<Sequence>)
+        if (sequence.size() == 0)
+            rebindMemoryResource(sequence, resource);
+}
+
+template<typename Sequence>
+auto& ProtobufReader::appendElement(Sequence& sequence, std::size_t& filled) {
+    if constexpr (is_std_array_v<Sequence>) {
+        if (filled == sequence.size())
+            throw fixedCapacityMismatch(filled + 1, sequence.size());
+
+        return sequence[filled++];
+    }
+    else {
+        checkAppendable(sequence, 1);
+
+        if constexpr (has_emplace_back<Sequence>::value)
+            return sequence.emplace_back();
+        else {
+            resizeSequence(sequence, sequence.size() + 1, resource);
+            return *std::next(sequence.begin(), static_cast<std::ptrdiff_t>(sequence.size() - 1));
+        }
+    }
+}
+
+// Unlike appendElement, also appends to std::vector<bool>, whose elements are proxies
+template<typename Sequence, typename Value>
+void ProtobufReader::appendValue(Sequence& sequence, const Value& value, std::size_t& filled) {
+    if constexpr (is_std_array_v<Sequence>)
+        appendElement(sequence, filled) = value;
+    else {
+        checkAppendable(sequence, 1);
+
+        if constexpr (has_emplace_back<Sequence>::value)
+            sequence.emplace_back(value);
+        else {
+            resizeSequence(sequence, sequence.size() + 1, resource);
+            *std::next(sequence.begin(), static_cast<std::ptrdiff_t>(sequence.size() - 1)) = value;
+        }
+    }
+}
+
+template<typename Field, typename Sequence>
+void ProtobufReader::readPacked(Sequence& numbers, std::size_t& filled) {
+    using Number = typename Sequence::value_type;
+    constexpr ProtobufEncoding encoding = Field::encoding();
+
+    const std::size_t length = readLength();
+
+    if constexpr (is_protobuf_fixed_width_v<Number, encoding> &&
+                  (is_std_array_v<Sequence> || is_contiguous_resizable_container<Sequence>::value)) {
+        if (length % sizeof(Number) != 0)
+            throw InvalidProtobufException("Packed field of " + std::to_string(length) + " bytes doesn't hold whole " +
+                                           numberTypeName<Number>() + " elements");
+
+        const std::size_t count = length / sizeof(Number);
+        std::size_t start = filled;
+
+        if constexpr (is_std_array_v<Sequence>) {
+            if (count > numbers.size() - filled)
+                throw fixedCapacityMismatch(filled + count, numbers.size());
+            filled += count;
+        }
+        else {
+            checkAppendable(numbers, count);
+            start = numbers.size();
+            resizeSequence(numbers, start + count, resource);
+        }
+
+        copyLittleEndian<Number>(cursor, numbers.data() + start, count);
+        cursor += length;
+    }
+    else {
+        const uint8_t* outerLimit = limit;
+        limit = cursor + length;
+
+        while (cursor < limit)
+            appendValue(numbers, readNumber<Number, encoding>(), filled);
+
+        limit = outerLimit;
+    }
+}
+
+template<typename Field, typename T>
+void ProtobufReader::readField(ProtobufWireType wireType, T& value, std::size_t& filled) {
+    constexpr ProtobufKind kind = protobufKindOf<T>();
+
+    if constexpr (kind == ProtobufKind::Number) {
+        expectWireType(wireType, protobufWireTypeOf<T>(Field::encoding()));
+        value = readNumber<T, Field::encoding()>();
+    }
+    else if constexpr (kind == ProtobufKind::Chrono) {
+        expectWireType(wireType, ProtobufLen);
+        value = readChrono<T>();
+    }
+    else if constexpr (kind == ProtobufKind::String) {
+        expectWireType(wireType, ProtobufLen);
+        readString(value);
+    }
+    else if constexpr (kind == ProtobufKind::Bytes) {
+        expectWireType(wireType, ProtobufLen);
+
+        const std::size_t length = readLength();
+        if (length > value.max_size())
+            throw capacityExceeded(length, value.max_size());
+
+        resizeSequence(value, length, resource);
+        if (length != 0)
+            std::memcpy(value.data(), cursor, length);
+        cursor += length;
+    }
+    else if constexpr (kind == ProtobufKind::Message) {
+        expectWireType(wireType, ProtobufLen);
+
+        const std::size_t length = readLength();
+        const uint8_t* outerLimit = limit;
+        limit = cursor + length;
+
+        enterNesting();
+        readMessage(value);
+        leaveNesting();
+
+        limit = outerLimit;
+    }
+    else if constexpr (kind == ProtobufKind::Repeated) {
+        using Element = typename T::value_type;
+        constexpr ProtobufKind elementKind = protobufKindOf<Element>();
+
+        std::size_t unused = 0;
+
+        if constexpr (elementKind == ProtobufKind::Number || elementKind == ProtobufKind::Chrono) {
+            if constexpr (elementKind == ProtobufKind::Number)
+                if (wireType == ProtobufLen)
+                    return readPacked<Field>(value, filled);
+
+            Element element {};
+            readField<Field>(wireType, element, unused);
+            appendValue(value, element, filled);
+        }
+        else {
+            auto& element = appendElement(value, filled);
+            resetField(element);
+            readField<Field>(wireType, element, unused);
+        }
+    }
+    else {
+        if (!hasReferencedValue(value))
+            resetField(emplaceReferencedValue(value));
+
+        readField<Field>(wireType, *value, filled);
+    }
+}
+
+template<typename T>
+void ProtobufReader::resetField(T& value) {
+    constexpr ProtobufKind kind = protobufKindOf<T>();
+
+    if constexpr (kind == ProtobufKind::Number || kind == ProtobufKind::Chrono)
+        value = T {};
+    else if constexpr (kind == ProtobufKind::String && is_json_inline_string_v<T>)
+        inline_string_traits<T>::assign(&value, std::string_view("", 0));
+    else if constexpr (kind == ProtobufKind::String || kind == ProtobufKind::Bytes)
+        value.clear();
+    else if constexpr (kind == ProtobufKind::Message)
+        resetMessage(value);
+    else if constexpr (kind == ProtobufKind::Repeated) {
+        if constexpr (is_std_array_v<T>)
+            for (auto& element : value)
+                resetField(element);
+        else
+            value.resize(0);
+    }
+    else
+        value.reset();
+}
+
+// Protobuf defaults missing fields to zero, which default member initializers may not
+template<typename Struct>
+void ProtobufReader::resetMessage(Struct& s) {
+    for_each(protobufFieldsOf<Struct>(), [this, &s](auto field) {
+                 resetField(s.*(decltype(field)::pointer()));
+             });
+}
+
+template<typename Struct>
+void ProtobufReader::readMessage(Struct& s) {
+    checkProtobufFields<Struct>();
+
+    constexpr auto fields = protobufFieldsOf<Struct>();
+    std::array<std::size_t, typeListSize(fields)> filled {};
+
+    while (cursor < limit) {
+        const uint64_t tag = readVarint();
+        const uint64_t number = tag >> 3;
+        const auto wireType = static_cast<ProtobufWireType>(tag & 7);
+
+        if (number == 0 || number > maxProtobufFieldNumber)
+            throw InvalidProtobufException("Invalid field number " + std::to_string(number) + " at offset " + std::to_string(offset()));
+
+        bool isKnown = false;
+        std::size_t index = 0;
+
+        for_each(fields, [this, &s, &filled, &isKnown, &index, number, wireType](auto field) {
+                     using Field = decltype(field);
+
+                     if (!isKnown && Field::number() == number) {
+                         isKnown = true;
+
+                         try {
+                             readField<Field>(wireType, s.*(Field::pointer()), filled[index]);
+                         }
+                         catch (std::logic_error& e) {
+                             throw MemberSerializationFailure(std::string("Deserialization of member \"") +
+                                 Field::name() + "\" failed: " + e.what());
+                         }
+                     }
+
+                     ++index;
+                 });
+
+        if (!isKnown)
+            skipField(number, wireType);
+    }
+
+    // std::array fields must be given all of their elements, or none to stay zero
+    std::size_t index = 0;
+    for_each(fields, [&s, &filled, &index](auto field) {
+                 using Field = decltype(field);
+                 using Member = member_type_t<decltype(Field::pointer())>;
+
+                 if constexpr (is_std_array_v<Member> && protobufKindOf<Member>() == ProtobufKind::Repeated) {
+                     if (filled[index] != 0 && filled[index] != std::tuple_size_v<Member>)
+                         throw MemberSerializationFailure(std::string("Deserialization of member \"") + Field::name() +
+                             "\" failed: " + fixedCapacityMismatch(filled[index], std::tuple_size_v<Member>).what());
+                 }
+
+                 ++index;
+             });
+}
+
+template<typename Struct>
+void ProtobufReader::readFromProtobuf(Struct& s) {
+    resetMessage(s);
+    readMessage(s);
+}
+
+
+template<typename Struct>
+void marshalProtobufImpl(const Struct& s, std::vector<uint8_t>& buffer) {
+    buffer.clear();
+
+    ProtobufWriter writer(buffer);
+    writer.writeMessage(s);
+}
+
+template<typename Struct>
+void unmarshalProtobufImpl(const uint8_t* data, std::size_t size, Struct& s, std::pmr::memory_resource* resource) {
+    ProtobufReader reader(data, size, resource);
+    reader.readFromProtobuf(s);
+}
+
+}  // namespace detail
+
+
+template<typename Struct>
+void marshal_protobuf(const Struct& s, std::vector<uint8_t>& buffer) {
+    detail::marshalProtobufImpl(s, buffer);
+}
+
+template<typename Struct>
+std::vector<uint8_t> marshal_protobuf(const Struct& s) {
+    std::vector<uint8_t> buffer;
+    detail::marshalProtobufImpl(s, buffer);
+
+    return buffer;
+}
+
+template<typename Struct>
+void unmarshal_protobuf(const uint8_t* data, std::size_t size, Struct& s, std::pmr::memory_resource* resource) {
+    detail::unmarshalProtobufImpl(data, size, s, resource);
+}
+
+template<typename Struct>
+void unmarshal_protobuf(const std::vector<uint8_t>& data, Struct& s, std::pmr::memory_resource* resource) {
+    detail::unmarshalProtobufImpl(data.data(), data.size(), s, resource);
+}
+
+inline InvalidProtobufException::InvalidProtobufException(std::string_view what) :
+    std::logic_error(what.data()) {
+}
+
+}  // namespace rapidjson_util
+
+
+/**
+ * Numbers the protobuf fields of the members of struct C, which are listed as (member, number)
+ * or (member, number, encoding) with encoding one of the ProtobufEncoding values, e.g.
+ *
+ * RAPIDJSON_UTIL_DESCRIBE_PROTOBUF_FIELDS(Trade, (id, 1), (price, 2), (delta, 3, ZigZag))
+ *
+ * Members left out aren't part of the protobuf message. Nested structs need field numbers of
+ * their own, from this macro or from RAPIDJSON_UTIL_DESCRIBE_MEMBERS.
+ */
+#define RAPIDJSON_UTIL_DESCRIBE_PROTOBUF_FIELDS(C, ...)                                                       \
+        static_assert(std::is_class_v<C>);                                                                    \
+        template<> struct rapidjson_util::protobuf_fields<C> {                                                \
+            static constexpr bool is_described = true;                                                        \
+            static constexpr auto field_descriptors = rapidjson_util::detail::make_typelist(                  \
+                       RAPIDJSON_UTIL_FOR_EACH_TUPLE(RAPIDJSON_UTIL_PROTOBUF_FIELD_META, C, __VA_ARGS__));    \
+        };                                                                                                    \
+        static_assert(rapidjson_util::detail::areValidProtobufFieldNumbers(                                   \
+                          rapidjson_util::protobuf_fields<C>::field_descriptors),                             \
+                      "Protobuf field numbers must be unique, from 1 to 536870911 and outside 19000 to 19999");
+
+
+#define RAPIDJSON_UTIL_PROTOBUF_FIELD_META(C, field) \
+        RAPIDJSON_UTIL_PROTOBUF_FIELD_APPLY(RAPIDJSON_UTIL_PROTOBUF_FIELD_META_I, (C, RAPIDJSON_UTIL_UNPACK field))
+
+#define RAPIDJSON_UTIL_PROTOBUF_FIELD_APPLY(macro, arguments) macro arguments
+
+#define RAPIDJSON_UTIL_PROTOBUF_FIELD_META_I(C, member, fieldNumber, ...)                                    \
+	[]{ struct rapidjsonUtilField {                                                                           \
+             static constexpr auto pointer() noexcept { return &C::member; }                                  \
+             static constexpr auto name() noexcept { return RAPIDJSON_UTIL_STRINGIFY(member); }               \
+             static constexpr uint32_t number() noexcept { return fieldNumber; }                              \
+             static constexpr rapidjson_util::ProtobufEncoding encoding() noexcept {                          \
+                 return rapidjson_util::ProtobufEncoding::                                                    \
+                     RAPIDJSON_UTIL_IF_ELSE(RAPIDJSON_UTIL_IS_EMPTY(__VA_ARGS__))(Default)(__VA_ARGS__);      \
+             }                                                                                                \
+    }; return rapidjsonUtilField{}; }  ()
+
+#endif
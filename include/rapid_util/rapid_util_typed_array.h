@@ -0,0 +1,127 @@
+// Copyright (C) 2025 Liu Wu. All rights reserved.
+//
+// Licensed under the zlib License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/Zlib
+//
+// This software is provided as-is, without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+
+
+#ifndef __RAPIDJSON_UTIL_TYPED_ARRAY_H__
+#define __RAPIDJSON_UTIL_TYPED_ARRAY_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "rapid_util_parser.h"
+
+#if defined(_WIN32) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define RAPIDJSON_UTIL_LITTLE_ENDIAN 1
+#else
+#define RAPIDJSON_UTIL_LITTLE_ENDIAN 0
+#endif
+
+
+namespace rapidjson_util {
+namespace detail {
+
+/**
+ * @return The RFC 8746 tag of little-endian typed arrays of Number
+ */
+template<typename Number>
+constexpr uint8_t typedArrayTag() {
+    static_assert(sizeof(int) == 4, "int members are encoded as 32-bit integers");
+
+    if constexpr (std::is_integral_v<Number> && !std::is_same_v<Number, fixed_width_integer_t<Number>>)
+        return typedArrayTag<fixed_width_integer_t<Number>>();
+    else if constexpr (std::is_same_v<Number, uint8_t>)  return 64;
+    else if constexpr (std::is_same_v<Number, uint16_t>) return 69;
+    else if constexpr (std::is_same_v<Number, uint32_t>) return 70;
+    else if constexpr (std::is_same_v<Number, uint64_t>) return 71;
+    else if constexpr (std::is_same_v<Number, int8_t>)   return 72;
+    else if constexpr (std::is_same_v<Number, int16_t>)  return 77;
+    else if constexpr (std::is_same_v<Number, int>)      return 78;
+    else if constexpr (std::is_same_v<Number, int64_t>)  return 79;
+    else if constexpr (std::is_same_v<Number, float>)    return 85;
+    else if constexpr (std::is_same_v<Number, double>)   return 86;
+    else static_assert(false, "Unsupported number type");
+}
+
+/**
+ * @brief Checks whether an RFC 8746 tag denotes a typed array of Number in either byte order
+ *
+ * The tag bits are 0b010fsell: f is set for floats, s for signed integers, e for little-endian
+ * and ll is the log2 of the element size, counted from 16 bits for floats. Clamped uint8 arrays
+ * are accepted as uint8 ones, as they hold the same bytes.
+ *
+ * @param tag The tag to check
+ * @param isLittleEndian Set to the byte order of the elements if the tag matches
+ */
+template<typename Number>
+constexpr bool isTypedArrayOf(uint64_t tag, bool& isLittleEndian) {
+    if (tag < 64 || tag > 87)
+        return false;
+
+    const bool isFloat = (tag & 0x10) != 0;
+    const bool isSigned = (tag & 0x08) != 0;
+    const std::size_t size = (isFloat ? 2 : 1) << (tag & 0x03);
+
+    if (isFloat ? !std::is_floating_point_v<Number> || isSigned
+                : !std::is_integral_v<Number> || isSigned != std::is_signed_v<Number>)
+        return false;
+    if (size != sizeof(Number) || tag == 76)
+        return false;
+
+    isLittleEndian = size == 1 || (tag & 0x04) != 0;
+    return true;
+}
+
+template<typename Number>
+constexpr const char* numberTypeName() {
+    if constexpr (std::is_same_v<Number, float>)       return "Float";
+    else if constexpr (std::is_same_v<Number, double>) return "Double";
+    else return RapidjsonValueTypeValidator::integerTypeName<Number>();
+}
+
+// Copies count numbers, reversing the bytes of each of them
+template<typename Number>
+void copyByteSwapped(const void* from, void* to, std::size_t count) {
+    const auto* in = static_cast<const uint8_t*>(from);
+    auto* out = static_cast<uint8_t*>(to);
+
+    for (std::size_t i = 0; i < count; ++i, in += sizeof(Number), out += sizeof(Number))
+        for (std::size_t byte = 0; byte < sizeof(Number); ++byte)
+            out[byte] = in[sizeof(Number) - 1 - byte];
+}
+
+// Copies count numbers between host order and the little-endian byte order of typed arrays,
+// the pointers may be null if count is 0, as for the data of empty vectors
+template<typename Number>
+void copyLittleEndian(const void* from, void* to, std::size_t count) {
+#if RAPIDJSON_UTIL_LITTLE_ENDIAN
+    if (count != 0)
+        std::memcpy(to, from, count * sizeof(Number));
+#else
+    copyByteSwapped<Number>(from, to, count);
+#endif
+}
+
+// Copies count numbers between host order and the big-endian byte order of typed arrays
+template<typename Number>
+void copyBigEndian(const void* from, void* to, std::size_t count) {
+#if RAPIDJSON_UTIL_LITTLE_ENDIAN
+    copyByteSwapped<Number>(from, to, count);
+#else
+    if (count != 0)
+        std::memcpy(to, from, count * sizeof(Number));
+#endif
+}
+
+}  // namespace detail
+}  // namespace rapidjson_util
+
+#endif
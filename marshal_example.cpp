@@ -1,5 +1,6 @@
 ﻿#include "rapid_util/rapid_util.h"
 #include <iostream>
+#include <chrono>
 
 struct Person {
     std::string name;
@@ -94,7 +95,7 @@ struct SensorReading {
 RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SensorReading, (sensorType, value))
 
 struct SystemStatus {
-    std::string timestamp;
+    std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds> timestamp;  // RFC 3339 string
     std::tuple<bool, int, SensorReading, std::string> statusData;  
 };
 
@@ -103,7 +104,7 @@ RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SystemStatus, (timestamp, statusData))
 
 void marshal_heterogeneous_array() {
     SystemStatus systemStatus;
-    systemStatus.timestamp = "2024-01-15T10:30:00Z";
+    systemStatus.timestamp = decltype(systemStatus.timestamp)(std::chrono::seconds(1705314600));  // 2024-01-15T10:30:00Z
     systemStatus.statusData = std::make_tuple(
         true,
         85,
@@ -0,0 +1,89 @@
+#include "allocation_counter.h"
+#include <cstdlib>
+#include <new>
+
+namespace rapidutil_test {
+
+namespace {
+
+// The innermost counter of each thread, a plain pointer so that reading it never allocates
+thread_local AllocationCounter* activeCounter = nullptr;
+
+}  // namespace
+
+AllocationCounter::AllocationCounter() : enclosing(activeCounter) {
+	activeCounter = this;
+}
+
+AllocationCounter::~AllocationCounter() {
+	activeCounter = enclosing;
+}
+
+void AllocationCounter::record(std::size_t bytes) noexcept {
+	for (AllocationCounter* counter = activeCounter; counter != nullptr; counter = counter->enclosing) {
+		++counter->counted.allocations;
+		counter->counted.bytes += bytes;
+	}
+}
+
+}  // namespace rapidutil_test
+
+
+#if RAPIDUTIL_TEST_COUNTS_MALLOC
+
+// glibc lets the executable replace malloc and keeps its own under these names. operator new
+// and RapidJSON's CrtAllocator both allocate with malloc, so counting it counts them both
+
+extern "C" {
+
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* memory, std::size_t size);
+void __libc_free(void* memory);
+
+void* malloc(std::size_t size) {
+	rapidutil_test::AllocationCounter::record(size);
+	return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) {
+	rapidutil_test::AllocationCounter::record(count * size);
+	return __libc_calloc(count, size);
+}
+
+// Growing a RapidJSON stack or string buffer reallocates it, which is counted as an allocation
+void* realloc(void* memory, std::size_t size) {
+	if (size != 0)
+		rapidutil_test::AllocationCounter::record(size);
+	return __libc_realloc(memory, size);
+}
+
+void free(void* memory) {
+	__libc_free(memory);
+}
+
+}  // extern "C"
+
+#else
+
+// The array and nothrow forms of the standard library call these, so replacing them counts
+// every allocation but the over-aligned ones
+
+void* operator new(std::size_t size) {
+	rapidutil_test::AllocationCounter::record(size);
+
+	if (void* memory = std::malloc(size != 0 ? size : 1))
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef __RAPIDJSON_UTIL_ALLOCATION_COUNTER_H__
+#define __RAPIDJSON_UTIL_ALLOCATION_COUNTER_H__
+
+#include <cstddef>
+#include <cstdlib>
+#include <utility>
+
+// With glibc the counter replaces malloc, through which RapidJSON allocates as well, elsewhere it
+// replaces operator new. Address sanitizer replaces malloc itself, so it leaves malloc alone
+#ifndef RAPIDUTIL_TEST_COUNTS_MALLOC
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define RAPIDUTIL_TEST_COUNTS_MALLOC 1
+#else
+#define RAPIDUTIL_TEST_COUNTS_MALLOC 0
+#endif
+#endif
+
+namespace rapidutil_test {
+
+/**
+ * @brief Allocations made through malloc, or through the global operator new where malloc
+ *        isn't counted, and the bytes they asked for
+ */
+struct AllocationCount {
+	std::size_t allocations = 0;
+	std::size_t bytes = 0;
+};
+
+/**
+ * @brief Counts the allocations the calling thread makes while the counter is alive
+ *
+ * Counters nest, each counting the allocations made during its own lifetime. The replacements
+ * of malloc or operator new that report to them are in allocation_counter.cpp, which the
+ * executable has to be linked with. Only where malloc is counted, with glibc, do the counts
+ * include the memory RapidJSON takes for its documents, parse stacks and string buffers, and
+ * every realloc that grows them.
+ */
+class AllocationCounter {
+public:
+	AllocationCounter();
+	~AllocationCounter();
+
+	AllocationCounter(const AllocationCounter&) = delete;
+	AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+	AllocationCount count() const {
+		return counted;
+	}
+
+	// Called by malloc or operator new on the thread of the counter
+	static void record(std::size_t bytes) noexcept;
+
+private:
+	AllocationCount counted;
+	AllocationCounter* enclosing;
+};
+
+/**
+ * @brief Allocations made by calling function on this thread
+ */
+template<typename Function>
+AllocationCount countAllocations(Function&& function) {
+	AllocationCounter counter;
+	std::forward<Function>(function)();
+
+	return counter.count();
+}
+
+}  // namespace rapidutil_test
+
+#endif
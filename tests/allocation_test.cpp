@@ -0,0 +1,234 @@
+#include "gmock/gmock.h"
+#include "allocation_counter.h"
+#include "rapid_util/rapid_util_columns.h"
+#include "rapid_util/rapid_util_msgpack.h"
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using rapidutil_test::AllocationCount;
+using rapidutil_test::AllocationCounter;
+using rapidutil_test::countAllocations;
+
+// Budgets are the counts measured with libstdc++ and glibc plus about a fifth, to leave room for
+// standard libraries which keep more or fewer strings and functions inline. With glibc malloc is
+// counted, so they include the chunks, stacks and buffers RapidJSON allocates and every realloc
+// that grows them; elsewhere only operator new is counted, which stays within them
+
+struct AllocationProduct {
+	std::string productId;
+	std::string name;
+	double price;
+	int quantity;
+};
+
+struct AllocationInventory {
+	std::string warehouse;
+	std::vector<std::optional<AllocationProduct>> products;
+};
+
+struct AllocationPerson {
+	std::string name;
+	int age;
+	bool isStudent;
+	std::optional<std::string> email;
+};
+
+struct AllocationSeries {
+	std::vector<double> samples;
+};
+
+struct AllocationCounters {
+	std::vector<int64_t> totals;
+	std::vector<uint16_t> ports;
+};
+
+struct AllocationTick {
+	int64_t sequence;
+	double price;
+	std::optional<int> venue;
+	bool isBid;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(AllocationProduct, (productId, name, price, quantity))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(AllocationInventory, (warehouse, products))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(AllocationPerson, (name, age, isStudent, email))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(AllocationSeries, (samples))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(AllocationCounters, (totals, ports))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(AllocationTick, (sequence, price, venue, isBid))
+
+namespace {
+
+AllocationInventory makeInventory(int products) {
+	AllocationInventory inventory { "Main Storage", {} };
+
+	for (int i = 0; i < products; ++i)
+		inventory.products.push_back(AllocationProduct { "P100" + std::to_string(i), "Product " + std::to_string(i), 9.5 + i, i });
+
+	return inventory;
+}
+
+AllocationPerson makePerson() {
+	return AllocationPerson { "Alice", 25, true, "alice@example.com" };
+}
+
+testing::AssertionResult withinBudget(const AllocationCount& count, std::size_t budget) {
+	if (count.allocations <= budget)
+		return testing::AssertionSuccess();
+
+	return testing::AssertionFailure() << "made " << count.allocations << " allocations ("
+		<< count.bytes << " bytes), budget is " << budget;
+}
+
+}  // namespace
+
+TEST(AllocationTest, CountAllocationsOfTheCall) {
+	AllocationCount count = countAllocations([] { std::vector<int> values(100); });
+
+	EXPECT_EQ(count.allocations, 1);
+	EXPECT_EQ(count.bytes, 100 * sizeof(int));
+	EXPECT_EQ(countAllocations([] {}).allocations, 0);
+}
+
+TEST(AllocationTest, CountNestedAllocations) {
+	AllocationCount inner;
+	AllocationCount outer = countAllocations([&inner] {
+		std::vector<int> before(10);
+		inner = countAllocations([] { std::vector<int> values(20); });
+		std::vector<int> after(30);
+	});
+
+	EXPECT_EQ(inner.allocations, 1);
+	EXPECT_EQ(inner.bytes, 20 * sizeof(int));
+	EXPECT_EQ(outer.allocations, 3);
+	EXPECT_EQ(outer.bytes, 60 * sizeof(int));
+}
+
+TEST(AllocationTest, IgnoreAllocationsOfOtherThreads) {
+	AllocationCounter counter;
+	std::thread thread([] { std::vector<int> values(100); });
+	AllocationCount started = counter.count();
+	thread.join();
+
+	EXPECT_EQ(counter.count().allocations, started.allocations);
+}
+
+TEST(AllocationTest, BuildJsonTreeWithinBudget) {
+	const AllocationInventory five = makeInventory(5);
+	const AllocationInventory ten = makeInventory(10);
+
+	AllocationCount fiveCount = countAllocations([&five] { auto tree = rapidjson_util::detail::buildJsonTreeFrom(five); });
+	AllocationCount tenCount = countAllocations([&ten] { auto tree = rapidjson_util::detail::buildJsonTreeFrom(ten); });
+
+	EXPECT_TRUE(withinBudget(fiveCount, 64));
+	// Each product adds its node and those of its four members, so the count grows linearly
+	EXPECT_LE(tenCount.allocations - fiveCount.allocations, 5 * 11);
+}
+
+TEST(AllocationTest, MarshalWithinBudget) {
+	const AllocationPerson person = makePerson();
+	const AllocationInventory inventory = makeInventory(5);
+
+	EXPECT_TRUE(withinBudget(countAllocations([&person] { rapidjson_util::marshal(person); }), 21));
+	EXPECT_TRUE(withinBudget(countAllocations([&inventory] { rapidjson_util::marshal(inventory); }), 85));
+}
+
+TEST(AllocationTest, UnmarshalWithinBudget) {
+	const std::string personJson = rapidjson_util::marshal(makePerson());
+	const std::string fiveJson = rapidjson_util::marshal(makeInventory(5));
+	const std::string tenJson = rapidjson_util::marshal(makeInventory(10));
+
+	EXPECT_TRUE(withinBudget(countAllocations([&personJson] {
+		AllocationPerson person;
+		rapidjson_util::unmarshal(personJson, person);
+	}), 21));
+
+	AllocationCount fiveCount = countAllocations([&fiveJson] {
+		AllocationInventory inventory;
+		rapidjson_util::unmarshal(fiveJson, inventory);
+	});
+	AllocationCount tenCount = countAllocations([&tenJson] {
+		AllocationInventory inventory;
+		rapidjson_util::unmarshal(tenJson, inventory);
+	});
+
+	EXPECT_TRUE(withinBudget(fiveCount, 105));
+	EXPECT_LE(tenCount.allocations - fiveCount.allocations, 5 * 15);
+}
+
+TEST(AllocationTest, NumberVectorsTakeNoNodePerElement) {
+	const AllocationSeries few { std::vector<double>(10, 0.5) };
+	const AllocationSeries many { std::vector<double>(1000, 0.5) };
+	const std::string fewJson = rapidjson_util::marshal(few);
+	const std::string manyJson = rapidjson_util::marshal(many);
+
+	// A std::vector of numbers is read and written in place, so only RapidJSON's buffers grow with it,
+	// by a few reallocations
+	AllocationCount fewWritten = countAllocations([&few] { rapidjson_util::marshal(few); });
+	AllocationCount manyWritten = countAllocations([&many] { rapidjson_util::marshal(many); });
+	EXPECT_LE(manyWritten.allocations - fewWritten.allocations, 16);
+
+	AllocationCount fewRead = countAllocations([&fewJson] {
+		AllocationSeries series;
+		rapidjson_util::unmarshal(fewJson, series);
+	});
+	AllocationCount manyRead = countAllocations([&manyJson] {
+		AllocationSeries series;
+		rapidjson_util::unmarshal(manyJson, series);
+	});
+	EXPECT_LE(manyRead.allocations - fewRead.allocations, 16);
+}
+
+TEST(AllocationTest, NarrowIntegersWithoutAllocating) {
+	const std::string fewJson = rapidjson_util::marshal(AllocationCounters { std::vector<int64_t>(10, -7), std::vector<uint16_t>(10, 443) });
+	const std::string manyJson = rapidjson_util::marshal(AllocationCounters { std::vector<int64_t>(1000, -7), std::vector<uint16_t>(1000, 443) });
+
+	AllocationCount fewRead = countAllocations([&fewJson] {
+		AllocationCounters counters;
+		rapidjson_util::unmarshal(fewJson, counters);
+	});
+	AllocationCount manyRead = countAllocations([&manyJson] {
+		AllocationCounters counters;
+		rapidjson_util::unmarshal(manyJson, counters);
+	});
+	EXPECT_LE(manyRead.allocations - fewRead.allocations, 16);
+}
+
+TEST(AllocationTest, MsgpackWithinBudget) {
+	const AllocationInventory inventory = makeInventory(5);
+	std::vector<uint8_t> bytes;
+	rapidjson_util::marshal_msgpack(inventory, bytes);
+
+	EXPECT_TRUE(withinBudget(countAllocations([&inventory] {
+		std::vector<uint8_t> encoded;
+		rapidjson_util::marshal_msgpack(inventory, encoded);
+	}), 86));
+	EXPECT_TRUE(withinBudget(countAllocations([&bytes] {
+		AllocationInventory decoded;
+		rapidjson_util::unmarshal_msgpack(bytes, decoded);
+	}), 95));
+}
+
+TEST(AllocationTest, DecodeShortLinesWithoutAllocating) {
+	auto ticksOf = [](int lines) {
+		std::string ndjson;
+		for (int i = 0; i < lines; ++i)
+			ndjson += rapidjson_util::marshal(AllocationTick { i, 101.25 + i, i % 4, i % 2 == 0 }) + "\n";
+
+		return ndjson;
+	};
+	const std::string few = ticksOf(10);
+	const std::string many = ticksOf(1000);
+
+	// The columns are reserved up front, so that all that could allocate per line is the parse
+	auto decode = [](const std::string& ndjson) {
+		rapidjson_util::columns<AllocationTick> table;
+		table.reserve(1000);
+
+		return countAllocations([&] { rapidjson_util::unmarshal_lines_columnar(ndjson, table); });
+	};
+
+	EXPECT_EQ(decode(many).allocations, decode(few).allocations);
+	EXPECT_TRUE(withinBudget(decode(few), 0));
+}
@@ -0,0 +1,305 @@
+#include "gmock/gmock.h"
+#include "rapid_util/rapid_util_binary_view.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <string>
+#include <vector>
+
+struct BinaryPoint {
+	uint8_t tag;
+	uint32_t id;
+	std::string name;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(BinaryPoint, (tag, id, name))
+
+TEST(BinaryViewTest, LayOutMembersAtFixedOffsets) {
+	auto buffer = rapidjson_util::marshal_binary(BinaryPoint { 7, 0x01020304, "ab" });
+
+	uint64_t fingerprint = rapidjson_util::binary_fingerprint<BinaryPoint>();
+	std::vector<uint8_t> expect = { 'R', 'J', 'U', 'B', 1, 0, 0, 0 };
+	for (int i = 0; i < 8; ++i)
+		expect.push_back(static_cast<uint8_t>(fingerprint >> (i * 8)));
+	expect.insert(expect.end(), { 50, 0, 0, 0, 0, 0, 0, 0 });
+
+	// tag at 0, id at 4 and a reference to the characters of name at 8
+	expect.insert(expect.end(), { 7, 0, 0, 0, 0x04, 0x03, 0x02, 0x01 });
+	expect.insert(expect.end(), { 48, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0 });
+	expect.insert(expect.end(), { 'a', 'b' });
+
+	ASSERT_EQ(buffer, expect);
+}
+
+struct BinaryDimensions {
+	double width;
+	double height;
+};
+
+struct BinaryShipment {
+	std::string id;
+	rapidjson_util::fixed_string<8> carrier;
+	BinaryDimensions dimensions;
+	std::optional<BinaryDimensions> box;
+	std::unique_ptr<int> priority;
+	std::vector<std::string> tags;
+	std::vector<double> route;
+	std::array<std::array<float, 2>, 3> corners;
+	std::vector<std::array<int16_t, 2>> offsets;
+	std::list<BinaryDimensions> parcels;
+	std::vector<int64_t> checkpoints;
+	std::chrono::seconds transit;
+	std::chrono::system_clock::time_point shipped;
+	rapidjson_util::bytes seal;
+	std::vector<std::optional<uint16_t>> bins;
+	std::vector<bool> flags;
+	bool fragile;
+	uint64_t serial;
+	int64_t balance;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(BinaryDimensions, (width, height))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(BinaryShipment, (id, carrier, dimensions, box, priority, tags, route, corners, offsets,
+                                                 parcels, checkpoints, transit, shipped, seal, bins, flags, fragile,
+                                                 serial, balance))
+
+namespace {
+
+BinaryShipment makeShipment() {
+	BinaryShipment shipment;
+	shipment.id = "SHP-0001";
+	shipment.carrier = "ACME";
+	shipment.dimensions = { 1.5, 2.25 };
+	shipment.priority = std::make_unique<int>(3);
+	shipment.tags = { "fragile", std::string(300, 't'), "" };
+	shipment.route.resize(1000);
+	for (std::size_t i = 0; i < shipment.route.size(); ++i)
+		shipment.route[i] = i * 0.125 - 7;
+	shipment.corners = { { { 0.f, 0.f }, { 1.f, 0.5f }, { -1.f, 2.f } } };
+	shipment.offsets = { { 1, -1 }, { 300, -300 } };
+	shipment.parcels = { { 1, 2 }, { 3, 4 } };
+	shipment.transit = std::chrono::seconds(-90);
+	shipment.shipped = std::chrono::system_clock::time_point(std::chrono::microseconds(1700000000123456));
+	shipment.seal = { std::byte(0xde), std::byte(0xad) };
+	shipment.bins = { 1, std::nullopt, 65535 };
+	shipment.flags = { true, false, true };
+	shipment.fragile = true;
+	shipment.serial = UINT64_MAX;
+	shipment.balance = INT64_MIN;
+
+	return shipment;
+}
+
+}  // namespace
+
+TEST(BinaryViewTest, RoundTripEverythingSupported) {
+	BinaryShipment shipment = makeShipment();
+	auto buffer = rapidjson_util::marshal_binary(shipment);
+
+	BinaryShipment decoded;
+	decoded.box = BinaryDimensions { 9, 9 };
+	decoded.checkpoints = { 1, 2, 3 };
+	rapidjson_util::unmarshal_binary(buffer, decoded);
+
+	ASSERT_EQ(decoded.id, shipment.id);
+	ASSERT_EQ(decoded.carrier, "ACME");
+	ASSERT_EQ(decoded.dimensions.height, 2.25);
+	ASSERT_FALSE(decoded.box.has_value());
+	ASSERT_TRUE(decoded.priority != nullptr);
+	ASSERT_EQ(*decoded.priority, 3);
+	ASSERT_EQ(decoded.tags, shipment.tags);
+	ASSERT_EQ(decoded.route, shipment.route);
+	ASSERT_EQ(decoded.corners, shipment.corners);
+	ASSERT_EQ(decoded.offsets, shipment.offsets);
+	ASSERT_EQ(decoded.parcels.back().height, 4);
+	ASSERT_TRUE(decoded.checkpoints.empty());
+	ASSERT_EQ(decoded.transit, std::chrono::seconds(-90));
+	ASSERT_EQ(decoded.shipped, shipment.shipped);
+	ASSERT_EQ(decoded.seal, shipment.seal);
+	ASSERT_THAT(decoded.bins, testing::ElementsAre(1, std::nullopt, 65535));
+	ASSERT_EQ(decoded.flags, shipment.flags);
+	ASSERT_TRUE(decoded.fragile);
+	ASSERT_EQ(decoded.serial, UINT64_MAX);
+	ASSERT_EQ(decoded.balance, INT64_MIN);
+
+	// The same struct always produces the same bytes
+	ASSERT_EQ(rapidjson_util::marshal_binary(decoded), buffer);
+}
+
+struct BinaryNode {
+	std::string label;
+	std::vector<BinaryNode> children;
+	std::unique_ptr<BinaryNode> next;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(BinaryNode, (label, children, next))
+
+TEST(BinaryViewTest, ReadMembersInPlace) {
+	BinaryShipment shipment = makeShipment();
+	auto buffer = rapidjson_util::marshal_binary(shipment);
+
+	rapidjson_util::binary_view<BinaryShipment> view(buffer.data(), buffer.size());
+
+	ASSERT_EQ(view.get<&BinaryShipment::id>(), "SHP-0001");
+	ASSERT_EQ(view.get<&BinaryShipment::carrier>(), "ACME");
+	ASSERT_EQ(view.get<&BinaryShipment::dimensions>().get<&BinaryDimensions::width>(), 1.5);
+	ASSERT_FALSE(view.get<&BinaryShipment::box>().has_value());
+	ASSERT_EQ(view.get<&BinaryShipment::priority>(), 3);
+	ASSERT_EQ(view.get<&BinaryShipment::tags>().size(), 3u);
+	ASSERT_EQ(view.get<&BinaryShipment::tags>()[1], std::string(300, 't'));
+	ASSERT_EQ(view.get<&BinaryShipment::route>().data()[999], shipment.route[999]);
+	ASSERT_EQ(view.get<&BinaryShipment::corners>()[2][1], 2.f);
+	ASSERT_EQ(view.get<&BinaryShipment::offsets>()[1][1], -300);
+	ASSERT_TRUE(view.get<&BinaryShipment::checkpoints>().empty());
+	ASSERT_EQ(view.get<&BinaryShipment::transit>(), std::chrono::seconds(-90));
+	ASSERT_EQ(view.get<&BinaryShipment::shipped>(), shipment.shipped);
+	ASSERT_EQ(view.get<&BinaryShipment::seal>()[1], std::byte(0xad));
+	ASSERT_TRUE(view.get<&BinaryShipment::fragile>());
+	ASSERT_EQ(view.get<&BinaryShipment::serial>(), UINT64_MAX);
+
+	std::vector<std::optional<uint16_t>> bins(view.get<&BinaryShipment::bins>().begin(), view.get<&BinaryShipment::bins>().end());
+	ASSERT_EQ(bins, shipment.bins);
+
+	std::vector<double> widths;
+	for (auto parcel : view.get<&BinaryShipment::parcels>())
+		widths.push_back(parcel.get<&BinaryDimensions::width>());
+	ASSERT_THAT(widths, testing::ElementsAre(1, 3));
+
+	BinaryDimensions dimensions;
+	view.get<&BinaryShipment::dimensions>().decode(dimensions);
+	ASSERT_EQ(dimensions.height, 2.25);
+
+	BinaryNode root;
+	root.label = "root";
+	root.children.resize(2);
+	root.children[1].label = "leaf";
+	root.next = std::make_unique<BinaryNode>();
+	root.next->label = "next";
+	auto tree = rapidjson_util::marshal_binary(root);
+
+	rapidjson_util::binary_view<BinaryNode> treeView(tree.data(), tree.size());
+	ASSERT_EQ(treeView.get<&BinaryNode::children>()[1].get<&BinaryNode::label>(), "leaf");
+	ASSERT_EQ(treeView.get<&BinaryNode::next>()->get<&BinaryNode::label>(), "next");
+	ASSERT_FALSE(treeView.get<&BinaryNode::next>()->get<&BinaryNode::next>().has_value());
+}
+
+TEST(BinaryViewTest, OpenMappedFile) {
+	BinaryShipment shipment = makeShipment();
+	auto buffer = rapidjson_util::marshal_binary(shipment);
+
+	std::string path = testing::TempDir() + "binary_view_test.bin";
+	std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+
+	{
+		auto view = rapidjson_util::binary_view<BinaryShipment>::open(path);
+		auto moved = std::move(view);
+
+		ASSERT_EQ(moved.get<&BinaryShipment::tags>()[0], "fragile");
+		ASSERT_EQ(moved.get<&BinaryShipment::balance>(), INT64_MIN);
+	}
+
+	std::remove(path.c_str());
+	ASSERT_THROW(rapidjson_util::binary_view<BinaryShipment>::open(path), std::system_error);
+}
+
+TEST(BinaryViewTest, ThrowWhenDataIsMalformed) {
+	auto expectFailure = [](std::vector<uint8_t> bytes, const std::string& message) {
+		BinaryPoint point;
+		try {
+			rapidjson_util::unmarshal_binary(bytes, point);
+			FAIL() << "Expected an exception for " << message;
+		}
+		catch (std::logic_error& e) {
+			EXPECT_EQ(std::string(e.what()), message);
+		}
+	};
+
+	const auto buffer = rapidjson_util::marshal_binary(BinaryPoint { 7, 42, "ab" });
+	auto patch = [&buffer](std::size_t at, uint8_t byte) {
+		auto patched = buffer;
+		patched[at] = byte;
+		return patched;
+	};
+
+	expectFailure({}, "Data of 0 bytes isn't in the compact binary format");
+	expectFailure(std::vector<uint8_t>(buffer.begin(), buffer.begin() + 20), "Data of 20 bytes isn't in the compact binary format");
+	expectFailure(patch(0, 'X'), "Data of 50 bytes isn't in the compact binary format");
+	expectFailure(patch(4, 2), "Expected binary format version 1, got 2");
+	expectFailure(std::vector<uint8_t>(buffer.begin(), buffer.end() - 1), "Binary data of 49 bytes, expected 50 bytes");
+
+	auto truncated = std::vector<uint8_t>(buffer.begin(), buffer.begin() + 40);
+	truncated[16] = 40;
+	expectFailure(truncated, "Binary data of 40 bytes can't hold the record of BinaryPoint");
+	expectFailure(patch(32, 49), "Reference at offset 32 to 2 elements at offset 49 exceeds the data");
+	expectFailure(patch(32, 24), "Reference at offset 32 to 2 elements at offset 24 exceeds the data");
+	expectFailure(patch(40, 3), "Reference at offset 32 to 3 elements at offset 48 exceeds the data");
+
+	auto otherSchema = rapidjson_util::marshal_binary(BinaryDimensions { 1, 2 });
+	try {
+		BinaryPoint point;
+		rapidjson_util::unmarshal_binary(otherSchema, point);
+		FAIL() << "Expected an exception for another schema";
+	}
+	catch (rapidjson_util::InvalidBinaryException& e) {
+		ASSERT_THAT(e.what(), testing::StartsWith("Binary data was written for another schema of BinaryPoint, expected fingerprint "));
+	}
+
+	ASSERT_NE(rapidjson_util::binary_fingerprint<BinaryPoint>(), rapidjson_util::binary_fingerprint<BinaryDimensions>());
+	ASSERT_NE(rapidjson_util::binary_fingerprint<BinaryShipment>(), rapidjson_util::binary_fingerprint<BinaryNode>());
+}
+
+struct BinaryPage {
+	std::vector<std::string> lines;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(BinaryPage, (lines))
+
+TEST(BinaryViewTest, ThrowWhenReferencesAliasEachOther) {
+	BinaryPage page;
+	page.lines.resize(64);
+	page.lines[0] = std::string(1024, 'x');
+	auto buffer = rapidjson_util::marshal_binary(page);
+
+	// The references of the lines follow the record at offset 40, point every line at the first one
+	const std::size_t linesAt = 40;
+	for (std::size_t line = 1; line < page.lines.size(); ++line)
+		std::memcpy(buffer.data() + linesAt + line * 16, buffer.data() + linesAt, 16);
+
+	rapidjson_util::binary_view<BinaryPage> view(buffer.data(), buffer.size());
+	ASSERT_EQ(view.get<&BinaryPage::lines>()[63], page.lines[0]);
+
+	BinaryPage decoded;
+	try {
+		rapidjson_util::unmarshal_binary(buffer, decoded);
+		FAIL() << "Expected an exception for aliased references";
+	}
+	catch (rapidjson_util::InvalidBinaryException& e) {
+		EXPECT_EQ(std::string(e.what()), "Reference at offset 56 overlaps others, the references of the data add up to "
+		                                 "more than its " + std::to_string(buffer.size()) + " bytes");
+	}
+}
+
+struct BinaryLongCode {
+	std::string code;
+};
+
+struct BinaryShortCode {
+	rapidjson_util::fixed_string<4> code;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(BinaryLongCode, (code))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(BinaryShortCode, (code))
+
+TEST(BinaryViewTest, ThrowWhenStringExceedsInlineCapacity) {
+	// Inline strings share the schema of std::string, only their capacity is checked
+	ASSERT_EQ(rapidjson_util::binary_fingerprint<BinaryLongCode>(), rapidjson_util::binary_fingerprint<BinaryShortCode>());
+
+	BinaryShortCode code;
+	rapidjson_util::unmarshal_binary(rapidjson_util::marshal_binary(BinaryLongCode { "ABCD" }), code);
+	ASSERT_EQ(code.code, "ABCD");
+
+	ASSERT_THROW(rapidjson_util::unmarshal_binary(rapidjson_util::marshal_binary(BinaryLongCode { "ABCDE" }), code),
+	             rapidjson_util::StringLengthExceededException);
+}
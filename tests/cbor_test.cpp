@@ -0,0 +1,257 @@
+#include "gmock/gmock.h"
+#include "rapid_util/rapid_util_cbor.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<uint8_t> toBytes(const std::string& bytes) {
+	return std::vector<uint8_t>(bytes.begin(), bytes.end());
+}
+
+// Keeps the NUL bytes within the literal
+template<std::size_t N>
+std::vector<uint8_t> toBytes(const char (&bytes)[N]) {
+	return std::vector<uint8_t>(bytes, bytes + N - 1);
+}
+
+}  // namespace
+
+struct CborHeader {
+	int8_t small;
+	int offset;
+	uint32_t count;
+	bool flag;
+	std::string name;
+	std::optional<double> ratio;
+	std::array<uint16_t, 2> ports;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CborHeader, (small, offset, count, flag, name, ratio, ports))
+
+TEST(CborTest, EncodeScalarsInTheirShortestHead) {
+	CborHeader header { 5, -200, 70000, true, "ab", std::nullopt, { 80, 443 } };
+
+	std::string expect = std::string("\xa7")
+		+ "\x65" "small" "\x05"
+		+ "\x66" "offset" "\x38\xc7"
+		+ "\x65" "count" "\x1a" + std::string("\x00\x01\x11\x70", 4)
+		+ "\x64" "flag" "\xf5"
+		+ "\x64" "name" "\x62" "ab"
+		+ "\x65" "ratio" "\xf6"
+		+ "\x65" "ports" "\xd8\x45\x44" "\x50" + std::string("\x00\xbb\x01", 3);
+
+	ASSERT_EQ(rapidjson_util::marshal_cbor(header), toBytes(expect));
+}
+
+struct CborDimensions {
+	double width;
+	double height;
+};
+
+struct CborParcel {
+	std::string kind;
+	int weight;
+};
+
+struct CborPallet {
+	int slots;
+};
+
+using CborLoad = std::variant<CborParcel, CborPallet>;
+
+struct CborShipment {
+	std::string id;
+	rapidjson_util::fixed_string<8> carrier;
+	CborDimensions dimensions;
+	std::optional<CborDimensions> box;
+	std::unique_ptr<int> priority;
+	std::vector<std::string> tags;
+	std::vector<double> route;
+	std::array<std::array<float, 2>, 3> corners;
+	std::vector<std::array<int16_t, 2>> offsets;
+	std::vector<int64_t> checkpoints;
+	std::tuple<int, std::string, bool> label;
+	CborLoad load;
+	std::optional<CborLoad> returnLoad;
+	std::chrono::seconds transit;
+	rapidjson_util::bytes seal;
+	std::vector<std::optional<uint16_t>> bins;
+	uint64_t serial;
+	int64_t balance;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CborDimensions, (width, height))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CborParcel, (kind, weight))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CborPallet, (slots))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CborShipment, (id, carrier, dimensions, box, priority, tags, route, corners, offsets,
+                                               checkpoints, label, load, returnLoad, transit, seal, bins, serial,
+                                               balance))
+
+TEST(CborTest, RoundTripEverythingJsonSupports) {
+	CborShipment shipment;
+	shipment.id = "SHP-0001";
+	shipment.carrier = "ACME";
+	shipment.dimensions = { 1.5, 2.25 };
+	shipment.priority = std::make_unique<int>(3);
+	shipment.tags = { "fragile", std::string(300, 't') };
+	shipment.route.resize(1000);
+	for (std::size_t i = 0; i < shipment.route.size(); ++i)
+		shipment.route[i] = i * 0.125 - 7;
+	shipment.corners = { { { 0.f, 0.f }, { 1.f, 0.5f }, { -1.f, 2.f } } };
+	shipment.offsets = { { 1, -1 }, { 300, -300 } };
+	shipment.label = { 42, "dock", true };
+	shipment.load = CborParcel { "box", 12 };
+	shipment.returnLoad = CborPallet { 4 };
+	shipment.transit = std::chrono::seconds(-90);
+	shipment.seal = { std::byte(0xde), std::byte(0xad) };
+	shipment.bins = { 1, std::nullopt, 65535 };
+	shipment.serial = UINT64_MAX;
+	shipment.balance = INT64_MIN;
+
+	auto buffer = rapidjson_util::marshal_cbor(shipment);
+
+	CborShipment decoded;
+	decoded.box = CborDimensions { 9, 9 };
+	decoded.checkpoints = { 1, 2, 3 };
+	rapidjson_util::unmarshal_cbor(buffer, decoded);
+
+	ASSERT_EQ(decoded.id, shipment.id);
+	ASSERT_EQ(decoded.carrier, "ACME");
+	ASSERT_EQ(decoded.dimensions.height, 2.25);
+	ASSERT_FALSE(decoded.box.has_value());
+	ASSERT_TRUE(decoded.priority != nullptr);
+	ASSERT_EQ(*decoded.priority, 3);
+	ASSERT_EQ(decoded.tags, shipment.tags);
+	ASSERT_EQ(decoded.route, shipment.route);
+	ASSERT_EQ(decoded.corners, shipment.corners);
+	ASSERT_EQ(decoded.offsets, shipment.offsets);
+	ASSERT_TRUE(decoded.checkpoints.empty());
+	ASSERT_EQ(decoded.label, shipment.label);
+	ASSERT_EQ(std::get<CborParcel>(decoded.load).weight, 12);
+	ASSERT_EQ(std::get<CborPallet>(*decoded.returnLoad).slots, 4);
+	ASSERT_EQ(decoded.transit, std::chrono::seconds(-90));
+	ASSERT_EQ(decoded.seal, shipment.seal);
+	ASSERT_THAT(decoded.bins, testing::ElementsAre(1, std::nullopt, 65535));
+	ASSERT_EQ(decoded.serial, UINT64_MAX);
+	ASSERT_EQ(decoded.balance, INT64_MIN);
+}
+
+struct CborSeal {
+	rapidjson_util::bytes seal;
+	std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds> sealedAt;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CborSeal, (seal, sealedAt))
+
+TEST(CborTest, RoundTripBytesAsByteStrings) {
+	using namespace std::chrono;
+
+	CborSeal seal{ { std::byte(0xde), std::byte(0xad) }, time_point<system_clock, seconds>(seconds(1705314600)) };
+	const auto bytes = toBytes("\xa2\x64" "seal" "\x42\xde\xad" "\x68" "sealedAt" "\xc0\x74" "2024-01-15T10:30:00Z");
+	ASSERT_EQ(rapidjson_util::marshal_cbor(seal), bytes);
+
+	CborSeal decoded;
+	rapidjson_util::unmarshal_cbor(bytes, decoded);
+	ASSERT_EQ(decoded.seal, seal.seal);
+	ASSERT_EQ(decoded.sealedAt, seal.sealedAt);
+
+	// Indefinite-length byte strings, and the base64 text JSON holds the bytes as
+	const std::string sealedAt = "\x68" "sealedAt" "\x74" "2024-01-15T10:30:00Z";
+	rapidjson_util::unmarshal_cbor(toBytes("\xa2\x64" "seal" "\x5f\x41\xde\x41\xad\xff" + sealedAt), decoded);
+	ASSERT_EQ(decoded.seal, seal.seal);
+	rapidjson_util::unmarshal_cbor(toBytes("\xa2\x64" "seal" "\x64" "3q0=" + sealedAt), decoded);
+	ASSERT_EQ(decoded.seal, seal.seal);
+
+	// A 300 byte seal takes a two-byte length
+	decoded.seal.assign(300, std::byte(0x5a));
+	auto buffer = rapidjson_util::marshal_cbor(decoded);
+	ASSERT_EQ(buffer[6], 0x59);
+	ASSERT_EQ(buffer[7] << 8 | buffer[8], 300);
+
+	rapidjson_util::unmarshal_cbor(buffer, seal);
+	ASSERT_EQ(seal.seal, decoded.seal);
+}
+
+struct CborSample {
+	std::string name;
+	std::vector<double> values;
+};
+
+struct CborGrid {
+	std::vector<std::array<uint16_t, 2>> cells;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CborSample, (name, values))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CborGrid, (cells))
+
+TEST(CborTest, ReadWhatOtherEncodersWrite) {
+	// 55799({_ "values": [_ 1.0, 2.5 as half], 1: "x", "extra": {"x": [1, h'00', undefined]}, "name": (_ "h", "i")})
+	std::string bytes = std::string("\xd9\xd9\xf7\xbf")
+		+ "\x66" "values" "\x9f\xfb\x3f\xf0" + std::string(6, '\0') + std::string("\xf9\x41\x00\xff", 4)
+		+ "\x01\x61" "x"
+		+ "\x65" "extra" "\xa1\x61x\x83\x01\x41" + std::string(1, '\0') + "\xf7"
+		+ "\x64" "name" "\x7f\x61h\x61i\xff"
+		+ "\xff";
+
+	CborSample sample;
+	rapidjson_util::unmarshal_cbor(toBytes(bytes), sample);
+
+	ASSERT_EQ(sample.name, "hi");
+	ASSERT_THAT(sample.values, testing::ElementsAre(1.0, 2.5));
+
+	// Big-endian typed arrays, and plain nested arrays for multi-dimensional ones
+	std::string bigEndian = std::string("\xa2")
+		+ "\x64" "name" "\x60"
+		+ "\x66" "values" "\xd8\x52\x50" "\x3f\xf0" + std::string(6, '\0') + "\x40\x04" + std::string(6, '\0');
+	rapidjson_util::unmarshal_cbor(toBytes(bigEndian), sample);
+	ASSERT_THAT(sample.values, testing::ElementsAre(1.0, 2.5));
+
+	CborGrid grid;
+	rapidjson_util::unmarshal_cbor(toBytes("\xa1\x65" "cells" "\x82\x82\x01\x02\xd8\x41\x44\x00\x03\x00\x04"), grid);
+	ASSERT_EQ(grid.cells, (std::vector<std::array<uint16_t, 2>> { { 1, 2 }, { 3, 4 } }));
+
+	// 40([[2, 2], 69(h'...')]), the row-major form marshal_cbor writes
+	rapidjson_util::unmarshal_cbor(toBytes("\xa1\x65" "cells" "\xd8\x28\x82\x82\x02\x02\xd8\x45\x48"
+	                                       "\x05\x00\x06\x00\x07\x00\x08\x00"), grid);
+	ASSERT_EQ(grid.cells, (std::vector<std::array<uint16_t, 2>> { { 5, 6 }, { 7, 8 } }));
+}
+
+TEST(CborTest, ThrowWhenDataIsMalformed) {
+	auto expectFailure = [](const std::string& bytes, const std::string& message) {
+		CborSample sample;
+		try {
+			rapidjson_util::unmarshal_cbor(toBytes(bytes), sample);
+			FAIL() << "Expected an exception for " << message;
+		}
+		catch (std::logic_error& e) {
+			EXPECT_EQ(std::string(e.what()), message);
+		}
+	};
+
+	const std::string name = "\x64" "name" "\x62" "hi";
+
+	expectFailure("\xa2", "CBOR map of 2 entries exceeds the data");
+	expectFailure("\x82\x01\x02", "Expected Object, got Array");
+	expectFailure("\xa1" + name, "JSON doesn't match the struct: required field \"values\" not found");
+	expectFailure("\xa2" + name + "\x66" "values" "\x9b\xff\xff\xff\xff\xff\xff\xff\xff",
+	              "Deserialization of member \"values\" failed: CBOR array of 18446744073709551615 elements exceeds the data");
+	expectFailure("\xa2" + name + "\x66" "values" "\xd8\x55\x44" + std::string(4, '\0'),
+	              "Deserialization of member \"values\" failed: Expected typed array of Double, got tag 85");
+	expectFailure("\xa2" + name + "\x66" "values" "\xd8\x56\x5a\x7f\xff\xff\xff",
+	              "Deserialization of member \"values\" failed: Typed array of 2147483647 bytes doesn't fit Double "
+	              "elements or exceeds the data");
+	expectFailure("\xa2" + name + "\x66" "values" "\x81\x61x",
+	              "Deserialization of member \"values\" failed: Expected Double, got String");
+	expectFailure("\xa2" + name + "\x66" "values" "\x9f\x01",
+	              "Deserialization of member \"values\" failed: CBOR data is truncated at offset 18");
+	expectFailure("\xa2\x64" "name" "\x07\x66" "values" "\x80", "Deserialization of member \"name\" failed: Expected String, got Int");
+	expectFailure("\xa2" + name + "\x66" "values" "\x80\xf6", "CBOR data has 1 trailing bytes after the root map");
+	expectFailure("\xa2" + name + "\x66" "values" "\x1c", "Deserialization of member \"values\" failed: Invalid CBOR "
+	              "initial byte 28 at offset 16");
+
+	// An unknown member nested far deeper than any struct could be
+	std::string deep = "\xa3" + name + "\x66" "values" "\x80\x61x" + std::string(100000, '\x81') + "\x00";
+	expectFailure(deep, "CBOR data nests deeper than 512 levels at offset 531");
+}
@@ -0,0 +1,188 @@
+#include "gmock/gmock.h"
+#include "rapid_util/rapid_util_columns.h"
+#include <array>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct ColumnarQuote {
+	std::string symbol;
+	double bid;
+	float spread;
+	int64_t volume;
+	uint8_t venue;
+	bool halted;
+	std::optional<int> auctionSize;
+	std::unique_ptr<std::string> note;
+	char currency[4];
+	std::vector<int> depth;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(ColumnarQuote, (symbol, bid, spread, volume, venue, halted, auctionSize, note, currency, depth))
+
+struct ColumnarReading {
+	std::string sensor;
+	std::optional<double> celsius;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(ColumnarReading, (sensor, celsius))
+
+
+struct ColumnarTick {
+	std::string symbol;
+	std::optional<double> bid;
+	int level = 1;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(ColumnarTick, (symbol, bid, level))
+RAPIDJSON_UTIL_DESCRIBE_OMISSION(ColumnarTick, Defaults)
+RAPIDJSON_UTIL_DESCRIBE_WIRE_NAMES(ColumnarTick, (symbol, "s"), (bid, "b"), (level, "l"))
+
+TEST(ColumnsTest, ExportMembersToColumns) {
+	std::vector<ColumnarQuote> quotes(3);
+	quotes[0] = { "AAPL", 189.5, 0.01f, 1200, 1, false, 300, std::make_unique<std::string>("open"), "USD", { 1, 2 } };
+	quotes[1] = { "SAP", 171.25, 0.05f, -1, 2, true, std::nullopt, nullptr, "EUR", {} };
+	quotes[2] = { "", 0.0, 0.0f, 0, 0, false, 0, std::make_unique<std::string>(), "", {} };
+
+	auto table = rapidjson_util::to_columns(quotes);
+	ASSERT_EQ(table.size(), 3);
+
+	auto& symbols = table.get<&ColumnarQuote::symbol>();
+	ASSERT_EQ(symbols.size(), 3);
+	ASSERT_EQ(symbols[0], "AAPL");
+	ASSERT_EQ(symbols[1], "SAP");
+	ASSERT_EQ(symbols[2], "");
+	ASSERT_THAT(std::vector<int64_t>(symbols.offsets(), symbols.offsets() + 4), testing::ElementsAre(0, 4, 7, 7));
+	ASSERT_EQ(std::string(symbols.chars(), 7), "AAPLSAP");
+	ASSERT_EQ(symbols.validity(), nullptr);
+
+	auto& bids = table.get<&ColumnarQuote::bid>();
+	ASSERT_THAT(std::vector<double>(bids.data(), bids.data() + 3), testing::ElementsAre(189.5, 171.25, 0.0));
+	ASSERT_EQ(table.get<&ColumnarQuote::spread>()[1], 0.05f);
+	ASSERT_EQ(table.get<&ColumnarQuote::volume>()[1], -1);
+	ASSERT_EQ(table.get<&ColumnarQuote::venue>()[1], 2);
+
+	auto& halted = table.get<&ColumnarQuote::halted>();
+	static_assert(std::is_same_v<decltype(halted.data()), const uint8_t*>);
+	ASSERT_THAT(std::vector<uint8_t>(halted.data(), halted.data() + 3), testing::ElementsAre(0, 1, 0));
+	ASSERT_TRUE(halted[1]);
+
+	auto& auctionSizes = table.get<&ColumnarQuote::auctionSize>();
+	ASSERT_EQ(auctionSizes.null_count(), 1);
+	ASSERT_NE(auctionSizes.validity(), nullptr);
+	ASSERT_EQ(auctionSizes.validity()[0], 0b101);
+	ASSERT_TRUE(auctionSizes.is_valid(0));
+	ASSERT_FALSE(auctionSizes.is_valid(1));
+	ASSERT_EQ(auctionSizes[0], 300);
+	ASSERT_EQ(auctionSizes[1], 0);
+
+	auto& notes = table.get<&ColumnarQuote::note>();
+	ASSERT_EQ(notes.null_count(), 1);
+	ASSERT_EQ(notes[0], "open");
+	ASSERT_EQ(notes[1], "");
+	ASSERT_FALSE(notes.is_valid(1));
+	ASSERT_TRUE(notes.is_valid(2));
+
+	auto& currencies = table.get<&ColumnarQuote::currency>();
+	ASSERT_EQ(currencies[0], "USD");
+	ASSERT_EQ(currencies[1], "EUR");
+	ASSERT_EQ(currencies[2], "");
+}
+
+TEST(ColumnsTest, AllocateValidityOnlyOnceNullsAppear) {
+	rapidjson_util::columns<ColumnarReading> table;
+
+	for (int i = 0; i < 11; ++i)
+		table.append({ "probe", 20.0 + i });
+
+	auto& celsius = table.get<&ColumnarReading::celsius>();
+	ASSERT_EQ(celsius.validity(), nullptr);
+	ASSERT_EQ(celsius.null_count(), 0);
+
+	table.append({ "probe", std::nullopt });
+	table.append({ "probe", 31.0 });
+
+	ASSERT_EQ(celsius.size(), 13);
+	ASSERT_EQ(celsius.null_count(), 1);
+	ASSERT_EQ(celsius.validity()[0], 0xFF);
+	ASSERT_EQ(celsius.validity()[1], 0b10111);
+	ASSERT_EQ(celsius[12], 31.0);
+}
+
+TEST(ColumnsTest, UnmarshalLinesIntoColumns) {
+	std::string ndjson =
+		R"({"symbol":"AAPL","bid":189.5,"spread":0.01,"volume":1200,"venue":1,"halted":false,"auctionSize":300,"note":"open","currency":"USD"})" "\n"
+		"\n"
+		R"({"symbol":"SAP","bid":171.25,"spread":0.05,"volume":-1,"venue":2,"halted":true,"auctionSize":null,"note":null,"currency":"EUR","depth":[1]})" "\r\n";
+
+	auto table = rapidjson_util::unmarshal_lines_columnar<ColumnarQuote>(ndjson);
+	ASSERT_EQ(table.size(), 2);
+	ASSERT_EQ(table.get<&ColumnarQuote::symbol>()[1], "SAP");
+	ASSERT_EQ(table.get<&ColumnarQuote::bid>()[0], 189.5);
+	ASSERT_EQ(table.get<&ColumnarQuote::spread>()[1], 0.05f);
+	ASSERT_EQ(table.get<&ColumnarQuote::volume>()[1], -1);
+	ASSERT_TRUE(table.get<&ColumnarQuote::halted>()[1]);
+	ASSERT_FALSE(table.get<&ColumnarQuote::auctionSize>().is_valid(1));
+	ASSERT_EQ(table.get<&ColumnarQuote::note>().null_count(), 1);
+	ASSERT_EQ(table.get<&ColumnarQuote::currency>()[1], "EUR");
+
+	std::istringstream input(R"({"sensor":"north","celsius":21.5})" "\n" R"({"sensor":"south","celsius":null})");
+	rapidjson_util::columns<ColumnarReading> readings;
+	rapidjson_util::unmarshal_lines_columnar(input, readings);
+
+	ASSERT_EQ(readings.size(), 2);
+	ASSERT_EQ(readings.get<&ColumnarReading::sensor>()[1], "south");
+	ASSERT_EQ(readings.get<&ColumnarReading::celsius>()[0], 21.5);
+	ASSERT_EQ(readings.get<&ColumnarReading::celsius>().validity()[0], 0b01);
+}
+
+TEST(ColumnsTest, UnmarshalOmittedMembersAndWireNames) {
+	auto table = rapidjson_util::unmarshal_lines_columnar<ColumnarTick>(R"({"s":"AAPL","b":189.5,"l":2})" "\n" R"({"s":"SAP"})");
+
+	ASSERT_EQ(table.size(), 2);
+	ASSERT_EQ(table.get<&ColumnarTick::symbol>()[1], "SAP");
+	ASSERT_FALSE(table.get<&ColumnarTick::bid>().is_valid(1));
+	ASSERT_EQ(table.get<&ColumnarTick::level>()[0], 2);
+	ASSERT_EQ(table.get<&ColumnarTick::level>()[1], 1);
+}
+
+TEST(ColumnsTest, ThrowWhenLinesAreMalformed) {
+	auto expectFailure = [](const std::string& ndjson, const std::string& message) {
+		rapidjson_util::columns<ColumnarReading> table;
+		try {
+			rapidjson_util::unmarshal_lines_columnar(ndjson, table);
+			FAIL() << "Expected an exception for " << message;
+		}
+		catch (rapidjson_util::LineDeserializationFailure& e) {
+			EXPECT_EQ(std::string(e.what()), message);
+		}
+	};
+
+	expectFailure(R"({"sensor":"north","celsius":21.5)", "Deserialization of line 1 failed: The provided JSON text has invalid syntax");
+	expectFailure("\n" R"({"sensor":"north"})", "Deserialization of line 2 failed: JSON doesn't match the struct: required field \"celsius\" not found");
+	expectFailure(R"({"sensor":1,"celsius":21.5})", "Deserialization of line 1 failed: Deserialization of member \"sensor\" failed: Expected String, got Int");
+	expectFailure(R"({"sensor":"north","celsius":21})", "Deserialization of line 1 failed: Deserialization of member \"celsius\" failed: Expected Double, got Int");
+	expectFailure("[]", "Deserialization of line 1 failed: Expected Object, got Array");
+
+	// The lines before the failing one stay, without a partial row of it
+	rapidjson_util::columns<ColumnarReading> table;
+	std::string ndjson = R"({"sensor":"north","celsius":null})" "\n" R"({"sensor":"south","celsius":"warm"})";
+	ASSERT_THROW(rapidjson_util::unmarshal_lines_columnar(ndjson, table), rapidjson_util::LineDeserializationFailure);
+
+	auto& sensors = table.get<&ColumnarReading::sensor>();
+	auto& celsius = table.get<&ColumnarReading::celsius>();
+	ASSERT_EQ(table.size(), 1);
+	ASSERT_EQ(sensors.size(), 1);
+	ASSERT_EQ(std::string(sensors.chars(), sensors.offsets()[1]), "north");
+	ASSERT_EQ(celsius.size(), 1);
+	ASSERT_EQ(celsius.null_count(), 1);
+
+	rapidjson_util::columns<ColumnarQuote> quotes;
+	ASSERT_THROW(rapidjson_util::unmarshal_lines_columnar(R"({"symbol":"AAPL","bid":1.0,"spread":0.5,"volume":1,"venue":256,"halted":false,)"
+	                                                      R"("auctionSize":null,"note":null,"currency":"USD"})", quotes),
+	             rapidjson_util::LineDeserializationFailure);
+	ASSERT_EQ(quotes.get<&ColumnarQuote::symbol>().size(), 0);
+	ASSERT_EQ(quotes.get<&ColumnarQuote::bid>().size(), 0);
+}
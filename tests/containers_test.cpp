@@ -0,0 +1,61 @@
+#include "gmock/gmock.h"
+#include "rapid_util/rapid_util_containers.h"
+#include <memory>
+#include <string>
+
+using rapidjson_util::fixed_string;
+using rapidjson_util::static_vector;
+using rapidjson_util::small_vector;
+
+TEST(FixedCapacityContainerTest, FixedStringAssignsWithinCapacity) {
+	fixed_string<5> str("abc");
+
+	ASSERT_EQ(str, "abc");
+	ASSERT_EQ(str.size(), 3);
+	ASSERT_STREQ(str.c_str(), "abc");
+
+	str = "vwxyz";
+	ASSERT_EQ(str, "vwxyz");
+
+	ASSERT_THROW(str = "toolong", std::length_error);
+	ASSERT_EQ(str, "vwxyz");
+}
+
+TEST(FixedCapacityContainerTest, StaticVectorResizesUpToCapacity) {
+	static_vector<std::string, 3> strings{ "a", "b" };
+
+	strings.resize(3);
+	ASSERT_THAT(strings, testing::ElementsAre("a", "b", ""));
+
+	ASSERT_THROW(strings.push_back("d"), std::length_error);
+	ASSERT_THROW(strings.resize(4), std::length_error);
+
+	strings.resize(1);
+	ASSERT_THAT(strings, testing::ElementsAre("a"));
+
+	auto copy = strings;
+	auto moved = std::move(strings);
+	ASSERT_EQ(copy, moved);
+}
+
+TEST(FixedCapacityContainerTest, SmallVectorSpillsToHeapBeyondInlineCapacity) {
+	small_vector<std::unique_ptr<int>, 2> pointers;
+	pointers.push_back(std::make_unique<int>(1));
+	pointers.push_back(std::make_unique<int>(2));
+	ASSERT_TRUE(pointers.is_inline());
+
+	pointers.push_back(std::make_unique<int>(3));
+	ASSERT_FALSE(pointers.is_inline());
+	ASSERT_EQ(*pointers[2], 3);
+
+	auto moved = std::move(pointers);
+	ASSERT_EQ(moved.size(), 3);
+	ASSERT_EQ(*moved[0], 1);
+	ASSERT_TRUE(pointers.empty());
+
+	small_vector<int, 4> numbers{ 1, 2 };
+	auto copy = numbers;
+	copy.resize(3);
+	ASSERT_TRUE(copy.is_inline());
+	ASSERT_THAT(copy, testing::ElementsAre(1, 2, 0));
+}
@@ -0,0 +1,343 @@
+#include "gmock/gmock.h"
+#include "rapid_util/rapid_util_msgpack.h"
+#include <array>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<uint8_t> toBytes(const std::string& bytes) {
+	return std::vector<uint8_t>(bytes.begin(), bytes.end());
+}
+
+}  // namespace
+
+struct MsgpackHeader {
+	int8_t small;
+	int offset;
+	uint32_t count;
+	bool flag;
+	std::string name;
+	std::optional<double> ratio;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MsgpackHeader, (small, offset, count, flag, name, ratio))
+
+TEST(MsgpackTest, EncodeScalarsInTheirSmallestFormat) {
+	MsgpackHeader header { 5, -200, 70000, true, "ab", std::nullopt };
+
+	std::string expect = std::string("\x86")
+		+ "\xa5" "small" "\x05"
+		+ "\xa6" "offset" "\xd1\xff\x38"
+		+ "\xa5" "count" "\xce" + std::string("\x00\x01\x11\x70", 4)
+		+ "\xa4" "flag" "\xc3"
+		+ "\xa4" "name" "\xa2" "ab"
+		+ "\xa5" "ratio" "\xc0";
+
+	ASSERT_EQ(rapidjson_util::marshal_msgpack(header), toBytes(expect));
+}
+
+TEST(MsgpackTest, ReuseBufferAcrossCalls) {
+	MsgpackHeader header { -1, 0, 0, false, std::string(40, 'x'), 0.5 };
+
+	std::vector<uint8_t> buffer;
+	rapidjson_util::marshal_msgpack(header, buffer);
+	const uint8_t* data = buffer.data();
+	const std::size_t size = buffer.size();
+
+	rapidjson_util::marshal_msgpack(header, buffer);
+	ASSERT_EQ(buffer.data(), data);
+	ASSERT_EQ(buffer.size(), size);
+
+	MsgpackHeader decoded;
+	rapidjson_util::unmarshal_msgpack(buffer, decoded);
+	ASSERT_EQ(decoded.small, -1);
+	ASSERT_EQ(decoded.name, header.name);
+	ASSERT_EQ(decoded.ratio, 0.5);
+}
+
+struct MsgpackSamples {
+	std::vector<double> values;
+	std::vector<std::array<int, 2>> pairs;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MsgpackSamples, (values, pairs))
+
+TEST(MsgpackTest, RoundTripEmptyNumberArrays) {
+	// The data() of an empty std::vector may be null, which must not reach memcpy either way
+	MsgpackSamples samples;
+
+	std::string expect = std::string("\x82")
+		+ "\xa6" "values" + std::string("\xc7\x00\x56", 3)
+		+ "\xa5" "pairs" "\x90";
+
+	auto buffer = rapidjson_util::marshal_msgpack(samples);
+	ASSERT_EQ(buffer, toBytes(expect));
+
+	MsgpackSamples decoded { { 1.0, 2.0 }, { { 1, 2 } } };
+	rapidjson_util::unmarshal_msgpack(buffer, decoded);
+	ASSERT_TRUE(decoded.values.empty());
+	ASSERT_TRUE(decoded.pairs.empty());
+}
+
+struct MsgpackDimensions {
+	double width;
+	double height;
+};
+
+struct MsgpackParcel {
+	std::string kind;
+	int weight;
+};
+
+struct MsgpackPallet {
+	int slots;
+};
+
+using MsgpackLoad = std::variant<MsgpackParcel, MsgpackPallet>;
+
+struct Shipment {
+	std::string id;
+	rapidjson_util::fixed_string<8> carrier;
+	MsgpackDimensions dimensions;
+	std::optional<MsgpackDimensions> box;
+	std::unique_ptr<int> priority;
+	std::vector<std::string> tags;
+	std::vector<double> route;
+	std::array<std::array<float, 2>, 3> corners;
+	std::vector<int64_t> checkpoints;
+	std::tuple<int, std::string, bool> label;
+	MsgpackLoad load;
+	std::optional<MsgpackLoad> returnLoad;
+	std::chrono::seconds transit;
+	rapidjson_util::bytes seal;
+	std::vector<std::optional<uint16_t>> bins;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MsgpackDimensions, (width, height))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MsgpackParcel, (kind, weight))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MsgpackPallet, (slots))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Shipment, (id, carrier, dimensions, box, priority, tags, route, corners, checkpoints,
+                                           label, load, returnLoad, transit, seal, bins))
+
+TEST(MsgpackTest, RoundTripEverythingJsonSupports) {
+	Shipment shipment;
+	shipment.id = "SHP-0001";
+	shipment.carrier = "ACME";
+	shipment.dimensions = { 1.5, 2.25 };
+	shipment.priority = std::make_unique<int>(3);
+	shipment.tags = { "fragile", std::string(300, 't') };
+	shipment.route.resize(1000);
+	for (std::size_t i = 0; i < shipment.route.size(); ++i)
+		shipment.route[i] = i * 0.125 - 7;
+	shipment.corners = { { { 0.f, 0.f }, { 1.f, 0.5f }, { -1.f, 2.f } } };
+	shipment.label = { 42, "dock", true };
+	shipment.load = MsgpackParcel { "box", 12 };
+	shipment.returnLoad = MsgpackPallet { 4 };
+	shipment.transit = std::chrono::seconds(-90);
+	shipment.seal = { std::byte(0xde), std::byte(0xad) };
+	shipment.bins = { 1, std::nullopt, 65535 };
+
+	auto buffer = rapidjson_util::marshal_msgpack(shipment);
+
+	Shipment decoded;
+	decoded.box = MsgpackDimensions { 9, 9 };
+	decoded.checkpoints = { 1, 2, 3 };
+	rapidjson_util::unmarshal_msgpack(buffer, decoded);
+
+	ASSERT_EQ(decoded.id, shipment.id);
+	ASSERT_EQ(decoded.carrier, "ACME");
+	ASSERT_EQ(decoded.dimensions.height, 2.25);
+	ASSERT_FALSE(decoded.box.has_value());
+	ASSERT_TRUE(decoded.priority != nullptr);
+	ASSERT_EQ(*decoded.priority, 3);
+	ASSERT_EQ(decoded.tags, shipment.tags);
+	ASSERT_EQ(decoded.route, shipment.route);
+	ASSERT_EQ(decoded.corners, shipment.corners);
+	ASSERT_TRUE(decoded.checkpoints.empty());
+	ASSERT_EQ(decoded.label, shipment.label);
+	ASSERT_EQ(std::get<MsgpackParcel>(decoded.load).weight, 12);
+	ASSERT_EQ(std::get<MsgpackPallet>(*decoded.returnLoad).slots, 4);
+	ASSERT_EQ(decoded.transit, std::chrono::seconds(-90));
+	ASSERT_EQ(decoded.seal, shipment.seal);
+	ASSERT_THAT(decoded.bins, testing::ElementsAre(1, std::nullopt, 65535));
+}
+
+struct MsgpackSeal {
+	rapidjson_util::bytes seal;
+	std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds> sealedAt;
+};
+
+struct MsgpackCrate {
+	std::optional<std::vector<std::byte>> payload;
+	rapidjson_util::hex_bytes checksum;
+	std::optional<std::chrono::system_clock::time_point> openedAt;
+	std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> scannedAt;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MsgpackSeal, (seal, sealedAt))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MsgpackCrate, (payload, checksum, openedAt, scannedAt))
+
+TEST(MsgpackTest, RoundTripBytesAsBinAndTimePointsAsTimestamps) {
+	using namespace std::chrono;
+
+	MsgpackSeal seal{ { std::byte(0xde), std::byte(0xad) }, time_point<system_clock, seconds>(seconds(1705314600)) };
+	const auto sealBytes = toBytes(std::string("\x82\xa4" "seal" "\xc4\x02\xde\xad" "\xa8" "sealedAt" "\xd6\xff\x65\xa5\x09\x28"));
+	ASSERT_EQ(rapidjson_util::marshal_msgpack(seal), sealBytes);
+
+	MsgpackSeal decodedSeal;
+	rapidjson_util::unmarshal_msgpack(sealBytes, decodedSeal);
+	ASSERT_EQ(decodedSeal.seal, seal.seal);
+	ASSERT_EQ(decodedSeal.sealedAt, seal.sealedAt);
+
+	// Bins of 16-bit lengths, and the 64 and 96-bit timestamps for fractions and times before 1970
+	MsgpackCrate crate;
+	crate.payload = std::vector<std::byte>(300, std::byte(0x5a));
+	crate.checksum = { std::byte(0x01), std::byte(0xff) };
+	crate.openedAt = system_clock::time_point(microseconds(-1500001));
+	crate.scannedAt = time_point<system_clock, nanoseconds>(nanoseconds(1705314600123456789));
+
+	auto buffer = rapidjson_util::marshal_msgpack(crate);
+	ASSERT_EQ(buffer[9], 0xc5);
+	ASSERT_EQ(buffer[10] << 8 | buffer[11], 300);
+
+	MsgpackCrate decoded;
+	rapidjson_util::unmarshal_msgpack(buffer, decoded);
+	ASSERT_EQ(decoded.payload, crate.payload);
+	ASSERT_EQ(decoded.checksum, crate.checksum);
+	ASSERT_EQ(decoded.openedAt, crate.openedAt);
+	ASSERT_EQ(decoded.scannedAt, crate.scannedAt);
+
+	// The strings JSON holds them as are read as well
+	rapidjson_util::unmarshal_msgpack(toBytes(std::string("\x82\xa4" "seal" "\xa4" "3q0=" "\xa8" "sealedAt" "\xb4"
+	                                                      "2024-01-15T10:30:00Z")), decodedSeal);
+	ASSERT_EQ(decodedSeal.seal, seal.seal);
+	ASSERT_EQ(decodedSeal.sealedAt, seal.sealedAt);
+}
+
+struct MsgpackSample {
+	std::string name;
+	std::vector<double> values;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MsgpackSample, (name, values))
+
+TEST(MsgpackTest, ReadMembersOutOfOrderAndSkipUnknownOnes) {
+	// {"values": [1.0, 2.5f], "extra": {"x": [1, "y", nil]}, "name": "hi"}, as other encoders may write it
+	std::string bytes = std::string("\x83")
+		+ "\xa6" "values" "\x92\xcb\x3f\xf0" + std::string(6, '\0') + "\xca\x40\x20" + std::string(2, '\0')
+		+ "\xa5" "extra" "\x81\xa1x\x93\x01\xa1y\xc0"
+		+ "\xa4" "name" "\xa2" "hi";
+
+	MsgpackSample sample;
+	rapidjson_util::unmarshal_msgpack(toBytes(bytes), sample);
+
+	ASSERT_EQ(sample.name, "hi");
+	ASSERT_THAT(sample.values, testing::ElementsAre(1.0, 2.5));
+}
+
+struct MsgpackTick {
+	std::string symbol;
+	std::optional<double> bid;
+	int level = 1;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MsgpackTick, (symbol, bid, level))
+RAPIDJSON_UTIL_DESCRIBE_OMISSION(MsgpackTick, Defaults)
+RAPIDJSON_UTIL_DESCRIBE_WIRE_NAMES(MsgpackTick, (symbol, "s"), (bid, "b"))
+
+TEST(MsgpackTest, OmitDefaultMembersAndUseWireNames) {
+	MsgpackTick tick{ "SAP", std::nullopt, 1 };
+	ASSERT_EQ(rapidjson_util::marshal_msgpack(tick), toBytes("\x81\xa1s\xa3SAP"));
+
+	tick = { "SAP", 171.25, 2 };
+	MsgpackTick decoded{ "X", 1.0, 7 };
+	rapidjson_util::unmarshal_msgpack(rapidjson_util::marshal_msgpack(tick), decoded);
+	ASSERT_EQ(decoded.bid, 171.25);
+	ASSERT_EQ(decoded.level, 2);
+
+	rapidjson_util::unmarshal_msgpack(toBytes("\x81\xa1s\xa3SAP"), decoded);
+	ASSERT_FALSE(decoded.bid.has_value());
+	ASSERT_EQ(decoded.level, 1);
+}
+
+TEST(MsgpackTest, ThrowWhenDataIsMalformed) {
+	auto expectFailure = [](const std::string& bytes, const std::string& message) {
+		MsgpackSample sample;
+		try {
+			rapidjson_util::unmarshal_msgpack(toBytes(bytes), sample);
+			FAIL() << "Expected an exception for " << message;
+		}
+		catch (std::logic_error& e) {
+			EXPECT_EQ(std::string(e.what()), message);
+		}
+	};
+
+	const std::string name = "\xa4" "name" "\xa2" "hi";
+
+	expectFailure("\x82", "MessagePack map of 2 entries exceeds the data");
+	expectFailure("\x92\x01\x02", "Expected Object, got Array");
+	expectFailure("\x81" + name, "JSON doesn't match the struct: required field \"values\" not found");
+	expectFailure("\x82" + name + "\xa6" "values" "\xdd\xff\xff\xff\xff",
+	              "Deserialization of member \"values\" failed: MessagePack array of 4294967295 elements exceeds the data");
+	expectFailure("\x82" + name + "\xa6" "values" "\xd6\x55" + std::string(4, '\0'),
+	              "Deserialization of member \"values\" failed: Expected typed array of Double, got extension type 85");
+	expectFailure("\x82" + name + "\xa6" "values" "\x91\xa1x",
+	              "Deserialization of member \"values\" failed: Expected Double, got String");
+	expectFailure("\x82\xa4" "name" "\x07\xa6" "values" "\x90", "Deserialization of member \"name\" failed: Expected String, got Int");
+	expectFailure("\x82" + name + "\xa6" "values" "\x90\xc0", "MessagePack data has 1 trailing bytes after the root map");
+
+	// An unknown member nested far deeper than any struct could be
+	std::string deep = "\x83" + name + "\xa6" "values" "\x90\xa1x" + std::string(100000, '\x91') + "\x00";
+	expectFailure(deep, "MessagePack data nests deeper than 512 levels at offset 531");
+}
+
+struct MsgpackTimer {
+	std::chrono::milliseconds timeout;
+};
+
+struct MsgpackTreeNode {
+	int value;
+	std::vector<MsgpackTreeNode> children;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MsgpackTimer, (timeout))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MsgpackTreeNode, (value, children))
+
+TEST(MsgpackTest, ThrowWhenDataNestsTooDeeply) {
+	// Codecs read their value as JSON first, however deep it is
+	MsgpackTimer timer;
+	try {
+		rapidjson_util::unmarshal_msgpack(toBytes("\x81\xa7" "timeout" + std::string(100000, '\x91') + "\x00"), timer);
+		FAIL() << "Expected an exception for a deeply nested chrono member";
+	}
+	catch (rapidjson_util::MemberSerializationFailure& e) {
+		EXPECT_EQ(std::string(e.what()), "Deserialization of member \"timeout\" failed: MessagePack data nests deeper "
+		                                 "than 512 levels at offset 521");
+	}
+
+	// {"value": 0, "children": [...]} levels, each a map and an array deep
+	auto treeOfDepth = [](std::size_t levels) {
+		const std::string node = std::string("\x82\xa5" "value", 7) + std::string("\x00\xa8" "children", 10);
+
+		std::string bytes;
+		for (std::size_t level = 1; level < levels; ++level)
+			bytes += node + "\x91";
+
+		return toBytes(bytes + node + "\x90");
+	};
+
+	MsgpackTreeNode tree;
+	rapidjson_util::unmarshal_msgpack(treeOfDepth(256), tree);
+	ASSERT_EQ(rapidjson_util::marshal_msgpack(tree), treeOfDepth(256));
+
+	try {
+		rapidjson_util::unmarshal_msgpack(treeOfDepth(600), tree);
+		FAIL() << "Expected an exception for a tree of 600 levels";
+	}
+	catch (rapidjson_util::MemberSerializationFailure& e) {
+		EXPECT_THAT(std::string(e.what()), testing::EndsWith("MessagePack data nests deeper than 512 levels at offset 4609"));
+	}
+}
@@ -0,0 +1,302 @@
+#include "gmock/gmock.h"
+#include "rapid_util/rapid_util_protobuf.h"
+#include <chrono>
+#include <list>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<uint8_t> toBytes(const std::string& bytes) {
+	return std::vector<uint8_t>(bytes.begin(), bytes.end());
+}
+
+// Keeps the NUL bytes within the literal
+template<std::size_t N>
+std::vector<uint8_t> toBytes(const char (&bytes)[N]) {
+	return std::vector<uint8_t>(bytes, bytes + N - 1);
+}
+
+}  // namespace
+
+struct ProtobufInner {
+	int a;
+};
+
+struct ProtobufSample {
+	int a;
+	std::string b;
+	ProtobufInner c;
+	std::vector<int> d;
+	int e;
+	int f;
+	uint32_t g;
+	double h;
+	std::optional<int> i;
+	std::string notOnTheWire;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_PROTOBUF_FIELDS(ProtobufInner, (a, 1))
+RAPIDJSON_UTIL_DESCRIBE_PROTOBUF_FIELDS(ProtobufSample, (a, 1), (b, 2), (c, 3), (d, 4), (e, 5, ZigZag), (f, 6), (g, 7, Fixed),
+                                        (h, 8), (i, 9))
+
+TEST(ProtobufTest, EncodeFieldsAsProtocDoes) {
+	ProtobufSample sample { 150, "testing", { 150 }, { 3, 270, 86942 }, -2, -1, 1, 1.0, 0, "local" };
+
+	std::string expect = std::string("\x08\x96\x01")
+		+ "\x12\x07" "testing"
+		+ "\x1a\x03\x08\x96\x01"
+		+ "\x22\x06\x03\x8e\x02\x9e\xa7\x05"
+		+ "\x28\x03"
+		+ "\x30\xff\xff\xff\xff\xff\xff\xff\xff\xff\x01"
+		+ "\x3d\x01" + std::string(3, '\0')
+		+ "\x41" + std::string(6, '\0') + "\xf0\x3f"
+		+ "\x48" + std::string(1, '\0');
+
+	ASSERT_EQ(rapidjson_util::marshal_protobuf(sample), toBytes(expect));
+
+	// Zero and empty fields are omitted, embedded messages and set optionals are not
+	ProtobufSample empty {};
+	ASSERT_EQ(rapidjson_util::marshal_protobuf(empty), toBytes("\x1a\x00"));
+
+	ProtobufSample decoded;
+	decoded.notOnTheWire = "kept";
+	rapidjson_util::unmarshal_protobuf(toBytes(expect), decoded);
+
+	ASSERT_EQ(decoded.a, 150);
+	ASSERT_EQ(decoded.b, "testing");
+	ASSERT_EQ(decoded.c.a, 150);
+	ASSERT_THAT(decoded.d, testing::ElementsAre(3, 270, 86942));
+	ASSERT_EQ(decoded.e, -2);
+	ASSERT_EQ(decoded.f, -1);
+	ASSERT_EQ(decoded.g, 1u);
+	ASSERT_EQ(decoded.h, 1.0);
+	ASSERT_EQ(decoded.i, 0);
+	ASSERT_EQ(decoded.notOnTheWire, "kept");
+}
+
+struct ProtobufDimensions {
+	double width = 1;
+	double height = 1;
+};
+
+struct ProtobufParcel {
+	std::string label;
+	ProtobufDimensions dimensions;
+	std::unique_ptr<ProtobufParcel> inner;
+};
+
+struct ProtobufShipment {
+	std::string id;
+	rapidjson_util::fixed_string<8> carrier;
+	std::optional<ProtobufDimensions> box;
+	std::shared_ptr<std::string> note;
+	std::vector<std::string> tags;
+	std::vector<double> route;
+	std::array<float, 3> corner;
+	std::list<int64_t> checkpoints;
+	std::vector<uint8_t> levels;
+	std::vector<bool> flags;
+	std::vector<ProtobufParcel> parcels;
+	std::chrono::milliseconds transit;
+	std::chrono::system_clock::time_point shipped;
+	std::vector<std::chrono::seconds> legs;
+	rapidjson_util::bytes seal;
+	int8_t grade;
+	uint64_t serial;
+	int64_t balance;
+	int64_t delta;
+	std::vector<int32_t> deltas;
+	std::array<uint64_t, 2> hashes;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(ProtobufDimensions, (width, height))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(ProtobufParcel, (label, dimensions, inner))
+RAPIDJSON_UTIL_DESCRIBE_PROTOBUF_FIELDS(ProtobufShipment, (id, 1), (carrier, 2), (box, 3), (note, 4), (tags, 5), (route, 6),
+                                        (corner, 7), (checkpoints, 8), (levels, 9), (flags, 10), (parcels, 11), (transit, 12),
+                                        (shipped, 13), (legs, 14), (seal, 15), (grade, 16), (serial, 17), (balance, 18),
+                                        (delta, 19, ZigZag), (deltas, 20, ZigZag), (hashes, 536870911, Fixed))
+
+TEST(ProtobufTest, RoundTripEverythingSupported) {
+	ProtobufShipment shipment;
+	shipment.id = "SHP-0001";
+	shipment.carrier = "ACME";
+	shipment.box = ProtobufDimensions { 0, 2.5 };
+	shipment.note = std::make_shared<std::string>("");
+	shipment.tags = { "fragile", "", std::string(300, 't') };
+	shipment.route = { -7, 0.125, 1e300 };
+	shipment.corner = { 1.f, -0.f, 3.f };
+	shipment.checkpoints = { 1, -1, INT64_MIN };
+	shipment.levels = { 0, 127, 128, 255 };
+	shipment.flags = { true, false, true };
+	shipment.parcels.resize(2);
+	shipment.parcels[0].label = std::string(200, 'p');
+	shipment.parcels[1].inner = std::make_unique<ProtobufParcel>();
+	shipment.parcels[1].inner->dimensions = { 3, 4 };
+	shipment.transit = std::chrono::milliseconds(-90250);
+	shipment.shipped = std::chrono::system_clock::time_point(std::chrono::microseconds(-1500001));
+	shipment.legs = { std::chrono::seconds(0), std::chrono::seconds(60) };
+	shipment.seal = { std::byte(0xde), std::byte(0xad) };
+	shipment.grade = -5;
+	shipment.serial = UINT64_MAX;
+	shipment.balance = INT64_MIN;
+	shipment.delta = INT64_MIN;
+	shipment.deltas = { INT32_MIN, -1, 0, INT32_MAX };
+	shipment.hashes = { 1, UINT64_MAX };
+
+	auto buffer = rapidjson_util::marshal_protobuf(shipment);
+
+	ProtobufShipment decoded;
+	decoded.tags = { "stale" };
+	decoded.parcels.resize(5);
+	rapidjson_util::unmarshal_protobuf(buffer, decoded);
+
+	ASSERT_EQ(decoded.id, shipment.id);
+	ASSERT_EQ(decoded.carrier, "ACME");
+	ASSERT_TRUE(decoded.box.has_value());
+	ASSERT_EQ(decoded.box->width, 0);
+	ASSERT_EQ(decoded.box->height, 2.5);
+	ASSERT_TRUE(decoded.note != nullptr);
+	ASSERT_EQ(*decoded.note, "");
+	ASSERT_EQ(decoded.tags, shipment.tags);
+	ASSERT_EQ(decoded.route, shipment.route);
+	ASSERT_EQ(decoded.corner, shipment.corner);
+	ASSERT_EQ(decoded.checkpoints, shipment.checkpoints);
+	ASSERT_EQ(decoded.levels, shipment.levels);
+	ASSERT_EQ(decoded.flags, shipment.flags);
+	ASSERT_EQ(decoded.parcels.size(), 2u);
+	ASSERT_EQ(decoded.parcels[0].label, shipment.parcels[0].label);
+	ASSERT_EQ(decoded.parcels[0].dimensions.width, 1);
+	ASSERT_EQ(decoded.parcels[1].inner->dimensions.height, 4);
+	ASSERT_EQ(decoded.parcels[1].inner->inner, nullptr);
+	ASSERT_EQ(decoded.transit, shipment.transit);
+	ASSERT_EQ(decoded.shipped, shipment.shipped);
+	ASSERT_EQ(decoded.legs, shipment.legs);
+	ASSERT_EQ(decoded.seal, shipment.seal);
+	ASSERT_EQ(decoded.grade, -5);
+	ASSERT_EQ(decoded.serial, UINT64_MAX);
+	ASSERT_EQ(decoded.balance, INT64_MIN);
+	ASSERT_EQ(decoded.delta, INT64_MIN);
+	ASSERT_EQ(decoded.deltas, shipment.deltas);
+	ASSERT_EQ(decoded.hashes, shipment.hashes);
+
+	ASSERT_EQ(rapidjson_util::marshal_protobuf(decoded), buffer);
+}
+
+struct ProtobufPmrRecord {
+	std::pmr::string name;
+	std::pmr::vector<std::pmr::string> aliases;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(ProtobufPmrRecord, (name, aliases))
+
+TEST(ProtobufTest, AllocateFromMemoryResource) {
+	ProtobufPmrRecord record;
+	record.name = std::pmr::string(100, 'n');
+	record.aliases.emplace_back(std::pmr::string(100, 'a'));
+	auto buffer = rapidjson_util::marshal_protobuf(record);
+
+	char arena[4096];
+	std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena), std::pmr::null_memory_resource());
+
+	ProtobufPmrRecord decoded;
+	rapidjson_util::unmarshal_protobuf(buffer, decoded, &resource);
+
+	ASSERT_EQ(decoded.name, record.name);
+	ASSERT_EQ(decoded.aliases, record.aliases);
+	ASSERT_EQ(decoded.name.get_allocator().resource(), &resource);
+	ASSERT_EQ(decoded.aliases[0].get_allocator().resource(), &resource);
+}
+
+TEST(ProtobufTest, ReadWhatOtherEncodersWrite) {
+	// Unpacked repeated numbers, unknown fields of every wire type, a scalar given twice and a
+	// message given in two parts, which are merged
+	std::string bytes = std::string("\x20\x01\x20\x02")
+		+ "\x08\x01"
+		+ "\xf8\x01\x05" "\xf9\x01" + std::string(8, '\0') + "\xfa\x01\x01x" "\xfd\x01" + std::string(4, '\0')
+		+ "\xfb\x01" "\x08\x01" "\xfb\x01\xfc\x01" "\xfc\x01"
+		+ "\x1a\x02\x08\x07"
+		+ "\x08\x02"
+		+ std::string("\x1a\x00", 2)
+		+ "\x22\x01\x03";
+
+	ProtobufSample sample;
+	sample.b = "stale";
+	rapidjson_util::unmarshal_protobuf(toBytes(bytes), sample);
+
+	ASSERT_EQ(sample.a, 2);
+	ASSERT_EQ(sample.b, "");
+	ASSERT_EQ(sample.c.a, 7);
+	ASSERT_THAT(sample.d, testing::ElementsAre(1, 2, 3));
+	ASSERT_FALSE(sample.i.has_value());
+
+	// A google.protobuf.Timestamp of 1.5 seconds before the epoch
+	ProtobufShipment shipment;
+	rapidjson_util::unmarshal_protobuf(toBytes("\x6a\x11\x08\xfe\xff\xff\xff\xff\xff\xff\xff\xff\x01\x10\x80\xca\xb5\xee\x01"), shipment);
+	ASSERT_EQ(shipment.shipped, std::chrono::system_clock::time_point(std::chrono::milliseconds(-1500)));
+}
+
+TEST(ProtobufTest, ThrowWhenDataIsMalformed) {
+	auto expectFailure = [](const std::string& bytes, const std::string& message) {
+		ProtobufShipment shipment;
+		try {
+			rapidjson_util::unmarshal_protobuf(toBytes(bytes), shipment);
+			FAIL() << "Expected an exception for " << message;
+		}
+		catch (std::logic_error& e) {
+			EXPECT_EQ(std::string(e.what()), message);
+		}
+	};
+
+	expectFailure("\x0a", "Deserialization of member \"id\" failed: Protobuf data is truncated at offset 1");
+	expectFailure("\x0a\x05" "abc", "Deserialization of member \"id\" failed: Length 5 at offset 1 exceeds the data");
+	expectFailure("\x0a\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\x01", "Deserialization of member \"id\" failed: Varint at offset 1 "
+	              "is longer than 10 bytes");
+	expectFailure(std::string("\x00", 1), "Invalid field number 0 at offset 1");
+	expectFailure("\x08\x01", "Deserialization of member \"id\" failed: Expected wire type LEN, got VARINT");
+	expectFailure("\x12\x09" "ACME-LONG", "Deserialization of member \"carrier\" failed: String length mismatch: protobuf data "
+	              "contains 9 characters, but given string has fixed capacity of 8 characters.");
+	expectFailure("\x80\x01\x80\x02", "Deserialization of member \"grade\" failed: Value 256 is out of range for Int8");
+	expectFailure("\x3a\x04" + std::string(4, '\0'), "Deserialization of member \"corner\" failed: Array size mismatch: JSON "
+	              "contains 1 elements, but given array has fixed capacity of 3 elements and cannot be resized.");
+	expectFailure("\x3a\x10" + std::string(16, '\0'), "Deserialization of member \"corner\" failed: Array size mismatch: JSON "
+	              "contains 4 elements, but given array has fixed capacity of 3 elements and cannot be resized.");
+	expectFailure("\x32\x05" + std::string(5, '\0'), "Deserialization of member \"route\" failed: Packed field of 5 bytes "
+	              "doesn't hold whole Double elements");
+	expectFailure("\x6a\x0b\x10\xff\xff\xff\xff\xff\xff\xff\xff\xff\x01", "Deserialization of member \"shipped\" failed: "
+	              "Nanoseconds -1 out of range");
+	expectFailure("\x62\x06\x10\x80\x94\xeb\xdc\x03", "Deserialization of member \"transit\" failed: Nanoseconds 1000000000 "
+	              "out of range");
+	expectFailure("\x62\x0a\x08\xff\xff\xff\xff\xff\xff\xff\xff\x7f", "Deserialization of member \"transit\" failed: Time of "
+	              "9223372036854775807 seconds and 0 nanoseconds doesn't fit the member type");
+	expectFailure("\xf3\x01\xf4\x02", "Group 30 ends with field 46 at offset 4");
+	expectFailure("\xfb\x01\x08\x01\xfc\x02", "Group 31 ends with field 47 at offset 6");
+	expectFailure("\xf4\x01", "Unexpected wire type EGROUP of field 30 at offset 2");
+	expectFailure(std::string("\x5a\x00" "\x5a\x05\x0d", 5) + std::string(4, '\0'), "Deserialization of member \"parcels\" failed: Deserialization of member "
+	              "\"label\" failed: Expected wire type LEN, got I32");
+
+	// Parcels nested far deeper than any real shipment
+	auto embed = [](char tag, const std::string& message) {
+		std::string bytes(1, tag);
+		for (std::size_t length = message.size(); ; length >>= 7) {
+			bytes += static_cast<char>(length < 0x80 ? length : (length & 0x7f) | 0x80);
+			if (length < 0x80)
+				break;
+		}
+		return bytes + message;
+	};
+
+	std::string deep;
+	for (int i = 0; i < 200; ++i)
+		deep = embed('\x1a', deep);
+
+	try {
+		ProtobufShipment shipment;
+		rapidjson_util::unmarshal_protobuf(toBytes(embed('\x5a', deep)), shipment);
+		FAIL() << "Expected an exception for deep nesting";
+	}
+	catch (rapidjson_util::MemberSerializationFailure& e) {
+		ASSERT_THAT(e.what(), testing::HasSubstr("Protobuf data nests deeper than 100 levels"));
+	}
+}
@@ -2,6 +2,10 @@
 #include <regex>
 #include <sstream>
 #include <iomanip>
+#include <deque>
+#include <functional>
+#include <string_view>
+#include <chrono>
 #include "gmock/gmock.h"
 
 #include "rapid_util/rapid_util.h"
@@ -444,4 +448,811 @@ TEST(RapidMarshalTest, SerializeHeterogeneousArrayWithOptionalWhenPopulated) {
                     })";
 
 	ASSERT_JSON_STREQ(actual, expect);
-}
\ No newline at end of file
+}
+
+struct Circle {
+	double radius;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Circle, (radius))
+
+struct Rectangle {
+	double width;
+	double height;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Rectangle, (width, height))
+
+using Shape = std::variant<Circle, Rectangle>;
+
+struct Drawing {
+	std::string name;
+	Shape shape;
+	std::optional<Shape> background;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Drawing, (name, shape, background))
+
+TEST(RapidMarshalTest, SerializeVariantWithExternalTag) {
+	Drawing drawing{ "wheel", Circle{ 1.5 }, Rectangle{ 4.0, 3.0 } };
+
+	auto actual = rapidjson_util::marshal(drawing);
+
+	auto expect = R"({
+                      "name" : "wheel",
+                      "shape" : { "Circle" : { "radius" : 1.5 } },
+                      "background" : { "Rectangle" : { "width" : 4.0, "height" : 3.0 } }
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+TEST(RapidMarshalTest, SerializeVariantWithOptionalWhenNull) {
+	Drawing drawing{ "door", Rectangle{ 0.8, 2.0 }, std::nullopt };
+
+	auto actual = rapidjson_util::marshal(drawing);
+
+	auto expect = R"({
+                      "name" : "door",
+                      "shape" : { "Rectangle" : { "width" : 0.8, "height" : 2.0 } },
+                      "background" : null
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+struct LoginEvent {
+	std::string user;
+	bool remembered;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(LoginEvent, (user, remembered))
+
+struct LogoutEvent {
+	std::string user;
+	int sessionSeconds;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(LogoutEvent, (user, sessionSeconds))
+
+constexpr char sessionEventKind[] = "kind";
+using SessionEvent = rapidjson_util::internally_tagged<std::variant<LoginEvent, LogoutEvent>, sessionEventKind>;
+
+struct AuditRecord {
+	int64_t sequence;
+	SessionEvent event;
+	std::variant<LoginEvent, LogoutEvent> cause;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(AuditRecord, (sequence, event, cause))
+
+TEST(RapidMarshalTest, SerializeVariantWithDiscriminatorField) {
+	AuditRecord record{ 7, LogoutEvent{ "liu", 3600 }, LoginEvent{ "liu", true } };
+
+	auto actual = rapidjson_util::marshal(record);
+
+	auto expect = R"({
+                      "sequence" : 7,
+                      "event" : { "kind" : "LogoutEvent", "user" : "liu", "sessionSeconds" : 3600 },
+                      "cause" : { "LoginEvent" : { "user" : "liu", "remembered" : true } }
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+TEST(RapidMarshalTest, RejectDiscriminatorNamingAMemberOfAnAlternative) {
+	using rapidjson_util::detail::isMemberOfAlternative;
+
+	static_assert(!isMemberOfAlternative("kind", static_cast<const SessionEvent*>(nullptr)));
+	static_assert(isMemberOfAlternative("user", static_cast<const SessionEvent*>(nullptr)));
+	static_assert(isMemberOfAlternative("sessionSeconds", static_cast<const SessionEvent*>(nullptr)));
+}
+
+// Not trivially copyable, so a failed emplace leaves the variant valueless rather than unchanged
+struct FragileShape {
+	int sides = 0;
+
+	FragileShape() = default;
+	FragileShape(const FragileShape& other) : sides(other.sides) {}
+	explicit FragileShape(bool fail) {
+		if (fail)
+			throw std::runtime_error("FragileShape failed to construct");
+	}
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(FragileShape, (sides))
+
+struct FragileDrawing {
+	std::variant<Circle, FragileShape> shape;
+	std::optional<std::variant<Circle, FragileShape>> background;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(FragileDrawing, (shape, background))
+
+TEST(RapidMarshalTest, ThrowForVariantValuelessByException) {
+	FragileDrawing drawing{ Circle{ 1.5 }, Circle{ 2.5 } };
+	EXPECT_THROW(drawing.shape.emplace<FragileShape>(true), std::runtime_error);
+	ASSERT_TRUE(drawing.shape.valueless_by_exception());
+
+	ASSERT_THROW(rapidjson_util::marshal(drawing), rapidjson_util::UnserializableValueException);
+
+	drawing.shape = Circle{ 1.5 };
+	EXPECT_THROW(drawing.background->emplace<FragileShape>(true), std::runtime_error);
+
+	ASSERT_THROW(rapidjson_util::marshal(drawing), rapidjson_util::UnserializableValueException);
+}
+
+
+struct Thumbnail {
+	int width;
+	int height;
+	std::string url;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Thumbnail, (width, height, url))
+
+struct Photo {
+	std::string title;
+	std::unique_ptr<Thumbnail> thumbnail;
+	std::shared_ptr<std::string> caption;
+	std::unique_ptr<std::vector<int>> tags;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Photo, (title, thumbnail, caption, tags))
+
+TEST(RapidMarshalTest, SerializeSmartPointersWhenNull) {
+	Photo photo{ "sunset", nullptr, nullptr, nullptr };
+
+	auto actual = rapidjson_util::marshal(photo);
+
+	auto expect = R"({
+                      "title" : "sunset",
+                      "thumbnail" : null,
+                      "caption" : null,
+                      "tags" : null
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+TEST(RapidMarshalTest, SerializeSmartPointersWhenPopulated) {
+	Photo photo{ "sunrise",
+		         std::make_unique<Thumbnail>(Thumbnail{ 64, 48, "/t/1.png" }),
+		         std::make_shared<std::string>("Over the sea"),
+		         std::make_unique<std::vector<int>>(std::vector<int>{ 3, 5 }) };
+
+	auto actual = rapidjson_util::marshal(photo);
+
+	auto expect = R"({
+                      "title" : "sunrise",
+                      "thumbnail" : { "width" : 64, "height" : 48, "url" : "/t/1.png" },
+                      "caption" : "Over the sea",
+                      "tags" : [3, 5]
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+struct Directory {
+	std::string name;
+	std::vector<std::unique_ptr<Directory>> children;
+	std::shared_ptr<Directory> link;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Directory, (name, children, link))
+
+TEST(RapidMarshalTest, SerializeRecursiveStructThroughSmartPointers) {
+	Directory root{ "/", {}, nullptr };
+	root.children.push_back(std::make_unique<Directory>(Directory{ "usr", {}, nullptr }));
+	root.children.push_back(nullptr);
+	root.link = std::make_shared<Directory>(Directory{ "home", {}, nullptr });
+
+	auto actual = rapidjson_util::marshal(root);
+
+	auto expect = R"({
+                      "name" : "/",
+                      "children" : [ { "name" : "usr", "children" : [], "link" : null }, null ],
+                      "link" : { "name" : "home", "children" : [], "link" : null }
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+struct SeriesSnapshot {
+	std::array<std::array<float, 3>, 2> transform;
+	std::vector<std::vector<double>> rows;
+	std::vector<std::array<int, 2>> points;
+	std::vector<std::tuple<std::string, std::vector<int>>> labels;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SeriesSnapshot, (transform, rows, points, labels))
+
+TEST(RapidMarshalTest, SerializeNestedContainers) {
+	SeriesSnapshot snapshot{ {{ { 1.5f, 0.0f, 2.0f }, { 0.0f, 1.5f, -1.0f } }},
+	                         { { 0.5, 1.25 }, {}, { 3.0 } },
+	                         { { 1, 2 }, { 3, 4 } },
+	                         { { "low", { 1, 2 } }, { "high", {} } } };
+
+	auto actual = rapidjson_util::marshal(snapshot);
+
+	auto expect = R"({
+                      "transform" : [[1.5, 0.0, 2.0], [0.0, 1.5, -1.0]],
+                      "rows" : [[0.5, 1.25], [], [3.0]],
+                      "points" : [[1, 2], [3, 4]],
+                      "labels" : [["low", [1, 2]], ["high", []]]
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+struct PortCounters {
+	int8_t temperature;
+	int16_t offset;
+	int32_t balance;
+	int64_t total;
+	uint8_t flags;
+	uint16_t port;
+	uint32_t packets;
+	uint64_t bytes;
+	std::optional<uint16_t> vlan;
+	std::vector<uint8_t> mask;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(PortCounters, (temperature, offset, balance, total, flags, port, packets, bytes, vlan, mask))
+
+TEST(RapidMarshalTest, SerializeFixedWidthIntegers) {
+	PortCounters counters{ -128, -32768, -2147483647 - 1, -9223372036854775807LL - 1,
+	                       255, 65535, 4294967295U, 18446744073709551615ULL, 100, { 255, 0, 7 } };
+
+	auto actual = rapidjson_util::marshal(counters);
+
+	auto expect = R"({
+                      "temperature" : -128,
+                      "offset" : -32768,
+                      "balance" : -2147483648,
+                      "total" : -9223372036854775808,
+                      "flags" : 255,
+                      "port" : 65535,
+                      "packets" : 4294967295,
+                      "bytes" : 18446744073709551615,
+                      "vlan" : 100,
+                      "mask" : [255, 0, 7]
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+struct LedgerTotals {
+	long long balance;
+	unsigned long long turnover;
+	std::optional<long long> adjustment;
+	std::vector<unsigned long long> volumes;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(LedgerTotals, (balance, turnover, adjustment, volumes))
+
+TEST(RapidMarshalTest, SerializeLongLongIntegers) {
+	LedgerTotals totals{ -9223372036854775807LL - 1, 18446744073709551615ULL, -5, { 0, 18446744073709551615ULL } };
+
+	auto actual = rapidjson_util::marshal(totals);
+
+	auto expect = R"({
+                      "balance" : -9223372036854775808,
+                      "turnover" : 18446744073709551615,
+                      "adjustment" : -5,
+                      "volumes" : [0, 18446744073709551615]
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+struct OrderTicket {
+	char symbol[8];
+	std::array<char, 4> venue;
+	rapidjson_util::fixed_string<12> clientId;
+	std::optional<rapidjson_util::fixed_string<6>> note;
+	std::vector<rapidjson_util::fixed_string<3>> flags;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(OrderTicket, (symbol, venue, clientId, note, flags))
+
+TEST(RapidMarshalTest, SerializeInlineStrings) {
+	OrderTicket ticket{ "MSFT", { 'X', 'N', 'A', 'S' }, "c-42", std::nullopt, { "ioc", "aon" } };
+
+	auto actual = rapidjson_util::marshal(ticket);
+
+	auto expect = R"({
+                      "symbol" : "MSFT",
+                      "venue" : "XNAS",
+                      "clientId" : "c-42",
+                      "note" : null,
+                      "flags" : ["ioc", "aon"]
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+struct FillReport {
+	rapidjson_util::static_vector<double, 4> prices;
+	rapidjson_util::small_vector<std::string, 2> venues;
+	std::deque<int> sequenceNumbers;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(FillReport, (prices, venues, sequenceNumbers))
+
+TEST(RapidMarshalTest, SerializeFixedCapacityAndSmallVectors) {
+	FillReport report{ { 101.5, 101.75 }, { "XNAS", "ARCX", "BATS" }, { 7, 8 } };
+
+	auto actual = rapidjson_util::marshal(report);
+
+	auto expect = R"({
+                      "prices" : [101.5, 101.75],
+                      "venues" : ["XNAS", "ARCX", "BATS"],
+                      "sequenceNumbers" : [7, 8]
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+struct FrameSummary {
+	std::string_view source;
+	std::reference_wrapper<const Address> origin;
+	std::vector<std::string_view> labels;
+#if defined(__cpp_lib_span)
+	std::span<const double> samples;
+	std::span<const Address> hops;
+#endif
+};
+
+#if defined(__cpp_lib_span)
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(FrameSummary, (source, origin, labels, samples, hops))
+#else
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(FrameSummary, (source, origin, labels))
+#endif
+
+TEST(RapidMarshalTest, SerializeViewsOfExternalMemory) {
+	const char ringBuffer[] = "sensor-7|spare bytes";
+	Address home{ "Main St", "Springfield", 12345 };
+	FrameSummary summary{ std::string_view(ringBuffer, 8), std::cref(home), { "raw", "filtered" } };
+#if defined(__cpp_lib_span)
+	std::array<double, 3> readings{ 0.5, 1.5, 2.5 };
+	summary.samples = readings;
+	summary.hops = std::span<const Address>(&home, 1);
+#endif
+
+	auto actual = rapidjson_util::marshal(summary);
+
+	std::string expect = R"({
+                      "source" : "sensor-7",
+                      "origin" : { "street" : "Main St", "city" : "Springfield", "zipCode" : 12345 },
+                      "labels" : ["raw", "filtered"])";
+#if defined(__cpp_lib_span)
+	expect += R"(,
+                      "samples" : [0.5, 1.5, 2.5],
+                      "hops" : [{ "street" : "Main St", "city" : "Springfield", "zipCode" : 12345 }])";
+#endif
+	expect += "}";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+// Written through a view of no characters when it is empty
+struct Annotation {
+	std::string text;
+};
+
+template<>
+struct rapidjson_util::json_codec<Annotation> {
+	static void write(JsonValueWriter& writer, const Annotation& annotation) {
+		writer.writeString(annotation.text.empty() ? std::string_view{} : std::string_view(annotation.text));
+	}
+
+	static void read(JsonValueReader& reader, Annotation& annotation) {
+		annotation.text = reader.readString();
+	}
+};
+
+struct EmptyFrame {
+	std::string_view source;
+	std::vector<std::string_view> labels;
+	Annotation note;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(EmptyFrame, (source, labels, note))
+
+TEST(RapidMarshalTest, SerializeEmptyViews) {
+	EmptyFrame frame{ std::string_view{}, { std::string_view{}, "raw" }, {} };
+
+	auto actual = rapidjson_util::marshal(frame);
+
+	auto expect = R"({
+                      "source" : "",
+                      "labels" : ["", "raw"],
+                      "note" : ""
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+using EpochMillis = rapidjson_util::chrono_as<rapidjson_util::ChronoEncoding::Milliseconds, std::chrono::system_clock::time_point>;
+
+struct AuditEvent {
+	std::chrono::system_clock::time_point occurredAt;
+	std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds> recordedAt;
+	EpochMillis receivedAt;
+	std::chrono::milliseconds latency;
+	std::optional<std::chrono::system_clock::time_point> acknowledgedAt;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(AuditEvent, (occurredAt, recordedAt, receivedAt, latency, acknowledgedAt))
+
+TEST(RapidMarshalTest, SerializeChronoTimePointsAndDurations) {
+	using namespace std::chrono;
+
+	const system_clock::time_point morning{ seconds(1705314600) };   // 2024-01-15T10:30:00Z
+	AuditEvent event{ morning + nanoseconds(123456789), time_point_cast<seconds>(morning - seconds(1706)),
+	                  EpochMillis(milliseconds(1705314600250) + microseconds(999)), milliseconds(42), std::nullopt };
+
+	auto actual = rapidjson_util::marshal(event);
+
+	auto expect = R"({
+                      "occurredAt" : "2024-01-15T10:30:00.123456789Z",
+                      "recordedAt" : "2024-01-15T10:01:34Z",
+                      "receivedAt" : 1705314600250,
+                      "latency" : 42,
+                      "acknowledgedAt" : null
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+TEST(RapidMarshalTest, ThrowForTimePointOutsideRfc3339Years) {
+	using namespace std::chrono;
+
+	AuditEvent event{ system_clock::time_point{}, {}, EpochMillis{}, milliseconds(0), std::nullopt };
+
+	event.recordedAt = time_point<system_clock, seconds>(seconds(-62167219200));    // 0000-01-01T00:00:00Z
+	ASSERT_THAT(rapidjson_util::marshal(event), testing::HasSubstr(R"("recordedAt":"0000-01-01T00:00:00Z")"));
+
+	event.recordedAt = time_point<system_clock, seconds>(seconds(253402300799));    // 9999-12-31T23:59:59Z
+	ASSERT_THAT(rapidjson_util::marshal(event), testing::HasSubstr(R"("recordedAt":"9999-12-31T23:59:59Z")"));
+
+	event.recordedAt = time_point<system_clock, seconds>(seconds(-62167219201));
+	ASSERT_THROW(rapidjson_util::marshal(event), rapidjson_util::UnserializableValueException);
+
+	event.recordedAt = time_point<system_clock, seconds>(seconds(253402300800));
+	ASSERT_THROW(rapidjson_util::marshal(event), rapidjson_util::UnserializableValueException);
+}
+
+struct Attachment {
+	rapidjson_util::bytes thumbnail;
+	rapidjson_util::hex_bytes digest;
+	std::vector<std::byte> signature;
+	std::optional<rapidjson_util::basic_bytes<rapidjson_util::BinaryEncoding::Base64, uint8_t>> preview;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Attachment, (thumbnail, digest, signature, preview))
+
+TEST(RapidMarshalTest, SerializeBinaryDataAsBase64AndHex) {
+	Attachment attachment;
+	for (int i = 0; i < 40; ++i) {
+		attachment.thumbnail.push_back(std::byte(i));
+		attachment.digest.push_back(std::byte(i));
+	}
+	attachment.signature = { std::byte(0xde), std::byte(0xad), std::byte(0xbe), std::byte(0xef) };
+
+	auto actual = rapidjson_util::marshal(attachment);
+
+	auto expect = R"({
+                      "thumbnail" : "AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8gISIjJCUmJw==",
+                      "digest" : "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f2021222324252627",
+                      "signature" : "3q2+7w==",
+                      "preview" : null
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+// Fixed-point amount in cents, written as a decimal string to keep it exact
+struct Price {
+	int64_t cents;
+};
+
+struct Ipv4Address {
+	uint32_t address;
+};
+
+template<>
+struct rapidjson_util::json_codec<Price> {
+	static void write(JsonValueWriter& writer, const Price& price) {
+		std::ostringstream out;
+		out << price.cents / 100 << '.' << std::setw(2) << std::setfill('0') << price.cents % 100;
+		writer.writeString(out.str());
+	}
+
+	static void read(JsonValueReader& reader, Price& price) {
+		std::string text(reader.readString());
+		auto separator = text.find('.');
+		price.cents = std::stoll(text.substr(0, separator)) * 100 + std::stoll(text.substr(separator + 1));
+	}
+};
+
+template<>
+struct rapidjson_util::json_codec<Ipv4Address> {
+	static void write(JsonValueWriter& writer, const Ipv4Address& ip) {
+		std::ostringstream out;
+		out << (ip.address >> 24) << '.' << (ip.address >> 16 & 0xff) << '.' << (ip.address >> 8 & 0xff) << '.' << (ip.address & 0xff);
+		writer.writeString(out.str());
+	}
+
+	static void read(JsonValueReader& reader, Ipv4Address& ip) {
+		ip.address = reader.readInteger<uint32_t>();
+	}
+};
+
+struct MarketTick {
+	Price last;
+	std::optional<Price> limit;
+	std::optional<Price> stop;
+	std::vector<Price> depth;
+	Ipv4Address venue;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MarketTick, (last, limit, stop, depth, venue))
+
+TEST(RapidMarshalTest, SerializeMembersThroughUserDefinedCodecs) {
+	MarketTick tick { { 1234 }, Price { 1205 }, std::nullopt, { { 1233 }, { 1232 }, { 1230 } }, { 0x0a000001 } };
+
+	auto actual = rapidjson_util::marshal(tick);
+
+	auto expect = R"({
+                      "last" : "12.34",
+                      "limit" : "12.05",
+                      "stop" : null,
+                      "depth" : [ "12.33", "12.32", "12.30" ],
+                      "venue" : "10.0.0.1"
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+}
+
+struct SkuDimensions {
+	double width;
+	double height;
+};
+
+struct SkuRow {
+	std::string productId;
+	double price;
+	std::optional<int> quantity;
+	SkuDimensions dimensions;
+};
+
+using SkuTable = rapidjson_util::columnar<std::vector<SkuRow>>;
+using SkuShelf = rapidjson_util::columnar<std::array<SkuRow, 2>>;
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SkuDimensions, (width, height))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SkuRow, (productId, price, quantity, dimensions))
+
+struct StockReport {
+	SkuTable skus;
+	SkuShelf shelf;
+	std::optional<SkuTable> returns;
+	std::deque<SkuRow> history;
+	std::vector<SkuRow> pending;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(StockReport, (skus, shelf, returns, history, pending))
+
+TEST(RapidMarshalTest, SerializeContainersOfStructsAsColumns) {
+	StockReport report;
+	report.skus = { { "P1", 9.5, 3, { 1, 2 } }, { "P2", 3.0, std::nullopt, { 4, 5 } } };
+	report.shelf = std::array<SkuRow, 2> { SkuRow { "S1", 1.0, 1, { 0, 0 } }, SkuRow { "S2", 2.0, 2, { 0, 0 } } };
+	report.history = { { "H1", 0.5, 7, { 1, 1 } } };
+	report.pending = { { "Q1", 1.5, 2, { 3, 3 } } };
+
+	auto actual = rapidjson_util::marshal(report);
+
+	auto expect = R"({
+                      "skus" : {
+                          "productId" : [ "P1", "P2" ],
+                          "price" : [ 9.5, 3.0 ],
+                          "quantity" : [ 3, null ],
+                          "dimensions" : [ { "width" : 1.0, "height" : 2.0 }, { "width" : 4.0, "height" : 5.0 } ]
+                      },
+                      "shelf" : {
+                          "productId" : [ "S1", "S2" ],
+                          "price" : [ 1.0, 2.0 ],
+                          "quantity" : [ 1, 2 ],
+                          "dimensions" : [ { "width" : 0.0, "height" : 0.0 }, { "width" : 0.0, "height" : 0.0 } ]
+                      },
+                      "returns" : null,
+                      "history" : [ { "productId" : "H1", "price" : 0.5, "quantity" : 7, "dimensions" : { "width" : 1.0, "height" : 1.0 } } ],
+                      "pending" : [ { "productId" : "Q1", "price" : 1.5, "quantity" : 2, "dimensions" : { "width" : 3.0, "height" : 3.0 } } ]
+                    })";
+
+	ASSERT_JSON_STREQ(actual, expect);
+
+	report.skus.clear();
+	report.returns = SkuTable {};
+
+	actual = rapidjson_util::marshal(report);
+	ASSERT_THAT(actual, testing::HasSubstr(R"("skus":{"productId":[],"price":[],"quantity":[],"dimensions":[]})"));
+	ASSERT_THAT(actual, testing::HasSubstr(R"("returns":{"productId":[],"price":[],"quantity":[],"dimensions":[]})"));
+}
+
+
+enum class QuoteSide { Bid, Ask };
+
+struct QuoteVenue {
+	std::string mic;
+	int lot = 100;
+};
+
+struct CompactQuote {
+	std::string symbol;
+	double price;
+	int64_t size;
+	QuoteSide side;
+	std::optional<std::string> note;
+	std::vector<int> fills;
+	rapidjson_util::fixed_string<4> currency;
+	QuoteVenue venue;
+	std::unique_ptr<QuoteVenue> backup;
+	int retries = 3;
+};
+
+struct TerseQuote {
+	std::string symbol;
+	std::optional<double> bid;
+	std::optional<double> ask;
+	int level = 0;
+};
+
+template<>
+struct rapidjson_util::json_codec<QuoteSide> {
+	static void write(JsonValueWriter& writer, QuoteSide side) { writer.writeString(side == QuoteSide::Bid ? "B" : "A"); }
+	static void read(JsonValueReader& reader, QuoteSide& side) { side = reader.readString() == "B" ? QuoteSide::Bid : QuoteSide::Ask; }
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(QuoteVenue, (mic, lot))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CompactQuote, (symbol, price, size, side, note, fills, currency, venue, backup, retries))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(TerseQuote, (symbol, bid, ask, level))
+RAPIDJSON_UTIL_DESCRIBE_OMISSION(TerseQuote, Nulls)
+RAPIDJSON_UTIL_DESCRIBE_WIRE_NAMES(TerseQuote, (symbol, "s"), (bid, "b"), (ask, "a"))
+
+TEST(RapidMarshalTest, OmitNullAndDefaultMembers) {
+	CompactQuote quote{ "", 0.0, 0, QuoteSide::Bid, std::nullopt, {}, {}, { "", 100 }, nullptr, 3 };
+
+	ASSERT_EQ(rapidjson_util::marshal(quote), R"({"symbol":"","price":0.0,"size":0,"side":"B","note":null,"fills":[],"currency":"",)"
+	                                          R"("venue":{"mic":"","lot":100},"backup":null,"retries":3})");
+	ASSERT_EQ(rapidjson_util::marshal(quote, rapidjson_util::Omission::Nulls), R"({"symbol":"","price":0.0,"size":0,"side":"B","fills":[],"currency":"",)"
+	                                                           R"("venue":{"mic":"","lot":100},"retries":3})");
+
+	// Nested structs are always written, but their members are omitted too
+	ASSERT_EQ(rapidjson_util::marshal(quote, rapidjson_util::Omission::Defaults), R"({"venue":{}})");
+
+	quote = CompactQuote{ "SAP", 171.25, 40, QuoteSide::Ask, "odd lot", { 10, 30 }, "EUR", { "XETR", 50 }, std::make_unique<QuoteVenue>(), 0 };
+	ASSERT_EQ(rapidjson_util::marshal(quote, rapidjson_util::Omission::Defaults), R"({"symbol":"SAP","price":171.25,"size":40,"side":"A","note":"odd lot",)"
+	                                                              R"("fills":[10,30],"currency":"EUR","venue":{"mic":"XETR","lot":50},)"
+	                                                              R"("backup":{},"retries":0})");
+}
+
+TEST(RapidMarshalTest, WriteNegativeZeroUnderDefaults) {
+	CompactQuote quote{ "", -0.0, 0, QuoteSide::Bid, std::nullopt, {}, {}, { "", 100 }, nullptr, 3 };
+
+	// -0.0 equals the 0.0 of a value-initialized struct, but isn't read back as such when left out
+	ASSERT_EQ(rapidjson_util::marshal(quote, rapidjson_util::Omission::Defaults), R"({"price":-0.0,"venue":{}})");
+}
+
+TEST(RapidMarshalTest, SerializeWithTypeOmissionAndWireNames) {
+	TerseQuote quote{ "AAPL", 189.5, std::nullopt, 0 };
+
+	// The style of the type takes precedence over that of the call
+	ASSERT_EQ(rapidjson_util::marshal(quote), R"({"s":"AAPL","b":189.5,"level":0})");
+	ASSERT_EQ(rapidjson_util::marshal(quote, rapidjson_util::Omission::Defaults), R"({"s":"AAPL","b":189.5,"level":0})");
+}
+
+
+struct AccountProfile {
+	std::string login;
+	std::string email;
+	std::string passwordHash;
+	int age;
+	std::optional<std::string> bio;
+	QuoteVenue venue;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(AccountProfile, (login, email, passwordHash, age, bio, venue))
+RAPIDJSON_UTIL_DESCRIBE_VIEW(AccountProfile, PublicProfile, (login, bio))
+RAPIDJSON_UTIL_DESCRIBE_VIEW(AccountProfile, AdminProfile, (email, login, age, venue))
+RAPIDJSON_UTIL_DESCRIBE_VIEW(TerseQuote, TerseQuoteBid, (symbol, bid))
+
+TEST(RapidMarshalTest, SerializeViews) {
+	AccountProfile profile{ "jdoe", "jdoe@example.com", "5f4dcc3b", 42, std::nullopt, { "XNAS", 10 } };
+
+	ASSERT_EQ(rapidjson_util::marshal<PublicProfile>(profile), R"({"login":"jdoe","bio":null})");
+
+	// Members are written in the order of the view, nested structs with all of theirs
+	ASSERT_EQ(rapidjson_util::marshal<AdminProfile>(profile), R"({"email":"jdoe@example.com","login":"jdoe","age":42,"venue":{"mic":"XNAS","lot":10}})");
+	ASSERT_EQ(rapidjson_util::marshal(profile), R"({"login":"jdoe","email":"jdoe@example.com","passwordHash":"5f4dcc3b","age":42,)"
+	                                            R"("bio":null,"venue":{"mic":"XNAS","lot":10}})");
+
+	// Views keep the wire names and the omission of the struct
+	TerseQuote quote{ "AAPL", std::nullopt, 190.0, 2 };
+	ASSERT_EQ(rapidjson_util::marshal<TerseQuoteBid>(quote), R"({"s":"AAPL"})");
+
+	static_assert(rapidjson_util::marshal_view<PublicProfile>::is_described);
+	static_assert(!rapidjson_util::marshal_view<AccountProfile>::is_described);
+}
+
+
+struct MaskedAddress {
+	std::string street;
+	std::string city;
+	int zipCode;
+};
+
+struct MaskedLine {
+	std::string sku;
+	int quantity;
+	double price;
+};
+
+struct MaskedOrder {
+	std::string id;
+	MaskedAddress shipTo;
+	std::optional<MaskedAddress> billTo;
+	std::vector<MaskedLine> lines;
+	std::vector<std::unique_ptr<MaskedLine>> returns;
+	std::string note;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MaskedAddress, (street, city, zipCode))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MaskedLine, (sku, quantity, price))
+RAPIDJSON_UTIL_DESCRIBE_WIRE_NAMES(MaskedLine, (quantity, "qty"))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MaskedOrder, (id, shipTo, billTo, lines, returns, note))
+
+TEST(RapidMarshalTest, SerializeWithFieldMask) {
+	MaskedOrder order{ "O-17", { "1 Rue de Rivoli", "Paris", 75001 }, std::nullopt, { { "A-1", 2, 9.5 }, { "B-2", 1, 29.5 } }, {}, "leave at door" };
+	order.returns.push_back(std::make_unique<MaskedLine>(MaskedLine{ "A-1", 1, 9.5 }));
+	order.returns.push_back(nullptr);
+
+	// Members are written in the order they are described, not in the order of the paths
+	rapidjson_util::FieldMask<MaskedOrder> mask{ "lines.sku", "shipTo.city", "id", "lines.qty" };
+	ASSERT_EQ(rapidjson_util::marshal(order, mask), R"({"id":"O-17","shipTo":{"city":"Paris"},"lines":[{"sku":"A-1","qty":2},{"sku":"B-2","qty":1}]})");
+
+	rapidjson_util::FieldMask<MaskedOrder> nullableMask{ "billTo.zipCode", "returns.price" };
+	ASSERT_EQ(rapidjson_util::marshal(order, nullableMask), R"({"billTo":null,"returns":[{"price":9.5},null]})");
+	order.billTo = MaskedAddress{ "5 Avenue Anatole", "Paris", 75007 };
+	ASSERT_EQ(rapidjson_util::marshal(order, nullableMask), R"({"billTo":{"zipCode":75007},"returns":[{"price":9.5},null]})");
+
+	// A member selected whole wins over the paths into it, whichever comes first
+	rapidjson_util::FieldMask<MaskedOrder> wholeMask{ "shipTo.city", "shipTo" };
+	ASSERT_EQ(rapidjson_util::marshal(order, wholeMask), R"({"shipTo":{"street":"1 Rue de Rivoli","city":"Paris","zipCode":75001}})");
+	ASSERT_EQ(rapidjson_util::marshal(order, rapidjson_util::FieldMask<MaskedOrder>{ "shipTo", "shipTo.city" }), rapidjson_util::marshal(order, wholeMask));
+
+	const std::vector<std::string> paths = { "note", "lines.price" };
+	ASSERT_EQ(rapidjson_util::marshal(order, rapidjson_util::FieldMask<MaskedOrder>(paths)), R"({"lines":[{"price":9.5},{"price":29.5}],"note":"leave at door"})");
+	ASSERT_EQ(rapidjson_util::marshal(order, rapidjson_util::FieldMask<MaskedOrder>{}), "{}");
+}
+
+TEST(RapidMarshalTest, RejectInvalidFieldPaths) {
+	using OrderMask = rapidjson_util::FieldMask<MaskedOrder>;
+
+	ASSERT_THROW(OrderMask{ "shipTo.country" }, rapidjson_util::InvalidFieldPathException);
+	ASSERT_THROW(OrderMask{ "note.length" }, rapidjson_util::InvalidFieldPathException);
+	ASSERT_THROW(OrderMask{ "shipTo." }, rapidjson_util::InvalidFieldPathException);
+	ASSERT_THROW(OrderMask{ "" }, rapidjson_util::InvalidFieldPathException);
+
+	// Members are named by their wire names
+	ASSERT_THROW(OrderMask{ "lines.quantity" }, rapidjson_util::InvalidFieldPathException);
+
+	try {
+		OrderMask{ "id", "shipTo.country" };
+		FAIL() << "Expected InvalidFieldPathException";
+	}
+	catch (const rapidjson_util::InvalidFieldPathException& e) {
+		ASSERT_STREQ(e.what(), R"(Expected a member of MaskedAddress in field path "shipTo.country", got "country")");
+	}
+}
@@ -1,5 +1,9 @@
 #include "gmock/gmock.h"
 #include "rapid_util/rapid_util.h"
+#include <cmath>
+#include <cstring>
+#include <memory_resource>
+#include <chrono>
 
 struct PrimitiveFields {
 	int IntNumber;
@@ -641,3 +645,1021 @@ TEST(RAPID_UNMARSHAL_TEST, ThrowWhenJsonArraySizeMismatchesTupleSize) {
 	}
 }
 
+
+
+struct Deposit {
+	std::string account;
+	uint64_t cents;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Deposit, (account, cents))
+
+struct Withdrawal {
+	std::string account;
+	uint64_t cents;
+	std::optional<std::string> atm;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Withdrawal, (account, cents, atm))
+
+using Transaction = std::variant<Deposit, Withdrawal>;
+
+struct LedgerEntry {
+	int id;
+	Transaction transaction;
+	std::optional<Transaction> reversal;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(LedgerEntry, (id, transaction, reversal))
+
+TEST(RapidUnmarshalTest, UnserializeVariantWithExternalTag) {
+	std::string json(R"({
+							"id" : 12,
+							"transaction" : { "Withdrawal" : { "account" : "A-1", "cents" : 2500, "atm" : "ATM-9" } },
+							"reversal" : { "Deposit" : { "account" : "A-1", "cents" : 2500 } }
+						})");
+
+	LedgerEntry entry;
+	rapidjson_util::unmarshal(json, entry);
+
+	ASSERT_EQ(entry.id, 12);
+	ASSERT_TRUE(std::holds_alternative<Withdrawal>(entry.transaction));
+	ASSERT_EQ(std::get<Withdrawal>(entry.transaction).account, "A-1");
+	ASSERT_EQ(std::get<Withdrawal>(entry.transaction).cents, 2500ULL);
+	ASSERT_EQ(std::get<Withdrawal>(entry.transaction).atm, "ATM-9");
+
+	ASSERT_TRUE(entry.reversal.has_value());
+	ASSERT_TRUE(std::holds_alternative<Deposit>(*entry.reversal));
+	ASSERT_EQ(std::get<Deposit>(*entry.reversal).cents, 2500ULL);
+}
+
+TEST(RapidUnmarshalTest, UnserializeNullableVariantWithOptionalWhenNull) {
+	std::string json(R"({
+							"id" : 13,
+							"transaction" : { "Deposit" : { "account" : "B-2", "cents" : 100 } },
+							"reversal" : null
+						})");
+
+	LedgerEntry entry;
+	entry.reversal = Withdrawal{ "B-2", 100, std::nullopt };
+
+	rapidjson_util::unmarshal(json, entry);
+
+	ASSERT_TRUE(std::holds_alternative<Deposit>(entry.transaction));
+	ASSERT_EQ(entry.reversal, std::nullopt);
+}
+
+TEST(RAPID_UNMARSHAL_TEST, ThrowWhenVariantTagIsUnknown) {
+	std::string json(R"({
+							"id" : 14,
+							"transaction" : { "Transfer" : { "account" : "C-3", "cents" : 1 } },
+							"reversal" : null
+						})");
+
+	LedgerEntry entry;
+	try {
+		rapidjson_util::unmarshal(json, entry);
+		FAIL() << "Expected MemberSerializationFailure";
+	}
+	catch (rapidjson_util::MemberSerializationFailure& e) {
+		EXPECT_STREQ(e.what(), "Deserialization of member \"transaction\" failed: Unknown variant alternative \"Transfer\"");
+	}
+}
+
+struct SensorReading {
+	std::string sensor;
+	double celsius;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SensorReading, (sensor, celsius))
+
+struct SensorFault {
+	std::string sensor;
+	int code;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SensorFault, (sensor, code))
+
+using TelemetryEvent = rapidjson_util::internally_tagged<std::variant<SensorReading, SensorFault>>;
+
+struct TelemetryMessage {
+	TelemetryEvent event;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(TelemetryMessage, (event))
+
+TEST(RapidUnmarshalTest, UnserializeVariantWithDiscriminatorField) {
+	std::string json(R"({ "event" : { "sensor" : "T-100", "code" : 42, "type" : "SensorFault" } })");
+
+	TelemetryMessage message;
+	rapidjson_util::unmarshal(json, message);
+
+	ASSERT_TRUE(std::holds_alternative<SensorFault>(message.event));
+	ASSERT_EQ(std::get<SensorFault>(message.event).sensor, "T-100");
+	ASSERT_EQ(std::get<SensorFault>(message.event).code, 42);
+}
+
+TEST(RAPID_UNMARSHAL_TEST, ThrowWhenVariantDiscriminatorIsMissing) {
+	std::string json(R"({ "event" : { "sensor" : "T-100", "celsius" : 21.5 } })");
+
+	TelemetryMessage message;
+	try {
+		rapidjson_util::unmarshal(json, message);
+		FAIL() << "Expected MemberSerializationFailure";
+	}
+	catch (rapidjson_util::MemberSerializationFailure& e) {
+		EXPECT_STREQ(e.what(), "Deserialization of member \"event\" failed: JSON doesn't match the struct: required field \"type\" not found");
+	}
+}
+
+
+struct MerkleNode {
+	std::string hash;
+	std::unique_ptr<MerkleNode> left;
+	std::unique_ptr<MerkleNode> right;
+	std::shared_ptr<uint64_t> leafIndex;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(MerkleNode, (hash, left, right, leafIndex))
+
+TEST(RapidUnmarshalTest, UnserializeRecursiveStructThroughSmartPointers) {
+	std::string json(R"({
+							"hash" : "root",
+							"left" : { "hash" : "a", "left" : null, "right" : null, "leafIndex" : 0 },
+							"right" : {
+										"hash" : "b",
+										"left" : null,
+										"right" : { "hash" : "c", "left" : null, "right" : null, "leafIndex" : 1 },
+										"leafIndex" : null
+									  },
+							"leafIndex" : null
+						})");
+
+	MerkleNode root;
+	rapidjson_util::unmarshal(json, root);
+
+	ASSERT_EQ(root.hash, "root");
+	ASSERT_EQ(root.leafIndex, nullptr);
+
+	ASSERT_NE(root.left, nullptr);
+	ASSERT_EQ(root.left->hash, "a");
+	ASSERT_EQ(root.left->left, nullptr);
+	ASSERT_NE(root.left->leafIndex, nullptr);
+	ASSERT_EQ(*root.left->leafIndex, 0ULL);
+
+	ASSERT_NE(root.right, nullptr);
+	ASSERT_EQ(root.right->left, nullptr);
+	ASSERT_NE(root.right->right, nullptr);
+	ASSERT_EQ(root.right->right->hash, "c");
+	ASSERT_EQ(*root.right->right->leafIndex, 1ULL);
+}
+
+TEST(RapidUnmarshalTest, UnserializeSmartPointersResetsToNullptrWhenNull) {
+	std::string json(R"({ "hash" : "leaf", "left" : null, "right" : null, "leafIndex" : null })");
+
+	MerkleNode node;
+	node.left = std::make_unique<MerkleNode>();
+	node.leafIndex = std::make_shared<uint64_t>(7);
+
+	rapidjson_util::unmarshal(json, node);
+
+	ASSERT_EQ(node.left, nullptr);
+	ASSERT_EQ(node.leafIndex, nullptr);
+}
+
+struct AttachmentList {
+	std::shared_ptr<std::vector<std::string>> files;
+	std::vector<std::unique_ptr<JobInfo>> jobs;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(AttachmentList, (files, jobs))
+
+TEST(RapidUnmarshalTest, UnserializeContainersOfSmartPointers) {
+	std::string json(R"({
+							"files" : ["a.txt", "b.txt"],
+							"jobs" : [ null, { "title" : "Welder", "salary" : 31000.0 } ]
+						})");
+
+	AttachmentList list;
+	rapidjson_util::unmarshal(json, list);
+
+	ASSERT_NE(list.files, nullptr);
+	ASSERT_THAT(*list.files, testing::ElementsAre("a.txt", "b.txt"));
+
+	ASSERT_EQ(list.jobs.size(), 2);
+	ASSERT_EQ(list.jobs[0], nullptr);
+	ASSERT_NE(list.jobs[1], nullptr);
+	ASSERT_EQ(list.jobs[1]->title, "Welder");
+	ASSERT_DOUBLE_EQ(list.jobs[1]->salary, 31000.0);
+}
+
+struct CalibrationTable {
+	std::array<std::array<double, 2>, 3> coefficients;
+	std::vector<std::array<float, 2>> samples;
+	std::vector<std::vector<int64_t>> buckets;
+	std::list<std::tuple<int, std::vector<std::string>>> groups;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(CalibrationTable, (coefficients, samples, buckets, groups))
+
+TEST(RapidUnmarshalTest, UnserializeNestedContainers) {
+	std::string json(R"({
+							"coefficients" : [[1.0, 0.5], [2.0, -0.5], [0.25, 4.0]],
+							"samples" : [[0.5, 1.5], [2.5, 3.5], [4.5, 5.5]],
+							"buckets" : [[1, 2, 3], [], [9007199254740993]],
+							"groups" : [[1, ["a", "b"]], [2, []]]
+						})");
+
+	CalibrationTable table;
+	table.samples.resize(7);
+	table.buckets = { { 5 } };
+
+	rapidjson_util::unmarshal(json, table);
+
+	ASSERT_DOUBLE_EQ(table.coefficients[1][1], -0.5);
+	ASSERT_DOUBLE_EQ(table.coefficients[2][0], 0.25);
+
+	ASSERT_EQ(table.samples.size(), 3);
+	ASSERT_FLOAT_EQ(table.samples[2][1], 5.5f);
+
+	ASSERT_EQ(table.buckets.size(), 3);
+	ASSERT_THAT(table.buckets[0], testing::ElementsAre(1, 2, 3));
+	ASSERT_TRUE(table.buckets[1].empty());
+	ASSERT_EQ(table.buckets[2][0], 9007199254740993LL);
+
+	ASSERT_EQ(table.groups.size(), 2);
+	ASSERT_EQ(std::get<0>(table.groups.front()), 1);
+	ASSERT_THAT(std::get<1>(table.groups.front()), testing::ElementsAre("a", "b"));
+	ASSERT_TRUE(std::get<1>(table.groups.back()).empty());
+}
+
+TEST(RAPID_UNMARSHAL_TEST, ThrowWhenNestedFixedArrayLengthMismatch) {
+	std::string json(R"({
+							"coefficients" : [[1.0, 0.5], [2.0], [0.25, 4.0]],
+							"samples" : [],
+							"buckets" : [],
+							"groups" : []
+						})");
+
+	CalibrationTable table;
+	try {
+		rapidjson_util::unmarshal(json, table);
+		FAIL() << "Expected MemberSerializationFailure";
+	}
+	catch (rapidjson_util::MemberSerializationFailure& e) {
+		EXPECT_STREQ(e.what(), "Deserialization of member \"coefficients\" failed: Array size mismatch: JSON contains 1 "
+		                       "elements, but given array has fixed capacity of 2 elements and cannot be resized.");
+	}
+}
+
+struct LinkStatistics {
+	int8_t signal;
+	int16_t noise;
+	uint8_t channel;
+	uint16_t mtu;
+	uint32_t frames;
+	std::optional<uint8_t> retries;
+	std::array<int16_t, 2> range;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(LinkStatistics, (signal, noise, channel, mtu, frames, retries, range))
+
+TEST(RapidUnmarshalTest, UnserializeFixedWidthIntegers) {
+	std::string json(R"({
+							"signal" : -90,
+							"noise" : -32768,
+							"channel" : 255,
+							"mtu" : 9000,
+							"frames" : 4294967295,
+							"retries" : 3,
+							"range" : [-300, 300]
+						})");
+
+	LinkStatistics stats;
+	rapidjson_util::unmarshal(json, stats);
+
+	ASSERT_EQ(stats.signal, -90);
+	ASSERT_EQ(stats.noise, -32768);
+	ASSERT_EQ(stats.channel, 255);
+	ASSERT_EQ(stats.mtu, 9000);
+	ASSERT_EQ(stats.frames, 4294967295U);
+	ASSERT_EQ(stats.retries, 3);
+	ASSERT_THAT(stats.range, testing::ElementsAre(-300, 300));
+}
+
+TEST(RAPID_UNMARSHAL_TEST, ThrowWhenIntegerIsOutOfRange) {
+	auto expectFailure = [](const std::string& json, const char* message) {
+		LinkStatistics stats;
+		try {
+			rapidjson_util::unmarshal(json, stats);
+			FAIL() << "Expected MemberSerializationFailure";
+		}
+		catch (rapidjson_util::MemberSerializationFailure& e) {
+			EXPECT_STREQ(e.what(), message);
+		}
+	};
+
+	expectFailure(R"({ "signal" : 128, "noise" : 0, "channel" : 0, "mtu" : 0, "frames" : 0, "retries" : null, "range" : [0, 0] })",
+	              "Deserialization of member \"signal\" failed: Value 128 is out of range for Int8");
+	expectFailure(R"({ "signal" : 0, "noise" : 0, "channel" : -1, "mtu" : 0, "frames" : 0, "retries" : null, "range" : [0, 0] })",
+	              "Deserialization of member \"channel\" failed: Value -1 is out of range for Uint8");
+	expectFailure(R"({ "signal" : 0, "noise" : 0, "channel" : 0, "mtu" : 0, "frames" : 4294967296, "retries" : null, "range" : [0, 0] })",
+	              "Deserialization of member \"frames\" failed: Value 4294967296 is out of range for Uint32");
+	expectFailure(R"({ "signal" : 0, "noise" : 0, "channel" : 0, "mtu" : 1.5, "frames" : 0, "retries" : null, "range" : [0, 0] })",
+	              "Deserialization of member \"mtu\" failed: Expected Uint16, got Double");
+	expectFailure(R"({ "signal" : 0, "noise" : 0, "channel" : 0, "mtu" : 0, "frames" : 0, "retries" : null, "range" : [0, 40000] })",
+	              "Deserialization of member \"range\" failed: Value 40000 is out of range for Int16");
+}
+
+struct LedgerTotals {
+	long long balance;
+	unsigned long long turnover;
+	std::optional<long long> adjustment;
+	std::vector<unsigned long long> volumes;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(LedgerTotals, (balance, turnover, adjustment, volumes))
+
+TEST(RapidUnmarshalTest, UnserializeLongLongIntegers) {
+	std::string json(R"({
+							"balance" : -9223372036854775808,
+							"turnover" : 18446744073709551615,
+							"adjustment" : -5,
+							"volumes" : [0, 18446744073709551615]
+						})");
+
+	LedgerTotals totals;
+	rapidjson_util::unmarshal(json, totals);
+
+	ASSERT_EQ(totals.balance, -9223372036854775807LL - 1);
+	ASSERT_EQ(totals.turnover, 18446744073709551615ULL);
+	ASSERT_EQ(totals.adjustment, -5);
+	ASSERT_THAT(totals.volumes, testing::ElementsAre(0ULL, 18446744073709551615ULL));
+
+	try {
+		rapidjson_util::unmarshal(R"({ "balance" : 0, "turnover" : -1, "adjustment" : null, "volumes" : [] })", totals);
+		FAIL() << "Expected MemberSerializationFailure";
+	}
+	catch (rapidjson_util::MemberSerializationFailure& e) {
+		EXPECT_STREQ(e.what(), "Deserialization of member \"turnover\" failed: Value -1 is out of range for Uint64");
+	}
+}
+
+struct QuoteRequest {
+	char symbol[6];
+	std::array<char, 4> currency;
+	rapidjson_util::fixed_string<8> trader;
+	std::optional<rapidjson_util::fixed_string<4>> desk;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(QuoteRequest, (symbol, currency, trader, desk))
+
+TEST(RapidUnmarshalTest, UnserializeInlineStrings) {
+	std::string json(R"({ "symbol" : "AAPL", "currency" : "USD", "trader" : "jdoe", "desk" : "FX" })");
+
+	QuoteRequest request;
+	std::memset(request.symbol, 'x', sizeof(request.symbol));
+	request.currency.fill('x');
+
+	rapidjson_util::unmarshal(json, request);
+
+	ASSERT_STREQ(request.symbol, "AAPL");
+	ASSERT_EQ(std::string_view(request.currency.data(), 3), "USD");
+	ASSERT_EQ(request.currency[3], '\0');
+	ASSERT_EQ(request.trader, "jdoe");
+	ASSERT_EQ(request.trader.size(), 4);
+	ASSERT_TRUE(request.desk.has_value());
+	ASSERT_EQ(*request.desk, "FX");
+}
+
+TEST(RAPID_UNMARSHAL_TEST, ThrowWhenInlineStringCapacityExceeded) {
+	std::string json(R"({ "symbol" : "GOOGLE", "currency" : "USD", "trader" : "jdoe", "desk" : null })");
+
+	QuoteRequest request;
+	try {
+		rapidjson_util::unmarshal(json, request);
+		FAIL() << "Expected MemberSerializationFailure";
+	}
+	catch (rapidjson_util::MemberSerializationFailure& e) {
+		EXPECT_STREQ(e.what(), "Deserialization of member \"symbol\" failed: String length mismatch: JSON contains 6 "
+		                       "characters, but given string has fixed capacity of 5 characters.");
+	}
+}
+
+struct RouteUpdate {
+	rapidjson_util::static_vector<int, 3> hops;
+	rapidjson_util::static_vector<JobInfo, 2> jobs;
+	rapidjson_util::small_vector<std::array<float, 2>, 2> waypoints;
+	std::optional<std::array<int, 2>> window;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(RouteUpdate, (hops, jobs, waypoints, window))
+
+TEST(RapidUnmarshalTest, UnserializeFixedCapacityAndSmallVectors) {
+	std::string json(R"({
+							"hops" : [4, 5, 6],
+							"jobs" : [{ "title" : "Pilot", "salary" : 90000.0 }],
+							"waypoints" : [[0.5, 1.0], [1.5, 2.0], [2.5, 3.0]],
+							"window" : [8, 17]
+						})");
+
+	RouteUpdate update;
+	rapidjson_util::unmarshal(json, update);
+
+	ASSERT_THAT(update.hops, testing::ElementsAre(4, 5, 6));
+	ASSERT_EQ(update.jobs.size(), 1);
+	ASSERT_EQ(update.jobs[0].title, "Pilot");
+	ASSERT_EQ(update.waypoints.size(), 3);
+	ASSERT_FALSE(update.waypoints.is_inline());
+	ASSERT_FLOAT_EQ(update.waypoints[2][1], 3.0f);
+	ASSERT_TRUE(update.window.has_value());
+	ASSERT_THAT(*update.window, testing::ElementsAre(8, 17));
+}
+
+struct ShiftPlan {
+	std::optional<std::array<int, 2>> window;
+	std::optional<std::array<std::string, 3>> crew;
+	std::unique_ptr<std::array<double, 2>> rates;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(ShiftPlan, (window, crew, rates))
+
+TEST(RapidUnmarshalTest, UnserializeNullableFixedArrays) {
+	ShiftPlan plan;
+	rapidjson_util::unmarshal(R"({ "window" : [8, 17], "crew" : ["Ada", "Bo", "Cy"], "rates" : [1.5, 2.0] })", plan);
+
+	ASSERT_TRUE(plan.window.has_value());
+	ASSERT_THAT(*plan.window, testing::ElementsAre(8, 17));
+	ASSERT_TRUE(plan.crew.has_value());
+	ASSERT_THAT(*plan.crew, testing::ElementsAre("Ada", "Bo", "Cy"));
+	ASSERT_NE(plan.rates, nullptr);
+	ASSERT_THAT(*plan.rates, testing::ElementsAre(1.5, 2.0));
+
+	rapidjson_util::unmarshal(R"({ "window" : null, "crew" : null, "rates" : null })", plan);
+	ASSERT_FALSE(plan.window.has_value());
+	ASSERT_FALSE(plan.crew.has_value());
+	ASSERT_EQ(plan.rates, nullptr);
+
+	// A fixed array keeps its length when it is emplaced
+	try {
+		rapidjson_util::unmarshal(R"({ "window" : [8, 12, 17], "crew" : null, "rates" : null })", plan);
+		FAIL() << "Expected MemberSerializationFailure";
+	}
+	catch (rapidjson_util::MemberSerializationFailure& e) {
+		EXPECT_STREQ(e.what(), "Deserialization of member \"window\" failed: Array size mismatch: JSON contains 3 "
+		                       "elements, but given array has fixed capacity of 2 elements and cannot be resized.");
+	}
+}
+
+TEST(RAPID_UNMARSHAL_TEST, ThrowWhenStaticVectorCapacityExceeded) {
+	std::string json(R"({
+							"hops" : [],
+							"jobs" : [{ "title" : "A", "salary" : 1.0 }, { "title" : "B", "salary" : 2.0 }, { "title" : "C", "salary" : 3.0 }],
+							"waypoints" : [],
+							"window" : null
+						})");
+
+	RouteUpdate update;
+	try {
+		rapidjson_util::unmarshal(json, update);
+		FAIL() << "Expected MemberSerializationFailure";
+	}
+	catch (rapidjson_util::MemberSerializationFailure& e) {
+		EXPECT_STREQ(e.what(), "Deserialization of member \"jobs\" failed: Array size mismatch: JSON contains 3 "
+		                       "elements, but given array can hold at most 2 elements.");
+	}
+
+	ASSERT_TRUE(update.jobs.empty());
+}
+
+struct SessionRequest {
+	std::pmr::string user;
+	std::pmr::vector<std::pmr::string> tags;
+	std::pmr::vector<int> scores;
+	std::optional<std::pmr::string> note;
+	std::string plain;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SessionRequest, (user, tags, scores, note, plain))
+
+TEST(RapidUnmarshalTest, UnserializePmrMembersIntoMemoryResource) {
+	std::string json(R"({
+							"user" : "a user name that is longer than any small string buffer",
+							"tags" : ["first tag that does not fit inline", "second tag that does not fit inline"],
+							"scores" : [7, 8, 9],
+							"note" : "a note that is too long for small string optimization",
+							"plain" : "plain"
+						})");
+
+	std::array<std::byte, 4096> buffer;
+	std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+	SessionRequest request;
+	rapidjson_util::unmarshal(json, request, &arena);
+
+	ASSERT_EQ(request.user, "a user name that is longer than any small string buffer");
+	ASSERT_EQ(request.user.get_allocator().resource(), &arena);
+	ASSERT_EQ(request.tags.get_allocator().resource(), &arena);
+	ASSERT_THAT(request.tags, testing::ElementsAre("first tag that does not fit inline",
+	                                               "second tag that does not fit inline"));
+	for (const auto& tag : request.tags)
+		ASSERT_EQ(tag.get_allocator().resource(), &arena);
+	ASSERT_THAT(request.scores, testing::ElementsAre(7, 8, 9));
+	ASSERT_EQ(request.scores.get_allocator().resource(), &arena);
+	ASSERT_TRUE(request.note.has_value());
+	ASSERT_EQ(request.note->get_allocator().resource(), &arena);
+	ASSERT_EQ(request.plain, "plain");
+}
+
+TEST(RapidUnmarshalTest, UnserializePmrContainersOfUnchangedSizeIntoMemoryResource) {
+	std::string json(R"({
+							"user" : "u",
+							"tags" : ["first tag that does not fit inline", "second tag that does not fit inline"],
+							"scores" : [7, 8, 9],
+							"note" : null,
+							"plain" : ""
+						})");
+
+	// The arena must outlive the members that end up allocated from it
+	std::pmr::monotonic_buffer_resource arena;
+
+	SessionRequest request;
+	request.tags = { "old first tag", "old second tag" };
+	request.scores = { 1, 2, 3 };
+
+	rapidjson_util::unmarshal(json, request, &arena);
+
+	ASSERT_EQ(request.tags.get_allocator().resource(), &arena);
+	ASSERT_THAT(request.tags, testing::ElementsAre("first tag that does not fit inline",
+	                                               "second tag that does not fit inline"));
+	for (const auto& tag : request.tags)
+		ASSERT_EQ(tag.get_allocator().resource(), &arena);
+	ASSERT_EQ(request.scores.get_allocator().resource(), &arena);
+	ASSERT_THAT(request.scores, testing::ElementsAre(7, 8, 9));
+}
+
+TEST(RapidUnmarshalTest, KeepDefaultMemoryResourceWithoutOne) {
+	std::string json(R"({ "user" : "u", "tags" : ["t"], "scores" : [], "note" : null, "plain" : "" })");
+
+	SessionRequest request;
+	rapidjson_util::unmarshal(json, request);
+
+	ASSERT_EQ(request.user, "u");
+	ASSERT_EQ(request.tags.get_allocator().resource(), std::pmr::get_default_resource());
+	ASSERT_THAT(request.tags, testing::ElementsAre("t"));
+	ASSERT_FALSE(request.note.has_value());
+}
+
+using EpochMicros = rapidjson_util::chrono_as<rapidjson_util::ChronoEncoding::Nanoseconds,
+                                              std::chrono::time_point<std::chrono::system_clock, std::chrono::microseconds>>;
+
+struct TradeEvent {
+	std::chrono::system_clock::time_point executedAt;
+	std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds> settledAt;
+	EpochMicros publishedAt;
+	rapidjson_util::chrono_as<rapidjson_util::ChronoEncoding::Milliseconds, std::chrono::seconds> holdTime;
+	std::optional<std::chrono::time_point<std::chrono::system_clock, std::chrono::duration<int64_t, std::centi>>> cancelledAt;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(TradeEvent, (executedAt, settledAt, publishedAt, holdTime, cancelledAt))
+
+TEST(RapidUnmarshalTest, UnserializeChronoTimePointsAndDurations) {
+	using namespace std::chrono;
+
+	std::string json(R"({
+							"executedAt" : "2024-01-15T11:30:00.25+01:00",
+							"settledAt" : "1969-12-31T23:59:59Z",
+							"publishedAt" : 1705314600000001999,
+							"holdTime" : 90999,
+							"cancelledAt" : "2024-02-29T23:00:00.5z"
+						})");
+
+	TradeEvent event;
+	rapidjson_util::unmarshal(json, event);
+
+	ASSERT_EQ(event.executedAt.time_since_epoch(), seconds(1705314600) + milliseconds(250));
+	ASSERT_EQ(event.settledAt.time_since_epoch(), seconds(-1));
+	ASSERT_EQ(event.publishedAt.time_since_epoch(), microseconds(1705314600000001));
+	ASSERT_EQ(event.holdTime, seconds(90));
+	ASSERT_TRUE(event.cancelledAt.has_value());
+	ASSERT_EQ(event.cancelledAt->time_since_epoch(), milliseconds(1709247600500));
+
+	std::string roundTrip = rapidjson_util::marshal(event);
+	ASSERT_THAT(roundTrip, testing::HasSubstr(R"("settledAt":"1969-12-31T23:59:59Z")"));
+	ASSERT_THAT(roundTrip, testing::HasSubstr(R"("publishedAt":1705314600000001000)"));
+	ASSERT_THAT(roundTrip, testing::HasSubstr(R"("holdTime":90000)"));
+	ASSERT_THAT(roundTrip, testing::HasSubstr(R"("cancelledAt":"2024-02-29T23:00:00.50Z")"));
+}
+
+struct SampleTiming {
+	std::chrono::duration<double> elapsed;
+	std::optional<std::chrono::duration<float, std::milli>> jitter;
+	std::chrono::time_point<std::chrono::system_clock, std::chrono::duration<double>> sampledAt;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SampleTiming, (elapsed, jitter, sampledAt))
+
+TEST(RapidUnmarshalTest, RoundTripFloatingPointDurations) {
+	using namespace std::chrono;
+
+	SampleTiming timing;
+	rapidjson_util::unmarshal(R"({ "elapsed" : 1.75, "jitter" : 0.25, "sampledAt" : "2024-01-15T10:30:00.5Z" })", timing);
+
+	ASSERT_EQ(timing.elapsed, duration<double>(1.75));
+	ASSERT_TRUE(timing.jitter.has_value());
+	ASSERT_EQ(timing.jitter->count(), 0.25f);
+	ASSERT_EQ(timing.sampledAt.time_since_epoch(), duration<double>(1705314600.5));
+
+	SampleTiming roundTrip;
+	rapidjson_util::unmarshal(rapidjson_util::marshal(timing), roundTrip);
+
+	ASSERT_EQ(roundTrip.elapsed, timing.elapsed);
+	ASSERT_EQ(roundTrip.jitter, timing.jitter);
+	ASSERT_EQ(roundTrip.sampledAt, timing.sampledAt);
+}
+
+TEST(RapidUnmarshalTest, ThrowWhenTimestampIsInvalid) {
+	for (std::string timestamp : { "2023-02-29T00:00:00Z", "2024-01-15 10:30:00", "2024-01-15T24:00:00Z", "2024-01-15T10:30:00.Z" }) {
+		std::string json = R"({ "executedAt" : ")" + timestamp + R"(", "settledAt" : "2024-01-15T10:30:00Z",
+		                        "publishedAt" : 0, "holdTime" : 0, "cancelledAt" : null })";
+
+		TradeEvent event;
+		try {
+			rapidjson_util::unmarshal(json, event);
+			FAIL() << "Expected MemberSerializationFailure for " << timestamp;
+		}
+		catch (rapidjson_util::MemberSerializationFailure& e) {
+			EXPECT_EQ(std::string(e.what()), "Deserialization of member \"executedAt\" failed: Expected RFC 3339 timestamp, "
+			                                 "got \"" + timestamp + "\"");
+		}
+	}
+}
+
+struct Blob {
+	rapidjson_util::bytes data;
+	rapidjson_util::hex_bytes digest;
+	std::optional<std::vector<std::byte>> signature;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(Blob, (data, digest, signature))
+
+TEST(RapidUnmarshalTest, UnserializeBase64AndHexBinaryData) {
+	std::string json(R"({ "data" : "Zm9vYmFy", "digest" : "DEADbeef", "signature" : "Zm8=" })");
+
+	Blob blob;
+	rapidjson_util::unmarshal(json, blob);
+
+	ASSERT_EQ(std::string(reinterpret_cast<const char*>(blob.data.data()), blob.data.size()), "foobar");
+	ASSERT_THAT(blob.digest, testing::ElementsAre(std::byte(0xde), std::byte(0xad), std::byte(0xbe), std::byte(0xef)));
+	ASSERT_TRUE(blob.signature.has_value());
+	ASSERT_THAT(*blob.signature, testing::ElementsAre(std::byte('f'), std::byte('o')));
+}
+
+// rapidutil_test_scalar builds these tests without the SSSE3 kernels, to run the scalar loops alone
+#if defined(RAPIDUTIL_TEST_SCALAR)
+static_assert(!RAPIDJSON_UTIL_BINARY_SSSE3, "The scalar tests must be compiled without the SSSE3 kernels");
+#endif
+
+TEST(RapidUnmarshalTest, RoundTripBinaryDataOfEveryLength) {
+	for (std::size_t length = 0; length < 100; ++length) {
+		Blob blob;
+		for (std::size_t i = 0; i < length; ++i) {
+			blob.data.push_back(std::byte(i * 37 + length));
+			blob.digest.push_back(std::byte(255 - i));
+		}
+
+		Blob decoded;
+		rapidjson_util::unmarshal(rapidjson_util::marshal(blob), decoded);
+
+		ASSERT_EQ(decoded.data, blob.data) << "length " << length;
+		ASSERT_EQ(decoded.digest, blob.digest) << "length " << length;
+		ASSERT_FALSE(decoded.signature.has_value());
+	}
+}
+
+TEST(RapidUnmarshalTest, UnserializeHexDigitsOfEitherCase) {
+	std::string json(R"({ "data" : "", "digest" : "00112233445566778899AaBbCcDdEeFf0123456789abcdefABCDEF", "signature" : null })");
+
+	Blob blob;
+	rapidjson_util::unmarshal(json, blob);
+
+	ASSERT_THAT(blob.digest, testing::ElementsAre(std::byte(0x00), std::byte(0x11), std::byte(0x22), std::byte(0x33),
+	                                              std::byte(0x44), std::byte(0x55), std::byte(0x66), std::byte(0x77),
+	                                              std::byte(0x88), std::byte(0x99), std::byte(0xaa), std::byte(0xbb),
+	                                              std::byte(0xcc), std::byte(0xdd), std::byte(0xee), std::byte(0xff),
+	                                              std::byte(0x01), std::byte(0x23), std::byte(0x45), std::byte(0x67),
+	                                              std::byte(0x89), std::byte(0xab), std::byte(0xcd), std::byte(0xef),
+	                                              std::byte(0xab), std::byte(0xcd), std::byte(0xef)));
+}
+
+TEST(RapidUnmarshalTest, ThrowWhenBinaryDataIsMalformed) {
+	auto expectFailure = [](const std::string& json, const std::string& message) {
+		Blob blob;
+		try {
+			rapidjson_util::unmarshal(json, blob);
+			FAIL() << "Expected MemberSerializationFailure for " << json;
+		}
+		catch (rapidjson_util::MemberSerializationFailure& e) {
+			EXPECT_EQ(std::string(e.what()), message);
+		}
+	};
+
+	expectFailure(R"({ "data" : "QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVph!mNk", "digest" : "", "signature" : null })",
+	              "Deserialization of member \"data\" failed: Expected base64 string, got '!' at offset 36");
+	expectFailure(R"({ "data" : "QUJDREVGR0hJSktMTU5P!FFSU1RVVldYWVphYmNk", "digest" : "", "signature" : null })",
+	              "Deserialization of member \"data\" failed: Expected base64 string, got '!' at offset 20");
+	expectFailure(R"({ "data" : "Zm9", "digest" : "", "signature" : null })",
+	              "Deserialization of member \"data\" failed: Expected base64 string, got 3 characters");
+	expectFailure(R"({ "data" : "", "digest" : "0g", "signature" : null })",
+	              "Deserialization of member \"digest\" failed: Expected hex string, got 'g' at offset 1");
+	expectFailure(R"({ "data" : "", "digest" : "00112233445566778899aabbccddeeff0011223344556677889:aabbccddeeff", "signature" : null })",
+	              "Deserialization of member \"digest\" failed: Expected hex string, got ':' at offset 51");
+	expectFailure(R"({ "data" : "", "digest" : "00112233445566778899aabbccddee`f", "signature" : null })",
+	              "Deserialization of member \"digest\" failed: Expected hex string, got '`' at offset 30");
+}
+
+TEST(RapidUnmarshalTest, KeepBinaryDataWhenItIsMalformed) {
+	Blob blob;
+	rapidjson_util::unmarshal(R"({ "data" : "Zm9vYmFy", "digest" : "DEADbeef", "signature" : null })", blob);
+
+	ASSERT_THROW(rapidjson_util::unmarshal(R"({ "data" : "QUJDREVGR0hJSktMTU5P!FFSU1RVVldYWVphYmNk", "digest" : "", "signature" : null })", blob),
+	             rapidjson_util::MemberSerializationFailure);
+	ASSERT_EQ(std::string(reinterpret_cast<const char*>(blob.data.data()), blob.data.size()), "foobar");
+
+	ASSERT_THROW(rapidjson_util::unmarshal(R"({ "data" : "", "digest" : "de:dbeef", "signature" : null })", blob),
+	             rapidjson_util::MemberSerializationFailure);
+	ASSERT_TRUE(blob.data.empty());
+	ASSERT_THAT(blob.digest, testing::ElementsAre(std::byte(0xde), std::byte(0xad), std::byte(0xbe), std::byte(0xef)));
+}
+
+struct Uuid {
+	std::array<uint8_t, 16> octets;
+};
+
+template<>
+struct rapidjson_util::json_codec<Uuid> {
+	static void write(JsonValueWriter& writer, const Uuid& uuid) {
+		static constexpr char digits[] = "0123456789abcdef";
+		std::string text;
+		for (std::size_t i = 0; i < uuid.octets.size(); ++i) {
+			if (i == 4 || i == 6 || i == 8 || i == 10)
+				text += '-';
+			text += digits[uuid.octets[i] >> 4];
+			text += digits[uuid.octets[i] & 0xf];
+		}
+		writer.writeString(text);
+	}
+
+	static void read(JsonValueReader& reader, Uuid& uuid) {
+		std::string_view text = reader.readString();
+		if (text.size() != 36)
+			throw std::invalid_argument("Expected UUID, got \"" + std::string(text) + "\"");
+
+		std::size_t octet = 0;
+		for (std::size_t i = 0; i < text.size(); i += 2) {
+			if (text[i] == '-')
+				++i;
+			uuid.octets[octet++] = static_cast<uint8_t>(std::stoi(std::string(text.substr(i, 2)), nullptr, 16));
+		}
+	}
+};
+
+struct DeviceLease {
+	Uuid device;
+	std::optional<Uuid> owner;
+	std::vector<Uuid> peers;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(DeviceLease, (device, owner, peers))
+
+TEST(RapidUnmarshalTest, UnserializeMembersThroughUserDefinedCodecs) {
+	std::string json(R"({
+							"device" : "123e4567-e89b-12d3-a456-426614174000",
+							"owner" : null,
+							"peers" : [ "00000000-0000-0000-0000-000000000001" ]
+						})");
+
+	DeviceLease lease;
+	lease.owner = Uuid {};
+	rapidjson_util::unmarshal(json, lease);
+
+	ASSERT_EQ(lease.device.octets[0], 0x12);
+	ASSERT_EQ(lease.device.octets[15], 0x00);
+	ASSERT_EQ(lease.device.octets[6], 0x12);
+	ASSERT_FALSE(lease.owner.has_value());
+	ASSERT_EQ(lease.peers.size(), 1);
+	ASSERT_EQ(lease.peers[0].octets[15], 0x01);
+
+	std::string roundTrip = rapidjson_util::marshal(lease);
+	ASSERT_THAT(roundTrip, testing::HasSubstr(R"("device":"123e4567-e89b-12d3-a456-426614174000")"));
+}
+
+TEST(RapidUnmarshalTest, ThrowWhenUserDefinedCodecFails) {
+	auto expectFailure = [](const std::string& json, const std::string& message) {
+		DeviceLease lease;
+		try {
+			rapidjson_util::unmarshal(json, lease);
+			FAIL() << "Expected MemberSerializationFailure for " << json;
+		}
+		catch (rapidjson_util::MemberSerializationFailure& e) {
+			EXPECT_EQ(std::string(e.what()), message);
+		}
+	};
+
+	expectFailure(R"({ "device" : "123e4567", "owner" : null, "peers" : [] })",
+	              "Deserialization of member \"device\" failed: Expected UUID, got \"123e4567\"");
+	expectFailure(R"({ "device" : "00000000-0000-0000-0000-000000000001", "owner" : 7, "peers" : [] })",
+	              "Deserialization of member \"owner\" failed: Expected String, got Int");
+}
+
+struct TradeLeg {
+	std::pmr::string symbol;
+	int64_t quantity;
+	std::optional<double> limit;
+};
+
+using TradeLegs = rapidjson_util::columnar<std::pmr::vector<TradeLeg>>;
+using TradeLegPair = rapidjson_util::columnar<std::array<TradeLeg, 2>>;
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(TradeLeg, (symbol, quantity, limit))
+
+struct TradeBlotter {
+	TradeLegs legs;
+	TradeLegPair spread;
+	std::unique_ptr<TradeLegs> amended;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(TradeBlotter, (legs, spread, amended))
+
+TEST(RapidUnmarshalTest, UnserializeContainersOfStructsFromColumns) {
+	std::string json(R"({
+							"legs" : { "symbol" : [ "AAPL", "MSFT", "TSLA" ], "quantity" : [ 100, -50, 7 ], "limit" : [ 187.5, null, 250.0 ] },
+							"spread" : { "limit" : [ 1.5, 2.5 ], "quantity" : [ 1, 2 ], "symbol" : [ "ESZ5", "ESH6" ] },
+							"amended" : { "symbol" : [ "NVDA" ], "quantity" : [ 9 ], "limit" : [ null ] }
+						})");
+
+	char arena[4096];
+	std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena), std::pmr::null_memory_resource());
+
+	TradeBlotter blotter;
+	blotter.legs.resize(1);
+	rapidjson_util::unmarshal(json, blotter, &resource);
+
+	ASSERT_EQ(blotter.legs.size(), 3);
+	ASSERT_EQ(blotter.legs.get_allocator().resource(), &resource);
+	ASSERT_EQ(blotter.legs[1].symbol, "MSFT");
+	ASSERT_EQ(blotter.legs[1].quantity, -50);
+	ASSERT_FALSE(blotter.legs[1].limit.has_value());
+	ASSERT_EQ(blotter.legs[2].limit, 250.0);
+	ASSERT_EQ(blotter.spread[1].symbol, "ESH6");
+	ASSERT_EQ(blotter.spread[1].limit, 2.5);
+	ASSERT_TRUE(blotter.amended != nullptr);
+	ASSERT_EQ(blotter.amended->size(), 1);
+	ASSERT_EQ((*blotter.amended)[0].quantity, 9);
+
+	TradeBlotter decoded;
+	rapidjson_util::unmarshal(rapidjson_util::marshal(blotter), decoded);
+	ASSERT_EQ(decoded.legs.size(), 3);
+	ASSERT_EQ(decoded.legs[2].symbol, "TSLA");
+	ASSERT_EQ(decoded.spread[0].quantity, 1);
+	ASSERT_EQ((*decoded.amended)[0].symbol, "NVDA");
+
+	rapidjson_util::unmarshal(R"({ "legs" : { "symbol" : [], "quantity" : [], "limit" : [] },
+	                               "spread" : { "limit" : [ null, null ], "quantity" : [ 1, 2 ], "symbol" : [ "A", "B" ] },
+	                               "amended" : null })", decoded);
+	ASSERT_TRUE(decoded.legs.empty());
+	ASSERT_EQ(decoded.amended, nullptr);
+}
+
+TEST(RapidUnmarshalTest, ThrowWhenColumnsAreMalformed) {
+	auto expectFailure = [](const std::string& json, const std::string& message) {
+		TradeBlotter blotter;
+		try {
+			rapidjson_util::unmarshal(json, blotter);
+			FAIL() << "Expected an exception for " << json;
+		}
+		catch (std::logic_error& e) {
+			EXPECT_EQ(std::string(e.what()), message);
+		}
+	};
+
+	const std::string spread = R"("spread" : { "symbol" : [ "A", "B" ], "quantity" : [ 1, 2 ], "limit" : [ 1.0, 2.0 ] }, "amended" : null)";
+
+	expectFailure(R"({ "legs" : { "symbol" : [ "A", "B" ], "quantity" : [ 1 ], "limit" : [ 1.0, 2.0 ] }, )" + spread + "}",
+	              "Deserialization of member \"legs\" failed: Deserialization of member \"quantity\" failed: "
+	              "Column length mismatch: JSON contains 1 elements, but the columns before contain 2 elements.");
+	expectFailure(R"({ "legs" : { "symbol" : [ "A" ], "limit" : [ 1.0 ] }, )" + spread + "}",
+	              "Deserialization of member \"legs\" failed: JSON doesn't match the struct: required field \"quantity\" not found");
+	expectFailure(R"({ "legs" : { "symbol" : [ "A" ], "quantity" : [ null ], "limit" : [ 1.0 ] }, )" + spread + "}",
+	              "Deserialization of member \"legs\" failed: Deserialization of member \"quantity\" failed: "
+	              "JSON array contains null elements");
+	expectFailure(R"({ "legs" : [ { "symbol" : "A", "quantity" : 1, "limit" : 1.0 } ], )" + spread + "}",
+	              "Deserialization of member \"legs\" failed: Expected Object, got Array");
+	expectFailure(R"({ "legs" : { "symbol" : [], "quantity" : [], "limit" : [] },
+	                   "spread" : { "symbol" : [ "A", "B", "C" ], "quantity" : [ 1, 2, 3 ], "limit" : [ 1.0, 2.0, 3.0 ] }, "amended" : null })",
+	              "Deserialization of member \"spread\" failed: Deserialization of member \"symbol\" failed: Array size mismatch: "
+	              "JSON contains 3 elements, but given array has fixed capacity of 2 elements and cannot be resized.");
+}
+
+
+struct SlimVenue {
+	std::string mic = "XNAS";
+	int lot = 100;
+};
+
+struct SlimOrder {
+	std::string symbol;
+	double limit = 0.0;
+	std::optional<int> display;
+	std::vector<std::string> tags;
+	char account[8] = "HOUSE";
+	SlimVenue venue;
+	std::unique_ptr<SlimVenue> route;
+	int retries = 3;
+};
+
+struct SlimTick {
+	std::string symbol;
+	std::optional<double> bid;
+	std::optional<double> ask;
+};
+
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SlimVenue, (mic, lot))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SlimOrder, (symbol, limit, display, tags, account, venue, route, retries))
+RAPIDJSON_UTIL_DESCRIBE_MEMBERS(SlimTick, (symbol, bid, ask))
+RAPIDJSON_UTIL_DESCRIBE_OMISSION(SlimTick, Nulls)
+RAPIDJSON_UTIL_DESCRIBE_WIRE_NAMES(SlimTick, (symbol, "s"), (bid, "b"), (ask, "a"))
+
+TEST(RapidUnmarshalTest, RestoreOmittedMembers) {
+	SlimOrder order;
+	order.symbol = "IBM";
+	order.limit = 180.5;
+	order.display = 100;
+	order.tags = { "iceberg" };
+	std::strcpy(order.account, "ALGO");
+	order.venue = { "ARCX", 1 };
+	order.route = std::make_unique<SlimVenue>();
+	order.retries = 9;
+
+	// Every member missing from the JSON is restored to that of a value-initialized SlimOrder
+	rapidjson_util::unmarshal(R"({"symbol":"MSFT","venue":{"lot":50}})", order, rapidjson_util::Omission::Defaults);
+	ASSERT_EQ(order.symbol, "MSFT");
+	ASSERT_EQ(order.limit, 0.0);
+	ASSERT_FALSE(order.display.has_value());
+	ASSERT_TRUE(order.tags.empty());
+	ASSERT_STREQ(order.account, "HOUSE");
+	ASSERT_EQ(order.venue.mic, "XNAS");
+	ASSERT_EQ(order.venue.lot, 50);
+	ASSERT_EQ(order.route, nullptr);
+	ASSERT_EQ(order.retries, 3);
+
+	order.display = 100;
+	order.retries = 0;
+	auto json = rapidjson_util::marshal(order, rapidjson_util::Omission::Defaults);
+	ASSERT_EQ(json, R"({"symbol":"MSFT","display":100,"venue":{"lot":50},"retries":0})");
+
+	SlimOrder decoded;
+	decoded.retries = 7;
+	rapidjson_util::unmarshal(json, decoded, rapidjson_util::Omission::Defaults);
+	ASSERT_EQ(decoded.display, 100);
+	ASSERT_EQ(decoded.venue.mic, "XNAS");
+	ASSERT_EQ(decoded.retries, 0);
+
+	order.limit = -0.0;
+	json = rapidjson_util::marshal(order, rapidjson_util::Omission::Defaults);
+	decoded.limit = 1.0;
+	rapidjson_util::unmarshal(json, decoded, rapidjson_util::Omission::Defaults);
+	ASSERT_TRUE(std::signbit(decoded.limit));
+
+	// Only nullable members may be missing when nulls are omitted
+	rapidjson_util::unmarshal(R"({"symbol":"T","limit":1.0,"tags":[],"account":"A","venue":{"mic":"M","lot":1},"retries":1})", decoded,
+	                          rapidjson_util::Omission::Nulls);
+	ASSERT_FALSE(decoded.display.has_value());
+	ASSERT_EQ(decoded.route, nullptr);
+
+	try {
+		rapidjson_util::unmarshal(R"({"symbol":"T","tags":[],"account":"A","venue":{"mic":"M","lot":1},"retries":1})", decoded,
+		                          rapidjson_util::Omission::Nulls);
+		FAIL() << "Expected MemberNotFoundException";
+	}
+	catch (rapidjson_util::MemberNotFoundException& e) {
+		ASSERT_STREQ(e.what(), "JSON doesn't match the struct: required field \"limit\" not found");
+	}
+
+	ASSERT_THROW(rapidjson_util::unmarshal(R"({"symbol":"MSFT"})", decoded), rapidjson_util::MemberNotFoundException);
+}
+
+TEST(RapidUnmarshalTest, UnserializeWireNamesWithTypeOmission) {
+	SlimTick tick{ "X", 1.0, 2.0 };
+
+	rapidjson_util::unmarshal(R"({"s":"AAPL","b":189.5})", tick);
+	ASSERT_EQ(tick.symbol, "AAPL");
+	ASSERT_EQ(tick.bid, 189.5);
+	ASSERT_FALSE(tick.ask.has_value());
+
+	ASSERT_THROW(rapidjson_util::unmarshal(R"({"symbol":"AAPL","bid":189.5,"ask":189.6})", tick), rapidjson_util::MemberNotFoundException);
+
+	tick.ask = 189.75;
+	SlimTick decoded;
+	rapidjson_util::unmarshal(rapidjson_util::marshal(tick), decoded);
+	ASSERT_EQ(decoded.ask, 189.75);
+}
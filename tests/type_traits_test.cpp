@@ -2,20 +2,38 @@
 #include "rapid_util/rapid_util_preprocessor.h"
 #include <cstdint>
 #include <tuple>
+#include <deque>
 
 using namespace rapidjson_util::detail;
 
+template<typename T>
+struct TypeHolder {
+
+};
+
 TEST(JsonValueTypeTraitTest, SupportValidJsonTypes) {
 	static_assert(is_json_serializable_primitive_type_v<int>);
 	static_assert(is_json_serializable_primitive_type_v<int8_t>);
 	static_assert(is_json_serializable_primitive_type_v<int32_t>);
+	static_assert(is_json_serializable_primitive_type_v<int16_t>);
 	static_assert(is_json_serializable_primitive_type_v<int64_t>);
+	static_assert(is_json_serializable_primitive_type_v<uint8_t>);
+	static_assert(is_json_serializable_primitive_type_v<uint16_t>);
+	static_assert(is_json_serializable_primitive_type_v<uint32_t>);
+	static_assert(is_json_serializable_primitive_type_v<unsigned>);
 	static_assert(is_json_serializable_primitive_type_v<uint64_t>);
+	static_assert(is_json_serializable_primitive_type_v<long>);
+	static_assert(is_json_serializable_primitive_type_v<unsigned long>);
+	static_assert(is_json_serializable_primitive_type_v<long long>);
+	static_assert(is_json_serializable_primitive_type_v<unsigned long long>);
 	static_assert(is_json_serializable_primitive_type_v<bool>);
 	static_assert(is_json_serializable_primitive_type_v<std::string>);
+	static_assert(is_json_serializable_primitive_type_v<std::pmr::string>);
 	static_assert(is_json_serializable_primitive_type_v<float>);
 	static_assert(is_json_serializable_primitive_type_v<double>);
 	static_assert(is_json_serializable_primitive_type_v<std::optional<int>>);
+	static_assert(is_json_serializable_primitive_type_v<std::unique_ptr<int>>);
+	static_assert(is_json_serializable_primitive_type_v<std::shared_ptr<std::string>>);
 }
 
 TEST(JsonValueTypeTraitTest, RejectUnserializableTypes) {
@@ -25,6 +43,8 @@ TEST(JsonValueTypeTraitTest, RejectUnserializableTypes) {
 	static_assert(!is_json_serializable_primitive_type_v<int&>, "References are not allowed, use std::optional instead");
 	static_assert(!is_json_serializable_primitive_type_v<std::optional<int*>>);
 	static_assert(!is_json_serializable_primitive_type_v<std::optional<int&>>);
+	static_assert(!is_json_serializable_primitive_type_v<std::unique_ptr<int*>>);
+	static_assert(!is_json_serializable_primitive_type_v<std::optional<std::unique_ptr<int>>>, "Nested nullable wrappers are ambiguous");
 	static_assert(!is_json_serializable_primitive_type_v<char*>, "Using std::string for parsing string");
 	static_assert(!is_json_serializable_primitive_type_v<const std::string>, "Const-qualified types are not allowed");
 	static_assert(!is_json_serializable_primitive_type_v<aUnSerialableType>, "Not a valid JSON ValueType");
@@ -44,11 +64,92 @@ TEST(JsonValueTypeTraitTest, ValidateTupleSerializableElementTypes) {
 
 }
 
-template<typename T>
-struct TypeHolder {
+struct VariantAlternative {
+	int id;
+};
+
+template<>
+struct rapidjson_util::detail::Descriptor<VariantAlternative> {
+	static constexpr bool is_describable = true;
+};
+
+TEST(JsonValueTypeTraitTest, ValidateNestedContainerElementTypes) {
+	static_assert(is_json_serializable_v<std::vector<std::vector<double>>>);
+	static_assert(is_json_serializable_v<std::array<std::array<float, 4>, 4>>);
+	static_assert(is_json_serializable_v<std::list<std::tuple<int, std::vector<std::string>>>>);
+	static_assert(is_json_serializable_v<std::vector<std::optional<std::list<int>>>>);
+	static_assert(!is_json_serializable_v<std::vector<std::vector<std::stringstream>>>);
+
+	static_assert(is_contiguous_number_array_v<std::vector<double>>);
+	static_assert(is_contiguous_number_array_v<std::vector<std::array<double, 3>>>);
+	using Tensor = contiguous_number_array_traits<std::array<std::array<std::array<int, 2>, 3>, 4>>;
+	static_assert(Tensor::extents.size() == 3 && Tensor::extents[0] == 4 && Tensor::extents[1] == 3 &&
+	              Tensor::extents[2] == 2);
+	static_assert(!is_contiguous_number_array_v<std::vector<std::vector<double>>>,
+	              "Rows of a vector of vectors are separate allocations");
+	static_assert(!is_contiguous_number_array_v<std::array<bool, 3>>);
+	static_assert(!is_contiguous_number_array_v<std::optional<std::vector<int>>>);
+}
+
+TEST(JsonValueTypeTraitTest, DetectContainersModellingTheSequenceConcept) {
+	using rapidjson_util::static_vector;
+	using rapidjson_util::small_vector;
 
+	static_assert(is_json_serializable_sequential_container_v<static_vector<int, 4>>);
+	static_assert(is_json_serializable_sequential_container_v<std::optional<small_vector<std::string, 2>>>);
+	static_assert(is_json_serializable_sequential_container_v<std::deque<double>>);
+	static_assert(!is_json_serializable_sequential_container_v<std::string>, "Strings are not arrays of chars");
+	static_assert(!is_json_serializable_sequential_container_v<TypeHolder<int>>);
+
+	static_assert(is_contiguous_number_array_v<static_vector<std::array<float, 2>, 8>>);
+	static_assert(is_contiguous_number_array_v<small_vector<uint16_t, 8>>);
+	static_assert(!is_contiguous_number_array_v<std::deque<int>>);
+}
+
+TEST(JsonValueTypeTraitTest, DetectMarshalOnlyViews) {
+	static_assert(is_json_view_v<std::string_view>);
+	static_assert(is_json_view_v<std::reference_wrapper<const VariantAlternative>>);
+	static_assert(is_json_serializable_v<std::vector<std::string_view>>);
+	static_assert(!is_json_view_v<std::reference_wrapper<int>>, "Only const references are views");
+	static_assert(!is_json_view_v<std::reference_wrapper<const std::stringstream>>);
+#if defined(__cpp_lib_span)
+	static_assert(is_json_view_v<std::span<const std::array<float, 3>>>);
+	static_assert(!is_json_view_v<std::span<int>>, "Only spans of const elements are views");
+#endif
+}
+
+struct CodecValue {};
+struct WriteOnlyCodecValue {};
+
+template<>
+struct rapidjson_util::json_codec<CodecValue> {
+	static void write(JsonValueWriter&, const CodecValue&) {}
+	static void read(JsonValueReader&, CodecValue&) {}
+};
+
+template<>
+struct rapidjson_util::json_codec<WriteOnlyCodecValue> {
+	static void write(JsonValueWriter&, const WriteOnlyCodecValue&) {}
 };
 
+TEST(JsonValueTypeTraitTest, DetectUserDefinedCodecs) {
+	static_assert(has_json_codec_v<CodecValue>);
+	static_assert(has_json_codec_v<std::optional<CodecValue>>);
+	static_assert(is_json_serializable_v<std::vector<std::unique_ptr<CodecValue>>>);
+	static_assert(!has_json_codec_v<WriteOnlyCodecValue>, "A codec needs both write and read");
+	static_assert(!is_json_serializable_v<WriteOnlyCodecValue>);
+}
+
+TEST(JsonValueTypeTraitTest, ValidateVariantSerializableAlternativeTypes) {
+	static_assert(is_json_serializable_variant_v<std::variant<VariantAlternative>>);
+	static_assert(is_json_serializable_variant_v<std::optional<std::variant<VariantAlternative>>>);
+
+	static_assert(!is_json_serializable_variant_v<std::variant<VariantAlternative, int>>,
+		          "Only described structs are allowed as alternatives");
+	static_assert(!is_json_serializable_variant_v<std::variant<std::optional<VariantAlternative>>>,
+		          "Optional alternatives are ambiguous with a null variant");
+}
+
 TEST(JsonValueTypeTraitTest, IdentifyContainersWithNullableElementsUsingStdOptional) {
 	using aUnSerialableType = std::stringstream;
 
@@ -61,6 +162,10 @@ TEST(JsonValueTypeTraitTest, IdentifyContainersWithNullableElementsUsingStdOptio
 	static_assert(has_std_optional_elements<std::array<std::optional<float>, 5>>::value);
 	static_assert(has_std_optional_elements<std::optional<std::array<std::optional<bool>, 10>>>::value);
 
+	static_assert(has_std_optional_elements<std::vector<std::unique_ptr<int>>>::value);
+	static_assert(has_std_optional_elements<std::shared_ptr<std::list<std::shared_ptr<std::string>>>>::value);
+
+	static_assert(!has_std_optional_elements<std::vector<int>>::value);
 	static_assert(!has_std_optional_elements<std::vector<std::optional<aUnSerialableType>>>::value);
 	static_assert(!has_std_optional_elements<TypeHolder<std::optional<bool>>>::value,
 		          "TypeHolder is not a standard sequential container.");
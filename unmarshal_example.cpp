@@ -1,5 +1,6 @@
 ﻿#include "rapid_util/rapid_util.h"
 #include <iostream>
+#include <chrono>
 
 struct Person {
     std::string name;
@@ -116,7 +117,7 @@ struct SensorReading {
 };
 
 struct SystemStatus {
-    std::string timestamp;
+    std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds> timestamp;  // RFC 3339 string
     std::tuple<bool, int, SensorReading, std::string> statusData;
     std::optional<std::tuple<double, std::string, int>> diagnostics;
 };
@@ -139,7 +140,7 @@ void unmarshal_heterogeneous_array() {
     const auto& [isOnline, sensorCount, reading, status] = systemStatus.statusData;
 
     std::cout << "Unmarshaled System Status:" << std::endl;
-    std::cout << "  Timestamp: " << systemStatus.timestamp << std::endl;
+    std::cout << "  Timestamp: " << systemStatus.timestamp.time_since_epoch().count() << " (Unix time)" << std::endl;
     std::cout << "  Status Data:" << std::endl;
     std::cout << "    - Online: " << (isOnline ? "Yes" : "No") << std::endl;
     std::cout << "    - Sensor Count: " << sensorCount << std::endl;